@@ -0,0 +1,134 @@
+#! /usr/bin/perl -w
+#
+# Merge LA-MPI event trace files (written by each process when
+# LAMPI_TRACE=1) and print a per-function summary, a time line of all
+# events and/or the point-to-point message matrix.
+#
+#   parse_trace.pl [--summary] [--timeline] [--matrix] <files>
+#
+# With no options all three reports are printed.  Times are in
+# seconds from the earliest recorded event.  The message matrix
+# counts sends on MPI_COMM_WORLD only, since peers on other
+# communicators are not world ranks.
+
+use strict;
+use FileHandle;
+use Getopt::Long;
+
+my $COMM_WORLD = 1;
+my $HEADER_LEN = 48;
+my $NAME_LEN = 16;
+my %SEND_FUNCS = map { $_ => 1 }
+    qw(MPI_Send MPI_Ssend MPI_Rsend MPI_Bsend MPI_Isend MPI_Sendrecv);
+
+my ($summary, $timeline, $matrix) = (0, 0, 0);
+my @events = ();
+my %calls = ();
+my %bytes_to = ();
+my %msgs_to = ();
+my $nprocs = 0;
+my $tmin;
+
+# check for correct number of arguments
+if ($#ARGV < 0) {
+    print "parse_trace.pl <--summary> <--timeline> <--matrix> <files>\n";
+    exit(0);
+}
+
+# parse command line
+GetOptions("summary" => \$summary,
+           "timeline" => \$timeline,
+           "matrix" => \$matrix);
+if (not ($summary or $timeline or $matrix)) {
+    $summary = $timeline = $matrix = 1;
+}
+
+# read each trace file
+foreach my $file (@ARGV) {
+    my $fh = new FileHandle;
+    my ($buf, $magic, $version, $rank, $np, $recsize, $nfuncs, $pad, $offset,
+        $tick);
+    my @names;
+
+    open($fh, "<$file") or die "parse_trace.pl: can not open $file\n";
+    binmode($fh);
+
+    read($fh, $buf, $HEADER_LEN) == $HEADER_LEN
+        or die "parse_trace.pl: $file: short header\n";
+    ($magic, $version, $rank, $np, $recsize, $nfuncs, $pad, $offset, $tick) =
+        unpack("a8 l l l l l l d d", $buf);
+    $magic eq "LAMPITRC"
+        or die "parse_trace.pl: $file: not a trace file\n";
+    $version == 2
+        or die "parse_trace.pl: $file: unknown version $version\n";
+    $nprocs = $np if ($np > $nprocs);
+
+    read($fh, $buf, $nfuncs * $NAME_LEN) == $nfuncs * $NAME_LEN
+        or die "parse_trace.pl: $file: short header\n";
+    @names = unpack("Z$NAME_LEN" x $nfuncs, $buf);
+
+    while (read($fh, $buf, $recsize) == $recsize) {
+        my ($t0, $t1, $bytes, $func, $peer, $tag, $comm) =
+            unpack("q q q l l l l", $buf);
+        my $name = $func < $nfuncs ? $names[$func] : "func$func";
+
+        # time stamps are in ticks of $tick seconds; take the duration
+        # before adding the offset, which would round it
+        my $dt = ($t1 - $t0) * $tick;
+        $t0 = $offset + $t0 * $tick;
+        $tmin = $t0 if (not defined($tmin) or $t0 < $tmin);
+        push @events, [ $t0, $dt, $rank, $name, $peer, $tag, $comm, $bytes ];
+
+        $calls{$name}[0]++;
+        $calls{$name}[1] += $dt;
+        $calls{$name}[2] += $bytes;
+
+        if ($SEND_FUNCS{$name} and $comm == $COMM_WORLD and $peer >= 0) {
+            $bytes_to{$rank}{$peer} += $bytes;
+            $msgs_to{$rank}{$peer}++;
+        }
+    }
+    close($fh);
+}
+
+exit(0) if (not @events);
+
+if ($summary) {
+    printf("\n%-20s %10s %14s %12s %16s\n",
+           "Function", "Calls", "Time (s)", "Avg (us)", "Bytes");
+    print "-" x 76, "\n";
+    foreach my $name (sort { $calls{$b}[1] <=> $calls{$a}[1] } keys %calls) {
+        my ($n, $t, $b) = @{$calls{$name}};
+        printf("%-20s %10d %14.6f %12.2f %16.0f\n",
+               $name, $n, $t, 1.0e6 * $t / $n, $b);
+    }
+}
+
+if ($timeline) {
+    printf("\n%14s %6s %-20s %6s %8s %6s %12s %12s\n",
+           "Time (s)", "Rank", "Function", "Peer", "Tag", "Comm",
+           "Bytes", "Dur (us)");
+    print "-" x 92, "\n";
+    foreach my $e (sort { $a->[0] <=> $b->[0] or $a->[2] <=> $b->[2] }
+                   @events) {
+        my ($t0, $dt, $rank, $name, $peer, $tag, $comm, $bytes) = @$e;
+        printf("%14.6f %6d %-20s %6d %8d %6d %12.0f %12.2f\n",
+               $t0 - $tmin, $rank, $name, $peer, $tag, $comm, $bytes,
+               1.0e6 * $dt);
+    }
+}
+
+if ($matrix) {
+    foreach my $what ([ "Messages", \%msgs_to ], [ "Bytes", \%bytes_to ]) {
+        my ($title, $m) = @$what;
+        print "\n$title sent (row: sender, column: receiver)\n\n";
+        printf("%6s", "");
+        printf(" %10d", $_) for (0 .. $nprocs - 1);
+        print "\n";
+        for my $i (0 .. $nprocs - 1) {
+            printf("%6d", $i);
+            printf(" %10.0f", $m->{$i}{$_} || 0) for (0 .. $nprocs - 1);
+            print "\n";
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * A simple MPI barrier latency benchmark.
+ *
+ * Times MPI_Barrier on communicators of the first 2, 4, 8, ...
+ * processes of MPI_COMM_WORLD, up to 128 or the number of processes.
+ * Run with all processes on one host to measure the on-host barrier;
+ * the algorithm can be chosen with LAMPI_BARRIER.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <mpi.h>
+
+
+static void usage(void)
+{
+    int self;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    if (self == 0) {
+        fprintf(stderr,
+                "Usage: mpi-barrier-bench [flags]\n"
+                "   Flags may be any of\n"
+                "      -s number         sample size (barriers) to time\n"
+                "      -n number         number of samples\n"
+                "      -m number         largest number of processes\n"
+                "      -h                print this info\n");
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+    MPI_Comm comm;
+    double t, tmin, tave;
+    int nproc, self, size, max_size, i, j, c;
+    int nsample = 10, sample_size = 1000;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    max_size = 128;
+    while ((c = getopt(argc, argv, "s:n:m:h")) != -1) {
+        switch (c) {
+        case 's':
+            sample_size = atoi(optarg);
+            break;
+        case 'n':
+            nsample = atoi(optarg);
+            break;
+        case 'm':
+            max_size = atoi(optarg);
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (nsample < 1 || sample_size < 1) {
+        usage();
+    }
+    if (max_size > nproc) {
+        max_size = nproc;
+    }
+
+    if (self == 0) {
+        printf("%8s %14s %14s\n", "procs", "tmin (usec)", "tave (usec)");
+    }
+
+    for (size = 2; size <= max_size; size *= 2) {
+
+        MPI_Comm_split(MPI_COMM_WORLD, self < size ? 0 : MPI_UNDEFINED,
+                       self, &comm);
+
+        if (comm != MPI_COMM_NULL) {
+
+            /* warm up */
+            for (i = 0; i < sample_size; i++) {
+                MPI_Barrier(comm);
+            }
+
+            tmin = 1.0e99;
+            tave = 0.0;
+            for (j = 0; j < nsample; j++) {
+                MPI_Barrier(comm);
+                t = MPI_Wtime();
+                for (i = 0; i < sample_size; i++) {
+                    MPI_Barrier(comm);
+                }
+                t = (MPI_Wtime() - t) / sample_size;
+                tmin = t < tmin ? t : tmin;
+                tave += t;
+            }
+            tave /= nsample;
+
+            if (self == 0) {
+                printf("%8d %14.3f %14.3f\n", size, 1.0e6 * tmin,
+                       1.0e6 * tave);
+                fflush(stdout);
+            }
+
+            MPI_Comm_free(&comm);
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        if (size < max_size && 2 * size > max_size) {
+            size = max_size / 2;
+        }
+    }
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -1,5 +1,10 @@
 /*
  * A simple MPI collective benchmark using sample based timing.
+ *
+ * With -T, each algorithm LA-MPI implements for the selected
+ * operations is timed in turn, and the fastest for each message size
+ * is written as a collective tuning file for use with
+ * LAMPI_COLL_TUNE.
  */
 
 #include <sys/time.h>
@@ -58,6 +63,37 @@ struct {
 };
 
 
+/*
+ * algorithms swept by -T for each operation, and whether the segment
+ * size is swept too
+ */
+
+struct {
+    int flag;
+    char *coll;
+    char *alg[5];
+    int segmented;
+} tune_table[] = {
+    { ALLGATHER,	"allgather",
+      { "recursive_doubling", "bruck", "ring", "smp", NULL }, 0 },
+    { ALLREDUCE,	"allreduce",	{ "linear", "p2p", "smp", NULL }, 1 },
+    { ALLTOALL,		"alltoall",	{ "bruck", "pairwise", "smp", NULL }, 0 },
+    { BARRIER,		"barrier",	{ "p2p", "smp", NULL }, 0 },
+    { BCAST,		"bcast",	{ "p2p", "smp", NULL }, 1 },
+    { REDUCE,		"reduce",	{ "linear", "p2p", "smp", NULL }, 1 },
+    { SCAN,		"scan",
+      { "recursive_doubling", "pipeline", "smp", NULL }, 1 },
+    { 0,		NULL,		{ NULL }, 0 }
+};
+
+/* segment sizes swept by -T; 0 is the built-in size */
+static int seg_table[] = { 0, 16 << 10, 64 << 10, 256 << 10, -1 };
+
+/* LA-MPI extension: force the algorithm used by a collective */
+extern int ulm_coll_tune_force(const char *coll, const char *alg,
+                               int segsize);
+
+
 static void usage(void)
 {
     int self;
@@ -91,6 +127,10 @@ static void help(void)
                "      -d                use double instead of int (only for: \n"
 	       "                        allreduce\n"
                "      -O <operation>    operation to time\n"
+               "      -T <file>         time each algorithm and write the\n"
+               "                        fastest to a tuning file (only for:\n"
+               "                        allgather, allreduce, alltoall,\n"
+               "                        barrier, bcast, reduce, scan)\n"
                "      -W                perform warm-up phase\n"
                "      -s number         sample size (repetitions) to time\n"
                "      -n number         number of samples\n"
@@ -146,6 +186,175 @@ static double second(void)
 }
 
 
+/*
+ * number of hosts, and largest number of processes on a host
+ */
+static void shape(int nproc, int *nhost, int *ppn)
+{
+    char name[MPI_MAX_PROCESSOR_NAME];
+    char *names;
+    int len, i, j, n;
+
+    names = (char *) calloc(nproc, MPI_MAX_PROCESSOR_NAME);
+    if (names == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    memset(name, 0, sizeof(name));
+    MPI_Get_processor_name(name, &len);
+    MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                  names, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, MPI_COMM_WORLD);
+    *nhost = *ppn = 0;
+    for (i = 0; i < nproc; i++) {
+        for (j = 0; j < i; j++) {
+            if (strcmp(names + i * MPI_MAX_PROCESSOR_NAME,
+                       names + j * MPI_MAX_PROCESSOR_NAME) == 0) {
+                break;
+            }
+        }
+        if (j < i) {
+            continue;
+        }
+        (*nhost)++;
+        for (n = 0, j = i; j < nproc; j++) {
+            if (strcmp(names + i * MPI_MAX_PROCESSOR_NAME,
+                       names + j * MPI_MAX_PROCESSOR_NAME) == 0) {
+                n++;
+            }
+        }
+        *ppn = n > *ppn ? n : *ppn;
+    }
+    free(names);
+}
+
+
+/*
+ * minimum over samples of the time per call, maximized over
+ * processes
+ */
+static double time_op(int op, int *sbuf, int *rbuf, int count,
+                      int nsample, int sample_size)
+{
+    double t, tmin;
+    int i, j;
+
+    tmin = 1.0e99;
+    for (j = 0; j < nsample; j++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        t = second();
+        for (i = 0; i < sample_size; i++) {
+            switch (op) {
+            case ALLGATHER:
+                MPI_Allgather(sbuf, count, MPI_INT, rbuf, count, MPI_INT,
+                              MPI_COMM_WORLD);
+                break;
+            case ALLREDUCE:
+                MPI_Allreduce(sbuf, rbuf, count, MPI_INT, MPI_SUM,
+                              MPI_COMM_WORLD);
+                break;
+            case ALLTOALL:
+                MPI_Alltoall(sbuf, count, MPI_INT, rbuf, count, MPI_INT,
+                             MPI_COMM_WORLD);
+                break;
+            case BARRIER:
+                MPI_Barrier(MPI_COMM_WORLD);
+                break;
+            case BCAST:
+                MPI_Bcast(rbuf, count, MPI_INT, 0, MPI_COMM_WORLD);
+                break;
+            case REDUCE:
+                MPI_Reduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, 0,
+                           MPI_COMM_WORLD);
+                break;
+            case SCAN:
+                MPI_Scan(sbuf, rbuf, count, MPI_INT, MPI_SUM,
+                         MPI_COMM_WORLD);
+                break;
+            }
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        t = second() - t;
+        tmin = t < tmin ? t : tmin;
+    }
+    tmin /= (double) sample_size;
+    MPI_Allreduce(&tmin, &t, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    return t;
+}
+
+
+/*
+ * time each algorithm of operation tune_table[op] for each message
+ * size, and write rules for the fastest to fp (on process 0 only)
+ */
+static void tune(FILE *fp, int op, int *sbuf, int *rbuf,
+                 int min_bytes, int max_bytes, int inc_bytes,
+                 int nsample, int sample_size,
+                 int nproc, int nhost, int ppn, int self)
+{
+    char *coll = tune_table[op].coll;
+    char *best_alg, *rule_alg;
+    double t, best_t;
+    int a, s, bytes, best_seg, rule_seg, rule_min;
+
+    rule_alg = NULL;
+    rule_seg = rule_min = 0;
+    for (bytes = min_bytes; bytes <= max_bytes;
+         bytes = inc_bytes ? bytes + inc_bytes : bytes ? 2 * bytes : 1) {
+
+        best_alg = NULL;
+        best_t = 1.0e99;
+        best_seg = 0;
+        for (a = 0; tune_table[op].alg[a]; a++) {
+            for (s = 0; seg_table[s] >= 0; s++) {
+                if (s > 0 && (!tune_table[op].segmented ||
+                              seg_table[s] >= bytes)) {
+                    break;
+                }
+                ulm_coll_tune_force(coll, tune_table[op].alg[a],
+                                    seg_table[s]);
+                t = time_op(tune_table[op].flag, sbuf, rbuf,
+                            bytes / sizeof(int), nsample, sample_size);
+                if (self == 0) {
+                    printf("%-10s %10d  %-20s %8d %14.3f usec\n",
+                           coll, bytes, tune_table[op].alg[a],
+                           seg_table[s], 1.0e6 * t);
+                    fflush(stdout);
+                }
+                if (t < best_t) {
+                    best_t = t;
+                    best_alg = tune_table[op].alg[a];
+                    best_seg = seg_table[s];
+                }
+            }
+        }
+        ulm_coll_tune_force(coll, NULL, 0);
+
+        if (rule_alg && (best_alg != rule_alg || best_seg != rule_seg)) {
+            if (self == 0) {
+                fprintf(fp, "%-10s %-20s %8d %d-%d %d %d %d\n",
+                        coll, rule_alg, rule_seg, rule_min, bytes - 1,
+                        nproc, nhost, ppn);
+            }
+            rule_alg = NULL;
+        }
+        if (rule_alg == NULL) {
+            rule_alg = best_alg;
+            rule_seg = best_seg;
+            rule_min = (bytes == min_bytes) ? 0 : bytes;
+        }
+        if (tune_table[op].flag == BARRIER) {
+            break;
+        }
+    }
+
+    if (self == 0 && rule_alg) {
+        fprintf(fp, "%-10s %-20s %8d %d-* %d %d %d\n",
+                coll, rule_alg, rule_seg, rule_min, nproc, nhost, ppn);
+    }
+}
+
+
 #define SAMPLE(NSAMPLE,SAMPLE_SIZE,CODE) {                         \
     int i, j;                                                      \
     double t, trms, tmin, tmax, tave, ttot;                        \
@@ -215,7 +424,9 @@ int main(int argc, char *argv[])
     int nproc;
     int self;
     FILE *outFile = 0;
+    FILE *tuneFile = 0;
     char FileName[10];
+    char *tuneFileName = NULL;
 
     /*
      * default options / arguments
@@ -236,7 +447,7 @@ int main(int argc, char *argv[])
     MPI_Comm_size(MPI_COMM_WORLD, &nproc);
 
 
-    while ((c = getopt(argc, argv, "adCO:n:s:h")) != -1) {
+    while ((c = getopt(argc, argv, "adCO:n:s:T:h")) != -1) {
         switch (c) {
 
         case 'a':
@@ -273,6 +484,10 @@ int main(int argc, char *argv[])
             }
             break;
 
+        case 'T':
+            tuneFileName = optarg;
+            break;
+
         case 'h':
             help();
 
@@ -407,6 +622,40 @@ int main(int argc, char *argv[])
         fflush(stdout);
     }
 
+    /*
+     * Tuning: sweep the algorithms and write the tuning file
+     */
+
+    if (tuneFileName) {
+        int nhost, ppn;
+
+        shape(nproc, &nhost, &ppn);
+        if (self == 0) {
+            if ((tuneFile = fopen(tuneFileName, "w")) == NULL) {
+                perror(tuneFileName);
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+            }
+            fprintf(tuneFile,
+                    "# collective tuning file written by mpi-coll-bench\n"
+                    "# %d processes on %d hosts, at most %d per host\n"
+                    "# collective algorithm segsize bytes procs hosts ppn\n",
+                    nproc, nhost, ppn);
+        }
+        for (i = 0; tune_table[i].flag; i++) {
+            if (operations & tune_table[i].flag) {
+                tune(tuneFile, i, sbuf, rbuf, min_bytes, max_bytes,
+                     inc_bytes, nsample, sample_size, nproc, nhost, ppn,
+                     self);
+            }
+        }
+        if (self == 0) {
+            fclose(tuneFile);
+            printf("Tuning file written to %s\n", tuneFileName);
+        }
+        MPI_Finalize();
+        return EXIT_SUCCESS;
+    }
+
     /*
      * Main loop
      */
@@ -0,0 +1,132 @@
+/*
+ * A simple MPI communicator creation benchmark.
+ *
+ * Duplicates MPI_COMM_WORLD the given number of times, keeping every
+ * duplicate alive, and reports the time per MPI_Comm_dup and the
+ * growth in resident memory per communicator.  The exchange phase
+ * then sends a message to each neighbor on every communicator, so the
+ * memory reported afterwards includes the per-peer state created by
+ * real traffic.  The shared memory collectives limit the number of
+ * communicators alive at once (MAX_COMMUNICATOR_SHARED_OBJECTS).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mpi.h>
+
+
+static void usage(void)
+{
+    int self;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    if (self == 0) {
+        fprintf(stderr,
+                "Usage: mpi-comm-bench [flags]\n"
+                "   Flags may be any of\n"
+                "      -n number         number of communicators\n"
+                "      -h                print this info\n");
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+
+/* resident set size in kB, or -1 if not available */
+static long rss_kb(void)
+{
+    char line[256];
+    FILE *fp;
+    long kb = -1;
+
+    fp = fopen("/proc/self/status", "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "VmRSS:", 6) == 0) {
+            kb = atol(line + 6);
+            break;
+        }
+    }
+    fclose(fp);
+
+    return kb;
+}
+
+
+int main(int argc, char *argv[])
+{
+    MPI_Comm *comm;
+    MPI_Status status;
+    double t;
+    long rss0, rss1, rss2;
+    int nproc, self, ncomm, lo, hi, sbuf, rbuf, i, c;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    ncomm = 64;
+    while ((c = getopt(argc, argv, "n:h")) != -1) {
+        switch (c) {
+        case 'n':
+            ncomm = atoi(optarg);
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (ncomm < 1) {
+        usage();
+    }
+
+    comm = malloc(ncomm * sizeof(MPI_Comm));
+    if (comm == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+
+    lo = (self + nproc - 1) % nproc;
+    hi = (self + 1) % nproc;
+    sbuf = self;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    rss0 = rss_kb();
+    t = MPI_Wtime();
+    for (i = 0; i < ncomm; i++) {
+        MPI_Comm_dup(MPI_COMM_WORLD, &comm[i]);
+    }
+    t = (MPI_Wtime() - t) / ncomm;
+    rss1 = rss_kb();
+
+    for (i = 0; i < ncomm; i++) {
+        MPI_Sendrecv(&sbuf, 1, MPI_INT, hi, i,
+                     &rbuf, 1, MPI_INT, lo, i, comm[i], &status);
+    }
+    rss2 = rss_kb();
+
+    if (self == 0) {
+        printf("%d processes, %d communicators\n", nproc, ncomm);
+        printf("%14s %20s %20s\n", "dup (usec)", "kB/comm created",
+               "kB/comm exchanged");
+        printf("%14.3f %20.3f %20.3f\n", 1.0e6 * t,
+               (double) (rss1 - rss0) / ncomm,
+               (double) (rss2 - rss0) / ncomm);
+        fflush(stdout);
+    }
+
+    for (i = 0; i < ncomm; i++) {
+        MPI_Comm_free(&comm[i]);
+    }
+    free(comm);
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/*
+ * Check that on-host eager reservations are released.
+ *
+ * Rank 1 sends a stream of small blocking messages to rank 0, which
+ * sleeps before receiving any of them, so the sender runs out of
+ * inline send headers and falls back to send descriptors.  Once rank 0
+ * has received everything, no eager data should be reserved against
+ * it; a leaked reservation would force later messages to rendezvous.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mpi.h>
+
+extern int ulm_eager_bytes(size_t *bytes);
+
+
+static void usage(void)
+{
+    int self;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    if (self == 0) {
+        fprintf(stderr,
+                "Usage: mpi-eager-check [flags]\n"
+                "   Flags may be any of\n"
+                "      -b number         bytes per message\n"
+                "      -n number         number of messages\n"
+                "      -d number         seconds before receives are posted\n"
+                "      -h                print this info\n");
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+    char *buf;
+    size_t reserved;
+    int nproc, self, bytes, nmsg, delay, i, c, rc;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    bytes = 1024;
+    nmsg = 3000;
+    delay = 1;
+    while ((c = getopt(argc, argv, "b:n:d:h")) != -1) {
+        switch (c) {
+        case 'b':
+            bytes = atoi(optarg);
+            break;
+        case 'n':
+            nmsg = atoi(optarg);
+            break;
+        case 'd':
+            delay = atoi(optarg);
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (bytes < 1 || nmsg < 1 || delay < 0 || nproc < 2) {
+        usage();
+    }
+
+    buf = malloc(bytes);
+    if (buf == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    memset(buf, 0, bytes);
+
+    rc = EXIT_SUCCESS;
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (self == 0) {
+        sleep(delay);
+        for (i = 0; i < nmsg; i++) {
+            MPI_Recv(buf, bytes, MPI_BYTE, 1, i, MPI_COMM_WORLD,
+                     MPI_STATUS_IGNORE);
+        }
+    } else if (self == 1) {
+        for (i = 0; i < nmsg; i++) {
+            MPI_Send(buf, bytes, MPI_BYTE, 0, i, MPI_COMM_WORLD);
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (self == 0) {
+        ulm_eager_bytes(&reserved);
+        if (reserved != 0) {
+            printf("mpi-eager-check: FAILED: %lu eager bytes still "
+                   "reserved after %d messages of %d bytes\n",
+                   (unsigned long) reserved, nmsg, bytes);
+            rc = EXIT_FAILURE;
+        } else {
+            printf("mpi-eager-check: passed\n");
+        }
+        fflush(stdout);
+    }
+
+    free(buf);
+    MPI_Finalize();
+
+    return rc;
+}
@@ -0,0 +1,191 @@
+/*
+ * A simple MPI halo exchange benchmark.
+ *
+ * Exchanges a face of the given size with both neighbors in each
+ * dimension of a periodic Cartesian grid, created once without and
+ * once with rank reordering, and reports the bytes per exchange that
+ * cross between hosts and the time per exchange.  Run with several
+ * processes per host on more than one host to see the effect of
+ * reordering.  With -a the exchange is a single neighborhood alltoall.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mpi.h>
+
+
+static void usage(void)
+{
+    int self;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    if (self == 0) {
+        fprintf(stderr,
+                "Usage: mpi-halo-bench [flags]\n"
+                "   Flags may be any of\n"
+                "      -a                use MPI_Neighbor_alltoall\n"
+                "      -d number         number of grid dimensions\n"
+                "      -b number         bytes per face\n"
+                "      -s number         sample size (exchanges) to time\n"
+                "      -n number         number of samples\n"
+                "      -h                print this info\n");
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+
+static int use_neighbor = 0;
+
+
+static void exchange(MPI_Comm comm, int ndims, char *sbuf, char *rbuf,
+                     int bytes)
+{
+    MPI_Status status;
+    int d, lo, hi;
+
+    if (use_neighbor) {
+        MPI_Neighbor_alltoall(sbuf, bytes, MPI_BYTE,
+                              rbuf, bytes, MPI_BYTE, comm);
+        return;
+    }
+
+    for (d = 0; d < ndims; d++) {
+        MPI_Cart_shift(comm, d, 1, &lo, &hi);
+        MPI_Sendrecv(sbuf, bytes, MPI_BYTE, hi, d,
+                     rbuf, bytes, MPI_BYTE, lo, d, comm, &status);
+        MPI_Sendrecv(sbuf, bytes, MPI_BYTE, lo, d,
+                     rbuf, bytes, MPI_BYTE, hi, d, comm, &status);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    MPI_Comm comm;
+    char name[MPI_MAX_PROCESSOR_NAME];
+    char *names, *sbuf, *rbuf;
+    double t, tmin, tave;
+    long long offhost, total;
+    int dims[8], periods[8];
+    int nproc, self, ndims, bytes, reorder, d, lo, hi, len, i, j, c;
+    int nsample = 10, sample_size = 100;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    ndims = 2;
+    bytes = 64 * 1024;
+    while ((c = getopt(argc, argv, "ad:b:s:n:h")) != -1) {
+        switch (c) {
+        case 'a':
+            use_neighbor = 1;
+            break;
+        case 'd':
+            ndims = atoi(optarg);
+            break;
+        case 'b':
+            bytes = atoi(optarg);
+            break;
+        case 's':
+            sample_size = atoi(optarg);
+            break;
+        case 'n':
+            nsample = atoi(optarg);
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (ndims < 1 || ndims > 8 || bytes < 0 ||
+        nsample < 1 || sample_size < 1) {
+        usage();
+    }
+
+    for (d = 0; d < ndims; d++) {
+        dims[d] = 0;
+        periods[d] = 1;
+    }
+    MPI_Dims_create(nproc, ndims, dims);
+
+    sbuf = malloc(2 * ndims * bytes + 1);
+    rbuf = malloc(2 * ndims * bytes + 1);
+    names = malloc(nproc * MPI_MAX_PROCESSOR_NAME);
+    if (sbuf == NULL || rbuf == NULL || names == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    memset(sbuf, 0, 2 * ndims * bytes + 1);
+
+    if (self == 0) {
+        printf("grid");
+        for (d = 0; d < ndims; d++) {
+            printf("%s%d", d ? " x " : " ", dims[d]);
+        }
+        printf(", %d bytes per face\n", bytes);
+        printf("%8s %20s %14s %14s\n", "reorder", "off-host bytes",
+               "tmin (usec)", "tave (usec)");
+    }
+
+    for (reorder = 0; reorder <= 1; reorder++) {
+
+        MPI_Cart_create(MPI_COMM_WORLD, ndims, dims, periods, reorder,
+                        &comm);
+
+        /* bytes sent to processes on other hosts per exchange */
+        memset(name, 0, sizeof(name));
+        MPI_Get_processor_name(name, &len);
+        MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                      names, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, comm);
+        offhost = 0;
+        for (d = 0; d < ndims; d++) {
+            MPI_Cart_shift(comm, d, 1, &lo, &hi);
+            if (strcmp(name, names + lo * MPI_MAX_PROCESSOR_NAME) != 0) {
+                offhost += bytes;
+            }
+            if (strcmp(name, names + hi * MPI_MAX_PROCESSOR_NAME) != 0) {
+                offhost += bytes;
+            }
+        }
+        MPI_Reduce(&offhost, &total, 1, MPI_LONG_LONG, MPI_SUM, 0, comm);
+
+        /* warm up */
+        for (i = 0; i < sample_size; i++) {
+            exchange(comm, ndims, sbuf, rbuf, bytes);
+        }
+
+        tmin = 1.0e99;
+        tave = 0.0;
+        for (j = 0; j < nsample; j++) {
+            MPI_Barrier(comm);
+            t = MPI_Wtime();
+            for (i = 0; i < sample_size; i++) {
+                exchange(comm, ndims, sbuf, rbuf, bytes);
+            }
+            t = (MPI_Wtime() - t) / sample_size;
+            tmin = t < tmin ? t : tmin;
+            tave += t;
+        }
+        tave /= nsample;
+
+        MPI_Comm_rank(comm, &i);
+        if (i == 0) {
+            printf("%8d %20lld %14.3f %14.3f\n", reorder, total,
+                   1.0e6 * tmin, 1.0e6 * tave);
+            fflush(stdout);
+        }
+
+        MPI_Comm_free(&comm);
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
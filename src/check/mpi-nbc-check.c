@@ -0,0 +1,315 @@
+/*
+ * Check the non-blocking collectives.
+ *
+ * Runs MPI_Ibcast, MPI_Ireduce, MPI_Iallreduce, MPI_Ialltoall and
+ * MPI_Iallgather over a range of counts, from every root where there
+ * is one, and checks the results.  The reductions use MPI_SUM and a
+ * non-commutative user op (2x2 matrix product modulo a prime), so a
+ * schedule that combines contributions out of rank order is caught.
+ * Several operations are left outstanding at once, and some complete
+ * by polling with MPI_Test.  Run at both odd and even process counts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+
+#define PRIME 1000003LL
+
+static int errors = 0;
+
+
+static void check(int ok, const char *what, int count, int root)
+{
+    int self;
+
+    if (!ok) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &self);
+        printf("mpi-nbc-check: rank %d: %s failed, count %d root %d\n",
+               self, what, count, root);
+        fflush(stdout);
+        errors++;
+    }
+}
+
+
+/* inout = in * inout for each 2x2 matrix, held as 4 ints */
+static void matmul(void *invec, void *inoutvec, int *len,
+                   MPI_Datatype *type)
+{
+    int *a = invec;
+    int *b = inoutvec;
+    long long c[4];
+    int i;
+
+    for (i = 0; i + 3 < *len; i += 4) {
+        c[0] = ((long long) a[i] * b[i] + (long long) a[i + 1] * b[i + 2]) % PRIME;
+        c[1] = ((long long) a[i] * b[i + 1] + (long long) a[i + 1] * b[i + 3]) % PRIME;
+        c[2] = ((long long) a[i + 2] * b[i] + (long long) a[i + 3] * b[i + 2]) % PRIME;
+        c[3] = ((long long) a[i + 2] * b[i + 1] + (long long) a[i + 3] * b[i + 3]) % PRIME;
+        b[i] = (int) c[0];
+        b[i + 1] = (int) c[1];
+        b[i + 2] = (int) c[2];
+        b[i + 3] = (int) c[3];
+    }
+}
+
+
+/* the matrix rank r contributes at element k */
+static void matrix(int r, int k, int *m)
+{
+    m[0] = r + 2 + k;
+    m[1] = 1;
+    m[2] = 3 + k % 5;
+    m[3] = r;
+}
+
+
+/* the product over ranks 0 .. nproc - 1, in rank order */
+static void product(int nproc, int k, int *m)
+{
+    int t[4];
+    int four = 4;
+    int r;
+
+    matrix(nproc - 1, k, m);
+    for (r = nproc - 2; r >= 0; r--) {
+        matrix(r, k, t);
+        matmul(t, m, &four, NULL);
+    }
+}
+
+
+static int product_ok(int nproc, int count, int *buf)
+{
+    int m[4];
+    int k;
+
+    for (k = 0; k < count; k++) {
+        product(nproc, k, m);
+        if (memcmp(m, buf + 4 * k, sizeof(m)) != 0) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+static void poll(MPI_Request *req)
+{
+    int flag = 0;
+
+    while (!flag) {
+        MPI_Test(req, &flag, MPI_STATUS_IGNORE);
+    }
+}
+
+
+static void check_ibcast(int count, int nproc, int self, int *a)
+{
+    MPI_Request req;
+    int root, i, ok;
+
+    for (root = 0; root < nproc; root++) {
+        for (i = 0; i < count; i++) {
+            a[i] = (self == root) ? 3 * i + root : -1;
+        }
+        MPI_Ibcast(a, count, MPI_INT, root, MPI_COMM_WORLD, &req);
+        poll(&req);
+        ok = 1;
+        for (i = 0; i < count; i++) {
+            ok = ok && (a[i] == 3 * i + root);
+        }
+        check(ok, "MPI_Ibcast", count, root);
+    }
+}
+
+
+static void check_ireduce(int count, int nproc, int self, MPI_Op op,
+                          int *a, int *b)
+{
+    MPI_Request req;
+    int root, i, ok;
+
+    for (root = 0; root < nproc; root++) {
+        for (i = 0; i < count; i++) {
+            a[i] = i + self;
+            b[i] = -1;
+        }
+        MPI_Ireduce(a, b, count, MPI_INT, MPI_SUM, root, MPI_COMM_WORLD,
+                    &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        if (self == root) {
+            ok = 1;
+            for (i = 0; i < count; i++) {
+                ok = ok && (b[i] == i * nproc + nproc * (nproc - 1) / 2);
+            }
+            check(ok, "MPI_Ireduce(MPI_SUM)", count, root);
+        }
+
+        for (i = 0; i < count; i++) {
+            matrix(self, i, a + 4 * i);
+        }
+        MPI_Ireduce(a, b, 4 * count, MPI_INT, op, root, MPI_COMM_WORLD,
+                    &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        if (self == root) {
+            check(product_ok(nproc, count, b), "MPI_Ireduce(matmul)",
+                  count, root);
+        }
+    }
+}
+
+
+static void check_iallreduce(int count, int nproc, int self, MPI_Op op,
+                             int *a, int *b, int *c)
+{
+    MPI_Request req[3];
+    int i, ok;
+
+    /* sum, sum in place and the matrix product all outstanding at once */
+    for (i = 0; i < count; i++) {
+        a[i] = i + self;
+        c[i] = 2 * self;
+        matrix(self, i, b + 4 * i);
+    }
+    MPI_Iallreduce(a, c + count, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD,
+                   &req[0]);
+    MPI_Iallreduce(MPI_IN_PLACE, c, count, MPI_INT, MPI_SUM,
+                   MPI_COMM_WORLD, &req[1]);
+    MPI_Iallreduce(b, a + count, 4 * count, MPI_INT, op, MPI_COMM_WORLD,
+                   &req[2]);
+    MPI_Waitall(3, req, MPI_STATUSES_IGNORE);
+
+    ok = 1;
+    for (i = 0; i < count; i++) {
+        ok = ok && (c[count + i] == i * nproc + nproc * (nproc - 1) / 2);
+    }
+    check(ok, "MPI_Iallreduce(MPI_SUM)", count, -1);
+    ok = 1;
+    for (i = 0; i < count; i++) {
+        ok = ok && (c[i] == nproc * (nproc - 1));
+    }
+    check(ok, "MPI_Iallreduce(MPI_IN_PLACE)", count, -1);
+    check(product_ok(nproc, count, a + count), "MPI_Iallreduce(matmul)",
+          count, -1);
+}
+
+
+static void check_ialltoall(int count, int nproc, int self, int *a, int *b)
+{
+    MPI_Request req;
+    int i, j, ok;
+
+    for (i = 0; i < nproc; i++) {
+        for (j = 0; j < count; j++) {
+            a[i * count + j] = 1000 * self + 7 * i + j;
+            b[i * count + j] = -1;
+        }
+    }
+    MPI_Ialltoall(a, count, MPI_INT, b, count, MPI_INT, MPI_COMM_WORLD,
+                  &req);
+    poll(&req);
+
+    ok = 1;
+    for (i = 0; i < nproc; i++) {
+        for (j = 0; j < count; j++) {
+            ok = ok && (b[i * count + j] == 1000 * i + 7 * self + j);
+        }
+    }
+    check(ok, "MPI_Ialltoall", count, -1);
+}
+
+
+static void check_iallgather(int count, int nproc, int self, int *a,
+                             int *b, int *c)
+{
+    MPI_Request req[2];
+    int i, j, ok;
+
+    for (j = 0; j < count; j++) {
+        a[j] = 5 * self + j;
+    }
+    for (i = 0; i < nproc; i++) {
+        for (j = 0; j < count; j++) {
+            b[i * count + j] = -1;
+            c[i * count + j] = (i == self) ? 5 * self + j : -1;
+        }
+    }
+    MPI_Iallgather(a, count, MPI_INT, b, count, MPI_INT, MPI_COMM_WORLD,
+                   &req[0]);
+    MPI_Iallgather(MPI_IN_PLACE, count, MPI_INT, c, count, MPI_INT,
+                   MPI_COMM_WORLD, &req[1]);
+    MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+
+    ok = 1;
+    for (i = 0; i < nproc; i++) {
+        for (j = 0; j < count; j++) {
+            ok = ok && (b[i * count + j] == 5 * i + j);
+        }
+    }
+    check(ok, "MPI_Iallgather", count, -1);
+    ok = 1;
+    for (i = 0; i < nproc; i++) {
+        for (j = 0; j < count; j++) {
+            ok = ok && (c[i * count + j] == 5 * i + j);
+        }
+    }
+    check(ok, "MPI_Iallgather(MPI_IN_PLACE)", count, -1);
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const int counts[] = { 0, 1, 7, 1000, 40000 };
+    MPI_Op matmul_op;
+    size_t n;
+    int *a, *b, *c;
+    int nproc, self, count, total, i;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+    MPI_Op_create(matmul, 0, &matmul_op);
+
+    for (i = 0; i < (int) (sizeof(counts) / sizeof(counts[0])); i++) {
+        count = counts[i];
+        n = (size_t) 4 * (count + 1) * (nproc + 1);
+        a = malloc(n * sizeof(int));
+        b = malloc(n * sizeof(int));
+        c = malloc(n * sizeof(int));
+        if (a == NULL || b == NULL || c == NULL) {
+            perror("malloc");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        check_ibcast(count, nproc, self, a);
+        check_ireduce(count, nproc, self, matmul_op, a, b);
+        check_iallreduce(count, nproc, self, matmul_op, a, b, c);
+        check_ialltoall(count, nproc, self, a, b);
+        check_iallgather(count, nproc, self, a, b, c);
+
+        free(a);
+        free(b);
+        free(c);
+    }
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (self == 0) {
+        if (total) {
+            printf("mpi-nbc-check: FAILED: %d errors on %d processes\n",
+                   total, nproc);
+        } else {
+            printf("mpi-nbc-check: passed on %d processes\n", nproc);
+        }
+        fflush(stdout);
+    }
+
+    MPI_Op_free(&matmul_op);
+    MPI_Finalize();
+
+    return total ? EXIT_FAILURE : EXIT_SUCCESS;
+}
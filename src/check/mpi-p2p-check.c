@@ -0,0 +1,274 @@
+/*
+ * Check point-to-point data delivery.
+ *
+ * Each rank sends to the next rank in a ring and receives from the
+ * previous one, over a range of message sizes that covers the eager,
+ * rendezvous and multi-fragment protocols of every path.  For each
+ * size the data is checked when the receive is posted first, when the
+ * message arrives unexpected, with a strided datatype on the receive
+ * side and on both sides, from MPI_ANY_SOURCE, and as a one-way stream
+ * of messages with the same tag, which must arrive in order.  Run it
+ * across hosts to exercise the off-host paths.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+
+enum {
+    STRIDE = 3                  /* ints per block in the strided type */
+};
+
+static int errors = 0;
+
+
+static void check(int ok, const char *what, int bytes, int peer)
+{
+    int self;
+
+    if (!ok) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &self);
+        printf("mpi-p2p-check: rank %d: %s failed, %d bytes from %d\n",
+               self, what, bytes, peer);
+        fflush(stdout);
+        errors++;
+    }
+}
+
+
+static int value(int src, int msg, int i)
+{
+    return (src << 24) ^ (msg << 16) ^ (i * 7 + 1);
+}
+
+
+static void fill(int *buf, int n, int src, int msg)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        buf[i] = value(src, msg, i);
+    }
+}
+
+
+static int verify(int *buf, int n, int src, int msg)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (buf[i] != value(src, msg, i)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/* progress for a while without posting receives */
+static void delay(double seconds)
+{
+    MPI_Status status;
+    double t = MPI_Wtime();
+    int flag;
+
+    while (MPI_Wtime() - t < seconds) {
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag,
+                   &status);
+    }
+}
+
+
+static void check_contiguous(int n, int to, int from, int self,
+                             int *sbuf, int *rbuf, int unexpected)
+{
+    MPI_Request req[2];
+    MPI_Status status;
+    int count;
+
+    fill(sbuf, n, self, 1);
+    memset(rbuf, 0, n * sizeof(int));
+    if (unexpected) {
+        MPI_Isend(sbuf, n, MPI_INT, to, 1, MPI_COMM_WORLD, &req[0]);
+        delay(0.05);
+        MPI_Irecv(rbuf, n, MPI_INT, from, 1, MPI_COMM_WORLD, &req[1]);
+    } else {
+        MPI_Irecv(rbuf, n, MPI_INT, from, 1, MPI_COMM_WORLD, &req[1]);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Isend(sbuf, n, MPI_INT, to, 1, MPI_COMM_WORLD, &req[0]);
+    }
+    MPI_Wait(&req[1], &status);
+    MPI_Wait(&req[0], MPI_STATUS_IGNORE);
+    MPI_Get_count(&status, MPI_INT, &count);
+    check(count == n && verify(rbuf, n, from, 1),
+          unexpected ? "unexpected" : "posted", n * (int) sizeof(int), from);
+}
+
+
+/*
+ * n ints are sent as blocks of STRIDE ints, one int apart, so the
+ * strided buffers hold n + n / STRIDE ints
+ */
+static void check_strided(int n, int to, int from, int self, int *sbuf,
+                          int *rbuf, int *tmp, int both)
+{
+    MPI_Datatype vtype;
+    MPI_Request req[2];
+    int blocks = n / STRIDE;
+    int i, j, ok;
+
+    if (blocks == 0) {
+        return;
+    }
+    MPI_Type_vector(blocks, STRIDE, STRIDE + 1, MPI_INT, &vtype);
+    MPI_Type_commit(&vtype);
+
+    fill(tmp, blocks * STRIDE, self, 2);
+    if (both) {
+        for (i = 0; i < blocks; i++) {
+            for (j = 0; j < STRIDE; j++) {
+                sbuf[i * (STRIDE + 1) + j] = tmp[i * STRIDE + j];
+            }
+            sbuf[i * (STRIDE + 1) + STRIDE] = -1;
+        }
+        MPI_Isend(sbuf, 1, vtype, to, 2, MPI_COMM_WORLD, &req[0]);
+    } else {
+        MPI_Isend(tmp, blocks * STRIDE, MPI_INT, to, 2, MPI_COMM_WORLD,
+                  &req[0]);
+    }
+    for (i = 0; i < blocks * (STRIDE + 1); i++) {
+        rbuf[i] = -2;
+    }
+    MPI_Irecv(rbuf, 1, vtype, from, 2, MPI_COMM_WORLD, &req[1]);
+    MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+    MPI_Type_free(&vtype);
+
+    ok = 1;
+    for (i = 0; i < blocks && ok; i++) {
+        for (j = 0; j < STRIDE; j++) {
+            ok = ok && (rbuf[i * (STRIDE + 1) + j] ==
+                        value(from, 2, i * STRIDE + j));
+        }
+        ok = ok && (rbuf[i * (STRIDE + 1) + STRIDE] == -2);
+    }
+    check(ok, both ? "strided send and receive" : "strided receive",
+          blocks * STRIDE * (int) sizeof(int), from);
+}
+
+
+static void check_any_source(int n, int nproc, int self, int *sbuf,
+                             int *rbuf)
+{
+    MPI_Status status;
+    int seen = 0;
+    int i;
+
+    if (self == 0) {
+        for (i = 1; i < nproc; i++) {
+            MPI_Recv(rbuf, n, MPI_INT, MPI_ANY_SOURCE, 3, MPI_COMM_WORLD,
+                     &status);
+            check(status.MPI_SOURCE > 0 && status.MPI_SOURCE < nproc &&
+                  !(seen & (1 << (status.MPI_SOURCE % 30))) &&
+                  verify(rbuf, n, status.MPI_SOURCE, 3),
+                  "MPI_ANY_SOURCE", n * (int) sizeof(int),
+                  status.MPI_SOURCE);
+            seen |= 1 << (status.MPI_SOURCE % 30);
+        }
+    } else {
+        fill(sbuf, n, self, 3);
+        MPI_Send(sbuf, n, MPI_INT, 0, 3, MPI_COMM_WORLD);
+    }
+}
+
+
+/* a one-way stream of window messages, all with the same tag */
+static void check_stream(int n, int window, int to, int from, int self,
+                         int *sbuf, int *rbuf, MPI_Request *req)
+{
+    int i, ok;
+
+    for (i = 0; i < window; i++) {
+        fill(sbuf + (size_t) i * n, n, self, 4 + i);
+        MPI_Isend(sbuf + (size_t) i * n, n, MPI_INT, to, 4, MPI_COMM_WORLD,
+                  &req[i]);
+    }
+    ok = 1;
+    for (i = 0; i < window; i++) {
+        MPI_Recv(rbuf, n, MPI_INT, from, 4, MPI_COMM_WORLD,
+                 MPI_STATUS_IGNORE);
+        ok = ok && verify(rbuf, n, from, 4 + i);
+    }
+    MPI_Waitall(window, req, MPI_STATUSES_IGNORE);
+    check(ok, "stream", n * (int) sizeof(int), from);
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const int sizes[] = {
+        0, 1, 7, 1000, 1024, 16383, 16384, 16385, 32768 + 11,
+        65536, 262144 + 5, 1048576 + 3
+    };
+    MPI_Request *req;
+    size_t max;
+    int *sbuf, *rbuf, *tmp;
+    int nproc, self, to, from, n, window, total, i;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    window = 32;
+    if (argc > 1) {
+        window = atoi(argv[1]);
+    }
+    if (window < 1) {
+        window = 1;
+    }
+
+    to = (self + 1) % nproc;
+    from = (self + nproc - 1) % nproc;
+    max = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    sbuf = malloc((max + max / STRIDE + 1) * sizeof(int) * window);
+    rbuf = malloc((max + max / STRIDE + 1) * sizeof(int));
+    tmp = malloc((max + 1) * sizeof(int));
+    req = malloc(window * sizeof(MPI_Request));
+    if (sbuf == NULL || rbuf == NULL || tmp == NULL || req == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+
+    for (i = 0; i < (int) (sizeof(sizes) / sizeof(sizes[0])); i++) {
+        n = sizes[i] / sizeof(int);
+        check_contiguous(n, to, from, self, sbuf, rbuf, 0);
+        check_contiguous(n, to, from, self, sbuf, rbuf, 1);
+        check_strided(n, to, from, self, sbuf, rbuf, tmp, 0);
+        check_strided(n, to, from, self, sbuf, rbuf, tmp, 1);
+        check_any_source(n, nproc, self, sbuf, rbuf);
+        check_stream(n, (n > 65536) ? 4 : window, to, from, self, sbuf,
+                     rbuf, req);
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (self == 0) {
+        if (total) {
+            printf("mpi-p2p-check: FAILED: %d errors on %d processes\n",
+                   total, nproc);
+        } else {
+            printf("mpi-p2p-check: passed on %d processes\n", nproc);
+        }
+        fflush(stdout);
+    }
+
+    free(req);
+    free(tmp);
+    free(rbuf);
+    free(sbuf);
+    MPI_Finalize();
+
+    return total ? EXIT_FAILURE : EXIT_SUCCESS;
+}
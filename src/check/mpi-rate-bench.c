@@ -0,0 +1,134 @@
+/*
+ * A simple MPI message rate benchmark.
+ *
+ * Even ranks send a window of small messages with MPI_Send to the
+ * next rank, which receives them and answers with one zero byte
+ * message.  Reports the time spent in each MPI_Send and the overall
+ * message rate.  With one process the messages are sent to self, which
+ * takes scheduling out of the measurement.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mpi.h>
+
+
+static void usage(void)
+{
+    int self;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    if (self == 0) {
+        fprintf(stderr,
+                "Usage: mpi-rate-bench [flags]\n"
+                "   Flags may be any of\n"
+                "      -b number         bytes per message\n"
+                "      -w number         messages per window\n"
+                "      -n number         number of windows\n"
+                "      -h                print this info\n");
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+    MPI_Status status;
+    char *buf;
+    double t, tsend, ttotal;
+    int nproc, self, peer, bytes, window, nwindow, i, j, c;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    bytes = 8;
+    window = 64;
+    nwindow = 1000;
+    while ((c = getopt(argc, argv, "b:w:n:h")) != -1) {
+        switch (c) {
+        case 'b':
+            bytes = atoi(optarg);
+            break;
+        case 'w':
+            window = atoi(optarg);
+            break;
+        case 'n':
+            nwindow = atoi(optarg);
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (bytes < 0 || window < 1 || nwindow < 1) {
+        usage();
+    }
+
+    buf = malloc(bytes + 1);
+    if (buf == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    memset(buf, 0, bytes + 1);
+
+    if (nproc == 1) {
+        peer = self;
+    } else if (self % 2 == 0) {
+        peer = (self + 1 < nproc) ? self + 1 : MPI_PROC_NULL;
+    } else {
+        peer = self - 1;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    tsend = 0.0;
+    ttotal = MPI_Wtime();
+    for (j = 0; j < nwindow; j++) {
+        if (nproc == 1) {
+            t = MPI_Wtime();
+            for (i = 0; i < window; i++) {
+                MPI_Send(buf, bytes, MPI_BYTE, peer, i, MPI_COMM_WORLD);
+            }
+            tsend += MPI_Wtime() - t;
+            for (i = 0; i < window; i++) {
+                MPI_Recv(buf, bytes, MPI_BYTE, peer, i, MPI_COMM_WORLD,
+                         &status);
+            }
+        } else if (self % 2 == 0) {
+            t = MPI_Wtime();
+            for (i = 0; i < window; i++) {
+                MPI_Send(buf, bytes, MPI_BYTE, peer, i, MPI_COMM_WORLD);
+            }
+            tsend += MPI_Wtime() - t;
+            MPI_Recv(NULL, 0, MPI_BYTE, peer, window, MPI_COMM_WORLD,
+                     &status);
+        } else {
+            for (i = 0; i < window; i++) {
+                MPI_Recv(buf, bytes, MPI_BYTE, peer, i, MPI_COMM_WORLD,
+                         &status);
+            }
+            MPI_Send(NULL, 0, MPI_BYTE, peer, window, MPI_COMM_WORLD);
+        }
+    }
+    ttotal = MPI_Wtime() - ttotal;
+
+    if (self == 0) {
+        printf("%d bytes, %d windows of %d messages\n",
+               bytes, nwindow, window);
+        printf("%14s %14s\n", "send (usec)", "msgs/sec");
+        printf("%14.3f %14.0f\n",
+               1.0e6 * tsend / ((double) nwindow * window),
+               (double) nwindow * window / ttotal);
+        fflush(stdout);
+    }
+
+    free(buf);
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+/*
+ * A simple MPI unexpected message benchmark.
+ *
+ * Every rank but 0 sends a window of messages to rank 0, which keeps
+ * making progress with MPI_Iprobe for a while before posting any
+ * receives, so the messages arrive unexpected.  Reports the bytes
+ * sent to rank 0, the most unexpected data rank 0 held at once, and
+ * the time to complete the exchange.  Senders switch to rendezvous
+ * once rank 0 is over LAMPI_UNEXPECTED_PEER_LIMIT bytes from one of
+ * them or LAMPI_UNEXPECTED_LIMIT bytes in total.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mpi.h>
+
+extern int ulm_unexpected_bytes(int proc, size_t *bytes, size_t *highwater);
+
+
+static void usage(void)
+{
+    int self;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    if (self == 0) {
+        fprintf(stderr,
+                "Usage: mpi-unexpected-bench [flags]\n"
+                "   Flags may be any of\n"
+                "      -b number         bytes per message\n"
+                "      -w number         messages per sender\n"
+                "      -d number         seconds before receives are posted\n"
+                "      -h                print this info\n");
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+    MPI_Request *req;
+    MPI_Status status;
+    char *buf;
+    double t, delay;
+    size_t bytes_now, highwater;
+    int nproc, self, bytes, window, nreq, flag, i, j, c;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &self);
+
+    bytes = 64 * 1024;
+    window = 64;
+    delay = 1.0;
+    while ((c = getopt(argc, argv, "b:w:d:h")) != -1) {
+        switch (c) {
+        case 'b':
+            bytes = atoi(optarg);
+            break;
+        case 'w':
+            window = atoi(optarg);
+            break;
+        case 'd':
+            delay = atof(optarg);
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (bytes < 0 || window < 1 || delay < 0.0 || nproc < 2) {
+        usage();
+    }
+
+    nreq = (self == 0) ? (nproc - 1) * window : window;
+    req = malloc(nreq * sizeof(MPI_Request));
+    buf = malloc((size_t) nreq * bytes + 1);
+    if (req == NULL || buf == NULL) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    memset(buf, 0, (size_t) nreq * bytes + 1);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    if (self == 0) {
+        while (MPI_Wtime() - t < delay) {
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag,
+                       &status);
+        }
+        for (i = 1; i < nproc; i++) {
+            for (j = 0; j < window; j++) {
+                MPI_Irecv(buf + (size_t) ((i - 1) * window + j) * bytes,
+                          bytes, MPI_BYTE, i, j, MPI_COMM_WORLD,
+                          &req[(i - 1) * window + j]);
+            }
+        }
+    } else {
+        for (j = 0; j < window; j++) {
+            MPI_Isend(buf + (size_t) j * bytes, bytes, MPI_BYTE, 0, j,
+                      MPI_COMM_WORLD, &req[j]);
+        }
+    }
+    MPI_Waitall(nreq, req, MPI_STATUSES_IGNORE);
+    t = MPI_Wtime() - t;
+
+    if (self == 0) {
+        ulm_unexpected_bytes(-1, &bytes_now, &highwater);
+        printf("%d senders, %d messages of %d bytes each\n",
+               nproc - 1, window, bytes);
+        printf("%20s %20s %14s\n", "bytes sent", "unexpected max",
+               "time (sec)");
+        printf("%20.0f %20lu %14.3f\n",
+               (double) (nproc - 1) * window * bytes,
+               (unsigned long) highwater, t - delay);
+        fflush(stdout);
+    }
+
+    free(buf);
+    free(req);
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
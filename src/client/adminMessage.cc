@@ -792,7 +792,7 @@ long long adminMessage::get_base_tag(int num_requested)
 
 
 int adminMessage::setupCollectives(int myLocalRank, int myHostRank,
-                                   int *map_global_rank_to_host, int daemonIsHostCommRoot,
+                                   int *map_host_to_first_rank, int daemonIsHostCommRoot,
                                    ssize_t lenSMBuffer, void *sharedBufferPtr,
                                    void *lockPtr, void *CounterPtr, int *sPtr)
 {
@@ -824,12 +824,9 @@ int adminMessage::setupCollectives(int myLocalRank, int myHostRank,
 
     /* loop over host count */
     for (host = 0; host < nhosts_m; host++) {
-        count = 0;
-        /* figure out how many procs on given host */
-        for (proc = 0; proc < totalNProcesses_m; proc++) {
-            if (map_global_rank_to_host[proc] == host)
-                count++;
-        }
+        /* procs on a host are a contiguous block of global ranks */
+        count = map_host_to_first_rank[host + 1] -
+            map_host_to_first_rank[host];
         /* set process count */
         groupHostData_m[host].nGroupProcIDOnHost = count;
 
@@ -843,12 +840,9 @@ int adminMessage::setupCollectives(int myLocalRank, int myHostRank,
             ulm_malloc(sizeof(int) * count);
 
         /* fill in list of procs */
-        count = 0;
-        for (proc = 0; proc < totalNProcesses_m; proc++) {
-            if (map_global_rank_to_host[proc] == host) {
-                groupHostData_m[host].groupProcIDOnHost[count] = proc;
-                count++;
-            }
+        for (proc = 0; proc < count; proc++) {
+            groupHostData_m[host].groupProcIDOnHost[proc] =
+                map_host_to_first_rank[host] + proc;
         }
     }                           /* end host loop */
 
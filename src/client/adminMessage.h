@@ -230,8 +230,8 @@ class adminMessage {
         NPATHTYPES,             /* number of network device types */
         GMMAXDEVS,              /* maximum number of opened Myrinet/GM devices */
         IBMAXACTIVE,            /* 3 integers: max. active HCAs, max. active ports/HCA, sizeof(ib_ud_peer_info_t) */
-#if ENABLE_NUMA
         CPULIST,                /* list of cpus for resource affinity */
+#if ENABLE_NUMA
         NCPUSPERNODE,           /* number of cpus per node */
         USERESOURCEAFFINITY,    /* user resource affinity */
         DEFAULTRESOURCEAFFINITY,        /* default resource affinity */
@@ -573,7 +573,7 @@ class adminMessage {
      * object's collective routines
      */
     int setupCollectives(int myLocalRank, int myHostRank,
-                         int *map_global_rank_to_host, int daemonIsHostCommRoot,
+                         int *map_host_to_first_rank, int daemonIsHostCommRoot,
                          ssize_t lenSMBuffer, void *sharedBufferPtr,
                          void *lockPtr, void *CounterPtr, int *sPtr);
 
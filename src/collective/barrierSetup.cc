@@ -150,16 +150,12 @@ int Communicator::genericSMPBarrierSetup(int firstInstanceOfContext,
                     swBarrier.pool[poolIndex][ele].nFreed = 0;
                     swBarrier.pool[poolIndex][ele].inUse = true;
                     // initialize barrier data
-                    *(swBarrier.pool[poolIndex][ele].barrierData->
-                      Counter) = 0;
-                    swBarrier.pool[poolIndex][ele].barrierData->commSize =
-                        localGroup->groupHostData[localGroup->
-                                                  hostIndexInGroup].
-                        nGroupProcIDOnHost;
-                    swBarrier.pool[poolIndex][ele].barrierData->
-                        releaseCnt = 0;
-                    swBarrier.pool[poolIndex][ele].barrierData->lock->
-                        init();
+                    SMPSWBarrierInit(swBarrier.pool[poolIndex][ele].
+                                     barrierData,
+                                     localGroup->groupHostData[localGroup->
+                                                               hostIndexInGroup].
+                                     nGroupProcIDOnHost,
+                                     localGroup->onHostProcID, 1);
                     // set barrier type
                     SMPBarrierType = SMPSWBARRIER;
                     // set pointer to barrier data structure
@@ -220,14 +216,12 @@ int Communicator::genericSMPBarrierSetup(int firstInstanceOfContext,
                     // set element as in use and list group infomation
                     swBarrier.pool[poolIndex][ele].nAllocated++;
                     // initialize barrier data
-                    swBarrier.pool[poolIndex][ele].barrierData->commSize =
-                        localGroup->groupHostData[localGroup->
-                                                  hostIndexInGroup].
-                        nGroupProcIDOnHost;
-                    swBarrier.pool[poolIndex][ele].barrierData->
-                        releaseCnt = 0;
-                    swBarrier.pool[poolIndex][ele].barrierData->lock->
-                        init();
+                    SMPSWBarrierInit(swBarrier.pool[poolIndex][ele].
+                                     barrierData,
+                                     localGroup->groupHostData[localGroup->
+                                                               hostIndexInGroup].
+                                     nGroupProcIDOnHost,
+                                     localGroup->onHostProcID, 0);
                     // set barrier type
                     SMPBarrierType = SMPSWBARRIER;
                     // set pointer to barrier data structure
@@ -80,6 +80,37 @@ int ulm_scatterv_interhost(int comm, void *dataBuffer,
 
 int ulm_bcast_interhost(void *buf, size_t count, ULMType_t *type, int root, int comm);
 
+void ulm_coll_pack_block(int pack, void *packed, size_t size,
+                         void *buf, int count, ULMType_t *type, int block);
+
+int ulm_coll_copy(void *dest, int dest_count, ULMType_t *dest_type,
+                  void *src, int src_count, ULMType_t *src_type);
+
+/*
+ * reduce_scatter and allgather block layout: if counts (displs) is
+ * NULL, every process's block holds block_count objects
+ */
+#define RS_COUNT(COUNTS, BLOCK_COUNT, I) \
+    ((COUNTS) ? (COUNTS)[I] : (BLOCK_COUNT))
+#define RS_DISPL(DISPLS, BLOCK_COUNT, I) \
+    ((DISPLS) ? (DISPLS)[I] : (I) * (BLOCK_COUNT))
+
+extern "C" int ulm_reduce_scatter_intrahost(const void *s_buf, void *r_buf,
+                                            int *counts, int *displs,
+                                            int block_count, ULMType_t *type,
+                                            ULMOp_t *op, int comm);
+
+extern "C" int ulm_reduce_scatter_p2p(const void *s_buf, void *r_buf,
+                                      int *counts, int *displs,
+                                      int block_count, ULMType_t *type,
+                                      ULMOp_t *op, int comm);
+
+extern "C" int ulm_allgather_p2p_blocks(void *sendbuf, int sendcount,
+                                        ULMType_t *sendtype, void *recvbuf,
+                                        int *counts, int *displs,
+                                        int block_count, ULMType_t *recvtype,
+                                        int comm);
+
 #ifdef USE_ELAN_COLL
 int ulm_bcast_quadrics(void *buf, size_t count, ULMType_t *type, int root, int comm);
 #endif
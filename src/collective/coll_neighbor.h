@@ -0,0 +1,93 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef _COLL_NEIGHBOR_H_
+#define _COLL_NEIGHBOR_H_
+
+/*
+ * Communication plan for the neighborhood collectives of a
+ * communicator with a Cartesian or graph topology.
+ *
+ * The neighbors of a process are numbered in slots: for a Cartesian
+ * topology slots 2d and 2d + 1 are the source and destination of a
+ * unit shift in dimension d; for a graph topology the slots follow
+ * the adjacency list.  Block j of the send buffer goes to, and block
+ * j of the receive buffer comes from, the neighbor in slot j.
+ *
+ * The plan is built from the topology on first use and kept until
+ * the communicator is freed.  Blocks of the fixed-size collectives
+ * bound for more than one process on a remote host travel in one
+ * message to a proxy on that host, the lowest ranked of those
+ * processes, which forwards them over shared memory.
+ */
+
+enum {
+    NBR_NONE,                   /* nothing is exchanged in this slot */
+    NBR_SELF,                   /* the neighbor is this process */
+    NBR_DIRECT,                 /* one message per block */
+    NBR_AGGREGATE,              /* part of a message to/from a host */
+    NBR_FORWARD                 /* forwarded by a proxy on this host */
+};
+
+typedef struct NbrPlan_t NbrPlan_t;
+struct NbrPlan_t {
+    int nslot;                  /* number of neighbor slots */
+    int maxdeg;                 /* most slots of any process */
+    int *nbr;                   /* neighbor in each slot or MPI_PROC_NULL */
+    int *peer;                  /* neighbor's slot paired with each slot */
+    int *send_mode;             /* how each send block leaves */
+    int *recv_mode;             /* how each receive block arrives */
+
+    /* aggregated messages sent, one per remote host */
+    int nout;
+    int *out_proxy;             /* proxy on the remote host */
+    int *out_start;             /* nout + 1 offsets into out_slot */
+    int *out_slot;              /* my slots in each message */
+
+    /* aggregated messages received as proxy, one per origin */
+    int nin;
+    int *in_origin;             /* sending process, ascending */
+    int *in_start;              /* nin + 1 offsets into in_target */
+    int *in_target;             /* destination of each block */
+    int *in_slot;               /* slot of the destination for the block */
+    int nforward;               /* blocks forwarded to other processes */
+
+    /* forwarded blocks received, in the order the proxies send them */
+    int nfwd;
+    int *fwd_slot;
+    int *fwd_proxy;             /* proxy forwarding each of them */
+};
+
+class Communicator;
+
+int ulm_neighbor_plan(Communicator *communicator, NbrPlan_t **plan);
+void ulm_neighbor_plan_free(NbrPlan_t *plan);
+
+#endif /* _COLL_NEIGHBOR_H_ */
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef _COLL_SCHED_H_
+#define _COLL_SCHED_H_
+
+#include "path/common/BaseDesc.h"
+
+/*
+ * Non-blocking collectives are compiled into schedules: a list of
+ * rounds, each of which is a list of sends, receives, local copies
+ * and local reductions.  When a round is started its local operations
+ * are executed and then its receives and sends are posted; the next
+ * round is started once all of them have completed.  Active schedules
+ * are advanced from ulm_make_progress(), and complete through
+ * ulm_wait() and ulm_test() like any other request.  A schedule freed
+ * while still active is released when it completes.
+ *
+ * All messages of a schedule share a single tag: a peer's messages
+ * are matched in order, and a round's receives are not posted until
+ * the previous round has completed.
+ *
+ * A persistent schedule is built once, by the ulm_*_init() functions,
+ * and replayed by each ulm_start(): algorithm choice, scratch space
+ * and the request array are all set up before the first start.
+ */
+
+enum CollOpKind_t {
+    COLL_OP_SEND = 1,
+    COLL_OP_RECV,
+    COLL_OP_COPY,
+    COLL_OP_REDUCE
+};
+
+/*
+ * one step of a schedule:
+ *
+ *   send/recv   count objects of type in buf to/from peer
+ *   copy        src (src_count objects of src_type) to buf
+ *   reduce      buf = src op buf, or buf = buf op src if reverse is
+ *               set, for count objects of type
+ */
+struct CollOp_t {
+    int kind;
+    int peer;
+    void *buf;
+    int count;
+    ULMType_t *type;
+    void *src;
+    int src_count;
+    ULMType_t *src_type;
+    int reverse;
+};
+
+/*
+ * CollDesc_t: the request descriptor for a non-blocking collective
+ */
+struct CollDesc_t : public RequestDesc_t {
+
+    int tag;                    // tag for all messages in the schedule
+    ULMOp_t *op;                // reduction operation, if any
+    CollOp_t *ops;              // operations in schedule order
+    int nops;
+    int maxops;
+    int *rounds;                // rounds[r] is the index of the first
+                                // operation of round r
+    int nrounds;
+    int maxrounds;
+    int round;                  // current round, -1 if not started
+    ULMRequest_t *req;          // outstanding requests of this round
+    int nreq;
+    int maxreq;
+    void *scratch;              // temporary storage for the schedule
+    ULMType_t *types[2];        // user datatypes retained by the schedule
+    int error;                  // first error seen, else ULM_SUCCESS
+    bool active;                // true while on the active list
+};
+
+int ulm_coll_sched_alloc(int comm, CollDesc_t **desc);
+void ulm_coll_sched_free(CollDesc_t *d);
+void *ulm_coll_sched_scratch(CollDesc_t *d, size_t size);
+void ulm_coll_sched_retain(CollDesc_t *d, ULMType_t *t0, ULMType_t *t1);
+int ulm_coll_sched_send(CollDesc_t *d, void *buf, int count,
+                        ULMType_t *type, int peer);
+int ulm_coll_sched_recv(CollDesc_t *d, void *buf, int count,
+                        ULMType_t *type, int peer);
+int ulm_coll_sched_copy(CollDesc_t *d, void *dest, int dest_count,
+                        ULMType_t *dest_type, void *src, int src_count,
+                        ULMType_t *src_type);
+int ulm_coll_sched_reduce(CollDesc_t *d, void *dest, void *src, int count,
+                          ULMType_t *type, int reverse);
+int ulm_coll_sched_round(CollDesc_t *d);
+int ulm_coll_sched_start(CollDesc_t *d, ULMRequest_t *request);
+int ulm_coll_sched_post(CollDesc_t *d, ULMRequest_t *request);
+int ulm_coll_sched_progress(void);
+bool ulm_coll_sched_pending(void);
+
+/*
+ * schedule fragments shared by several collectives
+ */
+void ulm_coll_sched_bcast_tree(CollDesc_t *d, void *buf, int count,
+                               ULMType_t *type, int root);
+void ulm_coll_sched_reduce_tree(CollDesc_t *d, void *sendbuf,
+                                void *recvbuf, int count,
+                                ULMType_t *type, int root);
+
+#endif /* _COLL_SCHED_H_ */
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef _COLL_TUNE_H_
+#define _COLL_TUNE_H_
+
+#include <stddef.h>
+
+/*
+ * Collective algorithm decision table
+ *
+ * The collective entry points consult ulm_coll_decide() for the
+ * algorithm and segment (block) size to use for a given message size.
+ * Rules are read once from the file named by LAMPI_COLL_TUNE, and
+ * the rules matching the shape of a communicator (number of
+ * processes, hosts and processes per host) are copied into its
+ * decision table when its collectives are initialized.  Lines of the
+ * file have the form
+ *
+ *   collective algorithm segsize bytes procs hosts ppn
+ *
+ * where bytes is the per-process message size and the last four
+ * fields are a number, a range "lo-hi" or "lo-*", or "*".  A segsize
+ * of 0 keeps the built-in block size.  '#' starts a comment.  The
+ * first matching rule wins; if none matches, or the algorithm cannot
+ * be used for the call, the built-in selection applies.  check/
+ * mpi-coll-bench -T generates such a file by timing each algorithm.
+ */
+
+enum {
+    COLL_TUNE_BARRIER,
+    COLL_TUNE_BCAST,
+    COLL_TUNE_REDUCE,
+    COLL_TUNE_ALLREDUCE,
+    COLL_TUNE_ALLTOALL,
+    COLL_TUNE_ALLGATHER,
+    COLL_TUNE_SCAN,             // scan and exscan
+    COLL_TUNE_NCOLL
+};
+
+enum {
+    COLL_ALG_DEFAULT = 0,       // built-in selection
+    COLL_ALG_LINEAR,            // gather to and scatter from one process
+    COLL_ALG_P2P,               // point-to-point tree
+    COLL_ALG_SMP,               // shared memory on-host, then interhost
+    COLL_ALG_BRUCK,
+    COLL_ALG_PAIRWISE,
+    COLL_ALG_RECURSIVE_DOUBLING,
+    COLL_ALG_RING,
+    COLL_ALG_PIPELINE,          // segmented chain
+    COLL_ALG_NALG
+};
+
+struct CollTuneRule_t {
+    int alg;
+    size_t segsize;
+    size_t min_bytes;
+    size_t max_bytes;
+    int min_procs, max_procs;
+    int min_hosts, max_hosts;
+    int min_ppn, max_ppn;
+};
+
+struct CollTuneTable_t {
+    int nrule[COLL_TUNE_NCOLL];
+    CollTuneRule_t *rule[COLL_TUNE_NCOLL];
+};
+
+class Communicator;
+
+int ulm_coll_tune_init(CollTuneTable_t *table, int nproc, int nhost, int ppn);
+void ulm_coll_tune_free(CollTuneTable_t *table);
+int ulm_coll_decide(Communicator *communicator, int coll, size_t bytes,
+                    size_t *segsize);
+
+extern "C" int ulm_coll_tune_force(const char *coll, const char *alg,
+                                   int segsize);
+
+#endif /* _COLL_TUNE_H_ */
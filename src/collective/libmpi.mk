@@ -13,14 +13,25 @@ SRC_LIBMPI += \
 	src/collective/ulm_barrier_intrahost.cc \
 	src/collective/ulm_bcast.cc \
 	src/collective/ulm_bcast_interhost.cc \
+	src/collective/ulm_coll_sched.cc \
+	src/collective/ulm_coll_tune.cc \
 	src/collective/ulm_collective.cc \
 	src/collective/ulm_gather.cc \
 	src/collective/ulm_gather_interhost.cc \
 	src/collective/ulm_gatherv.cc \
+	src/collective/ulm_iallgather.cc \
+	src/collective/ulm_iallreduce.cc \
+	src/collective/ulm_ialltoall.cc \
+	src/collective/ulm_ibarrier.cc \
+	src/collective/ulm_ibcast.cc \
+	src/collective/ulm_ireduce.cc \
+	src/collective/ulm_neighbor.cc \
 	src/collective/ulm_reduce.cc \
 	src/collective/ulm_reduce_interhost.cc \
 	src/collective/ulm_reduce_intrahost.cc \
 	src/collective/ulm_reduce_linear.cc \
+	src/collective/ulm_reduce_scatter.cc \
+	src/collective/ulm_reduce_scatter_intrahost.cc \
 	src/collective/ulm_scan.cc \
 	src/collective/ulm_scatter.cc \
 	src/collective/ulm_scatter_interhost.cc \
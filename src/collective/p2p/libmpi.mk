@@ -7,5 +7,6 @@ SRC_LIBMPI += \
 	src/collective/p2p/ulm_gather_p2p.cc \
 	src/collective/p2p/ulm_gatherv_p2p.cc \
 	src/collective/p2p/ulm_reduce_p2p.cc \
+	src/collective/p2p/ulm_reduce_scatter_p2p.cc \
 	src/collective/p2p/ulm_scatter_p2p.cc \
 	src/collective/p2p/ulm_scatterv_p2p.cc
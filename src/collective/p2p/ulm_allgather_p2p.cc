@@ -38,26 +38,12 @@
 #include "internal/profiler.h"
 #include "internal/types.h"
 #include "queue/globals.h"
+#include "collective/coll_fns.h"
 
-/* Simple pt-2-pt implementation, NOT OPTIMIZED */
 extern "C" int ulm_allgather_p2p(void *sendbuf, int sendcount,
                                  ULMType_t *sendtype, void *recvbuf,
                                  int recvcount, ULMType_t *recvtype, int comm)
 {
-    int nproc;
-    int rc = ULM_SUCCESS;
-    extern ulm_gather_t ulm_gather_p2p;
-    extern ulm_bcast_t ulm_bcast_p2p;
-
-    ulm_get_info(comm, ULM_INFO_NUMBER_OF_PROCS, &nproc, sizeof(int));
-
-    /* first call gather, then broadcast results to all participants */
-    rc = ulm_gather_p2p(sendbuf, sendcount, sendtype, recvbuf, recvcount,
-                   recvtype, 0, comm);
-    if (rc != ULM_SUCCESS) {
-        return rc;
-    }
-    rc = ulm_bcast_p2p(recvbuf, nproc * recvcount, recvtype, 0, comm);
-    
-    return rc;
+    return ulm_allgather_p2p_blocks(sendbuf, sendcount, sendtype, recvbuf,
+                                    NULL, NULL, recvcount, recvtype, comm);
 }
@@ -35,34 +35,246 @@
 #include <stdio.h>
 #include "ulm/ulm.h"
 #include "internal/log.h"
+#include "internal/malloc.h"
 #include "internal/profiler.h"
+#include "internal/type_copy.h"
 #include "internal/types.h"
 #include "queue/globals.h"
+#include "collective/coll_fns.h"
+#include "collective/coll_tune.h"
 
-extern "C" int ulm_allgatherv_p2p(void *sendbuf, int sendcount,
-                                  ULMType_t *sendtype, void *recvbuf,
-                                  int *recvcount, int *displs,
-                                  ULMType_t *recvtype, int comm)
+enum {
+    ALLGATHER_SHORT = 80 * 1024,        /* Bruck below this (bytes) */
+    ALLGATHER_LONG = 512 * 1024         /* recursive doubling below this */
+};
+
+/*
+ * Send packed bytes to dest, receive from source, and wait for both
+ */
+static int exchange(void *sbuf, size_t ssize, int dest,
+                    void *rbuf, size_t rsize, int source,
+                    int tag, int comm)
+{
+    ULMRequest_t send_request;
+    ULMRequest_t recv_request;
+    ULMStatus_t status;
+    int rc;
+
+    rc = ulm_irecv(rbuf, rsize, (ULMType_t *) MPI_BYTE, source, tag, comm,
+                   &recv_request);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    rc = ulm_isend(sbuf, ssize, (ULMType_t *) MPI_BYTE, dest, tag, comm,
+                   &send_request, ULM_SEND_STANDARD);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    rc = ulm_wait(&recv_request, &status);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    return ulm_wait(&send_request, &status);
+}
+
+/*
+ * Pack this process's own contribution into the packed buffer
+ */
+static void pack_own(unsigned char *packed, size_t size,
+                     void *sendbuf, int sendcount, ULMType_t *sendtype,
+                     void *recvbuf, int *counts, int *displs,
+                     int block_count, ULMType_t *recvtype, int self)
 {
-    int rc, proc, nprocs;
-    unsigned char *buf;
-    extern ulm_gatherv_t ulm_gatherv_p2p;
-    extern ulm_bcast_t ulm_bcast_p2p;
+    if (sendbuf == MPI_IN_PLACE) {
+        ulm_coll_pack_block(TYPE_PACK_PACK, packed, size,
+                            (unsigned char *) recvbuf +
+                            RS_DISPL(displs, block_count, self) *
+                            recvtype->extent,
+                            RS_COUNT(counts, block_count, self),
+                            recvtype, 0);
+    } else {
+        ulm_coll_pack_block(TYPE_PACK_PACK, packed, size,
+                            sendbuf, sendcount, sendtype, 0);
+    }
+}
 
-    ulm_get_info(comm, ULM_INFO_NUMBER_OF_PROCS, &nprocs, sizeof(int));
+/*
+ * allgather_packed - recursive doubling and Bruck allgather
+ *
+ * Both work on a packed copy of the result, so that every message is
+ * a single contiguous range of bytes whatever the datatype or the
+ * block displacements.
+ *
+ * Recursive doubling (power of two processes): in round k process
+ * self exchanges everything it has, 2^k blocks, with self ^ 2^k.
+ *
+ * Bruck (any number of processes): the packed buffer is rotated so
+ * that block i belongs to process self + i.  In the round with
+ * distance d, the first min(d, nproc - d) blocks are sent to
+ * self - d and the same number received from self + d.  Blocks are
+ * unrotated when unpacking.
+ *
+ * Either way there are ceil(log2(nproc)) rounds.
+ */
+static int allgather_packed(void *sendbuf, int sendcount, ULMType_t *sendtype,
+                            void *recvbuf, int *counts, int *displs,
+                            int block_count, ULMType_t *recvtype,
+                            int comm, int self, int nproc, int bruck)
+{
+    size_t *offset;
+    unsigned char *tmp;
+    int block;
+    int cnt;
+    int i;
+    int mask;
+    int peer;
+    int rc;
+    int start;
+    int tag;
 
-    /* First call pt-2-pt allgatherv */
-    rc = ulm_gatherv_p2p(sendbuf, sendcount, sendtype, recvbuf, 
-                         recvcount, displs, recvtype, 0, comm);
+    rc = ulm_get_system_tag(comm, 1, &tag);
     if (rc != ULM_SUCCESS) {
         return rc;
     }
 
-    /* broadcast to the recievers */
-    for (proc = 0; proc < nprocs; proc++) {
-        buf = ((unsigned char *) recvbuf) 
-            + displs[proc] * recvtype->extent;
-        rc = ulm_bcast_p2p(buf, recvcount[proc], recvtype, 0, comm);
+    /*
+     * offset[i] is the byte offset of packed block i, where block i
+     * belongs to process self + i for Bruck, and process i otherwise
+     */
+    offset = (size_t *) ulm_malloc((nproc + 1) * sizeof(size_t));
+    if (offset == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    offset[0] = 0;
+    for (i = 0; i < nproc; i++) {
+        block = bruck ? (self + i) % nproc : i;
+        offset[i + 1] = offset[i] +
+            RS_COUNT(counts, block_count, block) * recvtype->packed_size;
+    }
+
+    tmp = (unsigned char *) ulm_malloc(offset[nproc] > 0 ? offset[nproc] : 1);
+    if (tmp == NULL) {
+        ulm_free(offset);
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (bruck) {
+        pack_own(tmp, offset[1], sendbuf, sendcount, sendtype,
+                 recvbuf, counts, displs, block_count, recvtype, self);
+        for (mask = 1; mask < nproc; mask <<= 1) {
+            cnt = (mask < nproc - mask) ? mask : nproc - mask;
+            rc = exchange(tmp, offset[cnt], (self - mask + nproc) % nproc,
+                          tmp + offset[mask], offset[mask + cnt] - offset[mask],
+                          (self + mask) % nproc, tag, comm);
+            if (rc != ULM_SUCCESS) {
+                break;
+            }
+        }
+    } else {
+        pack_own(tmp + offset[self], offset[self + 1] - offset[self],
+                 sendbuf, sendcount, sendtype,
+                 recvbuf, counts, displs, block_count, recvtype, self);
+        for (mask = 1; mask < nproc; mask <<= 1) {
+            peer = self ^ mask;
+            start = self & ~(mask - 1);
+            i = peer & ~(mask - 1);
+            rc = exchange(tmp + offset[start],
+                          offset[start + mask] - offset[start], peer,
+                          tmp + offset[i], offset[i + mask] - offset[i], peer,
+                          tag, comm);
+            if (rc != ULM_SUCCESS) {
+                break;
+            }
+        }
+    }
+
+    if (rc == ULM_SUCCESS) {
+        for (i = 0; i < nproc; i++) {
+            block = bruck ? (self + i) % nproc : i;
+            if (block == self && sendbuf == MPI_IN_PLACE) {
+                continue;
+            }
+            ulm_coll_pack_block(TYPE_PACK_UNPACK, tmp + offset[i],
+                                offset[i + 1] - offset[i],
+                                (unsigned char *) recvbuf +
+                                RS_DISPL(displs, block_count, block) *
+                                recvtype->extent,
+                                RS_COUNT(counts, block_count, block),
+                                recvtype, 0);
+        }
+    }
+
+    ulm_free(tmp);
+    ulm_free(offset);
+
+    return rc;
+}
+
+/*
+ * allgather_ring - ring allgather for large data
+ *
+ * In step s each process passes block self - s to its right
+ * neighbour and receives block self - s - 1 from its left.  Every
+ * block crosses each link once and messages are sent straight from
+ * and to the receive buffer with the receive datatype, so there is
+ * no packing.
+ */
+static int allgather_ring(void *sendbuf, int sendcount, ULMType_t *sendtype,
+                          void *recvbuf, int *counts, int *displs,
+                          int block_count, ULMType_t *recvtype,
+                          int comm, int self, int nproc)
+{
+    ULMRequest_t send_request;
+    ULMRequest_t recv_request;
+    ULMStatus_t status;
+    int left = (self - 1 + nproc) % nproc;
+    int right = (self + 1) % nproc;
+    int sblock;
+    int rblock;
+    int rc;
+    int s;
+    int tag;
+
+    rc = ulm_get_system_tag(comm, 1, &tag);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+
+    if (sendbuf != MPI_IN_PLACE) {
+        rc = ulm_coll_copy((unsigned char *) recvbuf +
+                           RS_DISPL(displs, block_count, self) *
+                           recvtype->extent,
+                           RS_COUNT(counts, block_count, self), recvtype,
+                           sendbuf, sendcount, sendtype);
+        if (rc != ULM_SUCCESS) {
+            return rc;
+        }
+    }
+
+    for (s = 0; s < nproc - 1; s++) {
+        sblock = (self - s + nproc) % nproc;
+        rblock = (self - s - 1 + nproc) % nproc;
+        rc = ulm_irecv((unsigned char *) recvbuf +
+                       RS_DISPL(displs, block_count, rblock) *
+                       recvtype->extent,
+                       RS_COUNT(counts, block_count, rblock), recvtype,
+                       left, tag, comm, &recv_request);
+        if (rc != ULM_SUCCESS) {
+            return rc;
+        }
+        rc = ulm_isend((unsigned char *) recvbuf +
+                       RS_DISPL(displs, block_count, sblock) *
+                       recvtype->extent,
+                       RS_COUNT(counts, block_count, sblock), recvtype,
+                       right, tag, comm, &send_request, ULM_SEND_STANDARD);
+        if (rc != ULM_SUCCESS) {
+            return rc;
+        }
+        rc = ulm_wait(&recv_request, &status);
+        if (rc != ULM_SUCCESS) {
+            return rc;
+        }
+        rc = ulm_wait(&send_request, &status);
         if (rc != ULM_SUCCESS) {
             return rc;
         }
@@ -70,3 +282,91 @@ extern "C" int ulm_allgatherv_p2p(void *sendbuf, int sendcount,
 
     return ULM_SUCCESS;
 }
+
+/*!
+ * ulm_allgather_p2p_blocks - point-to-point allgather(v)
+ *
+ * \param sendbuf       This process's data, or MPI_IN_PLACE
+ * \param sendcount     Number of objects sent
+ * \param sendtype      Data type of send objects
+ * \param recvbuf       Result buffer
+ * \param counts        Number of objects in each process's block
+ * \param displs        Displacement of each process's block
+ * \param block_count   Block size used if counts is NULL
+ * \param recvtype      Data type of result objects
+ * \param comm          The communicator ID
+ * \return              ULM error code
+ *
+ * Unless the decision table says otherwise, selects recursive
+ * doubling for a power of two processes and Bruck otherwise for small
+ * and medium results, and a ring for large results where bandwidth
+ * matters more than the number of rounds.
+ */
+extern "C" int ulm_allgather_p2p_blocks(void *sendbuf, int sendcount,
+                                        ULMType_t *sendtype, void *recvbuf,
+                                        int *counts, int *displs,
+                                        int block_count, ULMType_t *recvtype,
+                                        int comm)
+{
+    size_t total;
+    int alg;
+    int nproc;
+    int pow2;
+    int self;
+
+    ulm_get_info(comm, ULM_INFO_PROCID, &self, sizeof(int));
+    ulm_get_info(comm, ULM_INFO_NUMBER_OF_PROCS, &nproc, sizeof(int));
+
+    if (nproc == 1) {
+        if (sendbuf == MPI_IN_PLACE) {
+            return ULM_SUCCESS;
+        }
+        return ulm_coll_copy((unsigned char *) recvbuf +
+                             RS_DISPL(displs, block_count, 0) *
+                             recvtype->extent,
+                             RS_COUNT(counts, block_count, 0), recvtype,
+                             sendbuf, sendcount, sendtype);
+    }
+
+    total = 0;
+    for (int i = 0; i < nproc; i++) {
+        total += RS_COUNT(counts, block_count, i) * recvtype->packed_size;
+    }
+
+    pow2 = (nproc & (nproc - 1)) == 0;
+    alg = ulm_coll_decide(communicators[comm], COLL_TUNE_ALLGATHER,
+                          total / nproc, NULL);
+    if (alg == COLL_ALG_DEFAULT || alg == COLL_ALG_SMP ||
+        (alg == COLL_ALG_RECURSIVE_DOUBLING && !pow2)) {
+        if (total < ALLGATHER_LONG && pow2) {
+            alg = COLL_ALG_RECURSIVE_DOUBLING;
+        } else if (total < ALLGATHER_SHORT) {
+            alg = COLL_ALG_BRUCK;
+        } else {
+            alg = COLL_ALG_RING;
+        }
+    }
+
+    if (alg == COLL_ALG_RECURSIVE_DOUBLING) {
+        return allgather_packed(sendbuf, sendcount, sendtype,
+                                recvbuf, counts, displs, block_count,
+                                recvtype, comm, self, nproc, 0);
+    } else if (alg == COLL_ALG_BRUCK) {
+        return allgather_packed(sendbuf, sendcount, sendtype,
+                                recvbuf, counts, displs, block_count,
+                                recvtype, comm, self, nproc, 1);
+    }
+
+    return allgather_ring(sendbuf, sendcount, sendtype,
+                          recvbuf, counts, displs, block_count,
+                          recvtype, comm, self, nproc);
+}
+
+extern "C" int ulm_allgatherv_p2p(void *sendbuf, int sendcount,
+                                  ULMType_t *sendtype, void *recvbuf,
+                                  int *recvcount, int *displs,
+                                  ULMType_t *recvtype, int comm)
+{
+    return ulm_allgather_p2p_blocks(sendbuf, sendcount, sendtype, recvbuf,
+                                    recvcount, displs, 0, recvtype, comm);
+}
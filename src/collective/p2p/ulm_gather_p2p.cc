@@ -37,83 +37,112 @@
 #include "internal/log.h"
 #include "internal/profiler.h"
 #include "internal/types.h"
+#include "internal/malloc.h"
+#include "internal/type_copy.h"
 #include "queue/globals.h"
+#include "collective/coll_fns.h"
 
 /*
  * Gather buffers from all procs in a communicator
  *
- * Note: not an efficient implementation.
+ * Binomial tree on ranks relative to the root: in round k a process
+ * whose relative rank has bit k set sends everything it holds to
+ * relative rank - 2^k and is done; otherwise it receives the data of
+ * the 2^k (or fewer) processes below relative rank + 2^k.  The data
+ * moves as packed bytes, ordered by relative rank, so each process
+ * receives at most ceil(log2(nproc)) messages and the root unpacks
+ * the result once.  Leaves send directly from the send buffer.
  */
-extern "C" 
+extern "C"
 int ulm_gather_p2p(void *sendbuf, int sendcount, ULMType_t *sendtype,
-                   void *recvbuf, int recvcount, ULMType_t *recvtype, 
+                   void *recvbuf, int recvcount, ULMType_t *recvtype,
                    int root, int comm)
 {
-    int proc, nproc, self, rc, tag, completed;
-    ULMRequest_t *rreq, sreq;
-    ULMStatus_t sstat;
-    unsigned char *ptr;
+    ULMRequest_t req;
+    ULMStatus_t stat;
+    size_t size;
+    unsigned char *tmp;
+    int nproc, self, rel, mask, peer, nblocks, rc, tag, i;
 
     ulm_get_info(comm, ULM_INFO_PROCID, &self, sizeof(int));
     ulm_get_info(comm, ULM_INFO_NUMBER_OF_PROCS, &nproc, sizeof(int));
     rc = ulm_get_system_tag(comm, 1, &tag);
     if (rc != ULM_SUCCESS) {
-	return MPI_ERR_INTERN;
+        return rc;
     }
-    
-    if (self == root) {
-        /* array of requests, stati */
-        rreq = (ULMRequest_t *)
-            malloc(nproc * sizeof(ULMRequest_t));
-        if (rreq == NULL) {
-            return ULM_ERROR;
-        }
 
-        /* first, send to myself */
-        rc = ulm_isend(sendbuf, sendcount, sendtype, root, tag, comm, &sreq,
+    rel = (self - root + nproc) % nproc;
+
+    if (rel & 1) {
+        /* leaf: nothing to collect */
+        rc = ulm_isend(sendbuf, sendcount, sendtype,
+                       (self - 1 + nproc) % nproc, tag, comm, &req,
                        ULM_SEND_STANDARD);
         if (rc != ULM_SUCCESS) {
             return rc;
         }
+        return ulm_wait(&req, &stat);
+    }
 
-        /* receive from everyone (including myself) */
-        ptr = (unsigned char *) recvbuf;
-        for (proc = 0; proc < nproc; proc++, 
-                ptr += recvcount * recvtype->extent) {
-            rc = ulm_irecv(ptr, recvcount, recvtype, proc, tag, comm, 
-                           &rreq[proc]);
-            if (rc != ULM_SUCCESS) {
-                return rc;
+    if (self == root) {
+        size = recvcount * recvtype->packed_size;
+        nblocks = nproc;
+    } else {
+        size = sendcount * sendtype->packed_size;
+        nblocks = 1;
+        while (!(rel & nblocks)) {
+            nblocks <<= 1;
+        }
+        if (rel + nblocks > nproc) {
+            nblocks = nproc - rel;
+        }
+    }
+
+    tmp = (unsigned char *) ulm_malloc(nblocks * size > 0 ? nblocks * size : 1);
+    if (tmp == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    if (self != root || sendbuf != MPI_IN_PLACE) {
+        ulm_coll_pack_block(TYPE_PACK_PACK, tmp, size,
+                            sendbuf, sendcount, sendtype, 0);
+    }
+
+    for (mask = 1; mask < nproc; mask <<= 1) {
+        if (rel & mask) {
+            peer = (rel - mask + root) % nproc;
+            rc = ulm_isend(tmp, nblocks * size, (ULMType_t *) MPI_BYTE,
+                           peer, tag, comm, &req, ULM_SEND_STANDARD);
+            if (rc == ULM_SUCCESS) {
+                rc = ulm_wait(&req, &stat);
+            }
+            break;
+        }
+        if (rel + mask < nproc) {
+            peer = (rel + mask + root) % nproc;
+            i = (rel + 2 * mask <= nproc) ? mask : nproc - rel - mask;
+            rc = ulm_irecv(tmp + mask * size, i * size,
+                           (ULMType_t *) MPI_BYTE, peer, tag, comm, &req);
+            if (rc == ULM_SUCCESS) {
+                rc = ulm_wait(&req, &stat);
             }
-        }            
-        
-        /* wait on the posted recv's */
-        completed = 0;
-        while (!completed) {
-            rc = ulm_testall(rreq, nproc, &completed);
             if (rc != ULM_SUCCESS) {
-                return rc;
+                break;
             }
         }
+    }
 
-        /* wait on send to self */
-        rc = ulm_wait(&sreq, &sstat);
-        if (rc != ULM_SUCCESS) {
-            return rc; 
-        }
-
-        free(rreq), rreq = 0;
-    } else {
-        rc = ulm_isend(sendbuf, sendcount, sendtype, root, tag, comm, &sreq,
-                       ULM_SEND_STANDARD);
-        if (rc != ULM_SUCCESS) {
-            return rc;
-        }
-        rc = ulm_wait(&sreq, &sstat);
-        if (rc != ULM_SUCCESS) {
-            return rc;
+    if (self == root && rc == ULM_SUCCESS) {
+        for (i = 0; i < nproc; i++) {
+            if (i == 0 && sendbuf == MPI_IN_PLACE) {
+                continue;
+            }
+            ulm_coll_pack_block(TYPE_PACK_UNPACK, tmp + i * size, size,
+                                recvbuf, recvcount, recvtype,
+                                (i + root) % nproc);
         }
     }
 
-    return ULM_SUCCESS;
+    ulm_free(tmp);
+
+    return rc;
 }
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "queue/globals.h"
+#include "ulm/ulm.h"
+#include "internal/log.h"
+#include "internal/type_copy.h"
+#include "internal/malloc.h"
+#include "collective/coll_fns.h"
+
+/*!
+ * ulm_reduce_scatter_p2p -- reduce_scatter, point to point algorithms
+ *
+ * \param s_buf       Initial data (the full vector)
+ * \param r_buf       Buffer to receive this process's block
+ * \param counts      Number of objects in each process's block, or
+ *                    NULL if every block contains block_count objects
+ * \param displs      Offset (in objects) of each process's block, or
+ *                    NULL if every block contains block_count objects
+ * \param block_count Number of objects per block if counts is NULL
+ * \param type        Data type of objects
+ * \param op          Operation structure (must commute)
+ * \param comm        Communicator
+ * \return            ULM error code
+ *
+ * Description
+ *
+ * This function performs a global reduce operation (such as sum, max,
+ * logical and, etc.) across all the members of the context specified
+ * by comm, leaving block i of the result at the process with rank i.
+ *
+ * Algorithm
+ *
+ * Two algorithms are used depending on the size of the vector:
+ *
+ * Recursive halving (short vectors): at each of log2(nproc) stages
+ * each process exchanges half of its current range of blocks with a
+ * peer and accumulates the half it keeps.  This requires a temporary
+ * of the full vector size but has logarithmic latency.
+ *
+ * Pairwise exchange (long vectors): at stage s each process sends
+ * the block belonging to self + s and receives its own block from
+ * self - s, accumulating as it goes.  This is bandwidth optimal and
+ * only needs a temporary the size of the local block.
+ *
+ * Both algorithms assume that the operation commutes.
+ */
+extern "C" int ulm_reduce_scatter_p2p(const void *s_buf,
+                                      void *r_buf,
+                                      int *counts,
+                                      int *displs,
+                                      int block_count,
+                                      ULMType_t *type,
+                                      ULMOp_t *op,
+                                      int comm)
+{
+    enum {
+        KILOBYTE = 1 << 10,
+        HALVING_MAX_BYTES = 512 * KILOBYTE
+    };
+    ULMFunc_t *func;
+    ULMRequest_t request;
+    ULMStatus_t status;
+    const unsigned char *sp;
+    int *vcounts;
+    int *vdispls;
+    int last;
+    int mask;
+    int n;
+    int nproc2;
+    int nproc;
+    int nrem;
+    int peer;
+    int rc;
+    int recv_count;
+    int recv_index;
+    int self;
+    int send_count;
+    int send_index;
+    int step;
+    int tag;
+    int total;
+    int vpeer;
+    int vself;
+    size_t extent;
+    unsigned char *acc;
+    void *arg;
+    void *buf;
+    void *tmp_acc;
+    void *tmp_buf;
+
+    ulm_dbg(("ulm_reduce_scatter_p2p\n"));
+
+    if (type == NULL) {
+        return ULM_ERR_BAD_PARAM;
+    }
+
+    /*
+     * Pre-defined operations have a vector of function pointers
+     * corresponding to the basic types.  User-defined operations have
+     * a vector of length 1.
+     */
+    if (op->isbasic) {
+        if (type->isbasic == 0) {
+            ulm_err(("Error: ulm_reduce_scatter: "
+                     "basic operation, non-basic datatype\n"));
+            return ULM_ERR_BAD_PARAM;
+        }
+        func = op->func[type->op_index];
+    } else {
+        func = op->func[0];
+    }
+
+    /*
+     * For fortran defined functions, pass a pointer to the fortran
+     * type handle as the function argument, else pass a pointer to
+     * the type struct.
+     */
+    if (op->fortran) {
+        arg = (void *) &(type->fhandle);
+    } else {
+        arg = (void *) &type;
+    }
+
+    nproc = communicators[comm]->localGroup->groupSize;
+    self = communicators[comm]->localGroup->ProcID;
+    tag = communicators[comm]->get_base_tag(1);
+    extent = type->extent;
+    total = RS_DISPL(displs, block_count, nproc - 1) +
+        RS_COUNT(counts, block_count, nproc - 1);
+    if (total == 0) {
+        return ULM_SUCCESS;
+    }
+    sp = (const unsigned char *)
+        ((s_buf == MPI_IN_PLACE) ? r_buf : s_buf);
+
+    rc = ULM_ERROR;
+    acc = NULL;
+    buf = NULL;
+    tmp_acc = NULL;
+    tmp_buf = NULL;
+    vcounts = NULL;
+    vdispls = NULL;
+
+    if (total * extent > HALVING_MAX_BYTES) {
+
+        /*
+         * Pairwise exchange
+         *
+         * The partial result is accumulated in r_buf unless we are
+         * working in place, in which case r_buf still holds input
+         * data needed by other processes.
+         */
+
+        n = RS_COUNT(counts, block_count, self);
+        if (n > 0) {
+            buf = tmp_buf = ulm_malloc(n * extent);
+            if (buf == NULL) {
+                return ULM_ERR_OUT_OF_RESOURCE;
+            }
+            if (s_buf == MPI_IN_PLACE) {
+                acc = (unsigned char *) (tmp_acc = ulm_malloc(n * extent));
+                if (acc == NULL) {
+                    rc = ULM_ERR_OUT_OF_RESOURCE;
+                    goto EXIT;
+                }
+            } else {
+                acc = (unsigned char *) r_buf;
+            }
+            type_copy(acc, sp + RS_DISPL(displs, block_count, self) * extent,
+                      n, type);
+        }
+
+        for (step = 1; step < nproc; step++) {
+            peer = (self + step) % nproc;
+            if (n > 0) {
+                rc = ulm_irecv(buf, n, type, (self - step + nproc) % nproc,
+                               tag, comm, &request);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+            }
+            if (RS_COUNT(counts, block_count, peer) > 0) {
+                rc = ulm_send((void *) (sp + RS_DISPL(displs, block_count, peer)
+                                        * extent),
+                              RS_COUNT(counts, block_count, peer), type,
+                              peer, tag, comm, ULM_SEND_STANDARD);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+            }
+            if (n > 0) {
+                rc = ulm_wait(&request, &status);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+                func(buf, acc, &n, arg);
+            }
+        }
+
+        if (n > 0 && acc != (unsigned char *) r_buf) {
+            type_copy(r_buf, acc, n, type);
+        }
+
+        rc = ULM_SUCCESS;
+        goto EXIT;
+    }
+
+    /*
+     * Recursive halving
+     *
+     * Notation:
+     *
+     * nproc  - the number of procs
+     * nproc2 - the largest 2^n such that 2^n <= nproc
+     * nrem   - nproc - nproc2
+     * self   - our group proc ProcID
+     * vself  - our virtual ProcID among the nproc2 participants
+     *
+     * There are three phases:
+     *
+     * Setup: of the first 2 * nrem procs, the even ones send their
+     * whole vector to their odd neighbour where it is accumulated.
+     * The odd procs then act for both blocks, so virtual proc v
+     * covers procs 2v and 2v+1 for v < nrem, and proc v + nrem
+     * otherwise.  Each virtual proc's blocks are therefore contiguous.
+     *
+     * Main: the nproc2 virtual procs recursively halve the range of
+     * virtual blocks they hold, exchanging the other half with
+     * vpeer = vself ^ 2^n.
+     *
+     * Final: the odd procs of the first 2 * nrem send the even proc
+     * its block.
+     */
+
+    acc = (unsigned char *) (tmp_acc = ulm_malloc(2 * total * extent));
+    if (acc == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    buf = (void *) (acc + total * extent);
+    type_copy(acc, sp, total, type);
+
+    nproc2 = 1;
+    n = nproc;
+    while (n >>= 1) {
+        nproc2 <<= 1;
+    }
+    nrem = nproc - nproc2;
+
+    if (self < 2 * nrem) {
+        if ((self & 1) == 0) {
+            rc = ulm_send(acc, total, type, self + 1, tag, comm,
+                          ULM_SEND_STANDARD);
+            if (rc != ULM_SUCCESS) {
+                goto EXIT;
+            }
+            vself = -1;
+        } else {
+            rc = ulm_recv(buf, total, type, self - 1, tag, comm, &status);
+            if (rc != ULM_SUCCESS) {
+                goto EXIT;
+            }
+            func(buf, acc, &total, arg);
+            vself = self / 2;
+        }
+    } else {
+        vself = self - nrem;
+    }
+
+    if (vself >= 0) {
+
+        vcounts = (int *) ulm_malloc(2 * nproc2 * sizeof(int));
+        if (vcounts == NULL) {
+            rc = ULM_ERR_OUT_OF_RESOURCE;
+            goto EXIT;
+        }
+        vdispls = vcounts + nproc2;
+        for (n = 0; n < nproc2; n++) {
+            if (n < nrem) {
+                vcounts[n] = RS_COUNT(counts, block_count, 2 * n) +
+                    RS_COUNT(counts, block_count, 2 * n + 1);
+                vdispls[n] = RS_DISPL(displs, block_count, 2 * n);
+            } else {
+                vcounts[n] = RS_COUNT(counts, block_count, n + nrem);
+                vdispls[n] = RS_DISPL(displs, block_count, n + nrem);
+            }
+        }
+
+        send_index = recv_index = 0;
+        last = nproc2;
+        for (mask = nproc2 >> 1; mask > 0; mask >>= 1) {
+            vpeer = vself ^ mask;
+            peer = (vpeer < nrem) ? 2 * vpeer + 1 : vpeer + nrem;
+            if (vself < vpeer) {
+                send_index = recv_index + mask;
+                send_count = vdispls[last - 1] + vcounts[last - 1] -
+                    vdispls[send_index];
+                recv_count = vdispls[send_index] - vdispls[recv_index];
+            } else {
+                recv_index = send_index + mask;
+                send_count = vdispls[recv_index] - vdispls[send_index];
+                recv_count = vdispls[last - 1] + vcounts[last - 1] -
+                    vdispls[recv_index];
+            }
+            if (recv_count > 0) {
+                rc = ulm_irecv((unsigned char *) buf +
+                               vdispls[recv_index] * extent,
+                               recv_count, type, peer, tag, comm, &request);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+            }
+            if (send_count > 0) {
+                rc = ulm_send(acc + vdispls[send_index] * extent,
+                              send_count, type, peer, tag, comm,
+                              ULM_SEND_STANDARD);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+            }
+            if (recv_count > 0) {
+                rc = ulm_wait(&request, &status);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+                func((unsigned char *) buf + vdispls[recv_index] * extent,
+                     acc + vdispls[recv_index] * extent, &recv_count, arg);
+            }
+            send_index = recv_index;
+            last = recv_index + mask;
+        }
+
+        n = RS_COUNT(counts, block_count, self);
+        if (n > 0) {
+            type_copy(r_buf, acc + RS_DISPL(displs, block_count, self) * extent,
+                      n, type);
+        }
+    }
+
+    if (self < 2 * nrem) {
+        if (self & 1) {
+            n = RS_COUNT(counts, block_count, self - 1);
+            if (n > 0) {
+                rc = ulm_send(acc + RS_DISPL(displs, block_count, self - 1)
+                              * extent, n, type, self - 1, tag, comm,
+                              ULM_SEND_STANDARD);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+            }
+        } else {
+            n = RS_COUNT(counts, block_count, self);
+            if (n > 0) {
+                rc = ulm_recv(r_buf, n, type, self + 1, tag, comm, &status);
+                if (rc != ULM_SUCCESS) {
+                    goto EXIT;
+                }
+            }
+        }
+    }
+
+    rc = ULM_SUCCESS;
+
+    /*
+     * Free resources and exit
+     */
+
+  EXIT:
+    if (vcounts) {
+        ulm_free(vcounts);
+    }
+    if (tmp_buf) {
+        ulm_free(tmp_buf);
+    }
+    if (tmp_acc) {
+        ulm_free(tmp_acc);
+    }
+
+    return rc;
+}
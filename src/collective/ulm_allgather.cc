@@ -40,6 +40,7 @@
 #include "util/Utility.h"
 #include "mem/ULMMallocMacros.h"
 #include "collective/coll_fns.h"
+#include "collective/coll_tune.h"
 #include "util/inline_copy_functions.h"
 
 /*
@@ -715,6 +716,7 @@ extern "C" int ulm_allgather(void *sendbuf, int sendcount,
                              ULMType_t *sendtype, void *recvbuf,
                              int recvcount, ULMType_t *recvtype, int comm)
 {
+    extern ulm_allgather_t ulm_allgather_p2p;
     int returnCode = ULM_SUCCESS;
     Communicator *commPtr = (Communicator *) communicators[comm];
     int numHosts = commPtr->localGroup->numberOfHostsInGroup;
@@ -748,8 +750,20 @@ extern "C" int ulm_allgather(void *sendbuf, int sendcount,
         currentRankBytesRead[host] = 0;
     }
 
-    /* decide which algorithm to use */
-    if (numStripes > 1) {
+    /*
+     * decide which algorithm to use: with one process per host there
+     * is nothing to gain from staging through shared memory
+     */
+    int alg = ulm_coll_decide(commPtr, COLL_TUNE_ALLGATHER,
+                              maxBytesPerProc, NULL);
+    if (alg == COLL_ALG_RECURSIVE_DOUBLING || alg == COLL_ALG_BRUCK ||
+        alg == COLL_ALG_RING ||
+        (alg == COLL_ALG_DEFAULT && numHosts > 1 &&
+         commPtr->localGroup->maxOnHostGroupSize == 1)) {
+        returnCode =
+            ulm_allgather_p2p(sendbuf, sendcount, sendtype, recvbuf,
+                              recvcount, recvtype, comm);
+    } else if (numStripes > 1) {
         numStripes =
             ((maxBytesPerProc -
               1) / commPtr->collectiveOpt.perRankStripeSize) + 1;
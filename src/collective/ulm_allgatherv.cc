@@ -41,6 +41,7 @@
 #include "util/inline_copy_functions.h"
 #include "internal/mpi.h"
 #include "internal/type_copy.h"
+#include "collective/coll_tune.h"
 
 /*
  * This routine is used to compute the contributions of a given host
@@ -1081,6 +1082,7 @@ extern "C" int ulm_allgatherv(void *sendbuf, int sendcount,
                               int *recvcount, int *displs,
                               ULMType_t *recvtype, int comm)
 {
+    extern ulm_allgatherv_t ulm_allgatherv_p2p;
     int returnCode = ULM_SUCCESS;
     /* get communicator pointer */
     Communicator *commPtr = (Communicator *) communicators[comm];
@@ -1111,6 +1113,7 @@ extern "C" int ulm_allgatherv(void *sendbuf, int sendcount,
     size_t *dataToSend = commPtr->collectiveOpt.dataToSend;
 
     int numStripes = 0;
+    size_t groupBytes = 0;
     for (int host = 0; host < numHosts; host++) {
 
         size_t totalBytes = 0;
@@ -1129,14 +1132,27 @@ extern "C" int ulm_allgatherv(void *sendbuf, int sendcount,
 
         /* fill in the amount of data that host "host" has to exchange */
         dataToSend[host] = totalBytes;
+        groupBytes += totalBytes;
 
         /* initialize some data */
         currentLocalRank[host] = 0;
         currentRankBytesRead[host] = 0;
     }
 
-    /* decide which algorithm to use */
-    if (numStripes > 1) {
+    /*
+     * decide which algorithm to use: with one process per host there
+     * is nothing to gain from staging through shared memory
+     */
+    int alg = ulm_coll_decide(commPtr, COLL_TUNE_ALLGATHER,
+                              groupBytes / group->groupSize, NULL);
+    if (alg == COLL_ALG_RECURSIVE_DOUBLING || alg == COLL_ALG_BRUCK ||
+        alg == COLL_ALG_RING ||
+        (alg == COLL_ALG_DEFAULT && numHosts > 1 &&
+         commPtr->localGroup->maxOnHostGroupSize == 1)) {
+        returnCode =
+            ulm_allgatherv_p2p(sendbuf, sendcount, sendtype, recvbuf,
+                               recvcount, displs, recvtype, comm);
+    } else if (numStripes > 1) {
         returnCode =
             ulm_allgathervMultipleStripes(sendbuf, sendcount, sendtype,
                                           recvbuf, recvcount, displs,
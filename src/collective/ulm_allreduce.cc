@@ -39,6 +39,7 @@
 #include "ulm/ulm.h"
 #include "internal/log.h"
 #include "internal/type_copy.h"
+#include "collective/coll_tune.h"
 
 /*!
  * ulm_allreduce - reduce function entry point
@@ -74,7 +75,6 @@ extern "C" int ulm_allreduce(const void *s_buf,
                              int comm)
 {
     enum {
-        USE_P2P = 0,
         KILOBYTE = 1 << 10,
         MEGABYTE = 1 << 20,
         BLOCK_SIZE = 1 * MEGABYTE
@@ -82,7 +82,9 @@ extern "C" int ulm_allreduce(const void *s_buf,
 
     Communicator *communicator;
     Group *group;
+    int alg;
     int block_count;
+    size_t block_size;
     int n;
     int rc;
     ulm_allreduce_t *algorithm;
@@ -96,9 +98,13 @@ extern "C" int ulm_allreduce(const void *s_buf,
     group = communicator->localGroup;
 
     /*
-     * Select algorithm based on arguments
+     * Select algorithm based on arguments and the decision table
      */
 
+    block_size = BLOCK_SIZE;
+    alg = ulm_coll_decide(communicator, COLL_TUNE_ALLREDUCE,
+                          count * type->packed_size, &block_size);
+
     if (group->groupSize == 1) {
 
         if (s_buf != MPI_IN_PLACE) {
@@ -107,7 +113,7 @@ extern "C" int ulm_allreduce(const void *s_buf,
 
         return ULM_SUCCESS;
 
-    } else if (op->commute == 0) {
+    } else if (op->commute == 0 || alg == COLL_ALG_LINEAR) {
 
         /*
          * For non-commuting operators, where evaluation order
@@ -117,7 +123,7 @@ extern "C" int ulm_allreduce(const void *s_buf,
 
         algorithm = ulm_allreduce_linear;
 
-    }  else if (USE_P2P ||
+    }  else if (alg == COLL_ALG_P2P ||
                 communicator->useSharedMemForCollectives == 0 ||
                 type->extent > communicator->collectiveOpt.maxReduceExtent) {
 
@@ -149,7 +155,7 @@ extern "C" int ulm_allreduce(const void *s_buf,
      * For explicit allreduce algorithms, call the algorithm blockwise
      */
 
-    block_count = BLOCK_SIZE / type->packed_size;
+    block_count = block_size / type->packed_size;
     if (block_count == 0) {
         block_count = 1;
     }
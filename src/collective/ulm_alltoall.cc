@@ -31,723 +31,554 @@
  */
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
 
-
-#include <stdio.h>
-#include <math.h>
 #include <string.h>
+
 #include "internal/mpi.h"
+#include "internal/log.h"
 #include "internal/malloc.h"
-
-#ifndef GINGER_ALLTOALL 
-#ifdef ENABLE_QSNET
+#include "internal/type_copy.h"
+#include "queue/globals.h"
+#include "collective/coll_fns.h"
+#include "collective/coll_tune.h"
+
+enum {
+    ALLTOALL_BRUCK_MAX = 256,           /* largest block (bytes) for Bruck */
+    ALLTOALL_AGGREGATE_MAX = 1024,      /* largest block (bytes) for host
+                                         * aggregation */
+    ALLTOALL_WINDOW = 8                 /* maximum concurrent exchanges */
+};
 
 /*
- * This is a simple implementation based on a sequence of gathers.
+ * alltoall_bruck - Bruck's algorithm for small blocks
  *
- * We are using this for quadrics currently because more aggressive
- * algorithms can lead to resource exhaustion even on moderate numbers of
- * processes (> 32).
- *
- * Action items:
- * (a) Make quadrics path more robust to resource exhaustion
- * (b) Rethink the alltoall implementation which remains far from optimal
- */ 
-extern "C" int ulm_alltoall(void *sendbuf, int sendcount, ULMType_t *sendtype,
-			    void *recvbuf, int recvcount, ULMType_t *recvtype,
-			    int comm)
+ * The blocks are rotated so that block i is destined for process
+ * self + i.  In round k (k = 1, 2, 4, ...) every block whose index
+ * has bit k set is packed into a single message to process self + k.
+ * After ceil(log2(nproc)) rounds block i holds the data from process
+ * self - i.  Each block is moved log(nproc)/2 times on average, but
+ * only log(nproc) messages are sent, which wins when per-message
+ * costs dominate.
+ */
+static int alltoall_bruck(void *sendbuf, int sendcount, ULMType_t *sendtype,
+                          void *recvbuf, int recvcount, ULMType_t *recvtype,
+                          int comm, int self, int nproc)
 {
-    int nproc;
+    ULMRequest_t send_request;
+    ULMRequest_t recv_request;
+    ULMStatus_t status;
+    size_t size = sendcount * sendtype->packed_size;
+    size_t nbytes;
+    unsigned char *tmp;
+    unsigned char *sbuf;
+    unsigned char *rbuf;
+    int i;
+    int k;
     int rc;
-    int root;
-    
-    rc = ulm_comm_size(comm, &nproc);
-    if (rc != ULM_SUCCESS) {
-        return MPI_ERR_COMM;
-    }
-
-    for (root = 0; root < nproc; root++) {
-        rc = ulm_gather((char*) sendbuf + root * sendcount * sendtype->extent,
-                        sendcount, sendtype,
-                        recvbuf, recvcount, recvtype,
-                        root, comm);
-        if (rc != ULM_SUCCESS) {
-            return rc;
-        }
-    }
-    
-    return ULM_SUCCESS;
-}
+    int rc2;
+    int tag;
 
-#else
-
-typedef struct group{
-    int groupNumber;
-    int groupSize;
-    int* elementsOfGroup;
-} group_t;
-
-extern "C" int ulm_alltoall(void *sendbuf, int sendcount, ULMType_t *sendtype,
-			    void *recvbuf, int recvcnt, ULMType_t *recvtype,
-			    int comm)
-{
-    int		numberGroups= 1 ;
-    int		i, group;
-    int		placeInGroup;
-    int		maxPlace;
-    group_t*	groups;
-    int		maxGroup;
-    int		count= 0;
-    int		procs;
-    int		destProc;
-    int		srcProc;
-    int		destGroup;
-    int		srcGroup;
-    int		rc;
-    int		tag;
-    int		comm_size;
-    int		self;
-    ULMRequest_t	recvRequest;
-    ULMRequest_t*	sendRequest;
-    ULMStatus_t	recvStatus;
-    ULMStatus_t	sendStatus;
-    unsigned char*	buf_loc;
-
-    rc = ulm_comm_size(comm, &comm_size);
-    if (rc != ULM_SUCCESS) {
-	return MPI_ERR_COMM;
-    }
     rc = ulm_get_system_tag(comm, 1, &tag);
     if (rc != ULM_SUCCESS) {
-	return MPI_ERR_INTERN;
+        return rc;
     }
 
-    sendRequest = (ULMRequest_t *)ulm_malloc(sizeof(ULMRequest_t) * comm_size);
-    if (!sendRequest) {
-	ulm_err(("Error: Out of memory\n"));
-	return MPI_ERR_INTERN;
+    /*
+     * one rotated copy of all blocks plus send and receive staging:
+     * at most (nproc + 1) / 2 blocks are moved in any round
+     */
+    tmp = (unsigned char *) ulm_malloc((nproc + 2 * ((nproc + 1) / 2)) * size);
+    if (tmp == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
     }
+    sbuf = tmp + nproc * size;
+    rbuf = sbuf + ((nproc + 1) / 2) * size;
 
-    if (comm_size > 100)
-	numberGroups = 2;
+    for (i = 0; i < nproc; i++) {
+        ulm_coll_pack_block(TYPE_PACK_PACK, tmp + i * size, size,
+                            sendbuf, sendcount, sendtype, (self + i) % nproc);
+    }
 
-    ulm_get_info(comm, ULM_INFO_PROCID, &self, sizeof(int));
+    for (k = 1; k < nproc; k <<= 1) {
+        nbytes = 0;
+        for (i = k; i < nproc; i++) {
+            if (i & k) {
+                memcpy(sbuf + nbytes, tmp + i * size, size);
+                nbytes += size;
+            }
+        }
 
+        rc = ulm_irecv(rbuf, nbytes, (ULMType_t *) MPI_BYTE,
+                       (self - k + nproc) % nproc, tag, comm, &recv_request);
+        if (rc != ULM_SUCCESS) {
+            break;
+        }
+        rc = ulm_isend(sbuf, nbytes, (ULMType_t *) MPI_BYTE,
+                       (self + k) % nproc, tag, comm, &send_request,
+                       ULM_SEND_STANDARD);
+        if (rc != ULM_SUCCESS) {
+            /* do not leave the receive outstanding */
+            ulm_wait(&recv_request, &status);
+            break;
+        }
+        rc = ulm_wait(&recv_request, &status);
+        rc2 = ulm_wait(&send_request, &status);
+        if (rc == ULM_SUCCESS) {
+            rc = rc2;
+        }
+        if (rc != ULM_SUCCESS) {
+            break;
+        }
 
-    maxPlace = (int)((comm_size/numberGroups) + 1);
-    maxGroup =  numberGroups;
-    groups = (group_t*)ulm_malloc(sizeof(group_t)*maxGroup);
-    for (i=0;i<maxGroup;i++){
-	groups[i].elementsOfGroup  = (int*)ulm_malloc(sizeof(int)*maxPlace);
-	groups[i].groupSize = 0;
-	groups[i].groupNumber	   = i;
-	memset((void*)groups[i].elementsOfGroup, -9, maxPlace);
-    }
-    for (i=0;i<comm_size;i++){
-	group=i%numberGroups;
-	placeInGroup = (int)(i/numberGroups);
-	groups[group].elementsOfGroup[placeInGroup]=i;
-	groups[group].groupSize++;
+        nbytes = 0;
+        for (i = k; i < nproc; i++) {
+            if (i & k) {
+                memcpy(tmp + i * size, rbuf + nbytes, size);
+                nbytes += size;
+            }
+        }
     }
 
-    srcGroup=(self%numberGroups);
-    for (destGroup=srcGroup, count=0;count < maxGroup;)
-    {
-	    buf_loc = (unsigned char *) sendbuf;
-	for (procs = 0; procs < groups[destGroup].groupSize;procs++)
-	{
-	    destProc = groups[destGroup].elementsOfGroup[procs];
-	    rc = ulm_isend(buf_loc+destProc*sendcount*sendtype->extent,
-			   sendcount, sendtype, destProc, tag,
-			   comm, &(sendRequest[procs]),  ULM_SEND_STANDARD);
+    if (rc == ULM_SUCCESS) {
+        for (i = 0; i < nproc; i++) {
+            ulm_coll_pack_block(TYPE_PACK_UNPACK, tmp + i * size, size,
+                                recvbuf, recvcount, recvtype,
+                                (self - i + nproc) % nproc);
+        }
+    }
 
-	    if (rc != ULM_SUCCESS) break;
-	}
+    ulm_free(tmp);
 
-	buf_loc = (unsigned char *) recvbuf;
-	for (procs = 0; procs < groups[srcGroup].groupSize;procs++)
-	{
-	    srcProc = groups[srcGroup].elementsOfGroup[procs];
-	    rc = ulm_irecv(buf_loc + srcProc*recvcnt*recvtype->extent,
-			   recvcnt, recvtype, srcProc,
-			   tag,  comm,  &recvRequest);
+    return rc;
+}
 
-	    rc = ulm_wait(&recvRequest, &recvStatus);
-	    if (rc != ULM_SUCCESS) break;
+/*
+ * alltoall_pairwise - scattered pairwise exchange for large blocks
+ *
+ * In step s each process sends to self + s and receives from
+ * self - s, so every process has exactly one sender and one receiver
+ * per step.  Up to ALLTOALL_WINDOW steps are in flight at once: enough
+ * to keep the network busy while bounding the number of outstanding
+ * requests (and unexpected messages) regardless of communicator size.
+ */
+static int alltoall_pairwise(void *sendbuf, int sendcount, ULMType_t *sendtype,
+                             void *recvbuf, int recvcount, ULMType_t *recvtype,
+                             int comm, int self, int nproc)
+{
+    ULMRequest_t send_request[ALLTOALL_WINDOW];
+    ULMRequest_t recv_request[ALLTOALL_WINDOW];
+    ULMStatus_t status;
+    int send_active[ALLTOALL_WINDOW];
+    int recv_active[ALLTOALL_WINDOW];
+    int peer;
+    int rc;
+    int rc2;
+    int s;
+    int tag;
+    int w;
 
+    rc = ulm_get_system_tag(comm, 1, &tag);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
 
-	}
+    rc = ulm_coll_copy((unsigned char *) recvbuf +
+                       self * recvcount * recvtype->extent,
+                       recvcount, recvtype,
+                       (unsigned char *) sendbuf +
+                       self * sendcount * sendtype->extent,
+                       sendcount, sendtype);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
 
-	for (procs = 0; procs < groups[destGroup].groupSize;procs++)
-	{
-	    destProc = groups[destGroup].elementsOfGroup[procs];
-	    rc = ulm_wait(&(sendRequest[procs]), &sendStatus);
+    for (w = 0; w < ALLTOALL_WINDOW; w++) {
+        send_active[w] = 0;
+        recv_active[w] = 0;
+    }
 
-	    if (rc != ULM_SUCCESS) break;
-	}
+    for (s = 1; s < nproc; s++) {
+        w = s % ALLTOALL_WINDOW;
 
-	count++;
-	srcGroup=(srcGroup-1)%maxGroup;
-	if (srcGroup<0)
-	    srcGroup = numberGroups-1;
+        /* retire the step that last used this slot */
+        if (recv_active[w]) {
+            recv_active[w] = 0;
+            rc = ulm_wait(&recv_request[w], &status);
+            if (rc != ULM_SUCCESS) {
+                break;
+            }
+        }
+        if (send_active[w]) {
+            send_active[w] = 0;
+            rc = ulm_wait(&send_request[w], &status);
+            if (rc != ULM_SUCCESS) {
+                break;
+            }
+        }
 
-	destGroup = (destGroup+1)%maxGroup;
+        peer = (self - s + nproc) % nproc;
+        rc = ulm_irecv((unsigned char *) recvbuf +
+                       peer * recvcount * recvtype->extent,
+                       recvcount, recvtype, peer, tag, comm,
+                       &recv_request[w]);
+        if (rc != ULM_SUCCESS) {
+            break;
+        }
+        recv_active[w] = 1;
 
+        peer = (self + s) % nproc;
+        rc = ulm_isend((unsigned char *) sendbuf +
+                       peer * sendcount * sendtype->extent,
+                       sendcount, sendtype, peer, tag, comm,
+                       &send_request[w], ULM_SEND_STANDARD);
+        if (rc != ULM_SUCCESS) {
+            break;
+        }
+        send_active[w] = 1;
     }
 
-    ulm_free(sendRequest);
-    for (i=0;i<maxGroup;i++){
-	ulm_free(groups[i].elementsOfGroup);
+    /*
+     * drain the window, also after an error so that no request is
+     * left outstanding: the peers carry on with every step, so the
+     * posted receives are matched and the sends consumed
+     */
+    for (w = 0; w < ALLTOALL_WINDOW; w++) {
+        if (recv_active[w]) {
+            rc2 = ulm_wait(&recv_request[w], &status);
+            if (rc == ULM_SUCCESS) {
+                rc = rc2;
+            }
+        }
+        if (send_active[w]) {
+            rc2 = ulm_wait(&send_request[w], &status);
+            if (rc == ULM_SUCCESS) {
+                rc = rc2;
+            }
+        }
     }
-    ulm_free(groups);
 
     return rc;
 }
 
-#endif
-#else
-
-typedef struct index_table{
-  int* dest;
-  int* elements;
-}index_t;
-
-int getLog2 (int comm_size, int *power2, int *leftover ){
-  int i;
-  int log2;
-
-  i = 1;
-  log2 = 0;
-  *leftover = 0;
-  *power2 = 1;
-
-  while ( i < comm_size ){
-    i *= 2;
-    log2++;
-  }
-
-  for (i=0;i<log2;i++) *power2 *= 2;
-
-  if (*power2 != comm_size){
-    log2 -= 1;
-    *power2 /= 2;
-    *leftover = comm_size - *power2;
-  }
-
-  return( log2 );
-}
-
-int createIndexTable(index_t *indices, int comm_size,
-                     void *sendbuf, ULMType_t *sendtype, int log2)
+/*
+ * alltoall_leaders_agree - combine the host leaders' status codes
+ *
+ * Each host leader sends its status to every other leader, in the same
+ * step order as the exchange, and takes the lowest (an error if any
+ * leader had one).  All leaders thus either go on to the exchange or
+ * all give up with the same error code.
+ */
+static int alltoall_leaders_agree(Group *group, int comm, int tag, int status)
 {
+    ULMRequest_t send_request;
+    ULMRequest_t recv_request;
+    ULMStatus_t st;
+    int nhosts = group->numberOfHostsInGroup;
+    int hi = group->hostIndexInGroup;
+    int result = status;
+    int remote;
+    int rc;
+    int s;
 
-  int i, j, k;
-  int group;
-  int dest2;
-
-  /* Grab space for index tracking table */
-  for (i=0;i<comm_size;i++){
-    indices[i].dest     = (int*)malloc(sizeof(int)*log2);
-    if (!indices[i].dest) 
-      return ULM_ERR_OUT_OF_RESOURCE;
-
-    indices[i].elements = (int*)malloc(sizeof(int)*log2);
-    if (!indices[i].elements) 
-      return ULM_ERR_OUT_OF_RESOURCE;
-  }
-
-  /****
-   * Fill out the index table. I guess some explaining about that table
-   * needs to go into here.  Here it goes:
-   *
-   *  indices[process].dest[loop] contains the destination process.
-   *  indices[process].elements[loop] contains the number of elements to xfr.
-   *
-   *  processe is 0 to comm_size
-   *  loop     is the n in 2^n number of processes (minus 1 for the index)
-   *
-   *  Choosing an easy and smallish number of process for an example(8)
-   *  The table end ups looking like:
-   *
-   *       Destination:            Elements:
-   *      Loops-->   0  1  2         0  1  2
-   *      procs| [0] 1  2  4     [0] 1  2  4
-   *           | [1] 0  3  5     [1] 1  2  4
-   *           v [2] 3  0  6     [2] 1  2  4
-   *             [3] 2  1  7     [3] 1  2  4
-   *             [4] 5  6  0     [4] 1  2  4
-   *             [5] 4  7  1     [5] 1  2  4
-   *             [6] 7  4  2     [6] 1  2  4
-   *             [7] 6  5  3     [7] 1  2  4
-   *****/
-  k = 1;
-  dest2 = 0;
-  group = 1;
-  for (i=0;i<log2;i++){
-    for (j=0;j<comm_size;j++){
-      if ( k < (group*2) ){
-        if (k<=group){
-          indices[j].dest[i]     = j + group; 
-          indices[j].elements[i] = group;
-          dest2 = j + (group-1);
+    for (s = 1; s < nhosts; s++) {
+        rc = ulm_irecv(&remote, sizeof(int), (ULMType_t *) MPI_BYTE,
+                       group->groupHostData[(hi - s + nhosts) % nhosts].groupProcIDOnHost[0],
+                       tag, comm, &recv_request);
+        if (rc != ULM_SUCCESS) {
+            return rc;
         }
-        else{
-          dest2 = j - group;
-          indices[j].dest[i]     = dest2; 
-          indices[j].elements[i] = group;
-          dest2++;
+        rc = ulm_isend(&status, sizeof(int), (ULMType_t *) MPI_BYTE,
+                       group->groupHostData[(hi + s) % nhosts].groupProcIDOnHost[0],
+                       tag, comm, &send_request, ULM_SEND_STANDARD);
+        if (rc == ULM_SUCCESS) {
+            rc = ulm_wait(&send_request, &st);
         }
-        k++;
-      }
-      else {
-        indices[j].dest[i]     = dest2;
-        indices[j].elements[i] = group;
-        k=1;
-      }
-    }
-    group *=2;
-  }
-  return ULM_SUCCESS;
-}/* createIndexTable */
-
-int exchangeByLog2 (void *sendbuf, int sendcount, ULMType_t *sendtype,
-                    void *recvbuf, int recvcnt, ULMType_t *recvtype,
-                    int comm, int comm_size, int self, 
-                    int rc, int tag, int log2, index_t *indices)
-{
-  int           i,j;
-  int           count= 0;
-  int           destProc;
-  int           skip;
-  int           flip;
-  unsigned char* buf_loc;
-  unsigned char* temp;
-  ULMRequest_t  recvRequest;
-  ULMRequest_t  sendRequest;
-  ULMStatus_t   recvStatus;
-  ULMStatus_t   sendStatus;
-
-
-  temp = (unsigned char*)ulm_malloc(sendtype->extent*comm_size);
-  if (!temp) 
-    return ULM_ERR_OUT_OF_RESOURCE;
-
-  /* If all Okay, pass the data in a 2^n segments */
-  memcpy( recvbuf, sendbuf, sendtype->extent*comm_size);
-  memcpy( temp, sendbuf, sendtype->extent*comm_size);
-
-  for (i=0;i<log2;i++){
-    j=0;
-    skip = 0;
-    flip = 0;
-
-    while ( j < comm_size){
-
-      buf_loc = temp;
-    
-      destProc = indices[self].dest[i];
-      count = indices[self].elements[i];
-      
-      if (count == 1){
-        if ((self%2)==0)
-          skip = j + 1; 
-        else 
-          skip = j;
-      }
-      else {
-
-        flip = self%(count*2);
-
-        if ( flip < (count)){
-          skip = j + count;
+        if (rc != ULM_SUCCESS) {
+            ulm_wait(&recv_request, &st);
+            return rc;
+        }
+        rc = ulm_wait(&recv_request, &st);
+        if (rc != ULM_SUCCESS) {
+            return rc;
         }
-        else {
-          skip = j;
+        if (remote < result) {
+            result = remote;
         }
-      }
-
-      rc = ulm_isend(buf_loc+(skip*(sendtype->extent)),
-                     count, sendtype, destProc, tag,
-                     comm, &sendRequest,  ULM_SEND_STANDARD);
-    
-      if (rc != ULM_SUCCESS) break;
-
-      /* set up the receive */
-      buf_loc = (unsigned char *) recvbuf;
-
-      rc = ulm_irecv(buf_loc + (skip*(recvtype->extent)),
-                     count, recvtype, destProc,
-                     tag,  comm,  &recvRequest);
-
-      rc = ulm_wait(&recvRequest, &recvStatus);
-      if (rc != ULM_SUCCESS) break;
-
-      rc = ulm_wait(&sendRequest, &sendStatus);      
-      if (rc != ULM_SUCCESS) break;
-
-      j = j + 2*count;
     }
 
-    memcpy( temp, recvbuf, sendtype->extent*comm_size);
-
-  }
-  ulm_free( temp );
-  return(rc);
-} /* exchangeByLog2 */
+    return result;
+}
 
-int exchangeFakeLog2 (void *sendbuf, int sendcount, ULMType_t *sendtype,
-                      void *recvbuf, int recvcnt, ULMType_t *recvtype,
-                      void *sendbuf_extra, void *recvbuf_extra, 
-                      int comm, int comm_size, int modifiedSelf, 
-                      int rc, int rc_extra, int tag, int log2, int power2, 
-                      int extra, index_t *indices)
+/*
+ * alltoall_smp - alltoall through the collective shared memory buffer
+ *
+ * Every process packs its whole send buffer into its own region of
+ * the shared buffer.  On-host blocks are then unpacked directly from
+ * the sender's region.  With more than one host, the lowest ranked
+ * process on each host (the host leader) gathers the blocks for each
+ * remote host into a single message, exchanges these with the other
+ * leaders, and writes the blocks it receives into a second region
+ * from which each local process unpacks them.  This replaces
+ * L * L_h small messages between each pair of hosts by one.
+ *
+ * Shared buffer layout, where L is the number of local processes and
+ * size the packed block size:
+ *
+ *   in:  [local sender][destination rank] blocks, L * nproc * size
+ *   out: [local receiver][source rank] blocks, L * nproc * size
+ */
+static int alltoall_smp(void *sendbuf, int sendcount, ULMType_t *sendtype,
+                        void *recvbuf, int recvcount, ULMType_t *recvtype,
+                        int comm, int self, int nproc)
 {
-  int           i,j;
-  int           count= 0;
-
-  int           destProc;
-  int           skip;
-  int           flip;
-  unsigned char* buf_loc;
-  unsigned char* temp;
-  ULMRequest_t  recvRequest;
-  ULMRequest_t  sendRequest;
-  ULMStatus_t   recvStatus;
-  ULMStatus_t   sendStatus;
-
-  int           destProc_extra;
-  int           skip_extra;
-  int           flip_extra;
-  unsigned char* buf_loc_extra;
-  unsigned char* temp_extra;
-  ULMRequest_t  recvRequest_extra;
-  ULMRequest_t  sendRequest_extra;
-  ULMStatus_t   recvStatus_extra;
-  ULMStatus_t   sendStatus_extra;
-
-  temp = (unsigned char*)ulm_malloc((sendtype->extent)*power2);
-  if (!temp) 
-    return ULM_ERR_OUT_OF_RESOURCE;
-
-  /* If all Okay, pass the data in a 2^n segments */
-  memcpy( recvbuf, sendbuf, sendtype->extent*comm_size);
-  memcpy( temp, sendbuf, sendtype->extent*comm_size);
-
-  if (extra){
-    temp_extra = (unsigned char*)ulm_malloc((sendtype->extent)*power2);
-    if (!temp_extra) 
-      return ULM_ERR_OUT_OF_RESOURCE;
-
-    memcpy( recvbuf_extra, sendbuf, sendtype->extent*comm_size);
-    memcpy( temp_extra, sendbuf_extra, (sendtype->extent)*comm_size);
-
-  }
-
-  for (i=0;i<log2;i++){
-    j=0;
-    skip = 0;
-    flip = 0;
-
-    if (extra) {
-      skip_extra = 0;
-      flip_extra = 0;
+    Communicator *communicator = communicators[comm];
+    Group *group = communicator->localGroup;
+    CollectiveSMBuffer_t *coll_desc;
+    ULMRequest_t *request;
+    ULMStatus_t status;
+    size_t size = sendcount * sendtype->packed_size;
+    size_t region;
+    unsigned char *in;
+    unsigned char *out;
+    unsigned char *staging;
+    unsigned char *p;
+    int nhosts = group->numberOfHostsInGroup;
+    int hi = group->hostIndexInGroup;
+    int local = group->onHostGroupSize;
+    int me = group->onHostProcID;
+    int rc = ULM_SUCCESS;
+    int tag = 0;
+    int h;
+    int i;
+    int j;
+    int r;
+    int s;
+
+    if (nhosts > 1) {
+        rc = ulm_get_system_tag(comm, 1, &tag);
+        if (rc != ULM_SUCCESS) {
+            return rc;
+        }
     }
 
-    while ( j < power2){
-
-      buf_loc = temp;
-    
-      destProc = indices[modifiedSelf].dest[i];
-      count = indices[modifiedSelf].elements[i];
-
-      if (extra){
-        buf_loc_extra = temp_extra;
-        
-        destProc_extra = indices[modifiedSelf+comm_size].dest[i];
-      }
-
-      if (count == 1){
-        if ((modifiedSelf%2)==0)
-          skip = j + 1; 
-        else 
-          skip = j;
-        if (extra){
-          if (((modifiedSelf+comm_size)%2)==0)
-            skip_extra = j + 1; 
-          else 
-            skip_extra = j;
+    /*
+     * the host leader allocates its staging space up front, so that
+     * the leaders can agree on the outcome before anything is sent
+     */
+    staging = NULL;
+    request = NULL;
+    if (nhosts > 1 && me == 0) {
+        staging = (unsigned char *)
+            ulm_malloc(2 * local * (nproc - local) * size);
+        request = (ULMRequest_t *)
+            ulm_malloc(2 * nhosts * sizeof(ULMRequest_t));
+        if (staging == NULL || request == NULL) {
+            rc = ULM_ERR_OUT_OF_RESOURCE;
         }
-      }
-      else {
+    }
 
-        flip = modifiedSelf%(count*2);
-        if (extra)
-          flip_extra = (modifiedSelf+comm_size)%(count*2);
+    coll_desc = communicator->getCollectiveSMBuffer(communicator->get_base_tag(1));
+    region = nproc * size;
+    in = (unsigned char *) coll_desc->mem;
+    out = in + local * region;
 
-        if ( flip < (count)){
-          skip = j + count;
-        }
-        else {
-          skip = j;
-        }
-        if (extra){
-          if ( flip_extra < (count)){
-            skip_extra = j + count;
-          }
-          else {
-            skip_extra = j;
-          }
+    for (r = 0; r < nproc; r++) {
+        ulm_coll_pack_block(TYPE_PACK_PACK, in + me * region + r * size,
+                            size, sendbuf, sendcount, sendtype, r);
+    }
+    communicator->smpBarrier(communicator->barrierData);
+
+    if (nhosts > 1) {
+        if (me == 0) {
+            int nrecv = 0;
+            int nsend = 0;
+            int rc2;
+
+            rc = alltoall_leaders_agree(group, comm, tag, rc);
+
+            /*
+             * host leader: exchange aggregated blocks with the other
+             * leaders, send staging first then receive staging, both
+             * ordered by host exchange step
+             */
+            p = staging + local * (nproc - local) * size;
+            for (s = 1; s < nhosts && rc == ULM_SUCCESS; s++) {
+                h = (hi - s + nhosts) % nhosts;
+                rc = ulm_irecv(p, local * group->groupHostData[h].nGroupProcIDOnHost * size,
+                               (ULMType_t *) MPI_BYTE,
+                               group->groupHostData[h].groupProcIDOnHost[0],
+                               tag, comm, &request[nhosts + s]);
+                if (rc == ULM_SUCCESS) {
+                    nrecv = s;
+                }
+                p += local * group->groupHostData[h].nGroupProcIDOnHost * size;
+            }
+
+            p = staging;
+            for (s = 1; s < nhosts && rc == ULM_SUCCESS; s++) {
+                unsigned char *msg = p;
+                h = (hi + s) % nhosts;
+                for (i = 0; i < local; i++) {
+                    for (j = 0; j < group->groupHostData[h].nGroupProcIDOnHost; j++) {
+                        r = group->groupHostData[h].groupProcIDOnHost[j];
+                        memcpy(p, in + i * region + r * size, size);
+                        p += size;
+                    }
+                }
+                rc = ulm_isend(msg, p - msg, (ULMType_t *) MPI_BYTE,
+                               group->groupHostData[h].groupProcIDOnHost[0],
+                               tag, comm, &request[s], ULM_SEND_STANDARD);
+                if (rc == ULM_SUCCESS) {
+                    nsend = s;
+                }
+            }
+
+            /*
+             * blocks from host h arrive as [sender on h][local
+             * receiver]; every posted request is waited for, even
+             * after an error, so none is left outstanding
+             */
+            p = staging + local * (nproc - local) * size;
+            for (s = 1; s <= nrecv; s++) {
+                h = (hi - s + nhosts) % nhosts;
+                rc2 = ulm_wait(&request[nhosts + s], &status);
+                if (rc == ULM_SUCCESS) {
+                    rc = rc2;
+                }
+                for (j = 0; j < group->groupHostData[h].nGroupProcIDOnHost &&
+                         rc == ULM_SUCCESS; j++) {
+                    r = group->groupHostData[h].groupProcIDOnHost[j];
+                    for (i = 0; i < local; i++) {
+                        memcpy(out + i * region + r * size, p, size);
+                        p += size;
+                    }
+                }
+            }
+            for (s = 1; s <= nsend; s++) {
+                rc2 = ulm_wait(&request[s], &status);
+                if (rc == ULM_SUCCESS) {
+                    rc = rc2;
+                }
+            }
+
+            if (request) {
+                ulm_free(request);
+            }
+            if (staging) {
+                ulm_free(staging);
+            }
+
+            /* pass the outcome on to the other local processes */
+            coll_desc->flag = rc;
         }
-      }
-
-      if (destProc >= comm_size){
-        destProc -= comm_size;
-      }
+        /* the other local processes still wait for the leader here */
+        communicator->smpBarrier(communicator->barrierData);
+        rc = coll_desc->flag;
+    }
 
-      if (extra)
-        if (destProc_extra >= comm_size){
-          destProc_extra -= comm_size;
+    for (r = 0; r < nproc && rc == ULM_SUCCESS; r++) {
+        if (group->mapGroupProcIDToHostID[r] == myhost()) {
+            p = in + group->mapGroupProcIDToOnHostProcID[r] * region +
+                self * size;
+        } else {
+            p = out + me * region + r * size;
         }
-
-      if (extra) {
-        rc_extra = ulm_isend(buf_loc_extra+(skip_extra*(sendtype->extent)),
-                             count, sendtype, destProc_extra, tag,
-                             comm, &sendRequest_extra,  ULM_SEND_STANDARD);
-    
-        if (rc_extra != ULM_SUCCESS) break;
-      }
-      rc = ulm_isend(buf_loc+(skip*(sendtype->extent)),
-                     count, sendtype, destProc, tag,
-                     comm, &sendRequest,  ULM_SEND_STANDARD);
-    
-      if (rc != ULM_SUCCESS) break;
-
-      /* set up the receive */
-      buf_loc = (unsigned char *) recvbuf;
-      if (extra)
-        buf_loc_extra = (unsigned char *) recvbuf_extra;
-
-      if (extra) {
-        rc_extra = ulm_irecv(buf_loc_extra + (skip_extra*(recvtype->extent)),
-                       count, recvtype, destProc_extra,
-                       tag,  comm,  &recvRequest_extra);
-
-        rc_extra = ulm_wait(&recvRequest_extra, &recvStatus_extra);
-        if (rc_extra != ULM_SUCCESS) break;
-
-        rc_extra = ulm_wait(&sendRequest_extra, &sendStatus_extra);      
-        if (rc_extra != ULM_SUCCESS) break;
-      }
-      rc = ulm_irecv(buf_loc + (skip*(recvtype->extent)),
-                     count, recvtype, destProc,
-                     tag,  comm,  &recvRequest);
-
-      rc = ulm_wait(&recvRequest, &recvStatus);
-      if (rc != ULM_SUCCESS) break;
-
-      rc = ulm_wait(&sendRequest, &sendStatus);      
-      if (rc != ULM_SUCCESS) break;
-
-      j = j + 2*count;
+        ulm_coll_pack_block(TYPE_PACK_UNPACK, p, size,
+                            recvbuf, recvcount, recvtype, r);
     }
 
-    memcpy( temp, recvbuf, sendtype->extent*power2);
-    if (extra)
-      memcpy( temp_extra, recvbuf_extra, sendtype->extent*power2);
+    communicator->releaseCollectiveSMBuffer(coll_desc);
 
-  }
+    return rc;
+}
 
-  ulm_free( temp );
+/*!
+ * ulm_alltoall - alltoall function entry point
+ *
+ * \param sendbuf       Send buffer (one block for each process)
+ * \param sendcount     Number of objects sent to each process
+ * \param sendtype      Data type of send objects
+ * \param recvbuf       Receive buffer (one block for each process)
+ * \param recvcount     Number of objects received from each process
+ * \param recvtype      Data type of receive objects
+ * \param comm          The communicator ID
+ * \return              ULM error code
+ *
+ * This top-level entry point selects the appropriate algorithm based
+ * on the block size and the shape of the communicator.  The choice
+ * must be the same on every process, so only quantities common to all
+ * processes are used.
+ */
+extern "C" int ulm_alltoall(void *sendbuf, int sendcount, ULMType_t *sendtype,
+                            void *recvbuf, int recvcount, ULMType_t *recvtype,
+                            int comm)
+{
+    Communicator *communicator;
+    Group *group;
+    size_t size;
+    size_t smp_size;
+    int alg;
+    int nproc;
+    int self;
 
-  if (extra){
-    ulm_free( temp_extra );
-    if (rc == rc_extra) return (rc);
-    else return (rc || rc_extra);
-  }
-  return(rc);
-} /* exchangeFakeLog2 */
+    communicator = communicators[comm];
+    group = communicator->localGroup;
+    nproc = group->groupSize;
+    self = group->ProcID;
+    size = sendcount * sendtype->packed_size;
 
-int exByProcess (void *sendbuf, int sendcount, ULMType_t *sendtype,
-                 void *recvbuf, int recvcnt, ULMType_t *recvtype,
-                 int comm, int comm_size, int power2, int self, int rc, int tag)
-{
-  int           destProc;
-  unsigned char* buf_loc;
-  ULMRequest_t  recvRequest;
-  ULMRequest_t  sendRequest;
-  ULMStatus_t   recvStatus;
-  ULMStatus_t   sendStatus;
-
-  if (self >= power2){
-
-    for (destProc=0;destProc<comm_size;destProc++){
-      buf_loc = (unsigned char *)sendbuf;
-    
-      if ( self != destProc){
-
-        rc = ulm_isend(buf_loc+destProc*(sendtype->extent),
-                       1, sendtype, destProc, tag,
-                       comm, &sendRequest,  ULM_SEND_STANDARD);
-    
-        if (rc != ULM_SUCCESS) break;
-
-        /* set up the receive */
-        buf_loc = (unsigned char *) recvbuf;
-
-        rc = ulm_irecv(buf_loc + destProc*(recvtype->extent),
-                       1, recvtype, destProc,
-                       tag,  comm,  &recvRequest);
-
-        rc = ulm_wait(&recvRequest, &recvStatus);
-        if (rc != ULM_SUCCESS) break;
-
-        rc = ulm_wait(&sendRequest, &sendStatus);      
-        if (rc != ULM_SUCCESS) break;
-      }
+    if (size == 0) {
+        return ULM_SUCCESS;
     }
-  }
-  else{
-    for (destProc=power2;destProc<comm_size;destProc++){
-      
-      if (self < power2 ){
-        buf_loc = (unsigned char *)sendbuf;
-    
-        rc = ulm_isend(buf_loc+destProc*(sendtype->extent),
-                       1, sendtype, destProc, tag,
-                       comm, &sendRequest,  ULM_SEND_STANDARD);
-    
-        if (rc != ULM_SUCCESS) break;
-
-        /* set up the receive */
-        buf_loc = (unsigned char *) recvbuf;
-
-        rc = ulm_irecv(buf_loc +destProc*(recvtype->extent),
-                       1, recvtype, destProc,
-                       tag,  comm,  &recvRequest);
-
-        rc = ulm_wait(&recvRequest, &recvStatus);
-        if (rc != ULM_SUCCESS) break;
-
-        rc = ulm_wait(&sendRequest, &sendStatus);      
-        if (rc != ULM_SUCCESS) break;
-      }
+
+    if (nproc == 1) {
+        return ulm_coll_copy(recvbuf, recvcount, recvtype,
+                             sendbuf, sendcount, sendtype);
     }
-  }
-  return(rc);
-} /* exchangeByProcess */
 
+    alg = ulm_coll_decide(communicator, COLL_TUNE_ALLTOALL, size, NULL);
 
-extern "C" int ulm_alltoall(void *sendbuf, int sendcount, ULMType_t *sendtype,
-                            void *recvbuf, int recvcnt, ULMType_t *recvtype,
-                            int comm)
-{
-  int           rc;
-  int           tag;
-  int           comm_size;
-  int           self;
-  int           leftover;
-  int           log2;
-  int           power2;
-  index_t*      indices;
-
-  rc = ulm_comm_size(comm, &comm_size);
-  if (rc != ULM_SUCCESS) {
-    return MPI_ERR_COMM;
-  }
-  rc = ulm_get_system_tag(comm, 1, &tag);
-  if (rc != ULM_SUCCESS) {
-    return MPI_ERR_INTERN;
-  }
-
-  ulm_get_info(comm, ULM_INFO_PROCID, &self, sizeof(int));
-
-  /***/
-  /* Do we have a power 2? */
-  log2 = getLog2 (comm_size, &power2, &leftover);
-
-  /* There is a power of two, so it's easy */
-  if ( leftover == 0){
-
-    indices = (index_t*)ulm_malloc(sizeof(index_t)*comm_size);
-    if (!indices) 
-      return ULM_ERR_OUT_OF_RESOURCE;
-    
-    /* set up the index table */
-    if (createIndexTable(indices, comm_size,
-                         sendbuf, sendtype, log2) != ULM_SUCCESS)
-      return MPI_ERR_COMM;
-
-
-    rc = exchangeByLog2 (sendbuf, sendcount, sendtype,
-                         recvbuf, recvcnt, recvtype,
-                         comm, comm_size, self, rc, tag, 
-                         log2, indices);
-  }
-
-  /* Create Dummy processes to the next power of 2
-   */
-  else {
-    unsigned char *send_extra;
-    unsigned char *recv_extra;
-    unsigned char *recv_larger;
-
-    log2++;
-    power2 *= 2;
-
-    indices = (index_t*)ulm_malloc(sizeof(index_t)*power2);
-    if (!indices) 
-      return ULM_ERR_OUT_OF_RESOURCE;
-
-    /* set up the index table */
-    if (createIndexTable(indices, power2,
-                         sendbuf, sendtype, log2) != ULM_SUCCESS)
-      return MPI_ERR_COMM;
-
-      recv_larger = (unsigned char*)ulm_malloc((sendtype->extent)*power2);
-      if (!recv_larger) 
-        return ULM_ERR_OUT_OF_RESOURCE;
+    if (communicator->useSharedMemForCollectives &&
+        (alg == COLL_ALG_DEFAULT || alg == COLL_ALG_SMP)) {
+        smp_size = group->maxOnHostGroupSize * nproc * size;
+        if (group->numberOfHostsInGroup == 1) {
 
-    if ( self < (power2-comm_size)){
+            /*
+             * All processes on-host: one copy in and one copy out
+             */
 
-      send_extra = (unsigned char*)ulm_malloc((sendtype->extent)*power2);
-      if (!send_extra) 
-        return ULM_ERR_OUT_OF_RESOURCE;
+            if (smp_size <= communicator->sharedCollectiveData[0].max_length) {
+                return alltoall_smp(sendbuf, sendcount, sendtype,
+                                    recvbuf, recvcount, recvtype,
+                                    comm, self, nproc);
+            }
 
-      recv_extra = (unsigned char*)ulm_malloc((sendtype->extent)*power2);
-      if (!recv_extra) 
-        return ULM_ERR_OUT_OF_RESOURCE;
-
-      memcpy( send_extra, sendbuf, (sendtype->extent)*comm_size);
+        } else if (group->maxOnHostGroupSize > 1 &&
+                   (size <= ALLTOALL_AGGREGATE_MAX || alg == COLL_ALG_SMP) &&
+                   2 * smp_size <= communicator->sharedCollectiveData[0].max_length) {
 
-      int rc_extra;
-      rc = exchangeFakeLog2 (sendbuf, sendcount, sendtype,
-                             recv_larger, recvcnt, recvtype,
-                             send_extra, recv_extra,
-                             comm, comm_size, self, rc, rc_extra, tag, 
-                             log2, power2, 1, indices);
-      ulm_free(send_extra);
-      ulm_free(recv_extra);
+            /*
+             * Small blocks, several processes per host: aggregate
+             * per-host traffic through the host leaders
+             */
 
+            return alltoall_smp(sendbuf, sendcount, sendtype,
+                                recvbuf, recvcount, recvtype,
+                                comm, self, nproc);
+        }
     }
-    else{
-
-      void *send_fake, *recv_fake;
-      
-      rc = exchangeFakeLog2 (sendbuf, sendcount, sendtype,
-                             recv_larger, recvcnt, recvtype,
-                             send_fake, recv_fake,
-                             comm, comm_size, self, rc, rc, tag, 
-                             log2, power2, 0, indices);      
 
+    if (alg == COLL_ALG_BRUCK ||
+        (alg != COLL_ALG_PAIRWISE && size <= ALLTOALL_BRUCK_MAX)) {
+        return alltoall_bruck(sendbuf, sendcount, sendtype,
+                              recvbuf, recvcount, recvtype,
+                              comm, self, nproc);
     }
-    memcpy( recvbuf, recv_larger, (sendtype->extent)*comm_size);
-    ulm_free(recv_larger);
-  }
-
-  /* clean-up */
-  ulm_free(indices);
-    
-  return rc;
-}
 
-#endif
+    return alltoall_pairwise(sendbuf, sendcount, sendtype,
+                             recvbuf, recvcount, recvtype,
+                             comm, self, nproc);
+}
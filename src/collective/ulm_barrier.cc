@@ -37,6 +37,7 @@
 #include "internal/log.h"
 #include "ulm/ulm.h"
 #include "queue/globals.h"
+#include "collective/coll_tune.h"
 
 /*
  * ulm_barrier - barrier
@@ -47,12 +48,12 @@
 extern "C" int ulm_barrier(int comm)
 {
     int rc;
-    enum { USE_P2P = 0 };
 
     extern ulm_barrier_t ulm_barrier_interhost;
     extern ulm_barrier_t ulm_barrier_p2p;
 
-    if (USE_P2P) {
+    if (ulm_coll_decide(communicators[comm], COLL_TUNE_BARRIER, 0, NULL)
+        == COLL_ALG_P2P) {
 
         rc = ulm_barrier_p2p(comm);
 
@@ -37,6 +37,80 @@
 #include "ulm/ulm.h"
 #include "queue/globals.h"
 #include "collective/coll_fns.h"
+#include "collective/coll_tune.h"
+
+enum {
+    KILOBYTE = 1 << 10,
+    MEGABYTE = 1 << 20,
+    BLOCK_SIZE = 128 * KILOBYTE,
+    BCAST_SLOTS = 4
+};
+
+/*
+ * bcast_onhost - broadcast from comm_root to the other processes on
+ * this host through the collective shared memory buffer
+ *
+ * The buffer is divided into BCAST_SLOTS slots, used in turn for
+ * successive stripes of the data.  The root publishes the number of
+ * stripes packed in coll_desc->flag, and each process publishes the
+ * number of stripes it has unpacked in its own (cache line padded)
+ * element of coll_desc->controlFlags.  The root only waits when it
+ * is about to reuse a slot that has not yet been drained, so packing
+ * of one stripe overlaps with unpacking of the previous ones and no
+ * barrier is needed.  Flags are reset in releaseCollectiveSMBuffer.
+ */
+static void bcast_onhost(void *buf, int count, ULMType_t *type,
+                         int comm_root, int self,
+                         Communicator *comm_ptr,
+                         CollectiveSMBuffer_t *coll_desc)
+{
+    Group *group = comm_ptr->localGroup;
+    size_t bcast_size = count * type->extent;
+    size_t slot_size;
+    size_t offset;
+    size_t ti = 0;
+    size_t mi = 0;
+    size_t mo = 0;
+    int stripe;
+    int nproc;
+    int root_onhost;
+    unsigned char *slot;
+
+    slot_size = (coll_desc->max_length / BCAST_SLOTS) & ~(CACHE_ALIGNMENT - 1);
+    if (bcast_size < slot_size) {
+        slot_size = bcast_size;
+    }
+    nproc = group->onHostGroupSize;
+    root_onhost = group->mapGroupProcIDToOnHostProcID[comm_root];
+
+    for (stripe = 0; ti < (size_t) count; stripe++) {
+        offset = 0;
+        slot = (unsigned char *) coll_desc->mem +
+            (stripe % BCAST_SLOTS) * slot_size;
+        if (self == comm_root) {
+            if (stripe >= BCAST_SLOTS) {
+                /* wait for the slot's last stripe to be drained */
+                for (int p = 0; p < nproc; p++) {
+                    volatile int *consumed = &(coll_desc->controlFlags[p].flag);
+                    if (p != root_onhost) {
+                        ULM_SPIN_AND_MAKE_PROGRESS(*consumed <
+                                                   stripe - BCAST_SLOTS + 1);
+                    }
+                }
+            }
+            type_pack(TYPE_PACK_PACK, slot, slot_size,
+                      &offset, buf, count, type, &ti, &mi, &mo);
+            wmb();
+            coll_desc->flag = stripe + 1;
+        } else {
+            ULM_SPIN_AND_MAKE_PROGRESS(coll_desc->flag <= stripe);
+            type_pack(TYPE_PACK_UNPACK, slot, slot_size,
+                      &offset, buf, count, type, &ti, &mi, &mo);
+            mb();
+            coll_desc->controlFlags[group->onHostProcID].flag = stripe + 1;
+        }
+    }
+}
 
 /*!
  * ulm_bcast - broadcast function entry point
@@ -52,13 +126,6 @@
  * The algorithm is called blockwise to moderate the load for very
  * large data sets.
  */
-
-enum {
-    KILOBYTE = 1 << 10,
-    MEGABYTE = 1 << 20,
-    BLOCK_SIZE = 128 * KILOBYTE
-};
-
 extern "C" int ulm_bcast(void *buf, int count, ULMType_t *type, int root, int comm)
 {
     Communicator *comm_ptr;
@@ -74,21 +141,15 @@ extern "C" int ulm_bcast(void *buf, int count, ULMType_t *type, int root, int co
     int total_procs;
     int cnt;
     int hi;
+    int alg;
     long long tag;
-    size_t bcast_size = 0;
-    size_t copy_buffer_size = 0;
-    size_t shared_buffer_size = 0;
-    size_t offset = 0;
-    size_t ti = 0;
-    size_t mi = 0;
-    size_t mo = 0;
+    size_t block_size;
     unsigned char *p;
-    void *RESTRICT_MACRO shared_buffer;
+
+    extern ulm_bcast_t ulm_bcast_p2p;
 
     group = communicators[comm]->localGroup;
-    bcast_size = count * type->extent;
     comm_ptr = (Communicator *) communicators[comm];
-    bcast_size = count * type->extent;
     hi = group->hostIndexInGroup;
     comm_root = group->groupHostData[hi].groupProcIDOnHost[0];
 
@@ -99,44 +160,43 @@ extern "C" int ulm_bcast(void *buf, int count, ULMType_t *type, int root, int co
 
     rc = ulm_get_info(comm, ULM_INFO_NUMBER_OF_PROCS, &total_procs, sizeof(int));
 
+    block_size = BLOCK_SIZE;
+    alg = ulm_coll_decide(comm_ptr, COLL_TUNE_BCAST,
+                          count * type->packed_size, &block_size);
+    block_count = block_size / type->packed_size;
+    if (block_count == 0) {
+        block_count = 1;
+    }
+
+    /* point-to-point tree over all processes, called blockwise */
+    if (alg == COLL_ALG_P2P) {
+        p = (unsigned char *) buf;
+        cnt = count;
+        while (cnt > 0) {
+            n = (block_count < cnt) ? block_count : cnt;
+            rc = ulm_bcast_p2p(p, n, type, root, comm);
+            if (rc != ULM_SUCCESS) {
+                return rc;
+            }
+            cnt -= n;
+            p += n * type->extent;
+        }
+        return ULM_SUCCESS;
+    }
+
     /* set up collective descriptor, shared buffer */
     tag = comm_ptr->get_base_tag(1);
     coll_desc = comm_ptr->getCollectiveSMBuffer(tag);
-    shared_buffer = coll_desc->mem;
-    shared_buffer_size = (size_t) coll_desc->max_length;
-    copy_buffer_size = (bcast_size < shared_buffer_size) ? bcast_size : shared_buffer_size;
+
     /* single-host case */
     if (total_hosts == 1) {
-        while (ti < (size_t) count) {
-            offset = 0;
-            if (self == root) {
-                type_pack(TYPE_PACK_PACK, shared_buffer, copy_buffer_size,
-                          &offset, buf, count, type, &ti, &mi, &mo);
-                wmb();
-                coll_desc->flag = 2;
-            } else {
-                ULM_SPIN_AND_MAKE_PROGRESS(coll_desc->flag != 2);
-                type_pack(TYPE_PACK_UNPACK, shared_buffer, copy_buffer_size,
-                          &offset, buf, count, type, &ti, &mi, &mo);
-            }
-
-            if (ti != (size_t) count) {
-                comm_ptr->smpBarrier(comm_ptr->barrierData);
-                coll_desc->flag = 1;
-                comm_ptr->smpBarrier(comm_ptr->barrierData);
-            }
-        }
-
+        bcast_onhost(buf, count, type, root, self, comm_ptr, coll_desc);
         comm_ptr->releaseCollectiveSMBuffer(coll_desc);
         return ULM_SUCCESS;
     }
 
     /* more than 1 host, so send data around to comm-roots
      * using ulm_bcast_interhost */
-    block_count = BLOCK_SIZE / type->packed_size;
-    if (block_count == 0) {
-        block_count = 1;
-    }
     p = (unsigned char *) buf;
     cnt = count;
     while (cnt > 0) {
@@ -163,25 +223,7 @@ extern "C" int ulm_bcast(void *buf, int count, ULMType_t *type, int root, int co
         comm_root = root;
     }
 
-    while (ti < (size_t) count) {
-        offset = 0;
-        if (self == comm_root) {
-            type_pack(TYPE_PACK_PACK, shared_buffer, copy_buffer_size,
-                      &offset, buf, count, type, &ti, &mi, &mo);
-            wmb();
-            coll_desc->flag = 2;
-        } else {
-            ULM_SPIN_AND_MAKE_PROGRESS(coll_desc->flag != 2);
-            type_pack(TYPE_PACK_UNPACK, shared_buffer, copy_buffer_size,
-                      &offset, buf, count, type, &ti, &mi, &mo);
-        }
-
-        if (ti != (size_t) count) {
-            comm_ptr->smpBarrier(comm_ptr->barrierData);
-            coll_desc->flag = 1;
-            comm_ptr->smpBarrier(comm_ptr->barrierData);
-        }
-    }
+    bcast_onhost(buf, count, type, comm_root, self, comm_ptr, coll_desc);
 
     comm_ptr->releaseCollectiveSMBuffer(coll_desc);
     return ULM_SUCCESS;
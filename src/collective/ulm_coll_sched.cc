@@ -0,0 +1,625 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "internal/log.h"
+#include "internal/malloc.h"
+#include "internal/mpi.h"
+#include "internal/type_copy.h"
+#include "queue/globals.h"
+#include "util/DblLinkList.h"
+#include "util/Lock.h"
+#include "collective/coll_fns.h"
+#include "collective/coll_sched.h"
+
+/*
+ * schedules that have been started but not yet completed
+ */
+static DoubleLinkList activeColl;
+static Locks activeCollLock;
+
+
+/*
+ * grow an array of elements of size bytes to hold at least n elements
+ */
+static int grow(void **array, int *max, int n, size_t size)
+{
+    void *p;
+    int newmax;
+
+    if (n <= *max) {
+        return ULM_SUCCESS;
+    }
+    newmax = (*max > 0) ? 2 * (*max) : 16;
+    while (newmax < n) {
+        newmax *= 2;
+    }
+    p = ulm_malloc(newmax * size);
+    if (p == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    if (*array) {
+        memcpy(p, *array, (*max) * size);
+        ulm_free(*array);
+    }
+    *array = p;
+    *max = newmax;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * append an operation to the last round of the schedule
+ */
+static CollOp_t *append(CollDesc_t *d, int kind)
+{
+    CollOp_t *o;
+
+    if (grow((void **) &d->ops, &d->maxops, d->nops + 1,
+             sizeof(CollOp_t)) != ULM_SUCCESS) {
+        d->error = ULM_ERR_OUT_OF_RESOURCE;
+        return NULL;
+    }
+    o = &d->ops[d->nops++];
+    memset(o, 0, sizeof(CollOp_t));
+    o->kind = kind;
+
+    return o;
+}
+
+
+/*
+ * index one past the last operation of round r
+ */
+static inline int round_end(CollDesc_t *d, int r)
+{
+    return (r + 1 < d->nrounds) ? d->rounds[r + 1] : d->nops;
+}
+
+
+/*
+ * dest = src op dest, or dest = dest op src if reverse is set, in
+ * which case src is overwritten
+ */
+static int reduce(CollDesc_t *d, CollOp_t *o)
+{
+    ULMFunc_t *func;
+    void *arg;
+    int count = o->count;
+
+    if (d->op->isbasic) {
+        func = d->op->func[o->type->op_index];
+    } else {
+        func = d->op->func[0];
+    }
+    if (d->op->fortran) {
+        arg = (void *) &(o->type->fhandle);
+    } else {
+        arg = (void *) &(o->type);
+    }
+
+    if (o->reverse) {
+        func(o->buf, o->src, &count, arg);
+        type_copy(o->buf, o->src, o->count, o->type);
+    } else {
+        func(o->src, o->buf, &count, arg);
+    }
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * retire the completed requests of the current round, returning the
+ * number still outstanding
+ */
+static int retire(CollDesc_t *d)
+{
+    RequestDesc_t *r;
+    RecvDesc_t *recv;
+    int i;
+    int pending = 0;
+
+    for (i = 0; i < d->nreq; i++) {
+        r = (RequestDesc_t *) d->req[i];
+        if (r == NULL) {
+            continue;
+        }
+        if (r->messageDone == REQUEST_INCOMPLETE) {
+            pending++;
+            continue;
+        }
+        if (r->requestType == REQUEST_TYPE_RECV) {
+            recv = (RecvDesc_t *) r;
+            if (recv->posted_m.length_m < recv->reslts_m.length_m &&
+                d->error == ULM_SUCCESS) {
+                d->error = ULM_ERR_RECV_MORE_THAN_POSTED;
+            }
+        }
+        r->status = ULM_STATUS_COMPLETE;
+        ulm_request_free(&(d->req[i]));
+        d->req[i] = NULL;
+    }
+
+    return pending;
+}
+
+
+/*
+ * advance a schedule as far as possible without blocking, returning
+ * true once it has completed
+ */
+static bool advance(CollDesc_t *d)
+{
+    CollOp_t *o;
+    int first;
+    int last;
+    int i;
+    int rc;
+
+    while (retire(d) == 0) {
+
+        d->nreq = 0;
+        d->round++;
+        if (d->round >= d->nrounds || d->error != ULM_SUCCESS) {
+            d->messageDone = REQUEST_COMPLETE;
+            return true;
+        }
+
+        first = d->rounds[d->round];
+        last = round_end(d, d->round);
+
+        /* local operations first... */
+        for (i = first; i < last; i++) {
+            o = &d->ops[i];
+            rc = ULM_SUCCESS;
+            if (o->kind == COLL_OP_COPY) {
+                rc = ulm_coll_copy(o->buf, o->count, o->type,
+                                   o->src, o->src_count, o->src_type);
+            } else if (o->kind == COLL_OP_REDUCE) {
+                rc = reduce(d, o);
+            }
+            if (rc != ULM_SUCCESS) {
+                d->error = rc;
+                break;
+            }
+        }
+
+        /* ...then receives before sends */
+        for (i = first; i < last && d->error == ULM_SUCCESS; i++) {
+            o = &d->ops[i];
+            if (o->kind == COLL_OP_RECV) {
+                rc = ulm_irecv(o->buf, o->count, o->type, o->peer,
+                               d->tag, d->ctx_m, &(d->req[d->nreq]));
+                if (rc != ULM_SUCCESS) {
+                    d->error = rc;
+                    break;
+                }
+                d->nreq++;
+            }
+        }
+        for (i = first; i < last && d->error == ULM_SUCCESS; i++) {
+            o = &d->ops[i];
+            if (o->kind == COLL_OP_SEND) {
+                rc = ulm_isend(o->buf, o->count, o->type, o->peer,
+                               d->tag, d->ctx_m, &(d->req[d->nreq]),
+                               ULM_SEND_STANDARD);
+                if (rc != ULM_SUCCESS) {
+                    d->error = rc;
+                    break;
+                }
+                d->nreq++;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ * allocate an empty schedule on intra-communicator comm
+ */
+int ulm_coll_sched_alloc(int comm, CollDesc_t **desc)
+{
+    CollDesc_t *d;
+
+    if (communicators[comm]->communicatorType ==
+        Communicator::INTER_COMMUNICATOR) {
+        return ULM_ERR_COMM;
+    }
+
+    d = new CollDesc_t;
+    if (d == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+
+    d->datatype = NULL;
+    d->ctx_m = comm;
+    d->requestType = REQUEST_TYPE_COLL;
+    d->status = ULM_STATUS_INITED;
+    d->persistent = false;
+    d->freeCalled = false;
+    d->persistFreeCalled = false;
+    d->messageDone = REQUEST_INCOMPLETE;
+
+    d->tag = (int) communicators[comm]->get_base_tag(1);
+    d->op = NULL;
+    d->ops = NULL;
+    d->nops = 0;
+    d->maxops = 0;
+    d->rounds = NULL;
+    d->nrounds = 0;
+    d->maxrounds = 0;
+    d->round = -1;
+    d->req = NULL;
+    d->nreq = 0;
+    d->maxreq = 0;
+    d->scratch = NULL;
+    d->types[0] = NULL;
+    d->types[1] = NULL;
+    d->error = ULM_SUCCESS;
+    d->active = false;
+
+    if (ulm_coll_sched_round(d) != ULM_SUCCESS) {
+        ulm_coll_sched_free(d);
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    *desc = d;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * release everything a schedule holds - it must not be active
+ */
+static void destroy(CollDesc_t *d)
+{
+    if (d->persistent) {
+        communicators[d->ctx_m]->refCounLock.lock();
+        (communicators[d->ctx_m]->requestRefCount)--;
+        communicators[d->ctx_m]->refCounLock.unlock();
+    }
+
+    ulm_type_release(d->types[0]);
+    ulm_type_release(d->types[1]);
+    if (d->ops) {
+        ulm_free(d->ops);
+    }
+    if (d->rounds) {
+        ulm_free(d->rounds);
+    }
+    if (d->req) {
+        ulm_free(d->req);
+    }
+    if (d->scratch) {
+        ulm_free(d->scratch);
+    }
+    delete d;
+}
+
+
+/*
+ * release a schedule and everything it holds.  An active schedule
+ * still has receives posted into its scratch space and the user's
+ * buffers, so it is only marked, and ulm_coll_sched_progress()
+ * releases it once it completes.
+ */
+void ulm_coll_sched_free(CollDesc_t *d)
+{
+    /* the list lock also waits out a concurrent ulm_coll_sched_progress() */
+    activeCollLock.lock();
+    if (d->active) {
+        d->freeCalled = true;
+        activeCollLock.unlock();
+        return;
+    }
+    activeCollLock.unlock();
+
+    destroy(d);
+}
+
+
+/*
+ * allocate size bytes of scratch space for the schedule (at most
+ * once per schedule)
+ */
+void *ulm_coll_sched_scratch(CollDesc_t *d, size_t size)
+{
+    d->scratch = ulm_malloc(size > 0 ? size : 1);
+    if (d->scratch == NULL) {
+        d->error = ULM_ERR_OUT_OF_RESOURCE;
+    }
+    return d->scratch;
+}
+
+
+/*
+ * hold references to the user datatypes until the schedule is freed
+ */
+void ulm_coll_sched_retain(CollDesc_t *d, ULMType_t *t0, ULMType_t *t1)
+{
+    d->types[0] = t0;
+    d->types[1] = t1;
+    ulm_type_retain(t0);
+    ulm_type_retain(t1);
+}
+
+
+/*
+ * The builder functions record a failure in d->error, which is
+ * returned by ulm_coll_sched_start(), so callers need not check each
+ * step.
+ */
+
+
+int ulm_coll_sched_send(CollDesc_t *d, void *buf, int count,
+                        ULMType_t *type, int peer)
+{
+    CollOp_t *o = append(d, COLL_OP_SEND);
+
+    if (o == NULL) {
+        return d->error;
+    }
+    o->buf = buf;
+    o->count = count;
+    o->type = type;
+    o->peer = peer;
+
+    return ULM_SUCCESS;
+}
+
+
+int ulm_coll_sched_recv(CollDesc_t *d, void *buf, int count,
+                        ULMType_t *type, int peer)
+{
+    CollOp_t *o = append(d, COLL_OP_RECV);
+
+    if (o == NULL) {
+        return d->error;
+    }
+    o->buf = buf;
+    o->count = count;
+    o->type = type;
+    o->peer = peer;
+
+    return ULM_SUCCESS;
+}
+
+
+int ulm_coll_sched_copy(CollDesc_t *d, void *dest, int dest_count,
+                        ULMType_t *dest_type, void *src, int src_count,
+                        ULMType_t *src_type)
+{
+    CollOp_t *o = append(d, COLL_OP_COPY);
+
+    if (o == NULL) {
+        return d->error;
+    }
+    o->buf = dest;
+    o->count = dest_count;
+    o->type = dest_type;
+    o->src = src;
+    o->src_count = src_count;
+    o->src_type = src_type;
+
+    return ULM_SUCCESS;
+}
+
+
+int ulm_coll_sched_reduce(CollDesc_t *d, void *dest, void *src, int count,
+                          ULMType_t *type, int reverse)
+{
+    CollOp_t *o = append(d, COLL_OP_REDUCE);
+
+    if (o == NULL) {
+        return d->error;
+    }
+    o->buf = dest;
+    o->count = count;
+    o->type = type;
+    o->src = src;
+    o->reverse = reverse;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * close the current round: subsequent operations are not started
+ * until everything in it has completed
+ */
+int ulm_coll_sched_round(CollDesc_t *d)
+{
+    if (d->nrounds > 0 && d->rounds[d->nrounds - 1] == d->nops) {
+        /* current round is still empty */
+        return ULM_SUCCESS;
+    }
+    if (grow((void **) &d->rounds, &d->maxrounds, d->nrounds + 1,
+             sizeof(int)) != ULM_SUCCESS) {
+        d->error = ULM_ERR_OUT_OF_RESOURCE;
+        return d->error;
+    }
+    d->rounds[d->nrounds++] = d->nops;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * make room for the largest number of messages in any round
+ */
+static int reserve(CollDesc_t *d)
+{
+    int n;
+    int r;
+    int i;
+
+    for (r = 0; r < d->nrounds; r++) {
+        n = 0;
+        for (i = d->rounds[r]; i < round_end(d, r); i++) {
+            if (d->ops[i].kind == COLL_OP_SEND ||
+                d->ops[i].kind == COLL_OP_RECV) {
+                n++;
+            }
+        }
+        if (grow((void **) &d->req, &d->maxreq, n,
+                 sizeof(ULMRequest_t)) != ULM_SUCCESS) {
+            return ULM_ERR_OUT_OF_RESOURCE;
+        }
+    }
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * start (or restart) a schedule and return it as a request
+ */
+int ulm_coll_sched_start(CollDesc_t *d, ULMRequest_t *request)
+{
+
+    /* report any failure while the schedule was being built */
+    if (d->round < 0 && d->error != ULM_SUCCESS) {
+        return d->error;
+    }
+
+    /* a persistent schedule may not be restarted while still active */
+    if (d->status == ULM_STATUS_INCOMPLETE) {
+        return ULM_ERR_REQUEST;
+    }
+
+    if (d->req == NULL && reserve(d) != ULM_SUCCESS) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+
+    d->round = -1;
+    d->nreq = 0;
+    d->error = ULM_SUCCESS;
+    d->messageDone = REQUEST_INCOMPLETE;
+    d->status = ULM_STATUS_INCOMPLETE;
+    *request = (ULMRequest_t) d;
+
+    activeCollLock.lock();
+    if (!advance(d)) {
+        d->active = true;
+        activeColl.AppendNoLock(d);
+    }
+    activeCollLock.unlock();
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * are any schedules still active?
+ */
+bool ulm_coll_sched_pending(void)
+{
+    return (activeColl.size() != 0);
+}
+
+
+/*
+ * start a newly built schedule, releasing it on failure.  A
+ * persistent schedule is instead returned as an inactive request, to
+ * be started by ulm_start().
+ */
+int ulm_coll_sched_post(CollDesc_t *d, ULMRequest_t *request)
+{
+    int rc;
+
+    if (d->persistent) {
+        if (d->error == ULM_SUCCESS) {
+            d->error = reserve(d);
+        }
+        if (d->error != ULM_SUCCESS) {
+            rc = d->error;
+            d->persistent = false;
+            ulm_coll_sched_free(d);
+            return rc;
+        }
+        communicators[d->ctx_m]->refCounLock.lock();
+        (communicators[d->ctx_m]->requestRefCount)++;
+        communicators[d->ctx_m]->refCounLock.unlock();
+        d->messageDone = REQUEST_COMPLETE;
+        *request = (ULMRequest_t) d;
+        return ULM_SUCCESS;
+    }
+
+    rc = ulm_coll_sched_start(d, request);
+    if (rc != ULM_SUCCESS) {
+        ulm_coll_sched_free(d);
+    }
+
+    return rc;
+}
+
+
+/*
+ * advance all active schedules - called from ulm_make_progress().
+ * Calls made while the list is busy (from within a schedule's own
+ * sends and receives, or from another thread) return immediately.
+ */
+int ulm_coll_sched_progress(void)
+{
+    Links_t *l;
+    CollDesc_t *d;
+
+    if (activeColl.size() == 0) {
+        return ULM_SUCCESS;
+    }
+    if (!activeCollLock.trylock()) {
+        return ULM_SUCCESS;
+    }
+
+    for (l = (Links_t *) activeColl.begin(); l != activeColl.end();
+         l = (Links_t *) l->next) {
+        d = (CollDesc_t *) l;
+        if (advance(d)) {
+            d->active = false;
+            l = (Links_t *) activeColl.RemoveLinkNoLock(l);
+            if (d->freeCalled) {
+                destroy(d);
+            }
+        }
+    }
+
+    activeCollLock.unlock();
+
+    return ULM_SUCCESS;
+}
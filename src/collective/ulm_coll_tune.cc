@@ -0,0 +1,345 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "init/environ.h"
+#include "internal/log.h"
+#include "internal/malloc.h"
+#include "queue/globals.h"
+#include "collective/coll_tune.h"
+
+static const char *coll_name[COLL_TUNE_NCOLL] = {
+    "barrier", "bcast", "reduce", "allreduce", "alltoall", "allgather",
+    "scan"
+};
+
+static const char *alg_name[COLL_ALG_NALG] = {
+    "default", "linear", "p2p", "smp",
+    "bruck", "pairwise", "recursive_doubling", "ring", "pipeline"
+};
+
+/*
+ * algorithms implemented by each collective
+ */
+#define ALG(a) (1 << COLL_ALG_##a)
+static const int alg_valid[COLL_TUNE_NCOLL] = {
+    ALG(DEFAULT) | ALG(P2P) | ALG(SMP),
+    ALG(DEFAULT) | ALG(P2P) | ALG(SMP),
+    ALG(DEFAULT) | ALG(LINEAR) | ALG(P2P) | ALG(SMP),
+    ALG(DEFAULT) | ALG(LINEAR) | ALG(P2P) | ALG(SMP),
+    ALG(DEFAULT) | ALG(SMP) | ALG(BRUCK) | ALG(PAIRWISE),
+    ALG(DEFAULT) | ALG(SMP) | ALG(BRUCK) | ALG(RECURSIVE_DOUBLING) |
+    ALG(RING),
+    ALG(DEFAULT) | ALG(SMP) | ALG(RECURSIVE_DOUBLING) | ALG(PIPELINE)
+};
+#undef ALG
+
+/*
+ * rules read from the tuning file, and algorithms forced through
+ * ulm_coll_tune_force()
+ */
+static CollTuneRule_t *file_rule[COLL_TUNE_NCOLL];
+static int file_nrule[COLL_TUNE_NCOLL];
+static int file_maxrule[COLL_TUNE_NCOLL];
+static bool file_read = false;
+static int forced_alg[COLL_TUNE_NCOLL];
+static size_t forced_segsize[COLL_TUNE_NCOLL];
+
+
+static int lookup(const char *name, const char **table, int n)
+{
+    for (int i = 0; i < n; i++) {
+        if (strcmp(name, table[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/*
+ * parse a number, "lo-hi", "lo-*" or "*" into [*lo, *hi]
+ */
+static int parse_range(const char *s, size_t *lo, size_t *hi)
+{
+    char *end;
+
+    if (strcmp(s, "*") == 0) {
+        *lo = 0;
+        *hi = (size_t) -1;
+        return 0;
+    }
+    if (!isdigit(*s)) {
+        return -1;
+    }
+    *lo = *hi = strtoul(s, &end, 10);
+    if (*end == '\0') {
+        return 0;
+    }
+    if (*end++ != '-') {
+        return -1;
+    }
+    if (strcmp(end, "*") == 0) {
+        *hi = (size_t) -1;
+        return 0;
+    }
+    if (!isdigit(*end)) {
+        return -1;
+    }
+    *hi = strtoul(end, &end, 10);
+
+    return (*end == '\0' && *hi >= *lo) ? 0 : -1;
+}
+
+
+static int parse_int_range(const char *s, int *lo, int *hi)
+{
+    size_t l, h;
+
+    if (parse_range(s, &l, &h) != 0) {
+        return -1;
+    }
+    *lo = (int) l;
+    *hi = (h > 0x7fffffff) ? 0x7fffffff : (int) h;
+
+    return 0;
+}
+
+
+static int add_rule(CollTuneRule_t **rule, int *nrule, int *maxrule,
+                    CollTuneRule_t *r)
+{
+    if (*nrule == *maxrule) {
+        int newmax = *maxrule ? 2 * *maxrule : 8;
+        CollTuneRule_t *p;
+
+        p = (CollTuneRule_t *) ulm_malloc(newmax * sizeof(CollTuneRule_t));
+        if (p == NULL) {
+            return ULM_ERR_OUT_OF_RESOURCE;
+        }
+        if (*rule) {
+            memcpy(p, *rule, *nrule * sizeof(CollTuneRule_t));
+            ulm_free(*rule);
+        }
+        *rule = p;
+        *maxrule = newmax;
+    }
+    (*rule)[(*nrule)++] = *r;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * read the tuning file named by LAMPI_COLL_TUNE, if any
+ */
+static void read_file(void)
+{
+    char *filename;
+    char line[512];
+    FILE *fp;
+    int lineno;
+
+    file_read = true;
+
+    lampi_environ_find_string("LAMPI_COLL_TUNE", &filename);
+    if (filename == NULL || *filename == '\0') {
+        return;
+    }
+    fp = fopen(filename, "r");
+    if (fp == NULL) {
+        ulm_warn(("Warning: Cannot open collective tuning file %s\n",
+                  filename));
+        return;
+    }
+
+    lineno = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char *field[8];
+        char *p;
+        int coll, nfield;
+        CollTuneRule_t r;
+
+        lineno++;
+        if ((p = strchr(line, '#')) != NULL) {
+            *p = '\0';
+        }
+        nfield = 0;
+        for (p = strtok(line, " \t\r\n"); p && nfield < 8;
+             p = strtok(NULL, " \t\r\n")) {
+            field[nfield++] = p;
+        }
+        if (nfield == 0) {
+            continue;
+        }
+
+        coll = -1;
+        r.alg = -1;
+        if (nfield == 7) {
+            coll = lookup(field[0], coll_name, COLL_TUNE_NCOLL);
+            r.alg = lookup(field[1], alg_name, COLL_ALG_NALG);
+        }
+        if (coll < 0 || r.alg < 0 || !(alg_valid[coll] & (1 << r.alg)) ||
+            !isdigit(*field[2]) ||
+            parse_range(field[3], &r.min_bytes, &r.max_bytes) != 0 ||
+            parse_int_range(field[4], &r.min_procs, &r.max_procs) != 0 ||
+            parse_int_range(field[5], &r.min_hosts, &r.max_hosts) != 0 ||
+            parse_int_range(field[6], &r.min_ppn, &r.max_ppn) != 0) {
+            ulm_warn(("Warning: %s:%d: ignoring bad collective tuning rule\n",
+                      filename, lineno));
+            continue;
+        }
+        r.segsize = strtoul(field[2], NULL, 10);
+
+        if (add_rule(&file_rule[coll], &file_nrule[coll],
+                     &file_maxrule[coll], &r) != ULM_SUCCESS) {
+            break;
+        }
+    }
+
+    fclose(fp);
+}
+
+
+/*
+ * ulm_coll_tune_init - fill in the decision table of a communicator
+ * of nproc processes on nhost hosts, with at most ppn processes per
+ * host
+ */
+int ulm_coll_tune_init(CollTuneTable_t *table, int nproc, int nhost, int ppn)
+{
+    if (!file_read) {
+        read_file();
+    }
+
+    for (int coll = 0; coll < COLL_TUNE_NCOLL; coll++) {
+        int maxrule = 0;
+
+        table->nrule[coll] = 0;
+        table->rule[coll] = NULL;
+        for (int i = 0; i < file_nrule[coll]; i++) {
+            CollTuneRule_t *r = &file_rule[coll][i];
+
+            if (nproc < r->min_procs || nproc > r->max_procs ||
+                nhost < r->min_hosts || nhost > r->max_hosts ||
+                ppn < r->min_ppn || ppn > r->max_ppn) {
+                continue;
+            }
+            if (add_rule(&table->rule[coll], &table->nrule[coll],
+                         &maxrule, r) != ULM_SUCCESS) {
+                return ULM_ERR_OUT_OF_RESOURCE;
+            }
+        }
+    }
+
+    return ULM_SUCCESS;
+}
+
+
+void ulm_coll_tune_free(CollTuneTable_t *table)
+{
+    for (int coll = 0; coll < COLL_TUNE_NCOLL; coll++) {
+        if (table->rule[coll]) {
+            ulm_free(table->rule[coll]);
+            table->rule[coll] = NULL;
+        }
+        table->nrule[coll] = 0;
+    }
+}
+
+
+/*
+ * ulm_coll_decide - choose an algorithm
+ *
+ * \param communicator  The communicator
+ * \param coll          The collective (COLL_TUNE_*)
+ * \param bytes         Per-process message size in bytes
+ * \param segsize       Set to the segment size, or left unchanged if
+ *                      the built-in block size should be used; may
+ *                      be NULL
+ * \return              The algorithm (COLL_ALG_*)
+ */
+int ulm_coll_decide(Communicator *communicator, int coll, size_t bytes,
+                    size_t *segsize)
+{
+    CollTuneTable_t *table = &communicator->collectiveOpt.tune;
+    CollTuneRule_t *r;
+
+    if (forced_alg[coll] != COLL_ALG_DEFAULT || forced_segsize[coll]) {
+        if (segsize && forced_segsize[coll]) {
+            *segsize = forced_segsize[coll];
+        }
+        return forced_alg[coll];
+    }
+
+    for (int i = 0; i < table->nrule[coll]; i++) {
+        r = &table->rule[coll][i];
+        if (bytes >= r->min_bytes && bytes <= r->max_bytes) {
+            if (segsize && r->segsize) {
+                *segsize = r->segsize;
+            }
+            return r->alg;
+        }
+    }
+
+    return COLL_ALG_DEFAULT;
+}
+
+
+/*
+ * ulm_coll_tune_force - use algorithm alg with segment size segsize
+ * (0 for the built-in size) for all subsequent calls of collective
+ * coll, overriding the decision tables; alg NULL or "default"
+ * restores them.  Must be called with the same arguments by all
+ * processes.  Used by check/mpi-coll-bench to time each algorithm.
+ */
+extern "C" int ulm_coll_tune_force(const char *coll, const char *alg,
+                                   int segsize)
+{
+    int c, a;
+
+    c = lookup(coll, coll_name, COLL_TUNE_NCOLL);
+    a = alg ? lookup(alg, alg_name, COLL_ALG_NALG) : COLL_ALG_DEFAULT;
+    if (c < 0 || a < 0 || !(alg_valid[c] & (1 << a)) || segsize < 0) {
+        return ULM_ERR_BAD_PARAM;
+    }
+    forced_alg[c] = a;
+    forced_segsize[c] = alg ? segsize : 0;
+
+    return ULM_SUCCESS;
+}
@@ -36,9 +36,12 @@
 #endif
 
 #include "internal/mpi.h"
+#include "internal/malloc.h"
+#include "internal/type_copy.h"
 #include "queue/Communicator.h"
 #include "queue/globals.h"
 #include "internal/collective.h"
+#include "collective/coll_fns.h"
 
 int ulm_comm_get_collective(MPI_Comm comm, int key, void **func)
 {
@@ -69,6 +72,9 @@ int ulm_comm_get_collective(MPI_Comm comm, int key, void **func)
     case ULM_COLLECTIVE_BCAST:
         *func = (void *) communicator->collective.bcast;
         break;
+    case ULM_COLLECTIVE_EXSCAN:
+        *func = (void *) communicator->collective.exscan;
+        break;
     case ULM_COLLECTIVE_GATHER:
         *func = (void *) communicator->collective.gather;
         break;
@@ -81,6 +87,9 @@ int ulm_comm_get_collective(MPI_Comm comm, int key, void **func)
     case ULM_COLLECTIVE_REDUCE_SCATTER:
         *func = (void *) communicator->collective.reduce_scatter;
         break;
+    case ULM_COLLECTIVE_REDUCE_SCATTER_BLOCK:
+        *func = (void *) communicator->collective.reduce_scatter_block;
+        break;
     case ULM_COLLECTIVE_SCAN:
         *func = (void *) communicator->collective.scan;
         break;
@@ -97,3 +106,48 @@ int ulm_comm_get_collective(MPI_Comm comm, int key, void **func)
     return ULM_SUCCESS;
 }
 
+
+/*
+ * ulm_coll_pack_block - pack (or unpack) block number block of buf,
+ * count objects of type at offset block * count * extent, to (from)
+ * the contiguous byte buffer packed of size bytes
+ */
+void ulm_coll_pack_block(int pack, void *packed, size_t size,
+                         void *buf, int count, ULMType_t *type, int block)
+{
+    size_t offset = 0;
+    size_t ti = 0;
+    size_t mi = 0;
+    size_t mo = 0;
+
+    type_pack(pack, packed, size, &offset,
+              (unsigned char *) buf + (size_t) block * count * type->extent,
+              count, type, &ti, &mi, &mo);
+}
+
+
+/*
+ * ulm_coll_copy - local copy between buffers of possibly different
+ * types with the same type signature
+ */
+int ulm_coll_copy(void *dest, int dest_count, ULMType_t *dest_type,
+                  void *src, int src_count, ULMType_t *src_type)
+{
+    size_t size = src_count * src_type->packed_size;
+    unsigned char *tmp;
+
+    if (src_type == dest_type && src_count == dest_count) {
+        type_copy(dest, src, src_count, src_type);
+        return ULM_SUCCESS;
+    }
+
+    tmp = (unsigned char *) ulm_malloc(size);
+    if (tmp == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    ulm_coll_pack_block(TYPE_PACK_PACK, tmp, size, src, src_count, src_type, 0);
+    ulm_coll_pack_block(TYPE_PACK_UNPACK, tmp, size, dest, dest_count, dest_type, 0);
+    ulm_free(tmp);
+
+    return ULM_SUCCESS;
+}
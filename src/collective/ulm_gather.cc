@@ -462,6 +462,7 @@ extern "C" int ulm_gather(void *sendbuf, int sendcount,
                           int recvcount, ULMType_t *recvtype, int root,
                           int comm)
 {
+    extern ulm_gather_t ulm_gather_p2p;
     int returnCode = ULM_SUCCESS;
     Communicator *commPtr = (Communicator *) communicators[comm];
     int numHosts = commPtr->localGroup->numberOfHostsInGroup;
@@ -490,8 +491,15 @@ extern "C" int ulm_gather(void *sendbuf, int sendcount,
         dataToSend[host] = totalBytes;
     }
 
-    /* decide which algorithm to use */
-    if (numStripes > 1) {
+    /*
+     * decide which algorithm to use: with one process per host there
+     * is nothing to gain from staging through shared memory
+     */
+    if (numHosts > 1 && commPtr->localGroup->maxOnHostGroupSize == 1) {
+        returnCode =
+            ulm_gather_p2p(sendbuf, sendcount, sendtype, recvbuf,
+                           recvcount, recvtype, root, comm);
+    } else if (numStripes > 1) {
         numStripes =
             ((maxBytesPerProc -
               1) / commPtr->collectiveOpt.perRankStripeSize) + 1;
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal/log.h"
+#include "internal/mpi.h"
+#include "queue/globals.h"
+#include "collective/coll_sched.h"
+
+/*!
+ * iallgather - build an allgather schedule, started now or, if persistent, on
+ * each ulm_start()
+ *
+ * \param sendbuf       Send buffer
+ * \param sendcount     Number of objects sent
+ * \param sendtype      Data type of send objects
+ * \param recvbuf       Receive buffer
+ * \param recvcount     Number of objects received from each process
+ * \param recvtype      Data type of receive objects
+ * \param comm          The communicator ID
+ * \param request       Request handle, completed by ulm_wait/ulm_test
+ * \param persistent    Return an inactive persistent request
+ * \return              ULM error code
+ *
+ * Algorithm
+ *
+ * Blocks move directly between receive buffers.  For a power of two
+ * number of processes, recursive doubling: in round k exchange the
+ * 2^k blocks gathered so far with self ^ 2^k.  Otherwise a ring: in
+ * round k pass block self - k to the right and receive block
+ * self - k - 1 from the left.
+ */
+static int iallgather(void *sendbuf, int sendcount,
+                      ULMType_t *sendtype, void *recvbuf,
+                      int recvcount, ULMType_t *recvtype,
+                      int comm, ULMRequest_t *request,
+                      bool persistent)
+{
+    CollDesc_t *d;
+    size_t size;
+    unsigned char *r;
+    int block;
+    int mask;
+    int nproc;
+    int peer;
+    int rc;
+    int self;
+    int step;
+
+    ulm_dbg(("ulm_iallgather\n"));
+
+    rc = ulm_coll_sched_alloc(comm, &d);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    d->persistent = persistent;
+    ulm_coll_sched_retain(d, sendtype, recvtype);
+
+    nproc = communicators[comm]->localGroup->groupSize;
+    self = communicators[comm]->localGroup->ProcID;
+    r = (unsigned char *) recvbuf;
+    size = recvcount * recvtype->extent;
+
+    if (sendbuf != MPI_IN_PLACE) {
+        ulm_coll_sched_copy(d, r + self * size, recvcount, recvtype,
+                            sendbuf, sendcount, sendtype);
+    }
+
+    if ((nproc & (nproc - 1)) == 0) {
+        for (mask = 1; mask < nproc; mask <<= 1) {
+            peer = self ^ mask;
+            block = peer & ~(mask - 1);
+            ulm_coll_sched_recv(d, r + block * size, mask * recvcount,
+                                recvtype, peer);
+            block = self & ~(mask - 1);
+            ulm_coll_sched_send(d, r + block * size, mask * recvcount,
+                                recvtype, peer);
+            ulm_coll_sched_round(d);
+        }
+    } else {
+        for (step = 0; step < nproc - 1; step++) {
+            block = (self - step - 1 + nproc) % nproc;
+            ulm_coll_sched_recv(d, r + block * size, recvcount, recvtype,
+                                (self - 1 + nproc) % nproc);
+            block = (self - step + nproc) % nproc;
+            ulm_coll_sched_send(d, r + block * size, recvcount, recvtype,
+                                (self + 1) % nproc);
+            ulm_coll_sched_round(d);
+        }
+    }
+
+    return ulm_coll_sched_post(d, request);
+}
+
+
+extern "C" int ulm_iallgather(void *sendbuf, int sendcount,
+                              ULMType_t *sendtype, void *recvbuf,
+                              int recvcount, ULMType_t *recvtype,
+                              int comm, ULMRequest_t *request)
+{
+    return iallgather(sendbuf, sendcount, sendtype, recvbuf, recvcount,
+                      recvtype, comm, request, false);
+}
+
+
+/*
+ * ulm_allgather_init - persistent allgather: the schedule is built once and
+ * replayed by each ulm_start()
+ */
+extern "C" int ulm_allgather_init(void *sendbuf, int sendcount,
+                                  ULMType_t *sendtype, void *recvbuf,
+                                  int recvcount, ULMType_t *recvtype,
+                                  int comm, ULMRequest_t *request)
+{
+    return iallgather(sendbuf, sendcount, sendtype, recvbuf, recvcount,
+                      recvtype, comm, request, true);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal/log.h"
+#include "internal/mpi.h"
+#include "queue/globals.h"
+#include "collective/coll_sched.h"
+
+/*!
+ * iallreduce - build an allreduce schedule, started now or, if persistent, on
+ * each ulm_start()
+ *
+ * \param sendbuf       Initial data
+ * \param recvbuf       Buffer to receive the reduced data
+ * \param count         Number of objects
+ * \param type          Data type of objects
+ * \param op            Operation operation
+ * \param comm          The communicator ID
+ * \param request       Request handle, completed by ulm_wait/ulm_test
+ * \param persistent    Return an inactive persistent request
+ * \return              ULM error code
+ *
+ * Algorithm
+ *
+ * For a power of two number of processes, recursive doubling: in
+ * round k exchange partial results with self ^ 2^k and combine them,
+ * lower ranks first.  Otherwise a binomial tree reduce to process 0
+ * followed by a binomial tree broadcast.
+ */
+static int iallreduce(void *sendbuf, void *recvbuf, int count,
+                      ULMType_t *type, ULMOp_t *op, int comm,
+                      ULMRequest_t *request,
+                      bool persistent)
+{
+    CollDesc_t *d;
+    void *tmp;
+    int mask;
+    int nproc;
+    int peer;
+    int rc;
+    int self;
+
+    ulm_dbg(("ulm_iallreduce\n"));
+
+    if (op->isbasic && type->isbasic == 0) {
+        ulm_err(("Error: ulm_iallreduce: "
+                 "basic operation, non-basic datatype\n"));
+        return ULM_ERR_BAD_PARAM;
+    }
+
+    rc = ulm_coll_sched_alloc(comm, &d);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    d->persistent = persistent;
+    ulm_coll_sched_retain(d, type, NULL);
+    d->op = op;
+
+    nproc = communicators[comm]->localGroup->groupSize;
+    self = communicators[comm]->localGroup->ProcID;
+
+    if (count == 0) {
+        return ulm_coll_sched_post(d, request);
+    }
+
+    if ((nproc & (nproc - 1)) == 0) {
+        if (sendbuf != MPI_IN_PLACE) {
+            ulm_coll_sched_copy(d, recvbuf, count, type,
+                                sendbuf, count, type);
+        }
+        tmp = ulm_coll_sched_scratch(d, count * type->extent);
+        for (mask = 1; mask < nproc; mask <<= 1) {
+            peer = self ^ mask;
+            ulm_coll_sched_recv(d, tmp, count, type, peer);
+            ulm_coll_sched_send(d, recvbuf, count, type, peer);
+            ulm_coll_sched_round(d);
+            ulm_coll_sched_reduce(d, recvbuf, tmp, count, type,
+                                  !op->commute && peer > self);
+        }
+    } else {
+        ulm_coll_sched_reduce_tree(d, sendbuf, recvbuf, count, type, 0);
+        ulm_coll_sched_bcast_tree(d, recvbuf, count, type, 0);
+    }
+
+    return ulm_coll_sched_post(d, request);
+}
+
+
+extern "C" int ulm_iallreduce(void *sendbuf, void *recvbuf, int count,
+                              ULMType_t *type, ULMOp_t *op, int comm,
+                              ULMRequest_t *request)
+{
+    return iallreduce(sendbuf, recvbuf, count, type, op, comm, request, false);
+}
+
+
+/*
+ * ulm_allreduce_init - persistent allreduce: the schedule is built once and
+ * replayed by each ulm_start()
+ */
+extern "C" int ulm_allreduce_init(void *sendbuf, void *recvbuf, int count,
+                                  ULMType_t *type, ULMOp_t *op, int comm,
+                                  ULMRequest_t *request)
+{
+    return iallreduce(sendbuf, recvbuf, count, type, op, comm, request, true);
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal/log.h"
+#include "queue/globals.h"
+#include "collective/coll_sched.h"
+
+/*!
+ * ialltoall - build an alltoall schedule, started now or, if persistent, on
+ * each ulm_start()
+ *
+ * \param sendbuf       Send buffer
+ * \param sendcount     Number of objects sent to each process
+ * \param sendtype      Data type of send objects
+ * \param recvbuf       Receive buffer
+ * \param recvcount     Number of objects received from each process
+ * \param recvtype      Data type of receive objects
+ * \param comm          The communicator ID
+ * \param request       Request handle, completed by ulm_wait/ulm_test
+ * \param persistent    Return an inactive persistent request
+ * \return              ULM error code
+ *
+ * Algorithm
+ *
+ * Pairwise exchange: at step s send to self + s and receive from
+ * self - s.  Steps are grouped into rounds of IALLTOALL_WINDOW to
+ * bound the number of messages in flight.
+ */
+static int ialltoall(void *sendbuf, int sendcount,
+                     ULMType_t *sendtype, void *recvbuf,
+                     int recvcount, ULMType_t *recvtype,
+                     int comm, ULMRequest_t *request,
+                     bool persistent)
+{
+    enum {
+        IALLTOALL_WINDOW = 8
+    };
+
+    CollDesc_t *d;
+    size_t rsize;
+    size_t ssize;
+    unsigned char *r;
+    unsigned char *s;
+    int nproc;
+    int peer;
+    int rc;
+    int self;
+    int step;
+
+    ulm_dbg(("ulm_ialltoall\n"));
+
+    rc = ulm_coll_sched_alloc(comm, &d);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    d->persistent = persistent;
+    ulm_coll_sched_retain(d, sendtype, recvtype);
+
+    nproc = communicators[comm]->localGroup->groupSize;
+    self = communicators[comm]->localGroup->ProcID;
+    s = (unsigned char *) sendbuf;
+    r = (unsigned char *) recvbuf;
+    ssize = sendcount * sendtype->extent;
+    rsize = recvcount * recvtype->extent;
+
+    ulm_coll_sched_copy(d, r + self * rsize, recvcount, recvtype,
+                        s + self * ssize, sendcount, sendtype);
+    for (step = 1; step < nproc; step++) {
+        peer = (self - step + nproc) % nproc;
+        ulm_coll_sched_recv(d, r + peer * rsize, recvcount, recvtype, peer);
+        peer = (self + step) % nproc;
+        ulm_coll_sched_send(d, s + peer * ssize, sendcount, sendtype, peer);
+        if (step % IALLTOALL_WINDOW == 0) {
+            ulm_coll_sched_round(d);
+        }
+    }
+
+    return ulm_coll_sched_post(d, request);
+}
+
+
+extern "C" int ulm_ialltoall(void *sendbuf, int sendcount,
+                             ULMType_t *sendtype, void *recvbuf,
+                             int recvcount, ULMType_t *recvtype,
+                             int comm, ULMRequest_t *request)
+{
+    return ialltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount,
+                     recvtype, comm, request, false);
+}
+
+
+/*
+ * ulm_alltoall_init - persistent alltoall: the schedule is built once and
+ * replayed by each ulm_start()
+ */
+extern "C" int ulm_alltoall_init(void *sendbuf, int sendcount,
+                                 ULMType_t *sendtype, void *recvbuf,
+                                 int recvcount, ULMType_t *recvtype,
+                                 int comm, ULMRequest_t *request)
+{
+    return ialltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount,
+                     recvtype, comm, request, true);
+}
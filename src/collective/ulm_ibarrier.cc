@@ -0,0 +1,76 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal/log.h"
+#include "queue/globals.h"
+#include "collective/coll_sched.h"
+
+/*!
+ * ulm_ibarrier - non-blocking barrier
+ *
+ * \param comm          The communicator ID
+ * \param request       Request handle, completed by ulm_wait/ulm_test
+ * \return              ULM error code
+ *
+ * Algorithm
+ *
+ * Dissemination: in round k every process sends a zero-byte message
+ * to self + 2^k and receives one from self - 2^k.
+ */
+extern "C" int ulm_ibarrier(int comm, ULMRequest_t *request)
+{
+    CollDesc_t *d;
+    int mask;
+    int nproc;
+    int rc;
+    int self;
+
+    ulm_dbg(("ulm_ibarrier\n"));
+
+    rc = ulm_coll_sched_alloc(comm, &d);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+
+    nproc = communicators[comm]->localGroup->groupSize;
+    self = communicators[comm]->localGroup->ProcID;
+
+    for (mask = 1; mask < nproc; mask <<= 1) {
+        ulm_coll_sched_recv(d, NULL, 0, NULL, (self - mask + nproc) % nproc);
+        ulm_coll_sched_send(d, NULL, 0, NULL, (self + mask) % nproc);
+        ulm_coll_sched_round(d);
+    }
+
+    return ulm_coll_sched_post(d, request);
+}
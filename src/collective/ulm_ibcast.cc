@@ -0,0 +1,129 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal/log.h"
+#include "queue/globals.h"
+#include "collective/coll_sched.h"
+
+/*
+ * ulm_coll_sched_bcast_tree - append a binomial tree broadcast of buf
+ * from root to schedule d: one round receiving from the parent, and
+ * one sending to the children, largest subtree first
+ */
+void ulm_coll_sched_bcast_tree(CollDesc_t *d, void *buf, int count,
+                               ULMType_t *type, int root)
+{
+    int mask;
+    int nproc;
+    int self;
+    int self_r;
+
+    nproc = communicators[d->ctx_m]->localGroup->groupSize;
+    self = communicators[d->ctx_m]->localGroup->ProcID;
+    self_r = (self - root + nproc) % nproc;
+
+    if (count == 0 || nproc == 1) {
+        return;
+    }
+
+    for (mask = 1; mask < nproc; mask <<= 1) {
+        if (self_r & mask) {
+            ulm_coll_sched_recv(d, buf, count, type,
+                                (self_r - mask + root) % nproc);
+            break;
+        }
+    }
+    ulm_coll_sched_round(d);
+
+    for (mask >>= 1; mask > 0; mask >>= 1) {
+        if (self_r + mask < nproc) {
+            ulm_coll_sched_send(d, buf, count, type,
+                                (self_r + mask + root) % nproc);
+        }
+    }
+    ulm_coll_sched_round(d);
+}
+
+
+/*!
+ * ibcast - build a broadcast schedule, started now or, if persistent, on
+ * each ulm_start()
+ *
+ * \param buf           Data buffer
+ * \param count         Number of objects
+ * \param type          Data type of objects
+ * \param root          The the root process
+ * \param comm          The communicator ID
+ * \param request       Request handle, completed by ulm_wait/ulm_test
+ * \param persistent    Return an inactive persistent request
+ * \return              ULM error code
+ */
+static int ibcast(void *buf, int count, ULMType_t *type,
+                  int root, int comm, ULMRequest_t *request,
+                  bool persistent)
+{
+    CollDesc_t *d;
+    int rc;
+
+    ulm_dbg(("ulm_ibcast\n"));
+
+    rc = ulm_coll_sched_alloc(comm, &d);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    d->persistent = persistent;
+    ulm_coll_sched_retain(d, type, NULL);
+
+    ulm_coll_sched_bcast_tree(d, buf, count, type, root);
+
+    return ulm_coll_sched_post(d, request);
+}
+
+
+extern "C" int ulm_ibcast(void *buf, int count, ULMType_t *type,
+                          int root, int comm, ULMRequest_t *request)
+{
+    return ibcast(buf, count, type, root, comm, request, false);
+}
+
+
+/*
+ * ulm_bcast_init - persistent broadcast: the schedule is built once and
+ * replayed by each ulm_start()
+ */
+extern "C" int ulm_bcast_init(void *buf, int count, ULMType_t *type,
+                              int root, int comm, ULMRequest_t *request)
+{
+    return ibcast(buf, count, type, root, comm, request, true);
+}
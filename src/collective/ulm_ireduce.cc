@@ -0,0 +1,207 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal/log.h"
+#include "internal/mpi.h"
+#include "queue/globals.h"
+#include "collective/coll_sched.h"
+
+/*
+ * ulm_coll_sched_reduce_tree - append a binomial tree reduction to
+ * root to schedule d, using the operation d->op.
+ *
+ * Each process receives its children's partial results in one round
+ * and combines them and sends its own to the parent in the next.  A
+ * non-commutative operation is reduced in rank order on a tree rooted
+ * at process 0, which then forwards the result to root.
+ */
+void ulm_coll_sched_reduce_tree(CollDesc_t *d, void *sendbuf,
+                                void *recvbuf, int count,
+                                ULMType_t *type, int root)
+{
+    ULMOp_t *op = d->op;
+    size_t size;
+    unsigned char *tmp;
+    void *acc;
+    void *src;
+    int mask;
+    int nchild;
+    int nproc;
+    int self;
+    int self_r;
+    int vroot;
+
+    nproc = communicators[d->ctx_m]->localGroup->groupSize;
+    self = communicators[d->ctx_m]->localGroup->ProcID;
+    vroot = op->commute ? root : 0;
+    self_r = (self - vroot + nproc) % nproc;
+    src = (sendbuf == MPI_IN_PLACE) ? recvbuf : sendbuf;
+
+    if (count == 0) {
+        return;
+    }
+
+    nchild = 0;
+    for (mask = 1; mask < nproc; mask <<= 1) {
+        if (self_r & mask) {
+            break;
+        }
+        if (self_r + mask < nproc) {
+            nchild++;
+        }
+    }
+
+    /*
+     * The result accumulates in recvbuf at the root and in scratch
+     * space elsewhere, followed by space for each child's data
+     */
+    size = count * type->extent;
+    if (self == root && root == vroot) {
+        acc = recvbuf;
+        tmp = (unsigned char *) ulm_coll_sched_scratch(d, nchild * size);
+    } else {
+        tmp = (unsigned char *) ulm_coll_sched_scratch(d, (nchild + 1) * size);
+        acc = tmp;
+        tmp += size;
+    }
+    if (tmp == NULL) {
+        return;
+    }
+
+    if (acc != src) {
+        ulm_coll_sched_copy(d, acc, count, type, src, count, type);
+    }
+    for (mask = 1, nchild = 0; mask < nproc; mask <<= 1) {
+        if (self_r & mask) {
+            break;
+        }
+        if (self_r + mask < nproc) {
+            ulm_coll_sched_recv(d, tmp + nchild * size, count, type,
+                                (self_r + mask + vroot) % nproc);
+            nchild++;
+        }
+    }
+    ulm_coll_sched_round(d);
+
+    /* children hold successively higher ranks */
+    for (mask = 1, nchild = 0; mask < nproc; mask <<= 1) {
+        if (self_r & mask) {
+            ulm_coll_sched_send(d, acc, count, type,
+                                (self_r - mask + vroot) % nproc);
+            break;
+        }
+        if (self_r + mask < nproc) {
+            ulm_coll_sched_reduce(d, acc, tmp + nchild * size, count, type,
+                                  !op->commute);
+            nchild++;
+        }
+    }
+    ulm_coll_sched_round(d);
+
+    if (root != vroot) {
+        if (self == vroot) {
+            ulm_coll_sched_send(d, acc, count, type, root);
+        } else if (self == root) {
+            ulm_coll_sched_recv(d, recvbuf, count, type, vroot);
+        }
+        ulm_coll_sched_round(d);
+    }
+}
+
+
+/*!
+ * ireduce - build a reduce schedule, started now or, if persistent, on
+ * each ulm_start()
+ *
+ * \param sendbuf       Initial data
+ * \param recvbuf       Buffer to receive the reduced data
+ * \param count         Number of objects
+ * \param type          Data type of objects
+ * \param op            Operation operation
+ * \param root          The the root process
+ * \param comm          The communicator ID
+ * \param request       Request handle, completed by ulm_wait/ulm_test
+ * \param persistent    Return an inactive persistent request
+ * \return              ULM error code
+ */
+static int ireduce(void *sendbuf, void *recvbuf, int count,
+                   ULMType_t *type, ULMOp_t *op, int root,
+                   int comm, ULMRequest_t *request,
+                   bool persistent)
+{
+    CollDesc_t *d;
+    int rc;
+
+    ulm_dbg(("ulm_ireduce\n"));
+
+    if (op->isbasic && type->isbasic == 0) {
+        ulm_err(("Error: ulm_ireduce: "
+                 "basic operation, non-basic datatype\n"));
+        return ULM_ERR_BAD_PARAM;
+    }
+
+    rc = ulm_coll_sched_alloc(comm, &d);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    d->persistent = persistent;
+    ulm_coll_sched_retain(d, type, NULL);
+    d->op = op;
+
+    ulm_coll_sched_reduce_tree(d, sendbuf, recvbuf, count, type, root);
+
+    return ulm_coll_sched_post(d, request);
+}
+
+
+extern "C" int ulm_ireduce(void *sendbuf, void *recvbuf, int count,
+                           ULMType_t *type, ULMOp_t *op, int root,
+                           int comm, ULMRequest_t *request)
+{
+    return ireduce(sendbuf, recvbuf, count, type, op, root, comm,
+                   request, false);
+}
+
+
+/*
+ * ulm_reduce_init - persistent reduce: the schedule is built once and
+ * replayed by each ulm_start()
+ */
+extern "C" int ulm_reduce_init(void *sendbuf, void *recvbuf, int count,
+                               ULMType_t *type, ULMOp_t *op, int root,
+                               int comm, ULMRequest_t *request)
+{
+    return ireduce(sendbuf, recvbuf, count, type, op, root, comm,
+                   request, true);
+}
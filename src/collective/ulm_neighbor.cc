@@ -0,0 +1,698 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal/mpi.h"
+#include "internal/log.h"
+#include "internal/malloc.h"
+#include "internal/type_copy.h"
+#include "queue/globals.h"
+#include "collective/coll_fns.h"
+#include "collective/coll_neighbor.h"
+
+/*
+ * neighbors - fill nbr with the neighbor in each slot of process rank
+ * and return the number of slots
+ */
+static int neighbors(ULMTopology_t *topo, int rank, int *nbr)
+{
+    int n = 0;
+
+    if (topo->type == MPI_CART) {
+        int stride = topo->cart.nnodes;
+        int d;
+
+        for (d = 0; d < topo->cart.ndims; d++) {
+            int dim = topo->cart.dims[d];
+            int coord;
+            int c;
+
+            stride /= dim;
+            coord = (rank / stride) % dim;
+            for (c = coord - 1; c <= coord + 1; c += 2) {
+                if (c >= 0 && c < dim) {
+                    nbr[n++] = rank + (c - coord) * stride;
+                } else if (topo->cart.periods[d]) {
+                    nbr[n++] = rank + ((c + dim) % dim - coord) * stride;
+                } else {
+                    nbr[n++] = MPI_PROC_NULL;
+                }
+            }
+        }
+    } else {
+        int i = (rank == 0) ? 0 : topo->graph.index[rank - 1];
+
+        for (; i < topo->graph.index[rank]; i++) {
+            nbr[n++] = topo->graph.edges[i];
+        }
+    }
+
+    return n;
+}
+
+
+/*
+ * pair - the slot of neighbor nbr[k] of process rank that pairs with
+ * slot k, or -1 if none does.  In a graph, the i-th occurrence of q
+ * among the neighbors of rank pairs with the i-th occurrence of rank
+ * among the neighbors of q.  tmp must hold maxdeg ints.
+ */
+static int pair(ULMTopology_t *topo, int rank, int *nbr, int k, int *tmp)
+{
+    int q = nbr[k];
+    int i;
+    int j;
+    int n;
+
+    if (q == MPI_PROC_NULL) {
+        return -1;
+    }
+    if (topo->type == MPI_CART) {
+        return k ^ 1;
+    }
+
+    i = 0;
+    for (j = 0; j < k; j++) {
+        if (nbr[j] == q) {
+            i++;
+        }
+    }
+    n = neighbors(topo, q, tmp);
+    for (j = 0; j < n; j++) {
+        if (tmp[j] == rank && i-- == 0) {
+            return j;
+        }
+    }
+
+    return -1;
+}
+
+
+/*
+ * route - find how process origin sends its blocks to processes on
+ * host: returns the number of such blocks and sets *proxy to the
+ * process that receives them if they are aggregated
+ */
+static int route(ULMTopology_t *topo, int origin, int host, int *hostid,
+                 int *nbr, int *tmp, int *proxy)
+{
+    int count = 0;
+    int n;
+    int k;
+
+    *proxy = -1;
+    n = neighbors(topo, origin, nbr);
+    for (k = 0; k < n; k++) {
+        if (nbr[k] != MPI_PROC_NULL && nbr[k] != origin &&
+            hostid[nbr[k]] == host && pair(topo, origin, nbr, k, tmp) >= 0) {
+            count++;
+            if (*proxy < 0 || nbr[k] < *proxy) {
+                *proxy = nbr[k];
+            }
+        }
+    }
+
+    return count;
+}
+
+
+static int int_compare(const void *a, const void *b)
+{
+    return *(const int *) a - *(const int *) b;
+}
+
+
+/*
+ * build_plan - work out the slots, pairing and message routes of
+ * process self
+ */
+static int build_plan(NbrPlan_t *plan, ULMTopology_t *topo, int self,
+                      int *hostid)
+{
+    int *lq;
+    int *tmp;
+    int *host;
+    int maxdeg;
+    int n;
+    int i;
+    int j;
+    int k;
+
+    if (topo->type == MPI_CART) {
+        maxdeg = 2 * topo->cart.ndims;
+    } else {
+        maxdeg = 0;
+        for (i = 0; i < topo->graph.nnodes; i++) {
+            n = topo->graph.index[i] - (i ? topo->graph.index[i - 1] : 0);
+            maxdeg = (n > maxdeg) ? n : maxdeg;
+        }
+    }
+    plan->maxdeg = maxdeg;
+
+    /* one allocation serves the per-slot arrays and scratch space */
+    plan->nbr = (int *) ulm_malloc(12 * (maxdeg + 1) * sizeof(int));
+    if (plan->nbr == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    plan->peer = plan->nbr + (maxdeg + 1);
+    plan->send_mode = plan->peer + (maxdeg + 1);
+    plan->recv_mode = plan->send_mode + (maxdeg + 1);
+    plan->out_proxy = plan->recv_mode + (maxdeg + 1);
+    plan->out_start = plan->out_proxy + (maxdeg + 1);
+    plan->out_slot = plan->out_start + (maxdeg + 1);
+    plan->fwd_slot = plan->out_slot + (maxdeg + 1);
+    plan->fwd_proxy = plan->fwd_slot + (maxdeg + 1);
+    lq = plan->fwd_proxy + (maxdeg + 1);
+    tmp = lq + (maxdeg + 1);
+    host = tmp + (maxdeg + 1);
+
+    n = plan->nslot = neighbors(topo, self, plan->nbr);
+    for (j = 0; j < n; j++) {
+        plan->peer[j] = pair(topo, self, plan->nbr, j, tmp);
+    }
+
+    /* sends: aggregate when more than one block goes to a remote host */
+    plan->nout = 0;
+    for (j = 0; j < n; j++) {
+        int q = plan->nbr[j];
+
+        if (plan->peer[j] < 0) {
+            plan->send_mode[j] = NBR_NONE;
+        } else if (q == self) {
+            plan->send_mode[j] = NBR_SELF;
+        } else if (hostid[q] == hostid[self]) {
+            plan->send_mode[j] = NBR_DIRECT;
+        } else {
+            int proxy = q;
+            int c = 0;
+
+            for (k = 0; k < n; k++) {
+                if (plan->peer[k] >= 0 && plan->nbr[k] != self &&
+                    hostid[plan->nbr[k]] == hostid[q]) {
+                    c++;
+                    proxy = (plan->nbr[k] < proxy) ? plan->nbr[k] : proxy;
+                }
+            }
+            plan->send_mode[j] = (c > 1) ? NBR_AGGREGATE : NBR_DIRECT;
+            if (c > 1) {
+                for (i = 0; i < plan->nout; i++) {
+                    if (plan->out_proxy[i] == proxy) {
+                        break;
+                    }
+                }
+                if (i == plan->nout) {
+                    plan->out_proxy[plan->nout++] = proxy;
+                }
+                host[j] = i;
+            }
+        }
+    }
+    k = 0;
+    for (i = 0; i < plan->nout; i++) {
+        plan->out_start[i] = k;
+        for (j = 0; j < n; j++) {
+            if (plan->send_mode[j] == NBR_AGGREGATE && host[j] == i) {
+                plan->out_slot[k++] = j;
+            }
+        }
+    }
+    plan->out_start[plan->nout] = k;
+
+    /* receives: ask how each remote neighbor routes to this host */
+    plan->nfwd = 0;
+    for (j = 0; j < n; j++) {
+        int s = plan->nbr[j];
+        int proxy;
+
+        if (plan->peer[j] < 0) {
+            plan->recv_mode[j] = NBR_NONE;
+        } else if (s == self) {
+            plan->recv_mode[j] = NBR_SELF;
+        } else if (hostid[s] == hostid[self]) {
+            plan->recv_mode[j] = NBR_DIRECT;
+        } else if (route(topo, s, hostid[self], hostid, lq, tmp, &proxy) < 2) {
+            plan->recv_mode[j] = NBR_DIRECT;
+        } else if (proxy == self) {
+            plan->recv_mode[j] = NBR_AGGREGATE;
+        } else {
+            plan->recv_mode[j] = NBR_FORWARD;
+            plan->fwd_slot[plan->nfwd] = j;
+            plan->fwd_proxy[plan->nfwd++] = proxy;
+        }
+    }
+
+    /* proxies forward in order of origin, then the origin's slot */
+    for (i = 1; i < plan->nfwd; i++) {
+        int f = plan->fwd_slot[i];
+        int proxy = plan->fwd_proxy[i];
+
+        for (k = i; k > 0; k--) {
+            int g = plan->fwd_slot[k - 1];
+
+            if (plan->nbr[g] < plan->nbr[f] ||
+                (plan->nbr[g] == plan->nbr[f] &&
+                 plan->peer[g] < plan->peer[f])) {
+                break;
+            }
+            plan->fwd_slot[k] = g;
+            plan->fwd_proxy[k] = plan->fwd_proxy[k - 1];
+        }
+        plan->fwd_slot[k] = f;
+        plan->fwd_proxy[k] = proxy;
+    }
+
+    /* blocks received as proxy */
+    plan->in_origin = (int *) ulm_malloc((n + 1) * sizeof(int));
+    if (plan->in_origin == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    plan->nin = 0;
+    for (j = 0; j < n; j++) {
+        if (plan->recv_mode[j] == NBR_AGGREGATE) {
+            for (i = 0; i < plan->nin; i++) {
+                if (plan->in_origin[i] == plan->nbr[j]) {
+                    break;
+                }
+            }
+            if (i == plan->nin) {
+                plan->in_origin[plan->nin++] = plan->nbr[j];
+            }
+        }
+    }
+    plan->in_start = (int *) ulm_malloc((plan->nin + 1) * sizeof(int));
+    plan->in_target = (int *) ulm_malloc((plan->nin * maxdeg + 1) * sizeof(int));
+    plan->in_slot = (int *) ulm_malloc((plan->nin * maxdeg + 1) * sizeof(int));
+    if (plan->in_start == NULL || plan->in_target == NULL ||
+        plan->in_slot == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    qsort(plan->in_origin, plan->nin, sizeof(int), int_compare);
+    plan->nforward = 0;
+    k = 0;
+    for (i = 0; i < plan->nin; i++) {
+        int s = plan->in_origin[i];
+        int ns = neighbors(topo, s, lq);
+        int m;
+
+        plan->in_start[i] = k;
+        for (m = 0; m < ns; m++) {
+            int t = lq[m];
+            int slot;
+
+            if (t == MPI_PROC_NULL || t == s || hostid[t] != hostid[self]) {
+                continue;
+            }
+            slot = pair(topo, s, lq, m, tmp);
+            if (slot < 0) {
+                continue;
+            }
+            plan->in_target[k] = t;
+            plan->in_slot[k] = slot;
+            if (t != self) {
+                plan->nforward++;
+            }
+            k++;
+        }
+    }
+    plan->in_start[plan->nin] = k;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * ulm_neighbor_plan - return the neighborhood plan of a communicator,
+ * building it on first use
+ */
+int ulm_neighbor_plan(Communicator *communicator, NbrPlan_t **plan)
+{
+    NbrPlan_t *p;
+    int rc;
+
+    if (communicator->neighborPlan != NULL) {
+        *plan = communicator->neighborPlan;
+        return ULM_SUCCESS;
+    }
+
+    if (communicator->topology == NULL) {
+        return ULM_ERR_BAD_PARAM;
+    }
+
+    p = (NbrPlan_t *) ulm_malloc(sizeof(NbrPlan_t));
+    if (p == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    memset(p, 0, sizeof(NbrPlan_t));
+
+    rc = build_plan(p, communicator->topology,
+                    communicator->localGroup->ProcID,
+                    communicator->localGroup->mapGroupProcIDToHostID);
+    if (rc != ULM_SUCCESS) {
+        ulm_neighbor_plan_free(p);
+        return rc;
+    }
+
+    communicator->neighborPlan = *plan = p;
+
+    return ULM_SUCCESS;
+}
+
+
+void ulm_neighbor_plan_free(NbrPlan_t *plan)
+{
+    if (plan == NULL) {
+        return;
+    }
+    if (plan->nbr) {
+        ulm_free(plan->nbr);
+    }
+    if (plan->in_origin) {
+        ulm_free(plan->in_origin);
+    }
+    if (plan->in_start) {
+        ulm_free(plan->in_start);
+    }
+    if (plan->in_target) {
+        ulm_free(plan->in_target);
+    }
+    if (plan->in_slot) {
+        ulm_free(plan->in_slot);
+    }
+    ulm_free(plan);
+}
+
+
+/*
+ * neighbor_exchange - the exchange behind all the neighborhood
+ * collectives.  For alltoall (all2all) send block j is sent to slot j,
+ * otherwise the whole send buffer is; with counts (displs) NULL every
+ * block holds count objects at offset j * count.  Only the fixed-size
+ * exchanges are aggregated, because a proxy must know the size of the
+ * blocks it forwards.
+ */
+static int neighbor_exchange(void *sendbuf, int *scounts, int *sdispls,
+                             int scount, ULMType_t *stype, void *recvbuf,
+                             int *rcounts, int *rdispls, int rcount,
+                             ULMType_t *rtype, int comm, int all2all)
+{
+    Communicator *communicator = communicators[comm];
+    NbrPlan_t *plan;
+    ULMRequest_t *request;
+    ULMRequest_t *inreq;
+    ULMStatus_t status;
+    unsigned char *tmp = NULL;
+    unsigned char *outbuf;
+    unsigned char *inbuf;
+    unsigned char *fwdbuf;
+    size_t size;
+    size_t nbytes;
+    int aggregate;
+    int nreq = 0;
+    int tag;
+    int self;
+    int i;
+    int j;
+    int k;
+    int rc;
+
+#define SEND_COUNT(J) (all2all ? RS_COUNT(scounts, scount, J) : scount)
+#define SEND_ADDR(J) ((unsigned char *) sendbuf + (all2all ? \
+        (size_t) RS_DISPL(sdispls, scount, J) * stype->extent : 0))
+#define RECV_ADDR(J) ((unsigned char *) recvbuf + \
+        (size_t) RS_DISPL(rdispls, rcount, J) * rtype->extent)
+
+    rc = ulm_neighbor_plan(communicator, &plan);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+    self = communicator->localGroup->ProcID;
+    aggregate = (scounts == NULL && rcounts == NULL);
+
+    /* every process reserves the same tags: one per sending slot, then
+     * one for aggregated and one for forwarded blocks */
+    rc = ulm_get_system_tag(comm, plan->maxdeg + 2, &tag);
+    if (rc != ULM_SUCCESS) {
+        return rc;
+    }
+
+    size = (size_t) scount * stype->packed_size;
+    nbytes = 0;
+    if (aggregate) {
+        nbytes += all2all ? plan->out_start[plan->nout] * size : size;
+        nbytes += (all2all ? plan->in_start[plan->nin] : plan->nin) * size;
+        nbytes += plan->nfwd * size;
+    }
+    request = (ULMRequest_t *) ulm_malloc((2 * plan->nslot + plan->nout +
+                                          plan->nin + plan->nfwd +
+                                          plan->nforward + 1) *
+                                         sizeof(ULMRequest_t));
+    if (request == NULL) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    inreq = request + 2 * plan->nslot + plan->nout + plan->nfwd +
+        plan->nforward;
+    if (nbytes > 0) {
+        tmp = (unsigned char *) ulm_malloc(nbytes);
+        if (tmp == NULL) {
+            ulm_free(request);
+            return ULM_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    outbuf = tmp;
+    inbuf = outbuf + (all2all ? plan->out_start[plan->nout] * size : size);
+    fwdbuf = inbuf + (all2all ? plan->in_start[plan->nin] : plan->nin) * size;
+
+    /* post all receives */
+    for (j = 0; j < plan->nslot; j++) {
+        int mode = plan->recv_mode[j];
+
+        if (!aggregate && (mode == NBR_AGGREGATE || mode == NBR_FORWARD)) {
+            mode = NBR_DIRECT;
+        }
+        if (mode != NBR_DIRECT) {
+            continue;
+        }
+        rc = ulm_irecv(RECV_ADDR(j), RS_COUNT(rcounts, rcount, j), rtype,
+                       plan->nbr[j], tag - plan->peer[j], comm,
+                       &request[nreq++]);
+        if (rc != ULM_SUCCESS) {
+            goto CLEANUP;
+        }
+    }
+    if (aggregate) {
+        for (i = 0; i < plan->nin; i++) {
+            k = all2all ? plan->in_start[i] : i;
+            nbytes = all2all ? (plan->in_start[i + 1] - k) * size : size;
+            rc = ulm_irecv(inbuf + k * size, nbytes, (ULMType_t *) MPI_BYTE,
+                           plan->in_origin[i], tag - plan->maxdeg, comm,
+                           &inreq[i]);
+            if (rc != ULM_SUCCESS) {
+                goto CLEANUP;
+            }
+        }
+        for (i = 0; i < plan->nfwd; i++) {
+            rc = ulm_irecv(fwdbuf + i * size, size, (ULMType_t *) MPI_BYTE,
+                           plan->fwd_proxy[i], tag - plan->maxdeg - 1, comm,
+                           &request[nreq++]);
+            if (rc != ULM_SUCCESS) {
+                goto CLEANUP;
+            }
+        }
+    }
+
+    /* post all sends */
+    for (j = 0; j < plan->nslot; j++) {
+        int mode = plan->send_mode[j];
+
+        if (!aggregate && mode == NBR_AGGREGATE) {
+            mode = NBR_DIRECT;
+        }
+        if (mode != NBR_DIRECT) {
+            continue;
+        }
+        rc = ulm_isend(SEND_ADDR(j), SEND_COUNT(j), stype, plan->nbr[j],
+                       tag - j, comm, &request[nreq++], ULM_SEND_STANDARD);
+        if (rc != ULM_SUCCESS) {
+            goto CLEANUP;
+        }
+    }
+    if (aggregate) {
+        if (!all2all && plan->nout > 0) {
+            ulm_coll_pack_block(TYPE_PACK_PACK, outbuf, size,
+                                sendbuf, scount, stype, 0);
+        }
+        for (i = 0; i < plan->nout; i++) {
+            unsigned char *buf = outbuf;
+
+            nbytes = size;
+            if (all2all) {
+                buf = outbuf + plan->out_start[i] * size;
+                nbytes = (plan->out_start[i + 1] - plan->out_start[i]) * size;
+                for (k = plan->out_start[i]; k < plan->out_start[i + 1]; k++) {
+                    ulm_coll_pack_block(TYPE_PACK_PACK, outbuf + k * size,
+                                        size, sendbuf, scount, stype,
+                                        plan->out_slot[k]);
+                }
+            }
+            rc = ulm_isend(buf, nbytes, (ULMType_t *) MPI_BYTE,
+                           plan->out_proxy[i], tag - plan->maxdeg, comm,
+                           &request[nreq++], ULM_SEND_STANDARD);
+            if (rc != ULM_SUCCESS) {
+                goto CLEANUP;
+            }
+        }
+    }
+
+    /* blocks this process sends to itself */
+    for (j = 0; j < plan->nslot; j++) {
+        if (plan->recv_mode[j] == NBR_SELF) {
+            k = plan->peer[j];
+            rc = ulm_coll_copy(RECV_ADDR(j), RS_COUNT(rcounts, rcount, j),
+                               rtype, SEND_ADDR(k), SEND_COUNT(k), stype);
+            if (rc != ULM_SUCCESS) {
+                goto CLEANUP;
+            }
+        }
+    }
+
+    /* as proxy, deliver aggregated blocks and forward the others in
+     * the order their destinations expect */
+    if (aggregate) {
+        for (i = 0; i < plan->nin; i++) {
+            rc = ulm_wait(&inreq[i], &status);
+            if (rc != ULM_SUCCESS) {
+                goto CLEANUP;
+            }
+            for (k = plan->in_start[i]; k < plan->in_start[i + 1]; k++) {
+                unsigned char *block = inbuf +
+                    (all2all ? k : i) * size;
+
+                if (plan->in_target[k] == self) {
+                    ulm_coll_pack_block(TYPE_PACK_UNPACK, block, size,
+                                        RECV_ADDR(plan->in_slot[k]),
+                                        rcount, rtype, 0);
+                    continue;
+                }
+                rc = ulm_isend(block, size, (ULMType_t *) MPI_BYTE,
+                               plan->in_target[k], tag - plan->maxdeg - 1,
+                               comm, &request[nreq++], ULM_SEND_STANDARD);
+                if (rc != ULM_SUCCESS) {
+                    goto CLEANUP;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < nreq; i++) {
+        rc = ulm_wait(&request[i], &status);
+        if (rc != ULM_SUCCESS) {
+            goto CLEANUP;
+        }
+    }
+
+    if (aggregate) {
+        for (i = 0; i < plan->nfwd; i++) {
+            j = plan->fwd_slot[i];
+            ulm_coll_pack_block(TYPE_PACK_UNPACK, fwdbuf + i * size, size,
+                                RECV_ADDR(j), rcount, rtype, 0);
+        }
+    }
+
+CLEANUP:
+    if (tmp) {
+        ulm_free(tmp);
+    }
+    ulm_free(request);
+
+    return rc;
+
+#undef SEND_COUNT
+#undef SEND_ADDR
+#undef RECV_ADDR
+}
+
+
+/*
+ * ulm_neighbor_allgather - gather the send buffer of every neighbor
+ * into the slot of that neighbor
+ */
+extern "C" int ulm_neighbor_allgather(void *sendbuf, int sendcount,
+                                      ULMType_t *sendtype, void *recvbuf,
+                                      int recvcount, ULMType_t *recvtype,
+                                      int comm)
+{
+    return neighbor_exchange(sendbuf, NULL, NULL, sendcount, sendtype,
+                             recvbuf, NULL, NULL, recvcount, recvtype,
+                             comm, 0);
+}
+
+
+extern "C" int ulm_neighbor_allgatherv(void *sendbuf, int sendcount,
+                                       ULMType_t *sendtype, void *recvbuf,
+                                       int *recvcounts, int *displs,
+                                       ULMType_t *recvtype, int comm)
+{
+    return neighbor_exchange(sendbuf, NULL, NULL, sendcount, sendtype,
+                             recvbuf, recvcounts, displs, 0, recvtype,
+                             comm, 0);
+}
+
+
+/*
+ * ulm_neighbor_alltoall - send block j of the send buffer to the
+ * neighbor in slot j and receive its block into slot j
+ */
+extern "C" int ulm_neighbor_alltoall(void *sendbuf, int sendcount,
+                                     ULMType_t *sendtype, void *recvbuf,
+                                     int recvcount, ULMType_t *recvtype,
+                                     int comm)
+{
+    return neighbor_exchange(sendbuf, NULL, NULL, sendcount, sendtype,
+                             recvbuf, NULL, NULL, recvcount, recvtype,
+                             comm, 1);
+}
+
+
+extern "C" int ulm_neighbor_alltoallv(void *sendbuf, int *sendcounts,
+                                      int *sdispls, ULMType_t *sendtype,
+                                      void *recvbuf, int *recvcounts,
+                                      int *rdispls, ULMType_t *recvtype,
+                                      int comm)
+{
+    return neighbor_exchange(sendbuf, sendcounts, sdispls, 0, sendtype,
+                             recvbuf, recvcounts, rdispls, 0, recvtype,
+                             comm, 1);
+}
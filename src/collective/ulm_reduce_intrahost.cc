@@ -72,6 +72,12 @@
  * This implementation uses a logarithmic fan in using a shared memory
  * buffer for collectives. Since the buffer is of fixed size, the
  * algorithm is applied blockwise.
+ *
+ * Each process's segment of the buffer holds two slots, used for
+ * alternate blocks, with a "ready" and a "consumed" flag for each
+ * holding a block number.  A process only waits for its parent to
+ * consume a slot before reusing it two blocks later, so successive
+ * blocks are pipelined up the tree without any barrier.
  */
 extern "C" int ulm_reduce_intrahost(const void *s_buf,
                                     void *r_buf,
@@ -83,24 +89,25 @@ extern "C" int ulm_reduce_intrahost(const void *s_buf,
     Communicator *communicator;
     Group *group;
     ULMFunc_t *func;
+    int block;
     int mask;
     int n;
     int nproc;
-    int parity;
     int peer;
     int root_onhost;
     int root_host;
     int self_host;
     int self;
     int tag;
-    size_t block_size;
+    size_t slot_size;
     size_t offset;
     ssize_t block_count;
     unsigned char *rp;
     unsigned char *sp;
     unsigned char *smbuf_start;
+    unsigned char *peer_slot;
+    unsigned char *self_slot;
     void *arg;
-    void *peer_buf;
     void *self_buf;
     volatile int *peer_flag;
     volatile int *self_flag;
@@ -173,7 +180,7 @@ extern "C" int ulm_reduce_intrahost(const void *s_buf,
      *   peer = self ^ 2^n
      * and if peer is less than nproc and send from the
      * superior to the inferior where it is accumulated.
-     * Once a proc has done a send then we are done.
+     * Once a proc has done a send then we are done with the block.
      */
 
     self = group->onHostProcID;
@@ -230,7 +237,7 @@ extern "C" int ulm_reduce_intrahost(const void *s_buf,
        if( smbuf->tag != tag ) {
 	  int *flag = (int *) smbuf->mem;
 	  for (int i = 0; i < communicator->localGroup->onHostGroupSize; i++) {
-	     flag[0] = flag[1] = -1;
+	     flag[0] = flag[1] = flag[2] = flag[3] = -1;
 	     flag += communicator->collectiveOpt.reduceOffset / sizeof(int);
 	  }
 	  mb();
@@ -241,50 +248,54 @@ extern "C" int ulm_reduce_intrahost(const void *s_buf,
        smbuf->lock.unlock();
     }
 
+    /*
+     * Each segment: ready[2], consumed[2], slot 0, slot 1
+     */
     offset = communicator->collectiveOpt.reduceOffset;
-    block_size = offset - 2 * sizeof(int);
+    slot_size = ((offset - 4 * sizeof(int)) / 2) & ~7;
     smbuf_start = (unsigned char *) smbuf->mem;
     self_flag = (int *) (smbuf_start + self * offset);
-    self_buf = (void *) (self_flag + 2);
+    self_slot = (unsigned char *) (self_flag + 4);
 
     /*
      * Apply the algorithm
      */
 
-    block_count = block_size / type->extent;
+    block_count = slot_size / type->extent;
     rp = (unsigned char *) r_buf;
     if (s_buf == MPI_IN_PLACE) {
         sp = rp;
     } else {
         sp = (unsigned char *) s_buf;
     }
-    parity = 0;
-    while (count > 0) {
+    for (block = 0; count > 0; block++) {
+        int slot = block & 1;
+
         n = block_count < count ? block_count : count;
+        self_buf = (void *) (self_slot + slot * slot_size);
+        if (self != 0 && block >= 2) {
+            /* wait for the parent to consume this slot's last block */
+            ULM_SPIN_AND_MAKE_PROGRESS(self_flag[2 + slot] < block - 2);
+        }
         type_copy(self_buf, sp, n, type);
         mb();
         for (mask = 1; mask < nproc; mask <<= 1) {
-            peer = self ^ mask;
-            peer_flag = (int *) (smbuf_start + peer * offset);
-            if (peer >= nproc) {
-                /* nothing this phase */ ;
-            } else if (self < peer) {
-                /* read from peer */
-                self_flag[parity] = peer;
-                mb();
-                ULM_SPIN_AND_MAKE_PROGRESS(peer_flag[parity] != self);
-                peer_buf = (void *) (peer_flag + 2);
-                func(peer_buf, self_buf, &n, arg);
-                self_flag[parity] = peer_flag[parity] = -1;
+            if (self & mask) {
+                /* signal parent that the block is readable */
+                self_flag[slot] = block;
                 mb();
-            } else {
-		/* signal peer that buffer is readable */
-                self_flag[parity] = peer;
+                break;
+            }
+            peer = self | mask;
+            if (peer < nproc) {
+                /* read from peer */
+                peer_flag = (int *) (smbuf_start + peer * offset);
+                peer_slot = (unsigned char *) (peer_flag + 4);
+                ULM_SPIN_AND_MAKE_PROGRESS(peer_flag[slot] < block);
+                func(peer_slot + slot * slot_size, self_buf, &n, arg);
                 mb();
-		/* wait for peer to finish reading */
-                ULM_SPIN_AND_MAKE_PROGRESS(self_flag[parity] == peer);
+                peer_flag[2 + slot] = block;
             }
-            parity = parity ^ 1;
         }
         if (self == 0) {
             type_copy(rp, self_buf, n, type);
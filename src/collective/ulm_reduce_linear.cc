@@ -206,7 +206,7 @@ extern "C" int ulm_reduce_linear(const void *s_buf,
             rc = ulm_wait(&req, &status);
         }
         if (self == root) {
-            rc = ulm_irecv(buf, count, type, nproc - 1, tag, comm, &req);
+            rc = ulm_irecv(r_buf, count, type, nproc - 1, tag, comm, &req);
             if (rc != ULM_SUCCESS) {
                 goto EXIT;
             }
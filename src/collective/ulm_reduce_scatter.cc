@@ -0,0 +1,260 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "queue/globals.h"
+#include "ulm/ulm.h"
+#include "internal/log.h"
+#include "internal/malloc.h"
+#include "internal/type_copy.h"
+#include "collective/coll_fns.h"
+
+/*
+ * reduce_scatter_linear - reduce to process 0 followed by a scatter.
+ *
+ * Used for operations that do not commute, since ulm_reduce then
+ * applies the operation in rank order.  Only process 0 needs a
+ * temporary of the full vector.
+ */
+static int reduce_scatter_linear(const void *s_buf,
+                                 void *r_buf,
+                                 int *counts,
+                                 int *displs,
+                                 int block_count,
+                                 int total,
+                                 ULMType_t *type,
+                                 ULMOp_t *op,
+                                 int comm)
+{
+    Group *group;
+    int rc;
+    void *buf;
+
+    group = communicators[comm]->localGroup;
+
+    if (s_buf == MPI_IN_PLACE) {
+        s_buf = r_buf;
+    }
+
+    buf = NULL;
+    if (group->ProcID == 0) {
+        buf = ulm_malloc(total * type->extent);
+        if (buf == NULL) {
+            return ULM_ERR_OUT_OF_RESOURCE;
+        }
+    }
+
+    rc = ulm_reduce(s_buf, buf, total, type, op, 0, comm);
+    if (rc == ULM_SUCCESS) {
+        if (counts) {
+            rc = ulm_scatterv(buf, counts, displs, type,
+                              r_buf, counts[group->ProcID], type, 0, comm);
+        } else {
+            rc = ulm_scatter(buf, block_count, type,
+                             r_buf, block_count, type, 0, comm);
+        }
+    }
+
+    if (buf) {
+        ulm_free(buf);
+    }
+
+    return rc;
+}
+
+/*
+ * reduce_scatter - select and apply a reduce_scatter algorithm
+ *
+ * counts and displs describe the result block of each process; if
+ * counts is NULL, every block holds block_count objects.
+ */
+static int reduce_scatter(const void *s_buf,
+                          void *r_buf,
+                          int *counts,
+                          int *displs,
+                          int block_count,
+                          ULMType_t *type,
+                          ULMOp_t *op,
+                          int comm)
+{
+    Communicator *communicator;
+    Group *group;
+    int nproc;
+    int total;
+
+    communicator = communicators[comm];
+    group = communicator->localGroup;
+    nproc = group->groupSize;
+
+    total = RS_DISPL(displs, block_count, nproc - 1) +
+        RS_COUNT(counts, block_count, nproc - 1);
+
+    /*
+     * Select algorithm based on arguments
+     */
+
+    if (nproc == 1) {
+
+        if (s_buf != MPI_IN_PLACE) {
+            type_copy(r_buf, s_buf, total, type);
+        }
+
+        return ULM_SUCCESS;
+
+    } else if (communicator->useSharedMemForCollectives &&
+               group->numberOfHostsInGroup == 1 &&
+               type->extent <= communicator->collectiveOpt.maxReduceExtent) {
+
+        /*
+         * All processes on-host: reduce straight out of shared
+         * memory.  This preserves rank order, so is used for all
+         * operations.
+         */
+
+        return ulm_reduce_scatter_intrahost(s_buf, r_buf, counts, displs,
+                                            block_count, type, op, comm);
+
+    } else if (op->commute == 0) {
+
+        /*
+         * For non-commuting operators, where evaluation order
+         * matters, use a linear algorithm.
+         */
+
+        return reduce_scatter_linear(s_buf, r_buf, counts, displs,
+                                     block_count, total, type, op, comm);
+    }
+
+    /*
+     * Point-to-point algorithm
+     */
+
+    return ulm_reduce_scatter_p2p(s_buf, r_buf, counts, displs,
+                                  block_count, type, op, comm);
+}
+
+/*!
+ * ulm_reduce_scatter - reduce_scatter function entry point
+ *
+ * \param s_buf         Initial data
+ * \param r_buf         Buffer to receive this process's block of the
+ *                      reduced data
+ * \param counts        Number of objects in each process's block
+ * \param type          Data type of objects
+ * \param op            Operation operation
+ * \param comm          The communicator ID
+ * \return              ULM error code
+ *
+ * Description
+ *
+ * This function performs an element-wise reduce operation across all
+ * the members of the group specified by the context ID, on vectors of
+ * sum(counts) objects, and returns block i of the result (counts[i]
+ * objects) at the process with rank i.
+ *
+ * This top-level entry point selects the appropriate algorithm.
+ */
+extern "C" int ulm_reduce_scatter(void *s_buf,
+                                  void *r_buf,
+                                  int *counts,
+                                  ULMType_t *type,
+                                  ULMOp_t *op,
+                                  int comm)
+{
+    enum {
+        DISPLS_SMALL_SIZE = 64
+    };
+    int displs_small[DISPLS_SMALL_SIZE];
+    int *displs;
+    int nproc;
+    int rc;
+
+    nproc = communicators[comm]->localGroup->groupSize;
+
+    if (nproc > DISPLS_SMALL_SIZE) {
+        displs = (int *) ulm_malloc(nproc * sizeof(int));
+        if (displs == NULL) {
+            return ULM_ERR_OUT_OF_RESOURCE;
+        }
+    } else {
+        displs = displs_small;
+    }
+
+    displs[0] = 0;
+    for (int i = 1; i < nproc; i++) {
+        displs[i] = displs[i - 1] + counts[i - 1];
+    }
+
+    rc = reduce_scatter(s_buf, r_buf, counts, displs, 0, type, op, comm);
+
+    if (displs != displs_small) {
+        ulm_free(displs);
+    }
+
+    return rc;
+}
+
+/*!
+ * ulm_reduce_scatter_block - reduce_scatter with equal block sizes
+ *
+ * \param s_buf         Initial data
+ * \param r_buf         Buffer to receive this process's block of the
+ *                      reduced data
+ * \param count         Number of objects in each process's block
+ * \param type          Data type of objects
+ * \param op            Operation operation
+ * \param comm          The communicator ID
+ * \return              ULM error code
+ *
+ * Description
+ *
+ * As ulm_reduce_scatter, but every process receives count objects.
+ * Block offsets are computed directly, so no per-process count or
+ * displacement arrays are built or scanned.
+ */
+extern "C" int ulm_reduce_scatter_block(void *s_buf,
+                                        void *r_buf,
+                                        int count,
+                                        ULMType_t *type,
+                                        ULMOp_t *op,
+                                        int comm)
+{
+    if (count == 0) {
+        return ULM_SUCCESS;
+    }
+
+    return reduce_scatter(s_buf, r_buf, NULL, NULL, count, type, op, comm);
+}
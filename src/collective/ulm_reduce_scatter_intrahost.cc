@@ -0,0 +1,227 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "internal/log.h"
+#include "internal/type_copy.h"
+#include "os/atomic.h"
+#include "ulm/ulm.h"
+#include "queue/globals.h"
+#include "collective/coll_fns.h"
+
+/*!
+ * ulm_reduce_scatter_intrahost - reduce_scatter, shared memory
+ *                                algorithm for single host groups
+ *
+ * \param s_buf         Initial data (the full vector)
+ * \param r_buf         Buffer to receive this process's block
+ * \param counts        Number of objects in each process's block, or
+ *                      NULL if every block contains block_count objects
+ * \param displs        Offset (in objects) of each process's block, or
+ *                      NULL if every block contains block_count objects
+ * \param block_count   Number of objects per block if counts is NULL
+ * \param type          Data type of objects
+ * \param op            Operation operation
+ * \param comm          The communicator ID
+ * \return              ULM error code
+ *
+ * Description
+ *
+ * This function performs a reduce_scatter across all processes of a
+ * communicator whose group lies entirely on this host.
+ *
+ * Algorithm
+ *
+ * Each process owns a segment of the collective shared memory buffer
+ * (collectiveOpt.reduceOffset bytes, as for ulm_reduce_intrahost).
+ * The vector is processed blockwise: every process copies the current
+ * block of its input into its segment, and after a barrier each
+ * process reduces the part of the block that falls in its own result
+ * range directly out of all the segments and into r_buf.  No process
+ * touches more than its own share of the data, and no process holds
+ * a temporary of the full vector.
+ *
+ * Contributions are combined in rank order, so the algorithm is also
+ * correct for operations that do not commute.
+ */
+extern "C" int ulm_reduce_scatter_intrahost(const void *s_buf,
+                                            void *r_buf,
+                                            int *counts,
+                                            int *displs,
+                                            int block_count,
+                                            ULMType_t *type,
+                                            ULMOp_t *op,
+                                            int comm)
+{
+    CollectiveSMBuffer_t *smbuf;
+    Communicator *communicator;
+    Group *group;
+    ULMFunc_t *func;
+    int base;
+    int hi;
+    int lo;
+    int n;
+    int len;
+    int my_count;
+    int my_displ;
+    int nproc;
+    int proc;
+    int self;
+    int tag;
+    int total;
+    size_t extent;
+    size_t offset;
+    ssize_t chunk_count;
+    unsigned char *rp;
+    unsigned char *sp;
+    unsigned char *smbuf_start;
+    void *arg;
+    void *self_buf;
+
+    if (type == NULL) {
+        return ULM_ERR_BAD_PARAM;
+    }
+
+    communicator = communicators[comm];
+    group = communicator->localGroup;
+    nproc = group->groupSize;
+    self = group->ProcID;
+    tag = communicator->get_base_tag(1);
+    extent = type->extent;
+
+    total = RS_DISPL(displs, block_count, nproc - 1) +
+        RS_COUNT(counts, block_count, nproc - 1);
+    if (total == 0) {
+        return ULM_SUCCESS;
+    }
+
+    /*
+     * Pre-defined operations have a vector of function pointers
+     * corresponding to the basic types.  User-defined operations have
+     * a vector of length 1.
+     */
+    if (op->isbasic) {
+        if (type->isbasic == 0) {
+            ulm_err(("Error: ulm_reduce_scatter: "
+                     "basic operation, non-basic datatype\n"));
+            return ULM_ERR_BAD_PARAM;
+        }
+        func = op->func[type->op_index];
+    } else {
+        func = op->func[0];
+    }
+
+    /*
+     * For fortran defined functions, pass a pointer to the fortran
+     * type handle as the function argument, else pass a pointer to
+     * the type struct.
+     */
+    if (op->fortran) {
+        arg = (void *) &(type->fhandle);
+    } else {
+        arg = (void *) &type;
+    }
+
+    /*
+     * Shared memory buffer set-up
+     */
+
+    smbuf = communicator->getCollectiveSMBuffer(tag,
+                                                ULM_COLLECTIVE_REDUCE_SCATTER);
+    offset = communicator->collectiveOpt.reduceOffset;
+    smbuf_start = (unsigned char *) smbuf->mem;
+    self_buf = (void *) (smbuf_start + group->onHostProcID * offset);
+    chunk_count = offset / extent;
+
+    my_count = RS_COUNT(counts, block_count, self);
+    my_displ = RS_DISPL(displs, block_count, self);
+
+    /*
+     * Apply the algorithm.  When working in place the input comes
+     * from r_buf; results for object i are written to r_buf at
+     * i - my_displ <= i, which has always been copied to shared
+     * memory by then, so no input is overwritten before it is read.
+     */
+
+    rp = (unsigned char *) r_buf;
+    if (s_buf == MPI_IN_PLACE) {
+        sp = rp;
+    } else {
+        sp = (unsigned char *) s_buf;
+    }
+
+    for (base = 0; base < total; base += n) {
+        n = (chunk_count < total - base) ? chunk_count : total - base;
+        type_copy(self_buf, sp + base * extent, n, type);
+        mb();
+        communicator->smpBarrier(communicator->barrierData);
+
+        lo = (my_displ > base) ? my_displ : base;
+        hi = (my_displ + my_count < base + n) ? my_displ + my_count : base + n;
+        if (lo < hi) {
+            len = hi - lo;
+            proc = nproc - 1;
+            type_copy(rp + (lo - my_displ) * extent,
+                      smbuf_start
+                      + group->mapGroupProcIDToOnHostProcID[proc] * offset
+                      + (lo - base) * extent,
+                      len, type);
+            for (proc = nproc - 2; proc >= 0; proc--) {
+                func(smbuf_start
+                     + group->mapGroupProcIDToOnHostProcID[proc] * offset
+                     + (lo - base) * extent,
+                     rp + (lo - my_displ) * extent, &len, arg);
+            }
+        }
+
+        /*
+         * Don't overwrite the segments until everyone has read them.
+         * After the last block the buffer is not reused until it is
+         * recycled, which is protected by releaseCollectiveSMBuffer.
+         */
+        if (base + n < total) {
+            communicator->smpBarrier(communicator->barrierData);
+        }
+    }
+
+    /*
+     * Release shared memory buffer
+     */
+
+    communicator->releaseCollectiveSMBuffer(smbuf);
+
+    return ULM_SUCCESS;
+}
@@ -37,27 +37,443 @@
 
 #include "ulm/ulm.h"
 #include "queue/globals.h"
-#include "internal/malloc.h" 
+#include "internal/log.h"
+#include "internal/malloc.h"
+#include "internal/mpi.h"
+#include "internal/type_copy.h"
+#include "collective/coll_tune.h"
 
 /* Macros ************************************************************ */
 
+enum {
+    SCAN_PIPELINE_MIN = 32 * 1024,	/* smallest vector (bytes) to pipeline */
+    SCAN_SEGSIZE = 64 * 1024		/* default pipeline segment (bytes) */
+};
+
 /*
- * ! Break out of loop on ULM error
+ * State shared by the phases of a scan
  */
-
-#define BREAK_ON_ERR(RC)	if ((RC) != ULM_SUCCESS) goto CLEANUP;
-#define REDUCE_SMALL_BUFSIZE	2048
+typedef struct {
+    ULMType_t *type;
+    ULMFunc_t *func;
+    void *arg;
+    int comm;
+    int tag;
+    int pipeline;		/* use the segmented chain */
+    int segcount;		/* objects per pipeline segment */
+} scan_t;
 
 /* Functions ******************************************************** */
+
+/*
+ * inout = in op inout, for count objects
+ */
+static inline void combine(scan_t *s, void *in, void *inout, int count)
+{
+    s->func(in, inout, &count, s->arg);
+}
+
+
+/*
+ * scan_rd - recursive doubling scan over the processes ranks[0..n-1],
+ * of which this is ranks[i]
+ *
+ * In round k, process i sends its partial result, covering processes
+ * i - 2^k + 1 ... i, to i + 2^k and combines the one it receives
+ * from i - 2^k on the left.  incl (if not NULL) receives the
+ * inclusive result and excl (if not NULL, and i > 0) the exclusive
+ * one; neither may alias mine unless incl == mine.
+ */
+static int scan_rd(scan_t *s, void *mine, void *incl, void *excl,
+		   int count, int *ranks, int n, int i)
+{
+    ULMRequest_t sreq;
+    ULMRequest_t rreq;
+    ULMStatus_t status;
+    size_t size = count * s->type->extent;
+    unsigned char *tmp;
+    void *partial;
+    int first = 1;
+    int shift;
+    int rc = ULM_SUCCESS;
+
+    tmp = (unsigned char *) ulm_malloc(incl ? size : 2 * size);
+    if (tmp == NULL) {
+	return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    partial = incl ? incl : (void *) (tmp + size);
+    if (partial != mine) {
+	type_copy(partial, mine, count, s->type);
+    }
+
+    for (shift = 1; shift < n; shift <<= 1) {
+	int from = i - shift;
+	int to = i + shift;
+
+	if (from >= 0) {
+	    rc = ulm_irecv(tmp, count, s->type, ranks[from], s->tag,
+			   s->comm, &rreq);
+	    if (rc != ULM_SUCCESS) {
+		break;
+	    }
+	}
+	if (to < n) {
+	    rc = ulm_isend(partial, count, s->type, ranks[to], s->tag,
+			   s->comm, &sreq, ULM_SEND_STANDARD);
+	    if (rc == ULM_SUCCESS) {
+		rc = ulm_wait(&sreq, &status);
+	    }
+	    if (rc != ULM_SUCCESS) {
+		break;
+	    }
+	}
+	if (from >= 0) {
+	    rc = ulm_wait(&rreq, &status);
+	    if (rc != ULM_SUCCESS) {
+		break;
+	    }
+	    if (excl) {
+		if (first) {
+		    type_copy(excl, tmp, count, s->type);
+		} else {
+		    combine(s, tmp, excl, count);
+		}
+		first = 0;
+	    }
+	    combine(s, tmp, partial, count);
+	}
+    }
+
+    ulm_free(tmp);
+
+    return rc;
+}
+
+
+/*
+ * scan_pipeline - segmented chain scan over the processes
+ * ranks[0..n-1], of which this is ranks[i], with the same arguments
+ * as scan_rd()
+ *
+ * Process i receives the prefix of each segment from i - 1, combines
+ * it with its own and passes it on to i + 1 while the next segment is
+ * arriving, so for long vectors every link carries the vector about
+ * once.  Temporary space is at most four segments: two to receive
+ * into, unless the exclusive result is wanted, and two to send from,
+ * unless the inclusive result is wanted or this is the first or last
+ * process of the chain.
+ */
+static int scan_pipeline(scan_t *s, void *mine, void *incl, void *excl,
+			 int count, int *ranks, int n, int i)
+{
+    ULMRequest_t sreq[2];
+    ULMRequest_t rreq;
+    ULMStatus_t status;
+    size_t extent = s->type->extent;
+    size_t segsize = s->segcount * extent;
+    unsigned char *tmp = NULL;
+    unsigned char *p;
+    unsigned char *rbuf[2] = { NULL, NULL };
+    unsigned char *sbuf[2] = { NULL, NULL };
+    unsigned char *in = NULL;
+    int nbuf = 0;
+    int active[2] = { 0, 0 };
+    int nseg = (count + s->segcount - 1) / s->segcount;
+    int k;
+    int rc = ULM_SUCCESS;
+
+#define SEG_OFFSET(K)	((size_t) (K) * s->segcount * extent)
+#define SEG_COUNT(K)	(((K) + 1) * s->segcount <= count ? \
+			 s->segcount : count - (K) * s->segcount)
+#define RECV_BUF(K)	(excl ? (unsigned char *) excl + SEG_OFFSET(K) : \
+			 rbuf[(K) % 2])
+
+    if (i > 0 && excl == NULL) {
+	nbuf += 2;
+    }
+    if (i > 0 && i < n - 1 && incl == NULL) {
+	nbuf += 2;
+    }
+    if (nbuf > 0) {
+	tmp = (unsigned char *) ulm_malloc(nbuf * segsize);
+	if (tmp == NULL) {
+	    return ULM_ERR_OUT_OF_RESOURCE;
+	}
+    }
+    p = tmp;
+    if (i > 0 && excl == NULL) {
+	rbuf[0] = p;
+	rbuf[1] = p + segsize;
+	p += 2 * segsize;
+    }
+    if (i > 0 && i < n - 1 && incl == NULL) {
+	sbuf[0] = p;
+	sbuf[1] = p + segsize;
+    }
+
+    if (i > 0) {
+	rc = ulm_irecv(RECV_BUF(0), SEG_COUNT(0), s->type, ranks[i - 1],
+		       s->tag, s->comm, &rreq);
+	if (rc != ULM_SUCCESS) {
+	    goto CLEANUP;
+	}
+    }
+
+    for (k = 0; k < nseg; k++) {
+	unsigned char *src = (unsigned char *) mine + SEG_OFFSET(k);
+	unsigned char *out;
+	int c = SEG_COUNT(k);
+
+	/* this segment's prefix, and post the next segment's receive */
+	if (i > 0) {
+	    rc = ulm_wait(&rreq, &status);
+	    if (rc != ULM_SUCCESS) {
+		goto CLEANUP;
+	    }
+	    in = RECV_BUF(k);
+	    if (k + 1 < nseg) {
+		rc = ulm_irecv(RECV_BUF(k + 1), SEG_COUNT(k + 1), s->type,
+			       ranks[i - 1], s->tag, s->comm, &rreq);
+		if (rc != ULM_SUCCESS) {
+		    goto CLEANUP;
+		}
+	    }
+	}
+
+	if (active[k % 2]) {
+	    rc = ulm_wait(&sreq[k % 2], &status);
+	    active[k % 2] = 0;
+	    if (rc != ULM_SUCCESS) {
+		goto CLEANUP;
+	    }
+	}
+
+	/* inclusive result of this segment */
+	if (incl) {
+	    out = (unsigned char *) incl + SEG_OFFSET(k);
+	} else if (i == n - 1) {
+	    continue;
+	} else if (i == 0) {
+	    out = src;
+	} else {
+	    out = sbuf[k % 2];
+	}
+	if (out != src) {
+	    type_copy(out, src, c, s->type);
+	}
+	if (i > 0) {
+	    combine(s, in, out, c);
+	}
+
+	if (i < n - 1) {
+	    rc = ulm_isend(out, c, s->type, ranks[i + 1], s->tag, s->comm,
+			   &sreq[k % 2], ULM_SEND_STANDARD);
+	    if (rc != ULM_SUCCESS) {
+		goto CLEANUP;
+	    }
+	    active[k % 2] = 1;
+	}
+    }
+
+    for (k = 0; k < 2; k++) {
+	if (active[k]) {
+	    rc = ulm_wait(&sreq[k], &status);
+	    if (rc != ULM_SUCCESS) {
+		break;
+	    }
+	}
+    }
+
+CLEANUP:
+    if (tmp) {
+	ulm_free(tmp);
+    }
+
+    return rc;
+
+#undef SEG_OFFSET
+#undef SEG_COUNT
+#undef RECV_BUF
+}
+
+
+/*
+ * scan over ranks[0..n-1] with the algorithm chosen for the call
+ */
+static inline int scan_group(scan_t *s, void *mine, void *incl, void *excl,
+			     int count, int *ranks, int n, int i)
+{
+    if (n == 1) {
+	if (incl && incl != mine) {
+	    type_copy(incl, mine, count, s->type);
+	}
+	return ULM_SUCCESS;
+    }
+    if (s->pipeline) {
+	return scan_pipeline(s, mine, incl, excl, count, ranks, n, i);
+    }
+    return scan_rd(s, mine, incl, excl, count, ranks, n, i);
+}
+
+
+/*
+ * host_blocks - if the processes on each host form a contiguous block
+ * of ranks, fill lo[h] and hi[h] with the first and last rank of the
+ * h-th block in rank order and return the number of blocks, else
+ * return 0
+ */
+static int host_blocks(Group *group, int *lo, int *hi)
+{
+    int nhost = group->numberOfHostsInGroup;
+    int h;
+    int r;
+
+    for (r = 0, h = 0; r < group->groupSize; h++) {
+	int host = group->mapGroupProcIDToHostID[r];
+
+	if (h == nhost) {
+	    return 0;
+	}
+	lo[h] = r;
+	while (r < group->groupSize &&
+	       group->mapGroupProcIDToHostID[r] == host) {
+	    r++;
+	}
+	hi[h] = r - 1;
+    }
+
+    return (h == nhost) ? nhost : 0;
+}
+
+
+/*
+ * scan_smp - two level scan for processes in per-host blocks
+ *
+ * Processes scan within their host; the last process on each host,
+ * holding the host total, takes part in an exclusive scan across
+ * hosts and hands the prefix of the preceding hosts to the others on
+ * its host, which combine it with their on-host result.
+ */
+static int scan_smp(scan_t *s, void *mine, void *incl, void *excl,
+		    int count, Group *group, int *lo, int *hi, int nhost)
+{
+    ULMRequest_t req;
+    ULMStatus_t status;
+    size_t size = count * s->type->extent;
+    unsigned char *tmp;
+    unsigned char *total;
+    unsigned char *prefix;
+    int *ranks;
+    int self = group->ProcID;
+    int host;
+    int nlocal;
+    int ilocal;
+    int mask;
+    int rc;
+
+    for (host = 0; self > hi[host]; host++) {
+	;
+    }
+    nlocal = hi[host] - lo[host] + 1;
+    ilocal = self - lo[host];
+
+    ranks = (int *) ulm_malloc((nlocal > nhost ? nlocal : nhost) *
+			       sizeof(int));
+    tmp = (unsigned char *) ulm_malloc(2 * size);
+    if (ranks == NULL || tmp == NULL) {
+	rc = ULM_ERR_OUT_OF_RESOURCE;
+	goto CLEANUP;
+    }
+    total = incl ? (unsigned char *) incl : tmp;
+    prefix = tmp + size;
+
+    /* on-host scan: the last process gets the host total */
+    for (int r = 0; r < nlocal; r++) {
+	ranks[r] = lo[host] + r;
+    }
+    rc = scan_group(s, mine, total, excl, count, ranks, nlocal, ilocal);
+    if (rc != ULM_SUCCESS || nhost == 1) {
+	goto CLEANUP;
+    }
+
+    /* exclusive scan of the host totals */
+    if (ilocal == nlocal - 1) {
+	for (int h = 0; h < nhost; h++) {
+	    ranks[h] = hi[h];
+	}
+	rc = scan_group(s, total, NULL, prefix, count, ranks, nhost, host);
+	if (rc != ULM_SUCCESS) {
+	    goto CLEANUP;
+	}
+    }
+    if (host == 0) {
+	goto CLEANUP;
+    }
+
+    /* binomial broadcast of the prefix from the last process on host */
+    {
+	int rel = nlocal - 1 - ilocal;
+
+	for (mask = 1; mask < nlocal; mask <<= 1) {
+	    if (rel & mask) {
+		rc = ulm_irecv(prefix, count, s->type,
+			       hi[host] - (rel - mask), s->tag - 1,
+			       s->comm, &req);
+		if (rc == ULM_SUCCESS) {
+		    rc = ulm_wait(&req, &status);
+		}
+		if (rc != ULM_SUCCESS) {
+		    goto CLEANUP;
+		}
+		break;
+	    }
+	}
+	for (mask >>= 1; mask > 0; mask >>= 1) {
+	    if (rel + mask < nlocal) {
+		rc = ulm_isend(prefix, count, s->type,
+			       hi[host] - (rel + mask), s->tag - 1,
+			       s->comm, &req, ULM_SEND_STANDARD);
+		if (rc == ULM_SUCCESS) {
+		    rc = ulm_wait(&req, &status);
+		}
+		if (rc != ULM_SUCCESS) {
+		    goto CLEANUP;
+		}
+	    }
+	}
+    }
+
+    if (incl) {
+	combine(s, prefix, incl, count);
+    }
+    if (excl) {
+	if (ilocal == 0) {
+	    type_copy(excl, prefix, count, s->type);
+	} else {
+	    combine(s, prefix, excl, count);
+	}
+    }
+
+CLEANUP:
+    if (ranks) {
+	ulm_free(ranks);
+    }
+    if (tmp) {
+	ulm_free(tmp);
+    }
+
+    return rc;
+}
+
+
 /*!
  * A scan, or prefix reduction, operation
- * \param sendbuf	Array of data objects to scan
+ * \param sendbuf	Array of data objects to scan, or MPI_IN_PLACE
  * \param recvbuf	Array of scanned data objects
  * \param count		Number of data objects
- * \param type		Data type (defaults to byte)
+ * \param type		Data type
  * \param op		Operation structure
- * \param root		The group ProcID of the root process
- * \param sense		The direction >= 0 means forward, < 0 means back
+ * \param exclusive	Leave out the process's own data
  * \param comm		The communicator ID
  * \return		ULM error code
  *
@@ -71,91 +487,52 @@
  *  where
  *
  *    b[0] = a[0]
- *    b[i] = f(a[i], b[i - 1])         0 < i < n
+ *    b[i] = f(b[i - 1], a[i])         0 < i < n
  *
  *  and f(x, y) is an associative binary operation (for example,
- *  addition).
+ *  addition).  The exclusive scan is c[i] = b[i - 1], with c[0]
+ *  undefined (recvbuf is left untouched).  Each a[i] is itself an
+ *  array, so that the scan is applied to many n-tuples in parallel.
  *
  *  The scan operation arises in many algorithms which require an
  *  ordering or sorting phase.
  *
- *  More generally, we refer to the above as a forward scan with root
- *  0, while a forward scan with root m (0 < m < n) is defined by
- *
- *    b[m] = a[m]
- *    b[0] = f(a[0], b[n - 1])
- *    b[i] = f(a[i], b[i - 1])         i != 0
- *
- *  Similarly, a reverse scan with root m (0 < m < n) is defined by
- *  reflexion as
- *
- *    b[M] = a[M]
- *    b[n - 1] = f(a[n - 1], b[0])
- *    b[i] = f(a[i], b[i + 1])         i != n - 1
- *
- *  where M = m - 1, m > 0
- *          = n - 1, m = 0
- *
- *  _ulm_scan() performs any of these scan operations on n-tuples of
- *  objects distributed across a ULM group, where n is the number of
- *  processes in the group.  Each object is itself an array, so that
- *  the scan can be applied to many n-tuples in parallel.
- *
  *
  *  Algorithm
  *
- *  The scan is performed recursively, where proc n communicates with
- *  n +/- 2^0, then with n +/- 2^1, etc.
- *
- *  This implementation  uses a simple one phase  algorithm, taking no account
- *  of on-host communication possibilities.  This is not only simple, but
- *  conforms with the MPI specification which recommends that the function
- *  should produce reproducible results independent of the mapping of processes
- *  onto the system.
- *
- *
+ *  Short vectors use recursive doubling: log(n) rounds, each sending
+ *  the whole vector.  Long vectors are split into segments that flow
+ *  down a chain of processes, pipelined so that every link carries
+ *  the vector about once.  When the processes on each host hold a
+ *  contiguous block of ranks, the scan is first done on-host, only
+ *  the last process on each host takes part in the scan across
+ *  hosts, and it passes the result on to the rest of its host.  The
+ *  order of evaluation is the same in all cases, so non-commutative
+ *  operations are supported.  The choice may be overridden through
+ *  the collective decision table (COLL_TUNE_SCAN).
  */
-int _ulm_scan(const void *sendbuf,
-	      void *recvbuf,
-	      int count,
-	      ULMType_t *type,
-	      ULMOp_t *op,
-	      int root,
-	      int sense,
-	      int comm)
+static int scan(const void *sendbuf, void *recvbuf, int count,
+		ULMType_t *type, ULMOp_t *op, int exclusive, int comm)
 {
-    int nproc;
-    int shift;
-    int tag;
-    size_t bufsize;
-    void *buf;
-    unsigned char small_buf[REDUCE_SMALL_BUFSIZE];
-    int self;
-    int self_r;			/* ProcID of self relative to the scan */
+    Communicator *communicator = communicators[comm];
+    Group *group = communicator->localGroup;
+    scan_t s;
+    size_t bytes;
+    size_t segsize;
+    void *mine;
+    void *saved = NULL;
+    int *lo = NULL;
+    int *hi = NULL;
+    int nhost = 0;
+    int alg;
     int rc;
-    ULMFunc_t *func;
-    void *arg;
 
     /*
      * Fast return for trivial data
      */
 
-    if (count == 0) {
-	return (ULM_SUCCESS);
-    }
-
-    /*
-     * Type, function and operation set-up
-     */
-
-    /*
-     * non-null type: send/recv uses datatype count
-     * null type: send/recv uses byte count
-     */
-    if (type) {
-	bufsize = count * type->extent;
-    } else {
-	bufsize = count;
+    if (count == 0 || (exclusive && group->groupSize == 1)) {
+	return ULM_SUCCESS;
     }
 
     /*
@@ -165,13 +542,13 @@ int _ulm_scan(const void *sendbuf,
      * User-defined operations have a vector of length 1.
      */
     if (op->isbasic) {
-	if (type == NULL || type->isbasic == 0) {
-	    ulm_err(("Error: ulm_reduce: basic operation, non-basic datatype\n"));
+	if (type->isbasic == 0) {
+	    ulm_err(("Error: ulm_scan: basic operation, non-basic datatype\n"));
 	    return ULM_ERROR;
 	}
-	func = op->func[type->op_index];
+	s.func = op->func[type->op_index];
     } else {
-	func = op->func[0];
+	s.func = op->func[0];
     }
 
     /*
@@ -180,84 +557,93 @@ int _ulm_scan(const void *sendbuf,
      * struct.
      */
     if (op->fortran) {
-	arg = (void *) &(type->fhandle);
+	s.arg = (void *) &(type->fhandle);
     } else {
-	arg = (void *) &type;
+	s.arg = (void *) &(s.type);
     }
+    s.type = type;
+    s.comm = comm;
+    s.tag = communicator->get_base_tag(2);
 
     /*
-     * Temporary buffer for receiving incremental data
+     * Algorithm selection
      */
-    if (bufsize > REDUCE_SMALL_BUFSIZE) {
-	buf = (void *) ulm_malloc(bufsize);
-	if (buf == NULL) {
-	    return (ULM_ERR_OUT_OF_RESOURCE);
-	}
-    } else {
-	buf = (void *) small_buf;
-    }
-
-    nproc = communicators[comm]->remoteGroup->groupSize;
-    self = communicators[comm]->localGroup->ProcID;
-    tag = communicators[comm]->get_base_tag(1);
-
-    self_r = (self - root + nproc) % nproc;
-
-    memmove(recvbuf, sendbuf, bufsize);
 
-    for (shift = 1; shift < nproc; shift <<= 1) {
+    bytes = count * type->packed_size;
+    segsize = SCAN_SEGSIZE;
+    alg = ulm_coll_decide(communicator, COLL_TUNE_SCAN, bytes, &segsize);
 
-	ULMRequest_t req;
-	ULMStatus_t status;
-	int send_peer;
-	int recv_peer;
-	int send_peer_r;
-	int recv_peer_r;
+    if (alg == COLL_ALG_DEFAULT || alg == COLL_ALG_SMP) {
+	int n = group->numberOfHostsInGroup;
 
-	rc = ULM_ERROR;
-
-	if (sense >= 0) {
-	    send_peer_r = self_r + shift;
-	    recv_peer_r = self_r - shift;
-	} else {
-	    send_peer_r = self_r - shift;
-	    recv_peer_r = self_r + shift;
+	lo = (int *) ulm_malloc(2 * n * sizeof(int));
+	if (lo == NULL) {
+	    return ULM_ERR_OUT_OF_RESOURCE;
 	}
-
-	if (send_peer_r >= 0 && send_peer_r < nproc) {
-
-	    send_peer = (send_peer_r + nproc - root) % nproc;
-
-	    BREAK_ON_ERR(ulm_isend(recvbuf, count, type, send_peer,
-				   tag, comm, &req, ULM_SEND_STANDARD));
-	    BREAK_ON_ERR(ulm_wait(&req, &status));
-
+	hi = lo + n;
+	nhost = host_blocks(group, lo, hi);
+	if (alg == COLL_ALG_DEFAULT &&
+	    (nhost == 1 || nhost == group->groupSize)) {
+	    nhost = 0;
 	}
-	if (recv_peer_r >= 0 && recv_peer_r < nproc) {
+    }
+    s.pipeline = (alg == COLL_ALG_PIPELINE ||
+		  (alg != COLL_ALG_RECURSIVE_DOUBLING &&
+		   bytes >= SCAN_PIPELINE_MIN));
+    s.segcount = segsize / (type->extent ? type->extent : 1);
+    if (s.segcount < 1) {
+	s.segcount = 1;
+    }
 
-	    recv_peer = (recv_peer_r + nproc - root) % nproc;
+    /*
+     * The exclusive result is received in place, so an in-place
+     * exclusive scan needs a copy of the process's own data
+     */
+    mine = (void *) sendbuf;
+    if (sendbuf == MPI_IN_PLACE) {
+	mine = recvbuf;
+	if (exclusive) {
+	    saved = ulm_malloc(count * type->extent);
+	    if (saved == NULL) {
+		rc = ULM_ERR_OUT_OF_RESOURCE;
+		goto CLEANUP;
+	    }
+	    type_copy(saved, recvbuf, count, type);
+	    mine = saved;
+	}
+    }
 
-	    BREAK_ON_ERR(ulm_irecv(buf, count, type, recv_peer,
-				   tag, comm, &req));
-	    BREAK_ON_ERR(ulm_wait(&req, &status));
+    if (nhost > 0) {
+	rc = scan_smp(&s, mine, exclusive ? NULL : recvbuf,
+		      exclusive ? recvbuf : NULL, count, group, lo, hi, nhost);
+    } else {
+	int *ranks = (int *) ulm_malloc(group->groupSize * sizeof(int));
 
-	    func(buf, recvbuf, &count, arg);
+	if (ranks == NULL) {
+	    rc = ULM_ERR_OUT_OF_RESOURCE;
+	    goto CLEANUP;
 	}
-
-	rc = ULM_SUCCESS;
+	for (int r = 0; r < group->groupSize; r++) {
+	    ranks[r] = r;
+	}
+	rc = scan_group(&s, mine, exclusive ? NULL : recvbuf,
+			exclusive ? recvbuf : NULL, count, ranks,
+			group->groupSize, group->ProcID);
+	ulm_free(ranks);
     }
 
-    rc = ULM_SUCCESS;
-
     /*
      * Free resources and exit
      */
 
 CLEANUP:
-    if (bufsize > REDUCE_SMALL_BUFSIZE && buf) {
-	ulm_free(buf);
+    if (lo) {
+	ulm_free(lo);
     }
-    return (rc);
+    if (saved) {
+	ulm_free(saved);
+    }
+    return rc;
 }
 
 /* Wrapper for mpi-compliant scan */
@@ -269,5 +655,17 @@ int ulm_scan(const void *sendbuf,
 	     ULMOp_t *op,
 	     int comm)
 {
-    return _ulm_scan(sendbuf, recvbuf, count, type, op, 0, 1, comm);
+    return scan(sendbuf, recvbuf, count, type, op, 0, comm);
+}
+
+/* Wrapper for mpi-compliant exclusive scan */
+extern "C"
+int ulm_exscan(const void *sendbuf,
+	       void *recvbuf,
+	       int count,
+	       ULMType_t *type,
+	       ULMOp_t *op,
+	       int comm)
+{
+    return scan(sendbuf, recvbuf, count, type, op, 1, comm);
 }
@@ -44,13 +44,34 @@
 
 CDECL_BEGIN
 
+/*
+ * Buffered send space is managed as a set of ranges tiling the user
+ * supplied buffer.  Free ranges are kept on segregated free lists
+ * indexed by size class (floor(log2(len))), with a bitmap of
+ * non-empty classes, so that allocation is a constant time lookup in
+ * the common case.  Freed ranges are coalesced with their free
+ * neighbours.  Allocations are exact in size since MPI_BSEND_OVERHEAD
+ * is zero.
+ */
+
+enum {
+    ULM_BSEND_NUM_CLASSES = 32,         /* number of free list size classes */
+    ULM_BSEND_HASH_SIZE = 256,          /* offset hash for allocated ranges */
+    ULM_BSEND_RANGE_CHUNK = 64          /* range structures per ulm_malloc */
+};
+
 /*
  * buffered pt-2-pt user supplied buffer
  */
 struct ULMBufferRange_t {
-        
-    /* pointer to the next allocated range structure */
+
+    /* neighbouring ranges in buffer address order */
     struct ULMBufferRange_t *next;
+    struct ULMBufferRange_t *prev;
+
+    /* free list links if free, or offset hash chain if allocated */
+    struct ULMBufferRange_t *linkNext;
+    struct ULMBufferRange_t *linkPrev;
 
     /* offset into buffer */
     ssize_t offset;
@@ -58,6 +79,9 @@ struct ULMBufferRange_t {
     /* length of allocation */
     ssize_t len;
 
+    /* range is on a free list */
+    int isFree;
+
     /* pointer to request object that "owns" allocation */
     ULMRequest_t request;
 
@@ -84,8 +108,28 @@ struct bsendData_t {
     /* buffer */
     void *buffer;
 
-    /* single linked list of allocations */
-    ULMBufferRange_t *allocations;
+    /* all ranges in address order */
+    ULMBufferRange_t *ranges;
+
+    /* free ranges by size class, and bitmap of non-empty classes */
+    ULMBufferRange_t *freeLists[ULM_BSEND_NUM_CLASSES];
+    unsigned int freeMap;
+
+    /* allocated ranges hashed by offset */
+    ULMBufferRange_t *allocations[ULM_BSEND_HASH_SIZE];
+
+    /* number of allocated ranges */
+    int numAllocations;
+
+    /* cache of unused range structures, and the chunks they came from */
+    ULMBufferRange_t *spareRanges;
+    ULMBufferRange_t *rangeChunks;
+
+    /* statistics for the attached buffer */
+    ssize_t maxBytesInUse;
+    int maxAllocations;
+    long numAllocs;
+    long numFailedAllocs;
 
     /* management lock */
     lockStructure_t lock[1];
@@ -93,7 +137,10 @@ struct bsendData_t {
 
 typedef struct bsendData_t  bsendData_t;
 
+int ulm_bsend_attach(void *buffer, ssize_t length);
+void ulm_bsend_detach(void);
 ULMBufferRange_t *ulm_bsend_alloc(ssize_t size, int freeAtZero);
+void ulm_bsend_free_alloc(ULMBufferRange_t *allocation);
 ULMBufferRange_t *ulm_bsend_find_alloc(ssize_t offset, ULMRequest_t request);
 void ulm_bsend_clean_alloc(int wantToDetach);
 int ulm_bsend_increment_refcount(ULMRequest_t request, ssize_t offset);
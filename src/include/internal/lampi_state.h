@@ -83,10 +83,15 @@ typedef struct {
 
 typedef struct {
 
-    int *map_global_proc_to_on_host_proc_id; /* global rank to local (on-host) rank map */
-    
-    int *map_global_rank_to_host;   /* global rank to host index map */
+    /*
+     * Ranks are laid out in contiguous blocks by host, so the process
+     * maps are O(nhosts): see global_proc_to_host()
+     */
+    int *map_host_to_first_rank;    /* first global rank on each host,
+                                       nhosts + 1 entries */
     int *map_host_to_local_size;    /* number of procs on a given host */
+    int map_uniform_local_size;     /* procs per host if all hosts have
+                                       the same number, otherwise 0 */
     int global_rank;                /* rank of this process */
     int global_size;                /* total number of processes in COMM_WORLD */
     int global_to_local_offset;
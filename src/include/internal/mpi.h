@@ -238,12 +238,90 @@ struct errhandler_t {
     int refcount;
 };
 
+/*
+ * event tracing: enabled at run time by LAMPI_TRACE; see
+ * mpi/internal/mpi_trace.c
+ */
+
+enum {
+    _MPI_TRACE_SEND = 0,
+    _MPI_TRACE_SSEND,
+    _MPI_TRACE_RSEND,
+    _MPI_TRACE_BSEND,
+    _MPI_TRACE_ISEND,
+    _MPI_TRACE_IRECV,
+    _MPI_TRACE_RECV,
+    _MPI_TRACE_SENDRECV,
+    _MPI_TRACE_WAIT,
+    _MPI_TRACE_WAITALL,
+    _MPI_TRACE_BARRIER,
+    _MPI_TRACE_BCAST,
+    _MPI_TRACE_REDUCE,
+    _MPI_TRACE_ALLREDUCE,
+    _MPI_TRACE_GATHER,
+    _MPI_TRACE_SCATTER,
+    _MPI_TRACE_ALLGATHER,
+    _MPI_TRACE_ALLTOALL,
+    _MPI_TRACE_REDUCE_SCATTER,
+    _MPI_TRACE_NFUNCS
+};
+
+/*
+ * one record per traced call, written as is to the trace file
+ */
+typedef struct _mpi_trace_record_t _mpi_trace_record_t;
+struct _mpi_trace_record_t {
+    long long t_enter;          /* _mpi_trace_clock() on entry */
+    long long t_exit;           /* _mpi_trace_clock() on exit */
+    long long bytes;            /* bytes sent (received for recv/wait) */
+    int func;                   /* _MPI_TRACE_* */
+    int peer;                   /* peer or root rank, or -1 */
+    int tag;                    /* tag, or -1 */
+    int comm;                   /* communicator */
+};
+
+extern int _mpi_trace_enabled;
+extern int _mpi_trace_tsc;
+
+/*
+ * trace time stamps: raw time stamp counter cycles when ulm_dclock()
+ * runs off the TSC, otherwise nanoseconds; the trace file header
+ * gives the scale, so conversion is left to the reader
+ */
+static inline long long _mpi_trace_clock(void)
+{
+#if defined(__x86_64__) && defined(__linux__)
+    if (_mpi_trace_tsc) {
+        unsigned int lo, hi;
+
+        __asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+        return ((long long) hi << 32) | lo;
+    }
+#endif
+    return (long long) (ulm_dclock() * 1.0e9);
+}
+
+#define _MPI_TRACE_BEGIN(T0)                                    \
+    ((T0) = _mpi_trace_enabled ? _mpi_trace_clock() : 0)
+
+#define _MPI_TRACE_END(T0, FUNC, PEER, TAG, COMM, BYTES)        \
+    do {                                                        \
+        if (_mpi_trace_enabled) {                               \
+            _mpi_trace_event((FUNC), (PEER), (TAG), (COMM),     \
+                             (long long) (BYTES), (T0));        \
+        }                                                       \
+    } while (0)
+
 /*
  * function prototypes
  */
 ULMFunc_t *_mpi_get_reduction_function(MPI_Op, MPI_Datatype);
+int _mpi_cart_map(MPI_Comm comm, int ndims, int *dims, int *periods,
+                  int nnodes, int *map);
 int _mpi_error(int ulm_error);
 int _mpi_finalize(void);
+int _mpi_graph_map(MPI_Comm comm, int nnodes, int *index, int *edges,
+                   int *map);
 int _mpi_init(void);
 int _mpi_init_datatypes(void);
 int _mpi_init_operations(void);
@@ -251,8 +329,13 @@ int _mpi_ptr_table_add(ptr_table_t *table, void *ptr);
 int _mpi_ptr_table_free(ptr_table_t *table, int index);
 ptr_table_t *_mpi_create_errhandler_table(void);
 void *_mpi_ptr_table_lookup(ptr_table_t *table, int index);
+void _mpi_ptr_table_destroy(ptr_table_t *table);
 void _mpi_dbg(const char *format, ...);
 void _mpi_errhandler(MPI_Comm comm, int rc, char *file, int line);
+void _mpi_trace_event(int func, int peer, int tag, int comm,
+                      long long bytes, long long t_enter);
+int _mpi_trace_finalize(void);
+int _mpi_trace_init(void);
 
 CDECL_END
 
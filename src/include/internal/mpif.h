@@ -46,9 +46,9 @@ CDECL_BEGIN
  */
 
 #define INLINE		__inline
-#define LOOKUP_OP(X)	((MPI_Op) _mpif.op_table->addr[(X)])
-#define LOOKUP_REQ(X)	((MPI_Request *) &(_mpif.request_table->addr[(X)]))
-#define LOOKUP_TYPE(X)	((MPI_Datatype) _mpif.type_table->addr[(X)])
+#define LOOKUP_OP(X)	((MPI_Op) PTR_TABLE_SLOT(_mpif.op_table, (X)))
+#define LOOKUP_REQ(X)	((MPI_Request *) &PTR_TABLE_SLOT(_mpif.request_table, (X)))
+#define LOOKUP_TYPE(X)	((MPI_Datatype) PTR_TABLE_SLOT(_mpif.type_table, (X)))
 
 /* -7 is the fortran value of MPI_STATUS_IGNORE and MPI_STATUSES_IGNORE */
 #define IGNORE_STATUS(status)     (*((MPI_Fint *) status) == -7)
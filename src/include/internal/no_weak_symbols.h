@@ -50,12 +50,18 @@
 #define PMPI_Address MPI_Address
 #undef PMPI_Allgather
 #define PMPI_Allgather MPI_Allgather
+#undef PMPI_Allgather_init
+#define PMPI_Allgather_init MPI_Allgather_init
 #undef PMPI_Allgatherv
 #define PMPI_Allgatherv MPI_Allgatherv
 #undef PMPI_Allreduce
 #define PMPI_Allreduce MPI_Allreduce
+#undef PMPI_Allreduce_init
+#define PMPI_Allreduce_init MPI_Allreduce_init
 #undef PMPI_Alltoall
 #define PMPI_Alltoall MPI_Alltoall
+#undef PMPI_Alltoall_init
+#define PMPI_Alltoall_init MPI_Alltoall_init
 #undef PMPI_Alltoallv
 #define PMPI_Alltoallv MPI_Alltoallv
 #undef PMPI_Attr_delete
@@ -68,6 +74,8 @@
 #define PMPI_Barrier MPI_Barrier
 #undef PMPI_Bcast
 #define PMPI_Bcast MPI_Bcast
+#undef PMPI_Bcast_init
+#define PMPI_Bcast_init MPI_Bcast_init
 #undef PMPI_Bsend
 #define PMPI_Bsend MPI_Bsend
 #undef PMPI_Bsend_init
@@ -130,6 +138,8 @@
 #define PMPI_Error_class MPI_Error_class
 #undef PMPI_Error_string
 #define PMPI_Error_string MPI_Error_string
+#undef PMPI_Exscan
+#define PMPI_Exscan MPI_Exscan
 #undef PMPI_Finalize
 #define PMPI_Finalize MPI_Finalize
 #undef PMPI_Finalized
@@ -182,6 +192,16 @@
 #define PMPI_Group_translate_ranks MPI_Group_translate_ranks
 #undef PMPI_Group_union
 #define PMPI_Group_union MPI_Group_union
+#undef PMPI_Iallgather
+#define PMPI_Iallgather MPI_Iallgather
+#undef PMPI_Iallreduce
+#define PMPI_Iallreduce MPI_Iallreduce
+#undef PMPI_Ialltoall
+#define PMPI_Ialltoall MPI_Ialltoall
+#undef PMPI_Ibarrier
+#define PMPI_Ibarrier MPI_Ibarrier
+#undef PMPI_Ibcast
+#define PMPI_Ibcast MPI_Ibcast
 #undef PMPI_Ibsend
 #define PMPI_Ibsend MPI_Ibsend
 #undef PMPI_Info_create
@@ -216,6 +236,8 @@
 #define PMPI_Iprobe MPI_Iprobe
 #undef PMPI_Irecv
 #define PMPI_Irecv MPI_Irecv
+#undef PMPI_Ireduce
+#define PMPI_Ireduce MPI_Ireduce
 #undef PMPI_Irsend
 #define PMPI_Irsend MPI_Irsend
 #undef PMPI_Isend
@@ -230,6 +252,14 @@
 #define PMPI_Name_get MPI_Name_get
 #undef PMPI_Name_put
 #define PMPI_Name_put MPI_Name_put
+#undef PMPI_Neighbor_allgather
+#define PMPI_Neighbor_allgather MPI_Neighbor_allgather
+#undef PMPI_Neighbor_allgatherv
+#define PMPI_Neighbor_allgatherv MPI_Neighbor_allgatherv
+#undef PMPI_Neighbor_alltoall
+#define PMPI_Neighbor_alltoall MPI_Neighbor_alltoall
+#undef PMPI_Neighbor_alltoallv
+#define PMPI_Neighbor_alltoallv MPI_Neighbor_alltoallv
 #undef PMPI_Op_create
 #define PMPI_Op_create MPI_Op_create
 #undef PMPI_Op_free
@@ -250,8 +280,12 @@
 #define PMPI_Recv_init MPI_Recv_init
 #undef PMPI_Reduce
 #define PMPI_Reduce MPI_Reduce
+#undef PMPI_Reduce_init
+#define PMPI_Reduce_init MPI_Reduce_init
 #undef PMPI_Reduce_scatter
 #define PMPI_Reduce_scatter MPI_Reduce_scatter
+#undef PMPI_Reduce_scatter_block
+#define PMPI_Reduce_scatter_block MPI_Reduce_scatter_block
 #undef PMPI_Request_c2f
 #define PMPI_Request_c2f MPI_Request_c2f
 #undef PMPI_Request_free
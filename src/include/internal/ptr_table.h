@@ -35,6 +35,7 @@
 #define _ULM_INTERNAL_PTR_TABLE_T
 
 #include "internal/linkage.h"
+#include "internal/system.h"
 #include "os/atomic.h"
 
 CDECL_BEGIN
@@ -43,18 +44,54 @@ CDECL_BEGIN
  * typedefs
  */
 typedef struct ptr_table_t ptr_table_t;
+typedef struct ptr_table_dir_t ptr_table_dir_t;
+
+/*
+ * Slots are held in fixed size segments which never move once
+ * allocated, so a pointer to a slot stays valid as the table grows.
+ */
+enum {
+    PTR_TABLE_SEGMENT_SHIFT = 8,
+    PTR_TABLE_SEGMENT_SIZE = 1 << PTR_TABLE_SEGMENT_SHIFT,
+    PTR_TABLE_SEGMENT_MASK = PTR_TABLE_SEGMENT_SIZE - 1
+};
+
+/*
+ * directory of segments: replaced by a larger copy when the table
+ * grows, with the old copy kept on the retired list until the table
+ * is destroyed, so concurrent lookups never see freed memory
+ */
+struct ptr_table_dir_t {
+    ptr_table_dir_t *retired;
+    int nsegments;
+    int max_segments;
+    void **segment[1];
+};
 
 /*
  * dynamic pointer table (used for MPI requests, dataytypes and ops)
+ *
+ * Lookups read only the first cache line and take no lock; adding
+ * and freeing slots is serialized by the lock.
  */
 struct ptr_table_t {
+    ptr_table_dir_t *volatile dir;      /* segment directory */
+    volatile int size;                  /* number of slots */
+    char pad[CACHE_ALIGNMENT - sizeof(void *) - sizeof(int)];
     lockStructure_t lock[1];
-    int lowest_free;
-    int number_free;
-    int size;
-    void **addr;
+    int high_water;                     /* slots [0,high_water) used */
+    int number_free;                    /* freed slots below high_water */
+    int max_free;                       /* capacity of free_index */
+    int *free_index;                    /* stack of freed slots */
 };
 
+/*
+ * table slot for index I (an lvalue)
+ */
+#define PTR_TABLE_SLOT(T, I)                                    \
+    ((T)->dir->segment[(I) >> PTR_TABLE_SEGMENT_SHIFT]          \
+                      [(I) & PTR_TABLE_SEGMENT_MASK])
+
 CDECL_END
 
 #endif /* !_ULM_INTERNAL_PTR_TABLE_T  */
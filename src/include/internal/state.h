@@ -118,7 +118,30 @@ inline int global_to_local_proc(int x)
 
 inline long global_proc_to_host(long x)
 {
-    return lampiState.map_global_rank_to_host[x];
+    int lo, hi, mid;
+
+    if (lampiState.map_uniform_local_size > 0) {
+        return x / lampiState.map_uniform_local_size;
+    }
+
+    /* last host whose block starts at or before x */
+    lo = 0;
+    hi = lampiState.nhosts - 1;
+    while (lo < hi) {
+        mid = (lo + hi + 1) / 2;
+        if (lampiState.map_host_to_first_rank[mid] <= x) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+inline int global_proc_to_on_host_proc(long x)
+{
+    return x - lampiState.map_host_to_first_rank[global_proc_to_host(x)];
 }
 
 inline int usethreads()
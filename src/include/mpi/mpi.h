@@ -119,9 +119,12 @@ extern "C"
 int MPI_Abort(MPI_Comm, int);
 int MPI_Address(void *, MPI_Aint *);
 int MPI_Allgather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int MPI_Allgather_init(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
 int MPI_Allgatherv(void *, int, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
 int MPI_Allreduce(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
+int MPI_Allreduce_init(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Request *);
 int MPI_Alltoall(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int MPI_Alltoall_init(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
 int MPI_Alltoallv(void *, int *, int *, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
 int MPI_Alltoallw(void *, int *, int *, MPI_Datatype *, void *, int *, int *, MPI_Datatype *, MPI_Comm);
 int MPI_Attr_delete(MPI_Comm, int);
@@ -129,6 +132,7 @@ int MPI_Attr_get(MPI_Comm, int, void *, int *);
 int MPI_Attr_put(MPI_Comm, int, void *);
 int MPI_Barrier(MPI_Comm);
 int MPI_Bcast(void *, int, MPI_Datatype, int, MPI_Comm);
+int MPI_Bcast_init(void *, int, MPI_Datatype, int, MPI_Comm, MPI_Request *);
 int MPI_Bsend(void *, int, MPI_Datatype, int, int, MPI_Comm);
 int MPI_Bsend_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int MPI_Buffer_attach(void *, int);
@@ -166,6 +170,7 @@ int MPI_Errhandler_get(MPI_Comm, MPI_Errhandler *);
 int MPI_Errhandler_set(MPI_Comm, MPI_Errhandler);
 int MPI_Error_class(int, int *);
 int MPI_Error_string(int, char *, int *);
+int MPI_Exscan(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
 int MPI_Finalize(void);
 int MPI_Finalized(int *);
 int MPI_Gather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, int, MPI_Comm);
@@ -193,6 +198,11 @@ int MPI_Group_rank(MPI_Group, int *);
 int MPI_Group_size(MPI_Group, int *);
 int MPI_Group_translate_ranks(MPI_Group, int, int *, MPI_Group, int *);
 int MPI_Group_union(MPI_Group, MPI_Group, MPI_Group *);
+int MPI_Iallgather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
+int MPI_Iallreduce(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Request *);
+int MPI_Ialltoall(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
+int MPI_Ibarrier(MPI_Comm, MPI_Request *);
+int MPI_Ibcast(void *, int, MPI_Datatype, int, MPI_Comm, MPI_Request *);
 int MPI_Ibsend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int MPI_Init(int *, char ***);
 int MPI_Init_thread(int *, char ***, int, int *);
@@ -201,11 +211,16 @@ int MPI_Intercomm_create(MPI_Comm, int, MPI_Comm, int, int, MPI_Comm *);
 int MPI_Intercomm_merge(MPI_Comm, int, MPI_Comm *);
 int MPI_Iprobe(int, int, MPI_Comm, int *, MPI_Status *);
 int MPI_Irecv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
+int MPI_Ireduce(void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm, MPI_Request *);
 int MPI_Irsend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int MPI_Isend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int MPI_Issend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int MPI_Keyval_create(MPI_Copy_function *, MPI_Delete_function *, int *, void *);
 int MPI_Keyval_free(int *);
+int MPI_Neighbor_allgather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int MPI_Neighbor_allgatherv(void *, int, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
+int MPI_Neighbor_alltoall(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int MPI_Neighbor_alltoallv(void *, int *, int *, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
 int MPI_Op_create(MPI_User_function *, int, MPI_Op *);
 int MPI_Op_free(MPI_Op *);
 int MPI_Pack(void *, int, MPI_Datatype, void *, int, int *, MPI_Comm);
@@ -216,7 +231,9 @@ int MPI_Query_thread(int *);
 int MPI_Recv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Status *);
 int MPI_Recv_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int MPI_Reduce(void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm);
+int MPI_Reduce_init(void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm, MPI_Request *);
 int MPI_Reduce_scatter(void *, void *, int *, MPI_Datatype, MPI_Op, MPI_Comm);
+int MPI_Reduce_scatter_block(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
 int MPI_Request_free(MPI_Request *);
 int MPI_Rsend(void *, int, MPI_Datatype, int, int, MPI_Comm);
 int MPI_Rsend_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
@@ -279,9 +296,12 @@ double MPI_Wtime(void);
 int PMPI_Abort(MPI_Comm, int);
 int PMPI_Address(void *, MPI_Aint *);
 int PMPI_Allgather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int PMPI_Allgather_init(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
 int PMPI_Allgatherv(void *, int, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
 int PMPI_Allreduce(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
+int PMPI_Allreduce_init(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Request *);
 int PMPI_Alltoall(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int PMPI_Alltoall_init(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
 int PMPI_Alltoallv(void *, int *, int *, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
 int PMPI_Alltoallw(void *, int *, int *, MPI_Datatype *, void *, int *, int *, MPI_Datatype *, MPI_Comm);
 int PMPI_Attr_delete(MPI_Comm, int);
@@ -289,6 +309,7 @@ int PMPI_Attr_get(MPI_Comm, int, void *, int *);
 int PMPI_Attr_put(MPI_Comm, int, void *);
 int PMPI_Barrier(MPI_Comm);
 int PMPI_Bcast(void *, int, MPI_Datatype, int, MPI_Comm);
+int PMPI_Bcast_init(void *, int, MPI_Datatype, int, MPI_Comm, MPI_Request *);
 int PMPI_Bsend(void *, int, MPI_Datatype, int, int, MPI_Comm);
 int PMPI_Bsend_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int PMPI_Buffer_attach(void *, int);
@@ -326,6 +347,7 @@ int PMPI_Errhandler_get(MPI_Comm, MPI_Errhandler *);
 int PMPI_Errhandler_set(MPI_Comm, MPI_Errhandler);
 int PMPI_Error_class(int, int *);
 int PMPI_Error_string(int, char *, int *);
+int PMPI_Exscan(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
 int PMPI_Finalize(void);
 int PMPI_Finalized(int *);
 int PMPI_Gather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, int, MPI_Comm);
@@ -353,6 +375,11 @@ int PMPI_Group_rank(MPI_Group, int *);
 int PMPI_Group_size(MPI_Group, int *);
 int PMPI_Group_translate_ranks(MPI_Group, int, int *, MPI_Group, int *);
 int PMPI_Group_union(MPI_Group, MPI_Group, MPI_Group *);
+int PMPI_Iallgather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
+int PMPI_Iallreduce(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Request *);
+int PMPI_Ialltoall(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm, MPI_Request *);
+int PMPI_Ibarrier(MPI_Comm, MPI_Request *);
+int PMPI_Ibcast(void *, int, MPI_Datatype, int, MPI_Comm, MPI_Request *);
 int PMPI_Ibsend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int PMPI_Init(int *, char ***);
 int PMPI_Init_thread(int *, char ***, int, int *);
@@ -361,11 +388,16 @@ int PMPI_Intercomm_create(MPI_Comm, int, MPI_Comm, int, int, MPI_Comm *);
 int PMPI_Intercomm_merge(MPI_Comm, int, MPI_Comm *);
 int PMPI_Iprobe(int, int, MPI_Comm, int *, MPI_Status *);
 int PMPI_Irecv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
+int PMPI_Ireduce(void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm, MPI_Request *);
 int PMPI_Irsend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int PMPI_Isend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int PMPI_Issend(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int PMPI_Keyval_create(MPI_Copy_function *, MPI_Delete_function *, int *, void *);
 int PMPI_Keyval_free(int *);
+int PMPI_Neighbor_allgather(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int PMPI_Neighbor_allgatherv(void *, int, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
+int PMPI_Neighbor_alltoall(void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm);
+int PMPI_Neighbor_alltoallv(void *, int *, int *, MPI_Datatype, void *, int *, int *, MPI_Datatype, MPI_Comm);
 int PMPI_Op_create(MPI_User_function *, int, MPI_Op *);
 int PMPI_Op_free(MPI_Op *);
 int PMPI_Pack(void *, int, MPI_Datatype, void *, int, int *, MPI_Comm);
@@ -376,7 +408,9 @@ int PMPI_Query_thread(int *);
 int PMPI_Recv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Status *);
 int PMPI_Recv_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
 int PMPI_Reduce(void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm);
+int PMPI_Reduce_init(void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm, MPI_Request *);
 int PMPI_Reduce_scatter(void *, void *, int *, MPI_Datatype, MPI_Op, MPI_Comm);
+int PMPI_Reduce_scatter_block(void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
 int PMPI_Request_free(MPI_Request *);
 int PMPI_Rsend(void *, int, MPI_Datatype, int, int, MPI_Comm);
 int PMPI_Rsend_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
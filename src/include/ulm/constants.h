@@ -88,6 +88,7 @@ enum ULMInfo_t {
     ULM_INFO_THIS_HOST_PROCIDS,
     ULM_INFO_THIS_HOST_COMM_ROOT,
     ULM_INFO_HOST_COMM_ROOTS,
+    ULM_INFO_HOSTIDS,
     _ULM_INFO_END_
 };
 typedef enum ULMInfo_t ULMInfo_t;
@@ -110,7 +111,9 @@ enum {
     ULM_COLLECTIVE_REDUCE_SCATTER,
     ULM_COLLECTIVE_SCAN,
     ULM_COLLECTIVE_SCATTER,
-    ULM_COLLECTIVE_SCATTERV
+    ULM_COLLECTIVE_SCATTERV,
+    ULM_COLLECTIVE_REDUCE_SCATTER_BLOCK,
+    ULM_COLLECTIVE_EXSCAN
 };
 
 /*
@@ -348,6 +348,8 @@ typedef int (ulm_reduce_t) (const void *, void *, int, ULMType_t *,
 			    ULMOp_t *, int, int);
 typedef int (ulm_reduce_scatter_t) (void *, void *, int *, ULMType_t *,
 				    ULMOp_t *, int);
+typedef int (ulm_reduce_scatter_block_t) (void *, void *, int, ULMType_t *,
+					  ULMOp_t *, int);
 typedef int (ulm_scan_t) (const void *, void *, int, ULMType_t *,
 			  ULMOp_t *, int);
 typedef int (ulm_scatter_t) (void *, int, ULMType_t *, void *, int,
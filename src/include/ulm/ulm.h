@@ -92,6 +92,21 @@ void ulm_finalize(void);
  */
 double ulm_dclock(void);
 
+/*!
+ * dclock resolution
+ *
+ * \return              Seconds between successive clock ticks (double)
+ */
+double ulm_dclock_resolution(void);
+
+/*!
+ * Whether dclock runs off the processor time stamp counter
+ *
+ * \param secs_per_cycle        Seconds per TSC cycle, if it does
+ * \return              1 if dclock uses the TSC, 0 otherwise
+ */
+int ulm_dclock_tsc(double *secs_per_cycle);
+
 /*!
  * abort function
  *
@@ -120,6 +135,19 @@ int ulm_make_progress(void);
  */
 int ulm_bind_pt2pt_message(ULMRequest_t *req, int comm, int dst);
 
+/*!
+ * send a small contiguous message without a send descriptor, if the
+ * path ulm_bind_pt2pt_message would pick for it can do so
+ *
+ * \param buf           Data buffer
+ * \param size          Message length in bytes
+ * \param comm          Communicator ID
+ * \param dst           Destination process
+ * \param tag           Message tag
+ * \return              1 if the message was sent, 0 otherwise
+ */
+int ulm_send_inline(void *buf, size_t size, int comm, int dst, int tag);
+
 /*!
  * set the functions to bind point-to-point messages to
  * path objects; which is by default ulm_bind_pt2pt_message ; 
@@ -174,6 +202,26 @@ int ulm_set_topology(int comm, ULMTopology_t *topology);
  */
 int ulm_pending_messages(int *flag);
 
+/*!
+ * Unexpected message data held by this process: bytes received
+ * before a matching receive was posted, now and at the most
+ *
+ * \param proc          Sending process (global ProcID), or -1 for all
+ * \param bytes         Unexpected bytes held now
+ * \param highwater     Most unexpected bytes held at any time
+ * \return              ULM return code
+ */
+int ulm_unexpected_bytes(int proc, size_t *bytes, size_t *highwater);
+
+/*!
+ * Eager data that on-host senders have reserved against this process
+ * and that it has not yet matched
+ *
+ * \param bytes         Reserved bytes, over all on-host senders
+ * \return              ULM return code
+ */
+int ulm_eager_bytes(size_t *bytes);
+
 /*!
  * Non-blocking send
  *
@@ -592,9 +640,95 @@ int ulm_scatterv(void *sendbuf, int *sendcounts, int *displs,
 int ulm_reduce(const void *sendbuf, void *recvbuf, int count,
 	       ULMType_t *type, ULMOp_t *op, int root, int comm);
 
+/*!
+ * ulm_reduce_scatter
+ *
+ * \param sendbuf       (choice)    The starting address of the send buffer
+ * \param recvbuf       (choice)    Address of the receive buffer
+ * \param recvcounts    (int*)      Integer array (of length group size)
+ * \param type          (handle)    Data type of send buffer elements
+ * \param OPtype        (handle)    OP type
+ * \param comm          (int)       Communicator
+ */
+int ulm_reduce_scatter(void *sendbuf, void *recvbuf, int *recvcounts,
+		       ULMType_t *type, ULMOp_t *op, int comm);
+
+/*!
+ * ulm_reduce_scatter_block
+ *
+ * \param sendbuf       (choice)    The starting address of the send buffer
+ * \param recvbuf       (choice)    Address of the receive buffer
+ * \param recvcount     (integer)   Number of elements per process
+ * \param type          (handle)    Data type of send buffer elements
+ * \param OPtype        (handle)    OP type
+ * \param comm          (int)       Communicator
+ */
+int ulm_reduce_scatter_block(void *sendbuf, void *recvbuf, int recvcount,
+			     ULMType_t *type, ULMOp_t *op, int comm);
+
 int ulm_scan(const void *sendbuf, void *recvbuf, int count,
 	     ULMType_t *type, ULMOp_t *op, int comm);
 
+int ulm_exscan(const void *sendbuf, void *recvbuf, int count,
+	       ULMType_t *type, ULMOp_t *op, int comm);
+
+/*
+ * non-blocking collectives: the request is completed by ulm_wait or
+ * ulm_test, and progressed by ulm_make_progress
+ */
+int ulm_ibarrier(int comm, ULMRequest_t *request);
+int ulm_ibcast(void *buf, int count, ULMType_t *type, int root, int comm,
+	       ULMRequest_t *request);
+int ulm_ireduce(void *sendbuf, void *recvbuf, int count, ULMType_t *type,
+		ULMOp_t *op, int root, int comm, ULMRequest_t *request);
+int ulm_iallreduce(void *sendbuf, void *recvbuf, int count,
+		   ULMType_t *type, ULMOp_t *op, int comm,
+		   ULMRequest_t *request);
+int ulm_ialltoall(void *sendbuf, int sendcount, ULMType_t *sendtype,
+		  void *recvbuf, int recvcount, ULMType_t *recvtype,
+		  int comm, ULMRequest_t *request);
+int ulm_iallgather(void *sendbuf, int sendcount, ULMType_t *sendtype,
+		   void *recvbuf, int recvcount, ULMType_t *recvtype,
+		   int comm, ULMRequest_t *request);
+
+/*
+ * persistent collectives: the request is started by ulm_start, and
+ * completed by ulm_wait or ulm_test, any number of times
+ */
+int ulm_bcast_init(void *buf, int count, ULMType_t *type, int root,
+		   int comm, ULMRequest_t *request);
+int ulm_reduce_init(void *sendbuf, void *recvbuf, int count,
+		    ULMType_t *type, ULMOp_t *op, int root, int comm,
+		    ULMRequest_t *request);
+int ulm_allreduce_init(void *sendbuf, void *recvbuf, int count,
+		       ULMType_t *type, ULMOp_t *op, int comm,
+		       ULMRequest_t *request);
+int ulm_alltoall_init(void *sendbuf, int sendcount, ULMType_t *sendtype,
+		      void *recvbuf, int recvcount, ULMType_t *recvtype,
+		      int comm, ULMRequest_t *request);
+int ulm_allgather_init(void *sendbuf, int sendcount, ULMType_t *sendtype,
+		       void *recvbuf, int recvcount, ULMType_t *recvtype,
+		       int comm, ULMRequest_t *request);
+
+/*
+ * neighborhood collectives on communicators with a Cartesian or
+ * graph topology: block j of each buffer belongs to the j-th neighbor
+ */
+int ulm_neighbor_allgather(void *sendbuf, int sendcount,
+			   ULMType_t *sendtype, void *recvbuf,
+			   int recvcount, ULMType_t *recvtype, int comm);
+int ulm_neighbor_allgatherv(void *sendbuf, int sendcount,
+			    ULMType_t *sendtype, void *recvbuf,
+			    int *recvcounts, int *displs,
+			    ULMType_t *recvtype, int comm);
+int ulm_neighbor_alltoall(void *sendbuf, int sendcount,
+			  ULMType_t *sendtype, void *recvbuf,
+			  int recvcount, ULMType_t *recvtype, int comm);
+int ulm_neighbor_alltoallv(void *sendbuf, int *sendcounts, int *sdispls,
+			   ULMType_t *sendtype, void *recvbuf,
+			   int *recvcounts, int *rdispls,
+			   ULMType_t *recvtype, int comm);
+
 /*
  * group functions
  */
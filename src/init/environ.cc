@@ -113,8 +113,25 @@ static struct {
     /* BPROC info. */
     { "BPROC_RANK", -1 },
 	
-    /* Processor affinity (experimental) */
+    /* Processor binding: 0 none, 1 compact, 2 scatter across sockets */
     { "LAMPI_PROCESSOR_AFFINITY", 0 },
+
+    /* MPI event tracing: enable, and ring buffer size in events */
+    { "LAMPI_TRACE", 0 },
+    { "LAMPI_TRACE_EVENTS", 65536 },
+
+    /* use the time stamp counter for dclock() where it is invariant */
+    { "LAMPI_DCLOCK_TSC", 1 },
+
+    /* huge pages for memory pools: 0 none, 1 default size, 2 1 GB */
+    { "LAMPI_HUGEPAGES", 0 },
+
+    /* largest shared memory send made without a descriptor, -1 never */
+    { "LAMPI_INLINE_SEND", 1024 },
+
+    /* unexpected message bytes held for one sender, and for all */
+    { "LAMPI_UNEXPECTED_PEER_LIMIT", 4 * 1024 * 1024 },
+    { "LAMPI_UNEXPECTED_LIMIT", 64 * 1024 * 1024 },
     
     { NULL }
 };
@@ -140,6 +157,18 @@ static struct {
 
     /* BPROC info. */
     { "NODES", "" },
+
+    /* on-host barrier algorithm: sense, tree or dissemination */
+    { "LAMPI_BARRIER", "" },
+
+    /* collective algorithm tuning file */
+    { "LAMPI_COLL_TUNE", "" },
+
+    /* MPI event trace file prefix */
+    { "LAMPI_TRACE_FILE", "lampi-trace" },
+
+    /* hugetlbfs mount for huge pages when MAP_HUGETLB is unavailable */
+    { "LAMPI_HUGEPAGE_PATH", "" },
 	
     { NULL }
 };
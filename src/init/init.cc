@@ -62,6 +62,7 @@
 #endif
 
 #include "queue/Communicator.h"
+#include "queue/FlowControl.h"
 #include "queue/contextID.h"
 #include "queue/globals.h"
 #include "client/adminMessage.h"
@@ -343,7 +344,7 @@ void lampi_init_prefork_globals(lampiState_t *s)
     /* do not prepend informative prefix to stdout/stderr */
     lampiState.output_prefix = 0;
     lampiState.quiet = 0;
-    lampiState.map_global_proc_to_on_host_proc_id = 0;
+    lampiState.map_host_to_first_rank = 0;
 }
 
 
@@ -474,7 +475,7 @@ void lampi_init_prefork_resources(lampiState_t *s)
     int *sPtr = (int *) SharedMemoryPools.getMemorySegment
         (sizeof(int), CACHE_ALIGNMENT);
     s->client->setupCollectives(s->local_rank, s->hostid,
-                                s->map_global_rank_to_host,
+                                s->map_host_to_first_rank,
                                 daemonIsHostCommRoot, lenSMBuffer,
                                 sharedBufferPtr, lockPtr, CounterPtr,
                                 sPtr);
@@ -610,46 +611,10 @@ void lampi_init_postfork_resources(lampiState_t *s)
         lampi_init_print("lampi_init_postfork_resources");
     }
 
-#undef HAVE_SCHED_SETAFFINITY
-#ifdef HAVE_SCHED_SETAFFINITY
     /*
-     * Enable processor affinity (experimental)
+     * Bind to the processor chosen by getCPUSet()
      */
-    int flag = 0;
-    lampi_environ_find_integer("LAMPI_PROCESSOR_AFFINITY", &flag);
-    if (flag) {
-        unsigned long mask;
-
-        if (lampiState.local_size < 8 * sizeof(mask)) {
-            mask = (1 << lampiState.local_rank);
-            if (sched_setaffinity(0, sizeof(mask), &mask) < 0) {
-                ulm_warn(("Warning: sched_setaffinity() failed: errno = %d\n",
-                          strerror(errno)));
-            }
-        }
-    }
-#endif
-
-    //
-    // Figure out which box we're on and the offset that converts a
-    // global proc id to a local one.
-    //
-
-    // setup ulm's global rank to local rank mapping
-    lampiState.map_global_proc_to_on_host_proc_id =
-        (int *) ulm_malloc(sizeof(int) * lampiState.global_size);
-    if (!lampiState.map_global_proc_to_on_host_proc_id) {
-        ulm_exit(("Unable to allocate space for "
-                  "lampiState.map_global_proc_to_on_host_proc_id\n"));
-    }
-    int offset = 0;
-    for (int h = 0; h < lampiState.nhosts; ++h) {
-        for (int lp = 0; lp < lampiState.map_host_to_local_size[h]; lp++) {
-            lampiState.map_global_proc_to_on_host_proc_id[offset + lp] =
-                lp;
-        }
-        offset += lampiState.map_host_to_local_size[h];
-    }
+    setCPUAffinity(lampiState.local_rank);
 
     //
     // initialize send queues
@@ -663,6 +628,11 @@ void lampi_init_postfork_resources(lampiState_t *s)
     //initialize "to be sent" ack queue
     UnprocessedAcks.Lock.init();
 
+    //
+    // unexpected message accounting and limits, used by the paths
+    //
+    flowControl.init();
+
     //
     // reliablity protocol initialization
     //
@@ -1052,7 +1022,7 @@ void lampi_init_prefork_connect_to_mpirun(lampiState_t *s)
 
 void lampi_init_prefork_receive_setup_params(lampiState_t *s)
 {
-    int tag, errorCode, recvd, h, i, p;
+    int tag, errorCode, recvd, h, p;
     int pathcnt, *paths;
 
     if (s->error) {
@@ -1153,12 +1123,10 @@ void lampi_init_prefork_receive_setup_params(lampiState_t *s)
                               (adminMessage::packType) sizeof(int), 1);
             break;
 
-#if ENABLE_NUMA
         case adminMessage::CPULIST:
             // list of cpus to use
         {
-            int c, cpulistlen, *cpulist;
-            constraint_info my_c;
+            int cpulistlen, *cpulist;
             s->client->unpack(&cpulistlen,
                               (adminMessage::packType) sizeof(int), 1);
 
@@ -1166,17 +1134,23 @@ void lampi_init_prefork_receive_setup_params(lampiState_t *s)
             s->client->unpack(cpulist,
                               (adminMessage::packType) sizeof(int),
                               cpulistlen);
+#if ENABLE_NUMA
+            constraint_info my_c;
             my_c.reset_mask(C_MUST_USE);
             my_c.set_type(R_CPU);
 
-            for (c = 0; c < cpulistlen; c++) {
+            for (int c = 0; c < cpulistlen; c++) {
                 my_c.set_num(cpulist[c]);
                 ULMreq->add_constraint(R_CPU, 1, &my_c);
             }
+#else
+            setCPUList(cpulistlen, cpulist);
+#endif
             ulm_delete(cpulist);
         }
         break;
 
+#if ENABLE_NUMA
         case adminMessage::NCPUSPERNODE:
             /* number of cpus per node to use */
             s->client->unpack(&nCpPNode,
@@ -1361,14 +1335,20 @@ case adminMessage::DEFAULTRESOURCEAFFINITY:
     *lampiState.sync.AllHostsDone = 0;
 
     /*
-     * Build an array that maps from global process
-     * number to the box number.
+     * Build the map from global process number to host: the first
+     * rank on each host, and the block size if it is the same on
+     * every host
      */
-    s->map_global_rank_to_host = ulm_new(int, nprocs());
+    s->map_host_to_first_rank = ulm_new(int, s->nhosts + 1);
+    s->map_uniform_local_size = s->map_host_to_local_size[0];
     p = 0;
-    for (h = 0; h < s->nhosts; ++h)
-        for (i = 0; i < s->map_host_to_local_size[h]; ++i)
-            s->map_global_rank_to_host[p++] = h;
+    for (h = 0; h < s->nhosts; ++h) {
+        s->map_host_to_first_rank[h] = p;
+        p += s->map_host_to_local_size[h];
+        if (s->map_host_to_local_size[h] != s->map_uniform_local_size)
+            s->map_uniform_local_size = 0;
+    }
+    s->map_host_to_first_rank[s->nhosts] = p;
 
     /*
      * receive path specific information
@@ -23,6 +23,7 @@ SRC_LIBMPI += \
 	src/interface/ulm_comm_test_inter.cc \
 	src/interface/ulm_communicator_alloc.cc \
 	src/interface/ulm_dclock.cc \
+	src/interface/ulm_eager_bytes.cc \
 	src/interface/ulm_f_keyval_create.cc \
 	src/interface/ulm_finalize.cc \
 	src/interface/ulm_get_errhandler_index.cc \
@@ -70,4 +71,5 @@ SRC_LIBMPI += \
 	src/interface/ulm_type_iscontig.cc \
 	src/interface/ulm_test.cc \
 	src/interface/ulm_testall.cc \
+	src/interface/ulm_unexpected_bytes.cc \
 	src/interface/ulm_wait.cc 
@@ -83,37 +83,13 @@ extern "C" int ulm_bind_pt2pt_message(ULMRequest_t *request, int ctx,int destina
             }
             /* allocate sharedmemSendInfo data */
             SendDesc->pathInfo.sharedmem.sharedData =
-                (sharedMemData_t *) SMPSendDescs.
-                getElement(getMemPoolIndex(), errorCode);
+                allocSMPSendHeader(&errorCode);
             if (!(SendDesc->pathInfo.sharedmem.sharedData)) {
                 return errorCode;
             }
-            /* compute address of first frag */
-            size_t offsetToFirstFrag = sizeof(sharedMemData_t);
-            SendDesc->pathInfo.sharedmem.firstFrag =
-                (SMPFragDesc_t *) ((char *) SendDesc->pathInfo.sharedmem.
-                                   sharedData + offsetToFirstFrag);
-            /* placement new */
-            new(SendDesc->pathInfo.sharedmem.firstFrag)
-                SMPFragDesc_t(getMemPoolIndex());
-
-            /* compute address of first frag payload -
-             * will never change */
-            size_t offsetToPayload =
-                (((sizeof(sharedMemData_t) + sizeof(SMPFragDesc_t) -
-                   1) / CACHE_ALIGNMENT) + 1) * CACHE_ALIGNMENT;
-            void *firstFragPayloadAddr =
-                (void *) ((char *) SendDesc->pathInfo.sharedmem.
-                          sharedData + offsetToPayload);
-
-            /* set the payload address in the first frag */
-            SendDesc->pathInfo.sharedmem.firstFrag->addr_m =
-                firstFragPayloadAddr;
-
-            // fill in pointer to send descriptor
-            SendDesc->pathInfo.sharedmem.firstFrag->SendingHeader_m.SMP =
-                (sharedMemData_t *) SendDesc->pathInfo.sharedmem.
-                sharedData;
+            SendDesc->pathInfo.sharedmem.firstFrag = (SMPFragDesc_t *)
+                ((char *) SendDesc->pathInfo.sharedmem.sharedData +
+                 sizeof(sharedMemData_t));
         }
         pathArray[useLocal]->bind(SendDesc, &globalDestID, 1, &errorCode);
     }
@@ -179,3 +155,31 @@ extern "C" int ulm_bind_pt2pt_message(ULMRequest_t *request, int ctx,int destina
 
     return errorCode;
 }
+
+
+/*!
+ * default - send a small contiguous message without a send
+ * descriptor, on the path ulm_bind_pt2pt_message would bind it to
+ *
+ * \param buf       data buffer
+ * \param size      message length in bytes
+ * \param ctx       communicator ID
+ * \param dst       destination process
+ * \param tag       message tag
+ * \return          1 if the message was sent, 0 otherwise
+ */
+extern "C" int ulm_send_inline(void *buf, size_t size, int ctx, int dst,
+                               int tag)
+{
+    int globalDestID =
+        communicators[ctx]->remoteGroup->mapGroupProcIDToGlobalProcID[dst];
+
+    // only shared memory guarantees delivery without a descriptor to
+    // retransmit from
+    if (pathList[globalDestID].useSharedMemory_m >= 0) {
+        int useLocal = pathList[globalDestID].useSharedMemory_m;
+        return pathArray[useLocal]->sendInline(buf, size, dst, tag, ctx);
+    }
+
+    return 0;
+}
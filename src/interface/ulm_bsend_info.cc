@@ -36,6 +36,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 
 #include "internal/buffer.h"
 #include "internal/log.h"
@@ -50,19 +51,19 @@ extern "C" void ulm_bsend_info_set(ULMRequest_t request,
                                    void *originalBuffer, size_t bufferSize,
                                    int count, ULMType_t * datatype)
 {
-    SendDesc_t *sendDesc = (SendDesc_t *) request;
+    SendDesc_t::bsendInfo_t *bsend = ((SendDesc_t *) request)->bsendInfo();
 
     if ((datatype != NULL) && (datatype->layout == CONTIGUOUS)
         && (datatype->num_pairs != 0)) {
-        sendDesc->appBufferPointer =
+        bsend->appBufferPointer =
             (void *) ((char *) originalBuffer +
                       datatype->type_map[0].offset);
     } else {
-        sendDesc->appBufferPointer = originalBuffer;
+        bsend->appBufferPointer = originalBuffer;
     }
-    sendDesc->bsendBufferSize = bufferSize;
-    sendDesc->bsendDtypeCount = count;
-    sendDesc->bsendDatatype = datatype;
+    bsend->bufferSize = bufferSize;
+    bsend->dtypeCount = count;
+    bsend->datatype = datatype;
     ulm_type_retain(datatype);
 }
 
@@ -72,109 +73,365 @@ extern "C" void ulm_bsend_info_get(ULMRequest_t request,
                                    ULMType_t ** datatype, int *comm)
 {
     SendDesc_t *sendDesc = (SendDesc_t *) request;
+    SendDesc_t::bsendInfo_t *bsend = sendDesc->bsendInfo();
 
-    *originalBuffer = sendDesc->appBufferPointer;
-    *bufferSize = sendDesc->bsendBufferSize;
-    *count = sendDesc->bsendDtypeCount;
+    *originalBuffer = bsend->appBufferPointer;
+    *bufferSize = bsend->bufferSize;
+    *count = bsend->dtypeCount;
     *comm = sendDesc->ctx_m;
-    *datatype = sendDesc->bsendDatatype;
+    *datatype = bsend->datatype;
 }
 
-extern "C" ULMBufferRange_t * ulm_bsend_alloc(ssize_t size, int freeAtZero)
+/*
+ * Buffered send allocator.
+ *
+ * At any given time, only one buffer is in use as pointed to by
+ * lampiState.bsendData->buffer.  This is set up with
+ * MPI_Buffer_attach.  The buffer is tiled by ULMBufferRange_t
+ * structures kept in address order.  Free ranges also sit on a free
+ * list for their size class; allocated ranges sit in a hash table
+ * keyed by offset so that completing sends can find and release
+ * their allocation without a search.
+ *
+ * All routines must be called with lampiState.bsendData->lock held.
+ */
+
+#define BSEND (lampiState.bsendData)
+
+/*
+ * size class of a free range: floor(log2(len))
+ */
+static inline int bsend_class(ssize_t len)
 {
-    /*
-       At any given time, only one buffer is in use as pointed to by
-       lampiState.bsendData->buffer.  This is set up with the
-       MPI_Buffer_attach.  lampiState.bsendData->allocations is a
-       linked list that contains blocks of allocations from the
-       buffer.  This routine attempts to grab another chunk of memory
-       from the buffer and records the chunk with a new
-       ULMBufferRange_t struct and adds it to the allocations linked
-       list.
-     */
+    int c = 0;
 
-    /* make sure there is at least a possibility of satisfying this allocation request */
-    if ((lampiState.bsendData->bufferLength -
-         lampiState.bsendData->bytesInUse) < size)
-        return NULL;
+    while (len > 1 && c < ULM_BSEND_NUM_CLASSES - 1) {
+        len >>= 1;
+        c++;
+    }
 
-    ULMBufferRange_t *result =
-        (ULMBufferRange_t *) ulm_malloc(sizeof(ULMBufferRange_t));
-    ULMBufferRange_t *next, *prev;
-    int allocated = 0;
+    return c;
+}
 
-    /* return null if we can't allocate memory for a new allocation */
-    if (result == NULL)
-        return result;
+static inline int bsend_hash(ssize_t offset)
+{
+    return (int) ((offset ^ (offset >> 8)) & (ULM_BSEND_HASH_SIZE - 1));
+}
 
-    result->len = size;
-    result->request = NULL;
-    result->refCount = -1;
-    result->freeAtZeroRefCount = freeAtZero;
+static ULMBufferRange_t *bsend_get_range(void)
+{
+    ULMBufferRange_t *range;
+
+    if (BSEND->spareRanges == NULL) {
+        /* the first structure in a chunk links the chunks for detach */
+        range = (ULMBufferRange_t *)
+            ulm_malloc((ULM_BSEND_RANGE_CHUNK + 1) *
+                       sizeof(ULMBufferRange_t));
+        if (range == NULL) {
+            return NULL;
+        }
+        range[0].next = BSEND->rangeChunks;
+        BSEND->rangeChunks = &range[0];
+        for (int i = 1; i <= ULM_BSEND_RANGE_CHUNK; i++) {
+            range[i].next = BSEND->spareRanges;
+            BSEND->spareRanges = &range[i];
+        }
+    }
 
-    for (next = prev = lampiState.bsendData->allocations; next != NULL;
-         prev = next, next = next->next) {
-        /* is there room at the beginning of the buffer? */
-        if (next == prev) {
-            if (next->offset >= size) {
-                result->next = next;
-                result->offset = 0;
-                lampiState.bsendData->allocations = result;
-                allocated = 1;
-                break;
-            }
+    range = BSEND->spareRanges;
+    BSEND->spareRanges = range->next;
+
+    return range;
+}
+
+static void bsend_put_range(ULMBufferRange_t *range)
+{
+    range->next = BSEND->spareRanges;
+    BSEND->spareRanges = range;
+}
+
+/*
+ * release the range cache; every range must be back on it
+ */
+static void bsend_free_ranges(void)
+{
+    ULMBufferRange_t *chunk;
+
+    while (BSEND->rangeChunks) {
+        chunk = BSEND->rangeChunks;
+        BSEND->rangeChunks = chunk->next;
+        ulm_free(chunk);
+    }
+    BSEND->spareRanges = NULL;
+}
+
+static void bsend_free_list_insert(ULMBufferRange_t *range)
+{
+    int c = bsend_class(range->len);
+
+    range->isFree = 1;
+    range->linkPrev = NULL;
+    range->linkNext = BSEND->freeLists[c];
+    if (range->linkNext) {
+        range->linkNext->linkPrev = range;
+    }
+    BSEND->freeLists[c] = range;
+    BSEND->freeMap |= (1U << c);
+}
+
+static void bsend_free_list_remove(ULMBufferRange_t *range)
+{
+    int c = bsend_class(range->len);
+
+    if (range->linkPrev) {
+        range->linkPrev->linkNext = range->linkNext;
+    } else {
+        BSEND->freeLists[c] = range->linkNext;
+        if (BSEND->freeLists[c] == NULL) {
+            BSEND->freeMap &= ~(1U << c);
         }
-        /* is there room between these two allocations? */
-        else if ((next->offset - (prev->offset + prev->len)) >= size) {
-            result->next = next;
-            result->offset = prev->offset + prev->len;
-            prev->next = result;
-            allocated = 1;
-            break;
+    }
+    if (range->linkNext) {
+        range->linkNext->linkPrev = range->linkPrev;
+    }
+    range->isFree = 0;
+}
+
+static void bsend_hash_insert(ULMBufferRange_t *range)
+{
+    int h = bsend_hash(range->offset);
+
+    range->linkPrev = NULL;
+    range->linkNext = BSEND->allocations[h];
+    if (range->linkNext) {
+        range->linkNext->linkPrev = range;
+    }
+    BSEND->allocations[h] = range;
+}
+
+static void bsend_hash_remove(ULMBufferRange_t *range)
+{
+    if (range->linkPrev) {
+        range->linkPrev->linkNext = range->linkNext;
+    } else {
+        BSEND->allocations[bsend_hash(range->offset)] = range->linkNext;
+    }
+    if (range->linkNext) {
+        range->linkNext->linkPrev = range->linkPrev;
+    }
+}
+
+/*
+ * Find a free range of at least size bytes.  Any range in a class
+ * above floor(log2(size - 1)) is large enough, so the bitmap gives
+ * an answer directly; failing that, search the list for the class
+ * containing size.
+ */
+static ULMBufferRange_t *bsend_find_free(ssize_t size)
+{
+    ULMBufferRange_t *range;
+    unsigned int map;
+    int c;
+
+    c = (size > 1) ? bsend_class(size - 1) + 1 : 0;
+    if (c < ULM_BSEND_NUM_CLASSES) {
+        map = BSEND->freeMap & (~0U << c);
+        if (map) {
+            for (c = 0; (map & (1U << c)) == 0; c++) {
+                ;
+            }
+            return BSEND->freeLists[c];
         }
     }
 
-    /* end cases */
-    if (!allocated) {
-        /* no allocations - so do first allocation! */
-        if (!next && !prev) {
-            result->next = NULL;
-            result->offset = 0;
-            lampiState.bsendData->allocations = result;
-            allocated = 1;
+    for (range = BSEND->freeLists[bsend_class(size)]; range != NULL;
+         range = range->linkNext) {
+        if (range->len >= size) {
+            return range;
         }
-        /* is there room at the end of the buffer? */
-        else if ((lampiState.bsendData->bufferLength - prev->offset -
-                  prev->len) >= size) {
-            result->next = NULL;
-            result->offset = prev->offset + prev->len;
-            prev->next = result;
-            allocated = 1;
+    }
+
+    return NULL;
+}
+
+/*
+ * Attach a buffer: a single free range covering it all
+ */
+extern "C" int ulm_bsend_attach(void *buffer, ssize_t length)
+{
+    ULMBufferRange_t *range = NULL;
+
+    memset(BSEND->freeLists, 0, sizeof(BSEND->freeLists));
+    memset(BSEND->allocations, 0, sizeof(BSEND->allocations));
+    BSEND->freeMap = 0;
+    BSEND->ranges = NULL;
+
+    if (length > 0) {
+        range = bsend_get_range();
+        if (range == NULL) {
+            return ULM_ERR_OUT_OF_RESOURCE;
         }
+        range->next = range->prev = NULL;
+        range->offset = 0;
+        range->len = length;
+        range->request = NULL;
+        range->refCount = 0;
+        range->freeAtZeroRefCount = 0;
+        bsend_free_list_insert(range);
+        BSEND->ranges = range;
+    }
+
+    BSEND->buffer = buffer;
+    BSEND->bufferLength = length;
+    BSEND->bytesInUse = 0;
+    BSEND->numAllocations = 0;
+    BSEND->maxBytesInUse = 0;
+    BSEND->maxAllocations = 0;
+    BSEND->numAllocs = 0;
+    BSEND->numFailedAllocs = 0;
+
+    return ULM_SUCCESS;
+}
+
+/*
+ * Detach the buffer once all allocations have been released
+ */
+extern "C" void ulm_bsend_detach(void)
+{
+    ulm_dbg(("ulm_bsend_detach: buffer %ld bytes, high-water mark %ld "
+             "bytes in %d allocations, %ld allocations, %ld failed\n",
+             (long) BSEND->bufferLength, (long) BSEND->maxBytesInUse,
+             BSEND->maxAllocations, BSEND->numAllocs,
+             BSEND->numFailedAllocs));
+
+    if (BSEND->ranges) {
+        bsend_free_list_remove(BSEND->ranges);
+        bsend_put_range(BSEND->ranges);
+        BSEND->ranges = NULL;
+    }
+    bsend_free_ranges();
+    BSEND->buffer = NULL;
+    BSEND->bufferLength = 0;
+}
+
+extern "C" ULMBufferRange_t * ulm_bsend_alloc(ssize_t size, int freeAtZero)
+{
+    ULMBufferRange_t *free_range, *result;
+
+    /* make sure there is at least a possibility of satisfying this allocation request */
+    if ((BSEND->bufferLength - BSEND->bytesInUse) < size) {
+        BSEND->numFailedAllocs++;
+        return NULL;
     }
 
-    /* allocation failed -- free memory and return null */
-    if (!allocated) {
-        ulm_free(result);
-        result = NULL;
+    free_range = bsend_find_free(size);
+    if (free_range == NULL) {
+        BSEND->numFailedAllocs++;
+        return NULL;
     }
+
+    bsend_free_list_remove(free_range);
+
+    if (free_range->len == size) {
+        /* exact fit: use the free range itself */
+        result = free_range;
+    } else {
+        /* split: allocate from the front, return the remainder */
+        result = bsend_get_range();
+        if (result == NULL) {
+            bsend_free_list_insert(free_range);
+            BSEND->numFailedAllocs++;
+            return NULL;
+        }
+        result->offset = free_range->offset;
+        result->len = size;
+        result->prev = free_range->prev;
+        result->next = free_range;
+        if (result->prev) {
+            result->prev->next = result;
+        } else {
+            BSEND->ranges = result;
+        }
+        free_range->prev = result;
+        free_range->offset += size;
+        free_range->len -= size;
+        bsend_free_list_insert(free_range);
+    }
+
+    result->isFree = 0;
+    result->request = NULL;
+    result->refCount = -1;
+    result->freeAtZeroRefCount = freeAtZero;
+    bsend_hash_insert(result);
+
     /* record allocation in total bytes used */
-    else {
-        lampiState.bsendData->bytesInUse += size;
+    BSEND->bytesInUse += size;
+    BSEND->numAllocations++;
+    BSEND->numAllocs++;
+    if (BSEND->bytesInUse > BSEND->maxBytesInUse) {
+        BSEND->maxBytesInUse = BSEND->bytesInUse;
+    }
+    if (BSEND->numAllocations > BSEND->maxAllocations) {
+        BSEND->maxAllocations = BSEND->numAllocations;
     }
 
     return result;
 }
 
+/*
+ * Release an allocation, merging it with free neighbours.  Returns
+ * the free range that now contains the allocation.
+ */
+static ULMBufferRange_t *bsend_free(ULMBufferRange_t *range)
+{
+    ULMBufferRange_t *neighbour;
+
+    bsend_hash_remove(range);
+    BSEND->bytesInUse -= range->len;
+    BSEND->numAllocations--;
+
+    neighbour = range->prev;
+    if (neighbour && neighbour->isFree) {
+        bsend_free_list_remove(neighbour);
+        neighbour->len += range->len;
+        neighbour->next = range->next;
+        if (range->next) {
+            range->next->prev = neighbour;
+        }
+        bsend_put_range(range);
+        range = neighbour;
+    }
+
+    neighbour = range->next;
+    if (neighbour && neighbour->isFree) {
+        bsend_free_list_remove(neighbour);
+        range->len += neighbour->len;
+        range->next = neighbour->next;
+        if (neighbour->next) {
+            neighbour->next->prev = range;
+        }
+        bsend_put_range(neighbour);
+    }
+
+    bsend_free_list_insert(range);
+
+    return range;
+}
+
+extern "C" void ulm_bsend_free_alloc(ULMBufferRange_t *allocation)
+{
+    bsend_free(allocation);
+}
+
 extern "C" ULMBufferRange_t * ulm_bsend_find_alloc(ssize_t offset,
                                                    ULMRequest_t
                                                    request)
 {
     ULMBufferRange_t *result = NULL;
 
-    for (result = lampiState.bsendData->allocations; result != NULL;
-         result = result->next) {
-        if (offset >= 0) {
+    if (offset >= 0) {
+        for (result = BSEND->allocations[bsend_hash(offset)];
+             result != NULL; result = result->linkNext) {
             if (result->offset == offset) {
                 if ((result->request == request)
                     || ((result->request == NULL)
@@ -183,10 +440,13 @@ extern "C" ULMBufferRange_t * ulm_bsend_find_alloc(ssize_t offset,
                 }
             }
         }
+    } else {
         /* offset == -1 in ulm_request_free() */
-        else if ((result->request == request)
-                 && (result->freeAtZeroRefCount != 1)) {
-            break;
+        for (result = BSEND->ranges; result != NULL; result = result->next) {
+            if (!result->isFree && (result->request == request)
+                && (result->freeAtZeroRefCount != 1)) {
+                break;
+            }
         }
     }
 
@@ -195,10 +455,14 @@ extern "C" ULMBufferRange_t * ulm_bsend_find_alloc(ssize_t offset,
 
 extern "C" void ulm_bsend_clean_alloc(int wantToDetach)
 {
-    ULMBufferRange_t *next, *prev;
+    ULMBufferRange_t *next;
 
-    prev = next = lampiState.bsendData->allocations;
+    next = BSEND->ranges;
     while (next != NULL) {
+        if (next->isFree) {
+            next = next->next;
+            continue;
+        }
         if (wantToDetach) {
             /* all allocations that are inited only must be released now */
             if (next->refCount == -1) {
@@ -207,23 +471,9 @@ extern "C" void ulm_bsend_clean_alloc(int wantToDetach)
             next->freeAtZeroRefCount = 1;
         }
         if (next->freeAtZeroRefCount && (next->refCount == 0)) {
-            lampiState.bsendData->bytesInUse -= next->len;
-            /* new first allocation element in list */
-            if (next == prev) {
-                lampiState.bsendData->allocations = next->next;
-                ulm_free(next);
-                prev = next = lampiState.bsendData->allocations;
-            }
-            /* free this element and move on */
-            else {
-                prev->next = next->next;
-                ulm_free(next);
-                next = prev->next;
-            }
-        } else {
-            prev = next;
-            next = next->next;
+            next = bsend_free(next);
         }
+        next = next->next;
     }
 }
 
@@ -263,9 +513,10 @@ extern "C" int ulm_bsend_decrement_refcount(ULMRequest_t request,
         return 0;
     }
 
+    /* release the allocation as soon as the last send completes */
     allocation->refCount--;
     if ((allocation->refCount == 0) && (allocation->freeAtZeroRefCount)) {
-        ulm_bsend_clean_alloc(0);
+        bsend_free(allocation);
     }
 
     ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
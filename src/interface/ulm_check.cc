@@ -67,7 +67,8 @@ extern "C" int ulm_invalid_request(ULMRequest_t *request)
     } else if (*request == _mpi.proc_null_request_persistent) {
         return 0;
     } else if (r->requestType != REQUEST_TYPE_RECV &&
-               r->requestType != REQUEST_TYPE_SEND) {
+               r->requestType != REQUEST_TYPE_SEND &&
+               r->requestType != REQUEST_TYPE_COLL) {
         return 1;
     } else {
         return 0;
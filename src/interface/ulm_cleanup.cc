@@ -113,18 +113,14 @@ void ulm_cleanup(void)
     }
 
     // clean up _ulm struct
-    if (lampiState.map_global_rank_to_host) {
-        ulm_delete(lampiState.map_global_rank_to_host);
-        lampiState.map_global_rank_to_host = 0;
+    if (lampiState.map_host_to_first_rank) {
+        ulm_delete(lampiState.map_host_to_first_rank);
+        lampiState.map_host_to_first_rank = 0;
     }
     if (lampiState.map_host_to_local_size) {
         ulm_delete(lampiState.map_host_to_local_size);
         lampiState.map_host_to_local_size = 0;
     }
-    if (lampiState.map_global_proc_to_on_host_proc_id) {
-        ulm_free(lampiState.map_global_proc_to_on_host_proc_id);
-        lampiState.map_global_proc_to_on_host_proc_id = 0;
-    }
 
     // clean up the group pools
     if (grpPool.groups) {
@@ -40,3 +40,19 @@ extern "C" double ulm_dclock()
 {
     return dclock();
 }
+
+extern "C" double ulm_dclock_resolution()
+{
+    return dclock_resolution();
+}
+
+extern "C" int ulm_dclock_tsc(double *secs_per_cycle)
+{
+#if defined(__x86_64__) && defined(__linux__)
+    if (dclock_use_tsc) {
+        *secs_per_cycle = dclock_secs_per_cycle;
+        return 1;
+    }
+#endif
+    return 0;
+}
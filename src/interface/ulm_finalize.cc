@@ -37,6 +37,7 @@
 
 #include <stdio.h>
 
+#include "collective/coll_sched.h"
 #include "internal/log.h"
 #include "internal/profiler.h"
 #include "path/common/path.h"
@@ -82,6 +83,12 @@ extern "C" void ulm_finalize(void)
 
 #endif
 
+    // complete any non-blocking collectives that were freed while
+    // still active
+    while (ulm_coll_sched_pending()) {
+        ulm_make_progress();
+    }
+
     rc = ulm_barrier(ULM_COMM_WORLD);
     if (rc != ULM_SUCCESS) {
         ulm_err(("ulm_finalize: barrier failed with return code %d\n", rc));
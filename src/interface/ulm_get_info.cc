@@ -294,6 +294,18 @@ extern "C" int ulm_get_info(int comm, ULMInfo_t key,
             }
             break;
 
+        case ULM_INFO_HOSTIDS:
+            num_procs = communicators[comm]->localGroup->groupSize;
+            if (size >= num_procs * sizeof(int)) {
+                int i;
+                int *val = (int *) buffer;
+                for (i = 0; i < num_procs; i++) {
+                    val[i] = communicators[comm]->localGroup->mapGroupProcIDToHostID[i];
+                }
+                rc = ULM_SUCCESS;
+            }
+            break;
+
         default:
             break;
         }
@@ -121,7 +121,7 @@ extern "C" int ulm_isend_init(void *buf,
         communicators[comm]->refCounLock.unlock();
         // increment datatype reference counts
         ulm_type_retain(SendDesc->datatype);
-        ulm_type_retain(SendDesc->bsendDatatype);
+        ulm_type_retain(SendDesc->bsendDatatype());
     } else {
         SendDesc->persistent = false;
     }
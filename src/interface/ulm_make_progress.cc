@@ -39,6 +39,7 @@
 
 #define ENABLE_TIMESTAMP 0
 
+#include "collective/coll_sched.h"
 #include "internal/profiler.h"
 #include "internal/timestamp.h"
 #include "path/common/path.h"
@@ -120,6 +121,10 @@ extern "C" int ulm_make_progress(void)
 
     TIMESTAMP(4);
 
+    // advance non-blocking collectives
+
+    ulm_coll_sched_progress();
+
     TIMESTAMP_REPORT(1000);
 
     return rc;
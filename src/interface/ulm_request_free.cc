@@ -38,6 +38,7 @@
 #include <stdio.h>
 
 #include "client/daemon.h"
+#include "collective/coll_sched.h"
 #include "internal/buffer.h"
 #include "internal/log.h"
 #include "internal/profiler.h"
@@ -69,6 +70,13 @@ extern "C" int ulm_request_free(ULMRequest_t *request)
         }
     }
 
+    if (RequestDesc->requestType == REQUEST_TYPE_COLL) {
+        // collective schedules own all of their resources
+        ulm_coll_sched_free((CollDesc_t *) RequestDesc);
+        *request = ULM_REQUEST_NULL;
+        return ULM_SUCCESS;
+    }
+
     incomplete = ((RequestDesc->status == ULM_STATUS_INCOMPLETE) &&
                   (RequestDesc->messageDone == REQUEST_INCOMPLETE));
 
@@ -116,7 +124,7 @@ extern "C" int ulm_request_free(ULMRequest_t *request)
                     allocation->refCount = 0;
                 allocation->freeAtZeroRefCount = 1;
                 if (allocation->refCount == 0)
-                    ulm_bsend_clean_alloc(0);
+                    ulm_bsend_free_alloc(allocation);
             }
             ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
         }
@@ -60,6 +60,27 @@ extern "C" int ulm_send(void *buf, size_t size, ULMType_t *dtype,
     SendDesc_t *SendDesc;
     int rc;
 
+    // small contiguous standard and ready sends are copied straight
+    // to the path, when it can take them, and are then complete
+    if ((sendMode == ULM_SEND_STANDARD || sendMode == ULM_SEND_READY) &&
+        (communicators[comm]->pt2ptPathSelectionFunction ==
+         (int (*)(void **, int, int)) ulm_bind_pt2pt_message)) {
+        if (dtype == NULL) {
+            if (ulm_send_inline(buf, size, comm, dest, tag)) {
+                return ULM_SUCCESS;
+            }
+        } else if (dtype->layout == CONTIGUOUS) {
+            void *addr = buf;
+            if (dtype->num_pairs != 0) {
+                addr = (void *) ((char *) buf + dtype->type_map[0].offset);
+            }
+            if (ulm_send_inline(addr, dtype->packed_size * size,
+                                comm, dest, tag)) {
+                return ULM_SUCCESS;
+            }
+        }
+    }
+
     // bind send descriptor to a given path....this can fail...
     rc = communicators[comm]->pt2ptPathSelectionFunction((void **) &SendDesc,
                                                          comm, dest);
@@ -42,6 +42,7 @@
 #include "queue/globals.h"
 #include "ulm/ulm.h"
 #include "path/common/path.h"
+#include "collective/coll_sched.h"
 
 /*
  *  Start processing the request - either send or receive.
@@ -178,6 +179,11 @@ extern "C" int ulm_start(ULMRequest_t *request)
 
         rc = commPtr->isend_start(&SendDesc);
 
+    } else if (RequestDesc->requestType == REQUEST_TYPE_COLL) {
+
+        // replay a persistent collective schedule
+        rc = ulm_coll_sched_start((CollDesc_t *) RequestDesc, request);
+
     } else {
 
         ulm_err(("Error: ulm_start: Unrecognized message request %d\n",
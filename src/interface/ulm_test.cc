@@ -37,6 +37,7 @@
 
 #include <stdio.h>
 
+#include "collective/coll_sched.h"
 #include "internal/buffer.h"
 #include "internal/log.h"
 #include "internal/profiler.h"
@@ -57,6 +58,7 @@ extern "C" int ulm_test(ULMRequest_t *request, int *completed,
     RequestDesc_t *RequestDesc;
     SendDesc_t *SendDesc;
     RecvDesc_t *RecvDesc;
+    CollDesc_t *CollDesc;
 
     int rc = ULM_SUCCESS;
 
@@ -170,6 +172,23 @@ extern "C" int ulm_test(ULMRequest_t *request, int *completed,
 
         break;
 
+    case REQUEST_TYPE_COLL:
+        CollDesc = (CollDesc_t *) (*request);
+        if (CollDesc->messageDone == REQUEST_INCOMPLETE) {
+            return ULM_SUCCESS;
+        }
+        // fill in status object - collectives have no peer or tag
+        status->tag_m = ULM_ANY_TAG;
+        status->peer_m = ULM_ANY_PROC;
+        status->state_m = ULM_STATUS_COMPLETE;
+        status->error_m = CollDesc->error;
+        status->length_m = 0;
+        status->persistent_m = CollDesc->persistent;
+        rc = CollDesc->error;
+        *completed = 1;
+
+        break;
+
     default:
         ulm_err(("Error: ulm_test: Unrecognized message type %d\n",
                  RequestDesc->requestType));
@@ -37,6 +37,7 @@
 
 #include <stdio.h>
 
+#include "collective/coll_sched.h"
 #include "internal/buffer.h"
 #include "internal/log.h"
 #include "internal/profiler.h"
@@ -55,6 +56,7 @@ extern "C" int ulm_wait(ULMRequest_t *request, ULMStatus_t *status)
     RequestDesc_t *RequestDesc;
     RecvDesc_t *RecvDesc;
     SendDesc_t *SendDesc;
+    CollDesc_t *CollDesc;
     int rc = ULM_SUCCESS;
 
     if (0) { // play fast and loose since the MPI layer checks this
@@ -163,6 +165,27 @@ extern "C" int ulm_wait(ULMRequest_t *request, ULMStatus_t *status)
 
         break;
 
+    case REQUEST_TYPE_COLL:
+        CollDesc = (CollDesc_t *) (*request);
+        while ((CollDesc->messageDone == REQUEST_INCOMPLETE)) {
+            rc = ulm_make_progress();
+            if ((rc == ULM_ERR_OUT_OF_RESOURCE)
+                || (rc == ULM_ERR_FATAL)
+                || (rc == ULM_ERROR)) {
+                return rc;
+            }
+        }
+
+        // fill in status object - collectives have no peer or tag
+        status->tag_m = ULM_ANY_TAG;
+        status->peer_m = ULM_ANY_PROC;
+        status->error_m = CollDesc->error;
+        status->length_m = 0;
+        status->persistent_m = CollDesc->persistent;
+        rc = CollDesc->error;
+
+        break;
+
     default:
         ulm_err(("Error: ulm_wait: Unrecognized message type: %d\n",
                  RequestDesc->requestType));
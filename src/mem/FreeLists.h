@@ -45,6 +45,7 @@
 #include "mem/MemoryPool.h"
 #include "mem/FixedSharedMemPool.h"
 #include "mem/MemorySegments.h"
+#include "os/numa.h"
 #include "ulm/ulm.h"
 
 #if ENABLE_NUMA && defined(__mips)
@@ -474,7 +475,7 @@ public:
     // Append the new elements to the free list.
     int createMoreElements(int poolIndex)
         {
-            size_t lenAdded;
+            size_t lenAdded = 0;
             int errorCode = ULM_SUCCESS;
 
             void *basePtr = GetChunkOfMemory(poolIndex, &lenAdded, &errorCode);
@@ -667,8 +668,6 @@ private:
     // number of chunks actually added to freelist
     int *chunksReturned;
 
-#include "os/numa.h"
-
     // request an element from a specified element pool
     inline volatile Links_t *RequestElement(int ListIndex = 0)
         {
@@ -238,6 +238,7 @@ public:
             }
 
             char *TmpPtr = 0;
+            size_t ZeroPageSize = PageSize;
             ssize_t WorkingSize = PoolSize;
             void *PoolBase = 0;
             while (!TmpPtr && WorkingSize) {
@@ -245,7 +246,8 @@ public:
                 ssize_t SizeToAllocate = WorkingSize + 2 * PageSize;
 
                 // allocate memory
-                TmpPtr = (char *) ZeroAlloc(SizeToAllocate, MemProt, MemFlags);
+                TmpPtr = (char *) ZeroAlloc(SizeToAllocate, MemProt, MemFlags,
+                                            &ZeroPageSize);
 
                 if (TmpPtr == 0)
                     WorkingSize /= 2;
@@ -277,16 +279,19 @@ public:
                          NPoolChunks, maxNPoolChunks));
                 return ULM_ERR_BAD_PARAM;
             }
-            // change memory protection for red zones
-            int retval = mprotect(TmpPtr, PageSize, PROT_NONE);
-            if (retval != 0) {
-                ulm_exit(("Error in red zone 1 mprotect\n"));
-            }
-            // end red zone
-            retval =
-                mprotect(TmpPtr + PageSize + WorkingSize, PageSize, PROT_NONE);
-            if (retval != 0) {
-                ulm_exit(("Error in red zone 2 mprotect\n"));
+            // change memory protection for red zones, which huge
+            // pages cannot provide
+            if (ZeroPageSize <= (size_t) PageSize) {
+                int retval = mprotect(TmpPtr, PageSize, PROT_NONE);
+                if (retval != 0) {
+                    ulm_exit(("Error in red zone 1 mprotect\n"));
+                }
+                // end red zone
+                retval = mprotect(TmpPtr + PageSize + WorkingSize, PageSize,
+                                  PROT_NONE);
+                if (retval != 0) {
+                    ulm_exit(("Error in red zone 2 mprotect\n"));
+                }
             }
             // initialize chunk descriptors
             if (MemFlags == SharedMemFlag) {
@@ -120,13 +120,15 @@ int ULMMemoryPool::InitPool()
     long PageSize = 1 << LogBase2PageSize;
 
     char *TmpPtr = 0;
+    size_t ZeroPageSize = PageSize;
     ssize_t WorkingSize = PoolSize;
     while (TmpPtr == 0 && WorkingSize > 0) {
         // add red-zone pages
         ssize_t SizeToAllocate = WorkingSize + 2 * PageSize;
 
         // allocate memory
-        TmpPtr = (char *) ZeroAlloc(SizeToAllocate, MemProt, MemFlags);
+        TmpPtr = (char *) ZeroAlloc(SizeToAllocate, MemProt, MemFlags,
+                                    &ZeroPageSize);
 
         if (TmpPtr == 0)
             WorkingSize /= 2;
@@ -136,20 +138,25 @@ int ULMMemoryPool::InitPool()
             PoolBase = (void *) (TmpPtr + PageSize);
     }
 
+    // no red zones on huge pages, which cannot be protected piecewise
+    bool RedZones = (ZeroPageSize <= (size_t) PageSize);
+    if (TmpPtr && !RedZones)
+        PoolBase = (void *) TmpPtr;
+
     // reset pool size
     PoolSize = WorkingSize;
     NPoolChunks = PoolSize / (1 << LogBase2ChunkSize);
 
     // change memory protection for red zones
     int retval;
-    if (WorkingSize > 0) {
+    if (WorkingSize > 0 && RedZones) {
         retval = mprotect(TmpPtr, PageSize, PROT_NONE);
         if (retval != 0) {
             ulm_exit(("Error in red zone 1 mprotect\n"));
         }
     }
     // end red zone
-    if (WorkingSize > 0) {
+    if (WorkingSize > 0 && RedZones) {
         retval =
             mprotect(TmpPtr + PageSize + WorkingSize, PageSize, PROT_NONE);
         if (retval != 0) {
@@ -163,20 +170,12 @@ int ULMMemoryPool::InitPool()
 
 void ULMMemoryPool::DeletePool()
 {
-#ifdef __CYGWIN__
-    int retval = munmap((caddr_t)PoolBase, PoolSize);
-#else
-    int retval = munmap(PoolBase, PoolSize);
-#endif
+    int retval = ZeroFree(PoolBase, PoolSize);
     if (retval == -1) {
         ulm_err(("Error: unmapping Pool memory.\n"));
     }
     if (isShared) {
-#ifdef __CYGWIN__
-        retval = munmap((caddr_t)PoolChunks, MaxNPoolChunks * sizeof(PoolChunks_t));
-#else
-        retval = munmap(PoolChunks, MaxNPoolChunks * sizeof(PoolChunks_t));
-#endif
+        retval = ZeroFree(PoolChunks, MaxNPoolChunks * sizeof(PoolChunks_t));
         if (retval == -1) {
             ulm_err(("Error: unmapping PoolChunks memory.\n"));
         }
@@ -203,13 +202,15 @@ int ULMMemoryPool::SetPoolSize(ssize_t initPoolSize)
     long PageSize = 1 << LogBase2PageSize;
 
     char *TmpPtr = 0;
+    size_t ZeroPageSize = PageSize;
     ssize_t WorkingSize = PoolSize;
     while (TmpPtr == 0 && WorkingSize > 0) {
         // add red-zone pages
         ssize_t SizeToAllocate = WorkingSize + 2 * PageSize;
 
         // allocate memory
-        TmpPtr = (char *) ZeroAlloc(SizeToAllocate, MemProt, MemFlags);
+        TmpPtr = (char *) ZeroAlloc(SizeToAllocate, MemProt, MemFlags,
+                                    &ZeroPageSize);
 
         if (TmpPtr == 0)
             WorkingSize /= 2;
@@ -219,6 +220,11 @@ int ULMMemoryPool::SetPoolSize(ssize_t initPoolSize)
             PoolBase = (void *) (TmpPtr + PageSize);
     }
 
+    // no red zones on huge pages, which cannot be protected piecewise
+    bool RedZones = (ZeroPageSize <= (size_t) PageSize);
+    if (TmpPtr && !RedZones)
+        PoolBase = (void *) TmpPtr;
+
     // reset pool size
     PoolSize = WorkingSize;
     NPoolChunks = PoolSize / (1 << LogBase2ChunkSize);
@@ -233,14 +239,14 @@ int ULMMemoryPool::SetPoolSize(ssize_t initPoolSize)
 
     // change memory protection for red zones
     int retval;
-    if (WorkingSize > 0) {
+    if (WorkingSize > 0 && RedZones) {
         retval = mprotect(TmpPtr, PageSize, PROT_NONE);
         if (retval != 0) {
             ulm_exit(("Error in red zone 1 mprotect\n"));
         }
     }
     // end red zone
-    if (WorkingSize > 0) {
+    if (WorkingSize > 0 && RedZones) {
         retval =
             mprotect(TmpPtr + PageSize + WorkingSize, PageSize, PROT_NONE);
         if (retval != 0) {
@@ -38,13 +38,18 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#endif
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include "init/environ.h"
 #include "internal/log.h"
 #include "internal/malloc.h"
 
@@ -98,12 +103,171 @@ void *ZeroAlloc(size_t size, int prot, int flags)
 #endif
 
 
-void *ZeroAlloc(size_t len, int MemoryProtection, int MemoryFlags)
+#ifdef __linux__
+
+// Huge page backing for the shared and private pools, selected by
+// LAMPI_HUGEPAGES (0 none, 1 the default huge page size, 2 1 GB pages
+// where the region is large enough).  Pages come from MAP_HUGETLB or,
+// failing that, from a file in the hugetlbfs mount LAMPI_HUGEPAGE_PATH.
+// Regions smaller than a huge page, and any request the kernel cannot
+// satisfy, fall back to default pages.  The first mapping of each kind
+// is reported through ulm_log.
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+#ifndef HUGETLBFS_MAGIC
+#define HUGETLBFS_MAGIC 0x958458f6
+#endif
+
+static size_t defaultHugePageSize(void)
+{
+    static size_t size = 0;
+    char line[128];
+    long kb;
+    FILE *fp;
+
+    if (size == 0) {
+        size = 2 * 1024 * 1024;
+        fp = fopen("/proc/meminfo", "r");
+        if (fp) {
+            while (fgets(line, sizeof(line), fp)) {
+                if (sscanf(line, "Hugepagesize: %ld kB", &kb) == 1) {
+                    size = (size_t) kb * 1024;
+                    break;
+                }
+            }
+            fclose(fp);
+        }
+    }
+
+    return size;
+}
+
+
+static void *hugeTLBAlloc(size_t len, int prot, int flags, size_t pageSize,
+                          int sizeFlags)
+{
+    size_t rlen = (len + pageSize - 1) & ~(pageSize - 1);
+    void *ptr;
+
+    ptr = mmap(NULL, rlen, prot,
+               flags | MAP_ANONYMOUS | MAP_HUGETLB | sizeFlags, -1, 0);
+
+    return (ptr == MAP_FAILED) ? 0 : ptr;
+}
+
+
+static void *hugeTLBFSAlloc(size_t len, int prot, int flags,
+                            size_t *pageSize)
+{
+    char *dir, path[PATH_MAX];
+    struct statfs fs;
+    size_t rlen;
+    void *ptr;
+    int fd;
+
+    lampi_environ_find_string("LAMPI_HUGEPAGE_PATH", &dir);
+    if (dir == 0 || *dir == '\0') {
+        return 0;
+    }
+    if (statfs(dir, &fs) < 0 || fs.f_type != (long) HUGETLBFS_MAGIC ||
+        len < (size_t) fs.f_bsize) {
+        return 0;
+    }
+    snprintf(path, sizeof(path), "%s/lampi.XXXXXX", dir);
+    fd = mkstemp(path);
+    if (fd < 0) {
+        return 0;
+    }
+    unlink(path);
+
+    *pageSize = fs.f_bsize;
+    rlen = (len + *pageSize - 1) & ~(*pageSize - 1);
+    flags &= ~MAP_ANONYMOUS;
+    ptr = mmap(NULL, rlen, prot, flags, fd, 0);
+    close(fd);
+
+    return (ptr == MAP_FAILED) ? 0 : ptr;
+}
+
+
+static void *hugePageAlloc(size_t len, int prot, int flags,
+                           size_t *hugePageSize)
+{
+    static int reportedHuge = 0;
+    static int reportedFallback = 0;
+    size_t pageSize = 0;
+    void *ptr = 0;
+    int policy;
+
+    lampi_environ_find_integer("LAMPI_HUGEPAGES", &policy);
+    if (policy <= 0) {
+        return 0;
+    }
+
+    if (policy >= 2 && len >= (size_t) 1 << 30) {
+        pageSize = (size_t) 1 << 30;
+        ptr = hugeTLBAlloc(len, prot, flags, pageSize, MAP_HUGE_1GB);
+    }
+    if (!ptr && len >= defaultHugePageSize()) {
+        pageSize = defaultHugePageSize();
+        ptr = hugeTLBAlloc(len, prot, flags, pageSize, 0);
+    }
+    if (!ptr) {
+        ptr = hugeTLBFSAlloc(len, prot, flags, &pageSize);
+    }
+
+    if (ptr) {
+        *hugePageSize = pageSize;
+    }
+    if (ptr && !reportedHuge) {
+        reportedHuge = 1;
+        ulm_log(("ZeroAlloc: %ld bytes on %ld kB huge pages\n",
+                 (long) len, (long) (pageSize / 1024)));
+    } else if (!ptr && len >= defaultHugePageSize() && !reportedFallback) {
+        reportedFallback = 1;
+        ulm_log(("ZeroAlloc: no huge pages for %ld bytes (%s), "
+                 "using default pages\n", (long) len, strerror(errno)));
+    }
+
+    return ptr;
+}
+
+#endif  /* __linux__ */
+
+
+void *ZeroAlloc(size_t len, int MemoryProtection, int MemoryFlags,
+                size_t *pageSize)
 {
     void *ptr;
     static int fd = -1;
     int flags = MemoryFlags;
 
+    if (pageSize) {
+        *pageSize = sysconf(_SC_PAGESIZE);
+    }
+#ifdef __linux__
+    {
+        size_t hugePageSize;
+
+        ptr = hugePageAlloc(len, MemoryProtection, MemoryFlags,
+                            &hugePageSize);
+        if (ptr) {
+            if (pageSize) {
+                *pageSize = hugePageSize;
+            }
+            return ptr;
+        }
+    }
+#endif
+
 #ifndef __osf__
 #ifndef __APPLE__
     if(fd < 0) {
@@ -181,3 +345,24 @@ void *ZeroAlloc(size_t len, int MemoryProtection, int MemoryFlags)
     return ptr;
 }
 
+
+int ZeroFree(void *ptr, size_t len)
+{
+    int rc;
+
+    rc = munmap(ptr, len);
+#ifdef __linux__
+    // huge page mappings must be unmapped in whole pages
+    if (rc < 0 && errno == EINVAL) {
+        size_t pageSize = defaultHugePageSize();
+
+        rc = munmap(ptr, (len + pageSize - 1) & ~(pageSize - 1));
+        if (rc < 0 && errno == EINVAL) {
+            pageSize = (size_t) 1 << 30;
+            rc = munmap(ptr, (len + pageSize - 1) & ~(pageSize - 1));
+        }
+    }
+#endif
+
+    return rc;
+}
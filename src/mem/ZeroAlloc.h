@@ -34,6 +34,13 @@
 #ifndef ZEROALLOC_H_INCLUDED
 #define ZEROALLOC_H_INCLUDED
 
-extern void *ZeroAlloc(size_t size, int prot, int flags);
+// Allocate zeroed memory with mmap.  If pageSize is given, it is set
+// to the size of the pages backing the region, which is larger than
+// the system page size when huge pages were obtained.
+extern void *ZeroAlloc(size_t size, int prot, int flags,
+                       size_t *pageSize = 0);
+
+// Unmap memory from ZeroAlloc, allowing for huge page rounding.
+extern int ZeroFree(void *ptr, size_t size);
 
 #endif
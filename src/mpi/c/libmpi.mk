@@ -2,9 +2,12 @@ SRC_LIBMPI += \
 	src/mpi/c/mpi_abort.c \
 	src/mpi/c/mpi_address.c \
 	src/mpi/c/mpi_allgather.c \
+	src/mpi/c/mpi_allgather_init.c \
 	src/mpi/c/mpi_allgatherv.c \
 	src/mpi/c/mpi_allreduce.c \
+	src/mpi/c/mpi_allreduce_init.c \
 	src/mpi/c/mpi_alltoall.c \
+	src/mpi/c/mpi_alltoall_init.c \
 	src/mpi/c/mpi_alltoallv.c \
 	src/mpi/c/mpi_alltoallw.c \
 	src/mpi/c/mpi_attr_delete.c \
@@ -12,6 +15,7 @@ SRC_LIBMPI += \
 	src/mpi/c/mpi_attr_put.c \
 	src/mpi/c/mpi_barrier.c \
 	src/mpi/c/mpi_bcast.c \
+	src/mpi/c/mpi_bcast_init.c \
 	src/mpi/c/mpi_bsend.c \
 	src/mpi/c/mpi_bsend_init.c \
 	src/mpi/c/mpi_buffer_attach.c \
@@ -43,6 +47,7 @@ SRC_LIBMPI += \
 	src/mpi/c/mpi_errhandler_set.c \
 	src/mpi/c/mpi_error_class.c \
 	src/mpi/c/mpi_error_string.c \
+	src/mpi/c/mpi_exscan.c \
 	src/mpi/c/mpi_finalize.c \
 	src/mpi/c/mpi_finalized.c \
 	src/mpi/c/mpi_gather.c \
@@ -69,6 +74,11 @@ SRC_LIBMPI += \
 	src/mpi/c/mpi_group_size.c \
 	src/mpi/c/mpi_group_translate_ranks.c \
 	src/mpi/c/mpi_group_union.c \
+	src/mpi/c/mpi_iallgather.c \
+	src/mpi/c/mpi_iallreduce.c \
+	src/mpi/c/mpi_ialltoall.c \
+	src/mpi/c/mpi_ibarrier.c \
+	src/mpi/c/mpi_ibcast.c \
 	src/mpi/c/mpi_ibsend.c \
 	src/mpi/c/mpi_init.c \
 	src/mpi/c/mpi_init_thread.c \
@@ -77,11 +87,16 @@ SRC_LIBMPI += \
 	src/mpi/c/mpi_intercomm_merge.c \
 	src/mpi/c/mpi_iprobe.c \
 	src/mpi/c/mpi_irecv.c \
+	src/mpi/c/mpi_ireduce.c \
 	src/mpi/c/mpi_irsend.c \
 	src/mpi/c/mpi_isend.c \
 	src/mpi/c/mpi_issend.c \
 	src/mpi/c/mpi_keyval_create.c \
 	src/mpi/c/mpi_keyval_free.c \
+	src/mpi/c/mpi_neighbor_allgather.c \
+	src/mpi/c/mpi_neighbor_allgatherv.c \
+	src/mpi/c/mpi_neighbor_alltoall.c \
+	src/mpi/c/mpi_neighbor_alltoallv.c \
 	src/mpi/c/mpi_op_create.c \
 	src/mpi/c/mpi_op_free.c \
 	src/mpi/c/mpi_pack.c \
@@ -92,7 +107,9 @@ SRC_LIBMPI += \
 	src/mpi/c/mpi_recv.c \
 	src/mpi/c/mpi_recv_init.c \
 	src/mpi/c/mpi_reduce.c \
+	src/mpi/c/mpi_reduce_init.c \
 	src/mpi/c/mpi_reduce_scatter.c \
+	src/mpi/c/mpi_reduce_scatter_block.c \
 	src/mpi/c/mpi_request_free.c \
 	src/mpi/c/mpi_rsend.c \
 	src/mpi/c/mpi_rsend_init.c \
@@ -43,6 +43,7 @@ int PMPI_Allreduce(void *sendbuf, void *recvbuf, int count,
                    MPI_Datatype type, MPI_Op op, MPI_Comm comm)
 {
     int rc;
+    long long t0;
     ulm_allreduce_t *allreduce;
     
     if (_mpi.check_args) {
@@ -63,12 +64,16 @@ int PMPI_Allreduce(void *sendbuf, void *recvbuf, int count,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_ALLREDUCE, (void **)&allreduce);
     if ( ULM_SUCCESS == rc )
     {
         rc = allreduce(sendbuf, recvbuf, count, type, op,
                                        comm);        
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_ALLREDUCE, -1, -1, comm,
+                   count * ((ULMType_t *) type)->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
@@ -44,6 +44,7 @@ int PMPI_Alltoall(void *sendbuf, int sendcount, MPI_Datatype senddatatype,
 		  MPI_Comm comm)
 {
     int rc;
+    long long t0;
     ULMType_t *sendtype;
     ULMType_t *recvtype;
     ulm_alltoall_t  *alltoall;
@@ -70,12 +71,16 @@ int PMPI_Alltoall(void *sendbuf, int sendcount, MPI_Datatype senddatatype,
 
     sendtype = (ULMType_t *) senddatatype;
     recvtype = (ULMType_t *) recvdatatype;
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_ALLTOALL, (void **)&alltoall);
     if ( ULM_SUCCESS == rc )
     {
         rc = alltoall(sendbuf, sendcount, sendtype, recvbuf,
                                       recvcount, recvtype, comm);        
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_ALLTOALL, -1, -1, comm,
+                   sendcount * sendtype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
@@ -42,6 +42,7 @@
 int PMPI_Barrier(MPI_Comm comm)
 {
     int rc;
+    long long t0;
     ulm_barrier_t   *barrier;
     
     if (_mpi.check_args) {
@@ -56,11 +57,14 @@ int PMPI_Barrier(MPI_Comm comm)
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_BARRIER, (void **)&barrier);
     if ( ULM_SUCCESS == rc )
     {
         rc = barrier(comm);        
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_BARRIER, -1, -1, comm, 0);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
@@ -45,6 +45,7 @@ int PMPI_Bcast (void *buffer, int count, MPI_Datatype type, int root,
     ULMType_t *datatype = type;
     ulm_bcast_t *bcast;
     int rc;
+    long long t0;
 
     if (_mpi.check_args) {
         rc = MPI_SUCCESS;
@@ -64,11 +65,15 @@ int PMPI_Bcast (void *buffer, int count, MPI_Datatype type, int root,
         }
     }
     
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_BCAST, (void **)&bcast);
     if ( ULM_SUCCESS == rc )
     {
         rc = bcast(buffer, count, datatype, root, comm);
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_BCAST, root, -1, comm,
+                   count * datatype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
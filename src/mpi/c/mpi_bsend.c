@@ -47,6 +47,7 @@ int PMPI_Bsend(void *buf, int count, MPI_Datatype type, int dest,
     ULMStatus_t stat;
     ULMType_t *datatype = type;
     int rc, position, size;
+    long long t0;
     void *sendBuffer, *tbuf;
     ULMBufferRange_t *allocation = NULL;
 
@@ -74,6 +75,8 @@ int PMPI_Bsend(void *buf, int count, MPI_Datatype type, int dest,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
+
     /*
      *  figure out if there is enough buffer space for the message.
      */
@@ -131,8 +134,7 @@ int PMPI_Bsend(void *buf, int count, MPI_Datatype type, int dest,
         if (rc != MPI_SUCCESS) {
             ATOMIC_LOCK_THREAD(lampiState.bsendData->lock);
             if (allocation->refCount == -1) {
-                allocation->refCount = 0;
-                ulm_bsend_clean_alloc(0);
+                ulm_bsend_free_alloc(allocation);
             }
             ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
             goto ERRHANDLER;
@@ -150,8 +152,7 @@ int PMPI_Bsend(void *buf, int count, MPI_Datatype type, int dest,
     if ((size > 0) && (rc != ULM_SUCCESS)) {
         ATOMIC_LOCK_THREAD(lampiState.bsendData->lock);
         if (allocation->refCount == -1) {
-            allocation->refCount = 0;
-            ulm_bsend_clean_alloc(0);
+            ulm_bsend_free_alloc(allocation);
         }
         ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
     }
@@ -160,6 +161,8 @@ int PMPI_Bsend(void *buf, int count, MPI_Datatype type, int dest,
 	rc = ulm_wait(&req, &stat);
     }
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_BSEND, dest, tag, comm, size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
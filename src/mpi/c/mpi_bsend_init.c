@@ -127,9 +127,7 @@ int PMPI_Bsend_init(void *buf, int count, MPI_Datatype type, int dest,
     if ((size > 0) && (rc != ULM_SUCCESS)) {
         /* clean up bsend buffer allocation */
         ATOMIC_LOCK_THREAD(lampiState.bsendData->lock);
-        allocation->freeAtZeroRefCount = 1;
-        allocation->refCount = 0;
-        ulm_bsend_clean_alloc(0);
+        ulm_bsend_free_alloc(allocation);
         ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
         _mpi_errhandler(comm, rc, __FILE__, __LINE__);
         /* return error code */
@@ -78,21 +78,17 @@ int PMPI_Buffer_attach(void *buffer, int bufferLength)
 
     }
 
+    /* set up the buffer and its free lists */
+    if (ulm_bsend_attach(buffer, bufferLength) != ULM_SUCCESS) {
+        rc = MPI_ERR_INTERN;
+        ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
+        _mpi_errhandler(MPI_COMM_WORLD, rc, __FILE__, __LINE__);
+        return rc;
+    }
+
     /* set the in use flag */
     lampiState.bsendData->poolInUse = 1;
 
-    /* set buffer length */
-    lampiState.bsendData->bufferLength = bufferLength;
-
-    /* set bytes in use */
-    lampiState.bsendData->bytesInUse = 0;
-
-    /* set buffer pointer */
-    lampiState.bsendData->buffer = buffer;
-
-    /* set allocations pointer to null */
-    lampiState.bsendData->allocations = NULL;
-
     /* unlock control structure */
     ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
 
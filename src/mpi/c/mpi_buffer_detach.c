@@ -89,20 +89,17 @@ int PMPI_Buffer_detach(void *buffer, int *size)
     /* reset in use flag */
     lampiState.bsendData->poolInUse = 0;
 
-    /* set internal buffer pointer to 0 */
-    lampiState.bsendData->buffer = (void *) 0;
-
-    /* set internal buffer length to 0 */
-    lampiState.bsendData->bufferLength = 0;
-
     /* all allocations should be gone; otherwise there is a problem */
-    if (lampiState.bsendData->allocations != NULL) {
+    if (lampiState.bsendData->numAllocations != 0) {
         ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
         rc = MPI_ERR_INTERN;
         _mpi_errhandler(MPI_COMM_WORLD, rc, __FILE__, __LINE__);
         return rc;
     }
 
+    /* release the buffer */
+    ulm_bsend_detach();
+
     /* unlock control structure */
     ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
 
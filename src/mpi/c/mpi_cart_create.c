@@ -49,18 +49,18 @@ int PMPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
     int nnodes;
     int rc;
     int range[1][3];
-    int rank_old;
+    int rank_new;
     int size_old;
+    int *map;
     void *p;
 
     /*
      * Sanity checks
-     *
-     * Note: reorder is ignored (assumed always false)
      */
 
     rc = MPI_SUCCESS;
     p = NULL;
+    map = NULL;
     topology = NULL;
 
     if (comm_new == NULL) {
@@ -95,24 +95,37 @@ int PMPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
     if (rc != MPI_SUCCESS) {
 	goto ERRHANDLER;
     }
-    rc = PMPI_Comm_rank(comm_old, &rank_old);
-    if (rc != MPI_SUCCESS) {
-	goto ERRHANDLER;
-    }
     if (nnodes > size_old) {
 	rc = MPI_ERR_DIMS;
 	goto ERRHANDLER;
     }
 
-    range[0][0] = 0;
-    range[0][1] = nnodes - 1;
-    range[0][2] = 1;
-
     rc = PMPI_Comm_group(comm_old, &group_old);
     if (rc != MPI_SUCCESS) {
 	goto ERRHANDLER;
     }
-    rc = PMPI_Group_range_incl(group_old, 1, range, &group_new);
+    if (reorder) {
+	/*
+	 * Place grid neighbors on the same host where possible
+	 */
+	map = (int *) ulm_malloc(nnodes * sizeof(int));
+	if (map == NULL) {
+	    rc = MPI_ERR_OTHER;
+	    goto ERRHANDLER;
+	}
+	rc = _mpi_cart_map(comm_old, ndims, dims, periods, nnodes, map);
+	if (rc != MPI_SUCCESS) {
+	    goto ERRHANDLER;
+	}
+	rc = PMPI_Group_incl(group_old, nnodes, map, &group_new);
+	ulm_free(map);
+	map = NULL;
+    } else {
+	range[0][0] = 0;
+	range[0][1] = nnodes - 1;
+	range[0][2] = 1;
+	rc = PMPI_Group_range_incl(group_old, 1, range, &group_new);
+    }
     if (rc != MPI_SUCCESS) {
 	goto ERRHANDLER;
     }
@@ -137,6 +150,11 @@ int PMPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
      * Attach the topology
      */
 
+    rc = PMPI_Comm_rank(*comm_new, &rank_new);
+    if (rc != MPI_SUCCESS) {
+	goto ERRHANDLER;
+    }
+
     topology = (ULMTopology_t *) ulm_malloc(sizeof(ULMTopology_t));
     if (topology == (ULMTopology_t *) NULL) {
 	rc = MPI_ERR_OTHER;
@@ -159,8 +177,8 @@ int PMPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
 	nnodes = nnodes / dims[i];
 	topology->cart.dims[i] = dims[i];
 	topology->cart.periods[i] = periods[i];
-	topology->cart.position[i] = rank_old / nnodes;
-	rank_old = rank_old % nnodes;
+	topology->cart.position[i] = rank_new / nnodes;
+	rank_new = rank_new % nnodes;
     }
 
     rc = ulm_set_topology(*comm_new, topology);
@@ -171,6 +189,9 @@ int PMPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
 
 ERRHANDLER:
     if (rc != MPI_SUCCESS) {
+	if (map != NULL) {
+	    ulm_free(map);
+	}
 	if (p != NULL) {
 	    ulm_free(p);
 	}
@@ -32,6 +32,7 @@
 #include "config.h"
 #endif
 
+#include "internal/malloc.h"
 #include "internal/mpi.h"
 
 #ifdef HAVE_PRAGMA_WEAK
@@ -43,6 +44,7 @@ int PMPI_Cart_map(MPI_Comm comm, int ndims, int *dims, int *periods,
 {
     int i;
     int nnodes;
+    int *map;
     int rank;
     int rc;
     int size;
@@ -73,13 +75,22 @@ int PMPI_Cart_map(MPI_Comm comm, int ndims, int *dims, int *periods,
 	goto ERRHANDLER;
     }
 
-    if (rank < nnodes) {
-	*newrank = rank;
-    } else {
+    map = (int *) ulm_malloc(nnodes * sizeof(int));
+    if (map == NULL) {
+	rc = MPI_ERR_OTHER;
+	goto ERRHANDLER;
+    }
+    rc = _mpi_cart_map(comm, ndims, dims, periods, nnodes, map);
+    if (rc == MPI_SUCCESS) {
 	*newrank = MPI_UNDEFINED;
+	for (i = 0; i < nnodes; i++) {
+	    if (map[i] == rank) {
+		*newrank = i;
+		break;
+	    }
+	}
     }
-
-    rc = MPI_SUCCESS;
+    ulm_free(map);
 
 ERRHANDLER:
     if (rc != MPI_SUCCESS) {
@@ -44,6 +44,7 @@ int PMPI_Gather(void *sendbuf, int sendcount, MPI_Datatype senddatatype,
 		int root, MPI_Comm comm)
 {
     int rc;
+    long long t0;
     ULMType_t *sendtype;
     ULMType_t *recvtype;
     ulm_gather_t    *gather;
@@ -75,12 +76,17 @@ int PMPI_Gather(void *sendbuf, int sendcount, MPI_Datatype senddatatype,
     sendtype = (ULMType_t *) senddatatype;
     recvtype = (ULMType_t *) recvdatatype;
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_GATHER, (void **)&gather);
     if ( ULM_SUCCESS == rc )
     {
         rc = gather(sendbuf, sendcount, sendtype, recvbuf,
                                 recvcount, recvtype, root, comm);
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_GATHER, root, -1, comm,
+                   (sendbuf == MPI_IN_PLACE) ? 0 :
+                   sendcount * sendtype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
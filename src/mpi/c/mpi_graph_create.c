@@ -50,16 +50,16 @@ int PMPI_Graph_create(MPI_Comm comm_old, int nnodes, int *index,
     int range[1][3];
     int rc;
     int size_old;
+    int *map;
     void *p;
 
     /*
      * Sanity checks
-     *
-     * Note: reorder is ignored (assumed always false)
      */
 
     rc = MPI_SUCCESS;
     p = NULL;
+    map = NULL;
     topology = NULL;
 
     if (comm_new == NULL) {
@@ -88,15 +88,46 @@ int PMPI_Graph_create(MPI_Comm comm_old, int nnodes, int *index,
 	goto ERRHANDLER;
     }
 
-    range[0][0] = 0;
-    range[0][1] = nnodes - 1;
-    range[0][2] = 1;
+    nedges = index[nnodes - 1];
+    for (i = 0; i < nnodes; i++) {
+	if (index[i] < (i ? index[i - 1] : 0)) {
+	    rc = MPI_ERR_ARG;
+	    goto ERRHANDLER;
+	}
+    }
+    for (i = 0; i < nedges; i++) {
+	if (edges[i] < 0 || edges[i] >= nnodes) {
+	    rc = MPI_ERR_ARG;
+	    goto ERRHANDLER;
+	}
+    }
 
     rc = PMPI_Comm_group(comm_old, &group_old);
     if (rc != MPI_SUCCESS) {
 	goto ERRHANDLER;
     }
-    rc = PMPI_Group_range_incl(group_old, 1, range, &group_new);
+    if (reorder) {
+	/*
+	 * Place graph neighbors on the same host where possible
+	 */
+	map = (int *) ulm_malloc(nnodes * sizeof(int));
+	if (map == NULL) {
+	    rc = MPI_ERR_OTHER;
+	    goto ERRHANDLER;
+	}
+	rc = _mpi_graph_map(comm_old, nnodes, index, edges, map);
+	if (rc != MPI_SUCCESS) {
+	    goto ERRHANDLER;
+	}
+	rc = PMPI_Group_incl(group_old, nnodes, map, &group_new);
+	ulm_free(map);
+	map = NULL;
+    } else {
+	range[0][0] = 0;
+	range[0][1] = nnodes - 1;
+	range[0][2] = 1;
+	rc = PMPI_Group_range_incl(group_old, 1, range, &group_new);
+    }
     if (rc != MPI_SUCCESS) {
 	goto ERRHANDLER;
     }
@@ -121,8 +152,6 @@ int PMPI_Graph_create(MPI_Comm comm_old, int nnodes, int *index,
      * Attach the topology
      */
 
-    nedges = index[nnodes - 1];
-
     topology = (ULMTopology_t *) ulm_malloc(sizeof(ULMTopology_t));
     if (topology == (ULMTopology_t *) NULL) {
 	rc = MPI_ERR_OTHER;
@@ -141,19 +170,9 @@ int PMPI_Graph_create(MPI_Comm comm_old, int nnodes, int *index,
     topology->graph.edges = (int *) p + nnodes;
 
     for (i = 0; i < nnodes; i++) {
-	if (index[i] < 0) {
-	    rc = MPI_ERR_ARG;
-	    goto ERRHANDLER;
-	}
 	topology->graph.index[i] = index[i];
     }
-
-
     for (i = 0; i < nedges; i++) {
-	if (edges[i] < 0 || edges[i] >= nnodes) {
-	    rc = MPI_ERR_ARG;
-	    goto ERRHANDLER;
-	}
 	topology->graph.edges[i] = edges[i];
     }
 
@@ -165,6 +184,9 @@ int PMPI_Graph_create(MPI_Comm comm_old, int nnodes, int *index,
 
 ERRHANDLER:
     if (rc != MPI_SUCCESS) {
+	if (map != NULL) {
+	    ulm_free(map);
+	}
 	if (p != NULL) {
 	    ulm_free(p);
 	}
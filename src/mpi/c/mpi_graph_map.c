@@ -32,6 +32,7 @@
 #include "config.h"
 #endif
 
+#include "internal/malloc.h"
 #include "internal/mpi.h"
 
 #ifdef HAVE_PRAGMA_WEAK
@@ -41,6 +42,8 @@
 int PMPI_Graph_map(MPI_Comm comm, int nnodes, int *index, int *edges,
 		   int *newrank)
 {
+    int *map;
+    int i;
     int rank;
     int rc;
     int size;
@@ -61,12 +64,29 @@ int PMPI_Graph_map(MPI_Comm comm, int nnodes, int *index, int *edges,
 	rc = MPI_ERR_ARG;
 	goto ERRHANDLER;
     }
+    for (i = 0; i < index[nnodes - 1]; i++) {
+	if (edges[i] < 0 || edges[i] >= nnodes) {
+	    rc = MPI_ERR_ARG;
+	    goto ERRHANDLER;
+	}
+    }
 
-    if (rank < nnodes) {
-	*newrank = rank;
-    } else {
+    map = (int *) ulm_malloc(nnodes * sizeof(int));
+    if (map == NULL) {
+	rc = MPI_ERR_OTHER;
+	goto ERRHANDLER;
+    }
+    rc = _mpi_graph_map(comm, nnodes, index, edges, map);
+    if (rc == MPI_SUCCESS) {
 	*newrank = MPI_UNDEFINED;
+	for (i = 0; i < nnodes; i++) {
+	    if (map[i] == rank) {
+		*newrank = i;
+		break;
+	    }
+	}
     }
+    ulm_free(map);
 
 ERRHANDLER:
     if (rc != MPI_SUCCESS) {
@@ -132,8 +132,7 @@ int PMPI_Ibsend(void *buf, int count, MPI_Datatype type, int dest,
         if (rc != MPI_SUCCESS) {
             ATOMIC_LOCK_THREAD(lampiState.bsendData->lock);
             if (allocation->refCount == -1) {
-                allocation->refCount = 0;
-                ulm_bsend_clean_alloc(0);
+                ulm_bsend_free_alloc(allocation);
             }
             ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
             goto ERRHANDLER;
@@ -151,8 +150,7 @@ int PMPI_Ibsend(void *buf, int count, MPI_Datatype type, int dest,
     if ((size > 0) && (rc != ULM_SUCCESS)) {
         ATOMIC_LOCK_THREAD(lampiState.bsendData->lock);
         if (allocation->refCount == -1) {
-            allocation->refCount = 0;
-            ulm_bsend_clean_alloc(0);
+            ulm_bsend_free_alloc(allocation);
         }
         ATOMIC_UNLOCK_THREAD(lampiState.bsendData->lock);
     }
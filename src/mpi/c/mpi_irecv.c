@@ -44,6 +44,7 @@ int PMPI_Irecv(void *buf, int count, MPI_Datatype type, int source,
     ULMRequest_t req;
     ULMType_t *datatype = type;
     int rc;
+    long long t0;
 
     if (source == MPI_PROC_NULL) {
 	*request = _mpi.proc_null_request;
@@ -70,9 +71,13 @@ int PMPI_Irecv(void *buf, int count, MPI_Datatype type, int source,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_irecv( buf, count, datatype, source,  tag,  comm,  &req);
     *request = (MPI_Request) req;
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_IRECV, source, tag, comm,
+                   count * datatype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
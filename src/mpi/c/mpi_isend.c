@@ -44,6 +44,7 @@ int PMPI_Isend(void *buf, int count, MPI_Datatype type, int dest,
     ULMRequest_t req;
     ULMType_t *datatype = type;
     int rc;
+    long long t0;
 
     if (dest == MPI_PROC_NULL) {
 	*request = _mpi.proc_null_request;
@@ -70,11 +71,15 @@ int PMPI_Isend(void *buf, int count, MPI_Datatype type, int dest,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_isend(buf, count, datatype, dest, tag, comm, &req,
 		   ULM_SEND_STANDARD);
 
     *request = (MPI_Request) req;
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_ISEND, dest, tag, comm,
+                   count * datatype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
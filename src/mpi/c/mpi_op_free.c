@@ -79,14 +79,14 @@ int PMPI_Op_free(MPI_Op *mop)
     ulm_pending_messages(&messages_pending);
     if (!messages_pending) {
         ATOMIC_LOCK(table->lock);
-        for (i = 0; i < table->size; i++) {
-            if (table->addr[i]) {
-                ulm_free(table->addr[i]);
-                table->addr[i] = NULL;
+        for (i = 0; i < table->high_water; i++) {
+            if (PTR_TABLE_SLOT(table, i)) {
+                ulm_free(PTR_TABLE_SLOT(table, i));
+                PTR_TABLE_SLOT(table, i) = NULL;
             }
         }
-        table->lowest_free = 0;
-        table->number_free = table->size;
+        table->high_water = 0;
+        table->number_free = 0;
         ATOMIC_UNLOCK(table->lock);
     }
 
@@ -47,6 +47,7 @@ int PMPI_Recv(void *buf, int count, MPI_Datatype type, int source,
     ULMStatus_t stat;
     ULMType_t *datatype = type;
     int rc;
+    long long t0;
 
     if (source == MPI_PROC_NULL) {
 	if (status != MPI_STATUS_IGNORE) {
@@ -79,6 +80,7 @@ int PMPI_Recv(void *buf, int count, MPI_Datatype type, int source,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_recv(buf, count, datatype, source, tag, comm, &stat);
 
     /* fill out status object */
@@ -90,6 +92,9 @@ int PMPI_Recv(void *buf, int count, MPI_Datatype type, int source,
 	status->_persistent = stat.persistent_m;
     }
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_RECV, stat.peer_m, stat.tag_m, comm,
+                   stat.length_m);
+
     rc =  (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
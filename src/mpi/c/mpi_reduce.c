@@ -43,6 +43,7 @@ int PMPI_Reduce(void *sendbuf, void *recvbuf, int count,
 		MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm)
 {
     int rc;
+    long long t0;
     ulm_reduce_t    *reduce;
 
     if (_mpi.check_args) {
@@ -65,12 +66,16 @@ int PMPI_Reduce(void *sendbuf, void *recvbuf, int count,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_REDUCE, (void **)&reduce);
     if ( ULM_SUCCESS == rc )
     {
         rc = reduce(sendbuf, recvbuf, count, type, op,
                                 root, comm);
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_REDUCE, root, -1, comm,
+                   count * ((ULMType_t *) type)->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
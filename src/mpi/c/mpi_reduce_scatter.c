@@ -32,8 +32,8 @@
 #include "config.h"
 #endif
 
-#include "internal/malloc.h"
 #include "internal/mpi.h"
+#include "internal/collective.h"
 
 #ifdef HAVE_PRAGMA_WEAK
 #pragma weak MPI_Reduce_scatter = PMPI_Reduce_scatter
@@ -43,10 +43,9 @@ int PMPI_Reduce_scatter(void *sendbuf, void *recvbuf,
 			int *recvcount, MPI_Datatype mtype,
 			MPI_Op mop, MPI_Comm comm)
 {
-    int rc, count, rank, size, i;
-    int *displs;
-    void *buf;
-    ULMType_t *type = mtype;
+    int rc;
+    long long t0;
+    ulm_reduce_scatter_t *reduce_scatter;
 
     if (_mpi.check_args) {
         rc = MPI_SUCCESS;
@@ -66,51 +65,24 @@ int PMPI_Reduce_scatter(void *sendbuf, void *recvbuf,
             rc = MPI_ERR_COMM;
         }
         if (rc != MPI_SUCCESS) {
-            _mpi_errhandler(comm, rc, __FILE__, __LINE__);
-            return rc;
+            goto ERRHANDLER;
         }
     }
 
-    if ((ulm_comm_rank(comm, &rank) != ULM_SUCCESS)
-	|| (ulm_comm_size(comm, &size) != ULM_SUCCESS)) {
-	rc = MPI_ERR_COMM;
-	_mpi_errhandler(comm, rc, __FILE__, __LINE__);
-	return rc;
+    _MPI_TRACE_BEGIN(t0);
+    rc = ulm_comm_get_collective(comm, ULM_COLLECTIVE_REDUCE_SCATTER,
+                                 (void **) &reduce_scatter);
+    if (rc == ULM_SUCCESS) {
+        rc = reduce_scatter(sendbuf, recvbuf, recvcount, mtype, mop, comm);
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_REDUCE_SCATTER, -1, -1, comm, 0);
 
-    displs = ulm_malloc(size * sizeof(int));
-    if (displs == NULL) {
-	rc = MPI_ERR_INTERN;
-        _mpi_errhandler(comm, rc, __FILE__, __LINE__);
-	return rc;
-    }
-
-    count = 0;
-    for (i = 0; i < size; i++) {
-	displs[i] = count;
-	count += recvcount[i];
-    }
-
-    buf = ulm_malloc(count * type->extent);
-    if (buf == NULL) {
-	ulm_free(displs);
-	rc = MPI_ERR_INTERN;
-        _mpi_errhandler(comm, rc, __FILE__, __LINE__);
-	return rc;
-    }
-
-    rc = PMPI_Reduce(sendbuf, buf, count, mtype, mop, 0, comm);
-    if (rc == MPI_SUCCESS) {
-	rc = PMPI_Scatterv(buf, recvcount, displs, mtype,
-			   recvbuf, recvcount[rank], mtype, 0, comm);
-    }
+    rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
+ERRHANDLER:
     if (rc != MPI_SUCCESS) {
         _mpi_errhandler(comm, rc, __FILE__, __LINE__);
     }
 
-    ulm_free(buf);
-    ulm_free(displs);
-
     return rc;
 }
@@ -46,6 +46,7 @@ int PMPI_Rsend(void *buf, int count, MPI_Datatype type, int dest,
     ULMStatus_t stat;
     ULMType_t *datatype = type;
     int rc;
+    long long t0;
 
     if (dest == MPI_PROC_NULL) {
 	return MPI_SUCCESS;
@@ -71,6 +72,7 @@ int PMPI_Rsend(void *buf, int count, MPI_Datatype type, int dest,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_isend(buf, count, datatype, dest,
 		   tag, comm, &req, ULM_SEND_READY);
 
@@ -78,6 +80,9 @@ int PMPI_Rsend(void *buf, int count, MPI_Datatype type, int dest,
 	rc = ulm_wait(&req, &stat);
     }
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_RSEND, dest, tag, comm,
+                   count * datatype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
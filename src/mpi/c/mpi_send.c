@@ -46,6 +46,7 @@ int PMPI_Send(void *buf, int count, MPI_Datatype type, int dest,
 {
     ULMType_t *datatype = type;
     int rc;
+    long long t0;
 
     if (dest == MPI_PROC_NULL) {
 	return MPI_SUCCESS;
@@ -71,9 +72,13 @@ int PMPI_Send(void *buf, int count, MPI_Datatype type, int dest,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_send(buf, count, datatype, dest,
                   tag, comm, ULM_SEND_STANDARD);
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_SEND, dest, tag, comm,
+                   count * datatype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
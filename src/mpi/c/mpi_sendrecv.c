@@ -49,6 +49,7 @@ int PMPI_Sendrecv(void *sendbuf, int sendcount, MPI_Datatype sendtype,
     ULMRequest_t req;
     ULMStatus_t stat;
     int rc;
+    long long t0;
 
     if (_mpi.check_args) {
         rc = MPI_SUCCESS;
@@ -78,6 +79,8 @@ int PMPI_Sendrecv(void *sendbuf, int sendcount, MPI_Datatype sendtype,
         }
     }
 
+    _MPI_TRACE_BEGIN(t0);
+
     if (source != MPI_PROC_NULL) {        /* post recv */
         rc = ulm_irecv(recvbuf, recvcount, recvtype,
                        source, recvtag, comm, &req);
@@ -121,6 +124,10 @@ int PMPI_Sendrecv(void *sendbuf, int sendcount, MPI_Datatype sendtype,
         rc = MPI_SUCCESS;
     }
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_SENDRECV, dest, sendtag, comm,
+                   (dest == MPI_PROC_NULL) ? 0 :
+                   sendcount * ((ULMType_t *) sendtype)->packed_size);
+
 ERRHANDLER:
     if (rc != MPI_SUCCESS) {
         _mpi_errhandler(comm, rc, __FILE__, __LINE__);
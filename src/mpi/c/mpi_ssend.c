@@ -45,6 +45,7 @@ int PMPI_Ssend(void *buf, int count, MPI_Datatype type, int dest,
     ULMStatus_t stat;
     ULMType_t *datatype = type;
     int rc;
+    long long t0;
 
     if (dest == MPI_PROC_NULL) {
 	return MPI_SUCCESS;
@@ -74,6 +75,7 @@ int PMPI_Ssend(void *buf, int count, MPI_Datatype type, int dest,
      * the synchronous send is implemented a ready send to improve the
      * performance of the non-blocking send
      */
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_isend(buf, count, datatype, dest,
 		   tag, comm, &req, ULM_SEND_SYNCHRONOUS);
 
@@ -81,6 +83,9 @@ int PMPI_Ssend(void *buf, int count, MPI_Datatype type, int dest,
 	rc = ulm_wait(&req, &stat);
     }
 
+    _MPI_TRACE_END(t0, _MPI_TRACE_SSEND, dest, tag, comm,
+                   count * datatype->packed_size);
+
     rc = (rc == ULM_SUCCESS) ? MPI_SUCCESS : _mpi_error(rc);
 
 ERRHANDLER:
@@ -45,6 +45,7 @@ int PMPI_Wait(MPI_Request *request, MPI_Status *status)
 {
     ULMStatus_t stat;
     int rc;
+    long long t0;
 
     if (_mpi.check_args) {
         rc = MPI_SUCCESS;
@@ -80,7 +81,10 @@ int PMPI_Wait(MPI_Request *request, MPI_Status *status)
 	return MPI_SUCCESS;
     }
 
+    _MPI_TRACE_BEGIN(t0);
     rc = ulm_wait((ULMRequest_t *) request, &stat);
+    _MPI_TRACE_END(t0, _MPI_TRACE_WAIT, stat.peer_m, stat.tag_m, -1,
+                   stat.length_m);
     if (rc != ULM_SUCCESS) {
         if (status != MPI_STATUS_IGNORE) {
 	    status->MPI_ERROR = _mpi_error(stat.error_m);
@@ -49,11 +49,13 @@ int PMPI_Waitall(int count,
 {
     int flag = 0;
     int rc;
+    long long t0;
 
     if (array_of_statuses != MPI_STATUSES_IGNORE) {
 	memset(array_of_statuses, 0, count * sizeof(MPI_Status));
     }
 
+    _MPI_TRACE_BEGIN(t0);
     while (flag == 0) {
         rc = PMPI_Testall(count,
                           array_of_requests,
@@ -64,6 +66,7 @@ int PMPI_Waitall(int count,
             return rc;
         }
     }
+    _MPI_TRACE_END(t0, _MPI_TRACE_WAITALL, -1, -1, -1, 0);
 
     return MPI_SUCCESS;
 }
@@ -33,7 +33,6 @@
 #endif
 
 #include "internal/mpi.h"
-#include <unistd.h>
 
 #ifdef HAVE_PRAGMA_WEAK
 #pragma weak MPI_Wtick = PMPI_Wtick
@@ -41,5 +40,5 @@
 
 double PMPI_Wtick(void)
 {
-    return 1.0 / (double) sysconf(_SC_CLK_TCK);
+    return ulm_dclock_resolution();
 }
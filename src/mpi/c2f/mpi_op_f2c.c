@@ -36,5 +36,5 @@
 
 MPI_Op MPI_Op_f2c(MPI_Fint op)
 {
-    return (MPI_Op) _mpif.op_table->addr[op];
+    return (MPI_Op) PTR_TABLE_SLOT(_mpif.op_table, op);
 }
@@ -39,7 +39,7 @@ MPI_Request MPI_Request_f2c(MPI_Fint request)
     /* the FORTRAN MPI_REQUEST_NULL is the value -1 */
 
     if (request >= 0)
-	return (MPI_Request) _mpif.request_table->addr[request];
+	return (MPI_Request) PTR_TABLE_SLOT(_mpif.request_table, request);
     else
 	return MPI_REQUEST_NULL;
 }
@@ -37,7 +37,7 @@
 MPI_Datatype MPI_Type_f2c(MPI_Fint datatype)
 {
     if (datatype >= 0) {
-        return (MPI_Datatype) _mpif.type_table->addr[datatype];
+        return (MPI_Datatype) PTR_TABLE_SLOT(_mpif.type_table, datatype);
     } else {
         return MPI_DATATYPE_NULL;
     }
@@ -4,6 +4,8 @@ SRC_LIBMPI += \
 	src/mpi/internal/mpi_op.c \
 	src/mpi/internal/mpi_ptr_table.c \
 	src/mpi/internal/mpi_state.c \
+	src/mpi/internal/mpi_topo_map.c \
+	src/mpi/internal/mpi_trace.c \
 	src/mpi/internal/mpi_type.c \
 	src/mpi/internal/mpi_util.c \
 	src/mpi/internal/mpif_op.c \
@@ -158,7 +158,7 @@ void _mpi_errhandler(MPI_Comm comm, int rc, char *file, int line)
     }
 
     if (index < _mpi.errhandler_table->size) {
-	handler = (errhandler_t *) _mpi.errhandler_table->addr[index];
+	handler = (errhandler_t *) PTR_TABLE_SLOT(_mpi.errhandler_table, index);
 	ATOMIC_LOCK(handler->lock);
 	handler->func(&comm, &rc, file, &line);
 	ATOMIC_UNLOCK(handler->lock);
@@ -39,110 +39,137 @@
  * MPI Fortran: miscellaneous utilities
  */
 
+#include <string.h>
+
 #include "internal/mpif.h"
 #include "internal/state.h"
 #include "os/atomic.h"
 
 /*
- * add a pointer to dynamic pointer table
+ * add a segment to a pointer table
+ *
+ * Called with the table lock held.  Lookups run concurrently, so the
+ * new segment and directory are made visible before the size is
+ * increased, and a replaced directory is retired, not freed.
  */
-int _mpi_ptr_table_add(ptr_table_t *table, void *ptr)
+static int grow_table(ptr_table_t *table)
 {
-    void **p;
-    int	index, i;
-    enum { TABLE_INIT = 1, TABLE_GROW = 2 };	/* ??? increase these after debug ??? */
-
-    if (_MPI_DEBUG) {
-	_mpi_dbg("_mpi_ptr_table_add:  IN:  "
-                 " table %p (size %ld, lowest free %ld, number free %ld)"
-                 " ptr = %p\n",
-		 table, table->size, table->lowest_free, table->number_free,
-                 ptr);
+    enum { DIR_INIT = 4, DIR_GROW = 2 };
+    ptr_table_dir_t *dir = table->dir;
+    void **segment;
+    int *free_index;
+    int nsegments;
+    int i;
+
+    nsegments = dir ? dir->nsegments : 0;
+
+    segment = ulm_malloc(PTR_TABLE_SEGMENT_SIZE * sizeof(void *));
+    if (segment == NULL) {
+        return -1;
+    }
+    for (i = 0; i < PTR_TABLE_SEGMENT_SIZE; i++) {
+        segment[i] = NULL;
     }
 
-    assert(table != NULL);
+    free_index = ulm_malloc((nsegments + 1) * PTR_TABLE_SEGMENT_SIZE *
+                            sizeof(int));
+    if (free_index == NULL) {
+        ulm_free(segment);
+        return -1;
+    }
+    if (table->free_index) {
+        memcpy(free_index, table->free_index,
+               table->number_free * sizeof(int));
+        ulm_free(table->free_index);
+    }
+    table->free_index = free_index;
+    table->max_free = (nsegments + 1) * PTR_TABLE_SEGMENT_SIZE;
 
-    ATOMIC_LOCK_THREAD(table->lock);
+    if (dir == NULL || dir->nsegments == dir->max_segments) {
 
-    if (table->addr == NULL) {
+        /*
+         * new directory
+         */
 
-	/*
-	 * first time
-	 */
+        int max_segments = dir ? DIR_GROW * dir->max_segments : DIR_INIT;
+        ptr_table_dir_t *new_dir;
 
         if (_MPI_DEBUG) {
-	    _mpi_dbg("_mpi_ptr_table_add:  INIT: table %p\n", table);
+            _mpi_dbg("_mpi_ptr_table_add:  GROW: table %p directory"
+                     " %d -> %d segments\n",
+                     table, dir ? dir->max_segments : 0, max_segments);
+        }
+
+        new_dir = ulm_malloc(sizeof(ptr_table_dir_t) +
+                             (max_segments - 1) * sizeof(void **));
+        if (new_dir == NULL) {
+            ulm_free(segment);
+            return -1;
         }
+        new_dir->retired = dir;
+        new_dir->nsegments = nsegments;
+        new_dir->max_segments = max_segments;
+        for (i = 0; i < nsegments; i++) {
+            new_dir->segment[i] = dir->segment[i];
+        }
+        dir = new_dir;
+    }
 
-	p = ulm_malloc(TABLE_INIT * sizeof(void *));
-	if (p == NULL) {
-	    return -1;
-	}
-	table->lowest_free = 0;
-	table->number_free = TABLE_INIT;
-	table->size = TABLE_INIT;
-	table->addr = p;
-        for (i = 0; i < table->size; i++) {
-	    table->addr[i] = NULL;
-	}
+    dir->segment[nsegments] = segment;
+    dir->nsegments = nsegments + 1;
+    wmb();
+    table->dir = dir;
+    wmb();
+    table->size = dir->nsegments * PTR_TABLE_SEGMENT_SIZE;
 
-    } else if (table->number_free == 0) {
+    return 0;
+}
 
-	/*
-	 * grow table
-	 */
+/*
+ * add a pointer to dynamic pointer table
+ */
+int _mpi_ptr_table_add(ptr_table_t *table, void *ptr)
+{
+    int index;
 
-        if (_MPI_DEBUG) {
-	    _mpi_dbg("_mpi_ptr_table_add:  GROW: table %p growing %d -> %d\n",
-		     table, table->size, table->size * TABLE_GROW);
-        }
+    assert(table != NULL);
 
-	p = realloc(table->addr, TABLE_GROW * table->size * sizeof(void *));
-	if (p == NULL) {
-            ATOMIC_UNLOCK_THREAD(table->lock);
-	    return -1;
-	}
-	table->lowest_free = table->size;
-	table->number_free = (TABLE_GROW - 1) * table->size;
-	table->size *= TABLE_GROW;
-	table->addr = p;
-        for (i = table->lowest_free; i < table->size; i++) {
-	    table->addr[i] = NULL;
-	}
+    if (_MPI_DEBUG) {
+        _mpi_dbg("_mpi_ptr_table_add:  IN:  "
+                 " table %p (size %d, high water %d, number free %d)"
+                 " ptr = %p\n",
+                 table, table->size, table->high_water, table->number_free,
+                 ptr);
     }
 
-    assert(table->addr != NULL);
-    assert(table->size > 0);
-    assert(table->lowest_free >= 0);
-    assert(table->lowest_free < table->size);
-    assert(table->number_free > 0);
-    assert(table->number_free <= table->size);
+    ATOMIC_LOCK_THREAD(table->lock);
 
     /*
-     * add pointer to table, and return the index
+     * reuse the most recently freed slot, otherwise take the next
+     * unused one, growing the table if necessary
      */
 
-    index = table->lowest_free;
-    assert(table->addr[index] == NULL);
-    table->addr[index] = ptr;
-    table->number_free--;
     if (table->number_free > 0) {
-        for (i = table->lowest_free + 1; i < table->size; i++) {
-	    if (table->addr[i] == NULL) {
-	        table->lowest_free = i;
-	        break;
-	    }
+        index = table->free_index[--table->number_free];
+    } else {
+        if (table->high_water == table->size && grow_table(table) < 0) {
+            ATOMIC_UNLOCK_THREAD(table->lock);
+            return -1;
         }
+        index = table->high_water++;
     }
-    else {
-        table->lowest_free = table->size;
-    }
+
+    assert(index >= 0);
+    assert(index < table->size);
+    assert(PTR_TABLE_SLOT(table, index) == NULL);
+
+    PTR_TABLE_SLOT(table, index) = ptr;
 
     if (_MPI_DEBUG) {
-	_mpi_dbg("_mpi_ptr_table_add:  OUT: "
-                 " table %p (size %ld, lowest free %ld, number free %ld)"
+        _mpi_dbg("_mpi_ptr_table_add:  OUT: "
+                 " table %p (size %d, high water %d, number free %d)"
                  " addr[%d] = %p\n",
-		 table, table->size, table->lowest_free, table->number_free,
+                 table, table->size, table->high_water, table->number_free,
                  index, ptr);
     }
 
@@ -157,32 +184,32 @@ int _mpi_ptr_table_add(ptr_table_t *table, void *ptr)
 int _mpi_ptr_table_free(ptr_table_t *table, int index)
 {
     assert(table != NULL);
-    assert(table->addr != NULL);
+    assert(table->dir != NULL);
     assert(index >= 0);
     assert(index < table->size);
 
     if (_MPI_DEBUG) {
-	_mpi_dbg("_mpi_ptr_table_free: IN:  "
-                 " table %p (size %ld, lowest free %ld, number free %ld)"
+        _mpi_dbg("_mpi_ptr_table_free: IN:  "
+                 " table %p (size %d, high water %d, number free %d)"
                  " addr[%d] = %p\n",
-		 table, table->size, table->lowest_free, table->number_free,
-                 index, table->addr[index]);
+                 table, table->size, table->high_water, table->number_free,
+                 index, PTR_TABLE_SLOT(table, index));
     }
 
     ATOMIC_LOCK_THREAD(table->lock);
 
-    table->addr[index] = NULL;
-    if (index < table->lowest_free) {
-	table->lowest_free = index;
+    if (PTR_TABLE_SLOT(table, index) != NULL) {
+        PTR_TABLE_SLOT(table, index) = NULL;
+        assert(table->number_free < table->max_free);
+        table->free_index[table->number_free++] = index;
     }
-    table->number_free++;
 
     if (_MPI_DEBUG) {
-	_mpi_dbg("_mpi_ptr_table_free: OUT: "
-                 " table %p (size %ld, lowest free %ld, number free %ld)"
+        _mpi_dbg("_mpi_ptr_table_free: OUT: "
+                 " table %p (size %d, high water %d, number free %d)"
                  " addr[%d] = %p\n",
-		 table, table->size, table->lowest_free, table->number_free,
-                 index, table->addr[index]);
+                 table, table->size, table->high_water, table->number_free,
+                 index, PTR_TABLE_SLOT(table, index));
     }
 
     ATOMIC_UNLOCK_THREAD(table->lock);
@@ -191,38 +218,40 @@ int _mpi_ptr_table_free(ptr_table_t *table, int index)
 }
 
 /*
- * lookup pointer by index in pointer table
+ * lookup pointer by index in pointer table: no lock is needed since
+ * slots never move
  */
 void *_mpi_ptr_table_lookup(ptr_table_t *table, int index)
 {
-    void *p;
-
-    if (_MPI_DEBUG) {
-	_mpi_dbg("_mpi_ptr_table_free: IN: "
-                 " table %p (size %ld, lowest free %ld, number free %ld)"
-                 " addr[%d] = %p\n",
-		 table, table->size, table->lowest_free, table->number_free,
-                 index, table->addr[index]);
-    }
-
-    ATOMIC_LOCK_THREAD(table->lock);
-
     assert(table != NULL);
-    assert(table->addr != NULL);
+    assert(table->dir != NULL);
     assert(index >= 0);
     assert(index < table->size);
 
-    p = table->addr[index];
+    return PTR_TABLE_SLOT(table, index);
+}
 
-    ATOMIC_UNLOCK_THREAD(table->lock);
+/*
+ * free a pointer table and its storage (but not the pointers it
+ * holds)
+ */
+void _mpi_ptr_table_destroy(ptr_table_t *table)
+{
+    ptr_table_dir_t *dir;
+    int i;
 
-    if (_MPI_DEBUG) {
-	_mpi_dbg("_mpi_ptr_table_free: OUT:"
-                 " table %p (size %ld, lowest free %ld, number free %ld)"
-                 " addr[%d] = %p\n",
-		 table, table->size, table->lowest_free, table->number_free,
-                 index, table->addr[index]);
+    if (table->dir) {
+        for (i = 0; i < table->dir->nsegments; i++) {
+            ulm_free(table->dir->segment[i]);
+        }
     }
-
-    return p;
+    while (table->dir) {
+        dir = table->dir;
+        table->dir = dir->retired;
+        ulm_free(dir);
+    }
+    if (table->free_index) {
+        ulm_free(table->free_index);
+    }
+    ulm_free(table);
 }
@@ -157,6 +157,14 @@ int _mpi_init(void)
         }
         memset(_mpi.free_table, 0, sizeof(ptr_table_t));
         ATOMIC_LOCK_INIT(_mpi.free_table->lock);
+
+        /*
+         * event tracing, if requested
+         */
+        rc = _mpi_trace_init();
+        if (rc < 0) {
+            return rc;
+        }
     }
 
     ATOMIC_UNLOCK(_mpi.lock);
@@ -164,11 +172,7 @@ int _mpi_init(void)
     /*
      * initialize the control structure of buffered sends
      */
-    lampiState.bsendData->poolInUse = 0;
-    lampiState.bsendData->bufferLength = 0;
-    lampiState.bsendData->bytesInUse = 0;
-    lampiState.bsendData->buffer = 0;
-    lampiState.bsendData->allocations = NULL;
+    memset(lampiState.bsendData, 0, sizeof(bsendData_t));
     ATOMIC_LOCK_INIT(lampiState.bsendData->lock);
 
     return MPI_SUCCESS;
@@ -189,30 +193,26 @@ int _mpi_finalize(void)
         return _mpi_error(rc);
     }
 
+    _mpi_trace_finalize();
+
     ATOMIC_LOCK(_mpi.lock);
     if (_mpi.finalized == 0) {
 
         _mpi.finalized = 1;
 
         for (i = 0; i < _mpi.errhandler_table->size; i++) {
-            if (_mpi.errhandler_table->addr[i]) {
-                ulm_free(_mpi.errhandler_table->addr[i]);
+            if (PTR_TABLE_SLOT(_mpi.errhandler_table, i)) {
+                ulm_free(PTR_TABLE_SLOT(_mpi.errhandler_table, i));
             }
         }
-        if (_mpi.errhandler_table->addr) {
-            ulm_free(_mpi.errhandler_table->addr);
-        }
-        ulm_free(_mpi.errhandler_table);
+        _mpi_ptr_table_destroy(_mpi.errhandler_table);
 
         for (i = 0; i < _mpi.free_table->size; i++) {
-            if (_mpi.free_table->addr[i]) {
-                ulm_free(_mpi.free_table->addr[i]);
+            if (PTR_TABLE_SLOT(_mpi.free_table, i)) {
+                ulm_free(PTR_TABLE_SLOT(_mpi.free_table, i));
             }
         }
-        if (_mpi.free_table->addr) {
-            ulm_free(_mpi.free_table->addr);
-        }
-        ulm_free(_mpi.free_table);
+        _mpi_ptr_table_destroy(_mpi.free_table);
     }
     ATOMIC_UNLOCK(_mpi.lock);
 
@@ -0,0 +1,477 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "internal/malloc.h"
+#include "internal/mpi.h"
+
+/*
+ * Rank reordering for process topologies
+ *
+ * The ranks of a Cartesian or graph topology are mapped onto the
+ * processes of a communicator so that as many neighbor pairs as
+ * possible share a host.  Processes are listed host by host, and
+ * each host is given a compact region of the topology: a block of
+ * the grid for Cartesian topologies when the hosts are uniformly
+ * populated, and otherwise a region grown greedily from a seed,
+ * always adding the vertex with most edges into the region.  The
+ * result is only used if it cuts fewer edges than the identity map.
+ *
+ * map[newrank] is set to the rank in comm of the process that is to
+ * have rank newrank in the topology.  Only information common to all
+ * processes is used, so all processes compute the same map.
+ */
+
+
+/*
+ * List the processes of comm host by host: hosts in order of their
+ * lowest rank, ranks in increasing order within a host.  procs[]
+ * gets the ranks, host h has procs[first[h]] to procs[first[h + 1] -
+ * 1], and hostof[rank] is the host of each process.
+ */
+static int host_order(MPI_Comm comm, int size, int *procs, int *first,
+                      int *hostof, int *nhost)
+{
+    int *hostid;
+    int i, j, n;
+
+    hostid = (int *) ulm_malloc(size * sizeof(int));
+    if (hostid == NULL) {
+        return MPI_ERR_NO_MEM;
+    }
+    if (ulm_get_info(comm, ULM_INFO_HOSTIDS, hostid,
+                     size * sizeof(int)) != ULM_SUCCESS) {
+        ulm_free(hostid);
+        return MPI_ERR_COMM;
+    }
+
+    *nhost = n = 0;
+    for (i = 0; i < size; i++) {
+        hostof[i] = -1;
+    }
+    for (i = 0; i < size; i++) {
+        if (hostof[i] >= 0) {
+            continue;
+        }
+        first[*nhost] = n;
+        for (j = i; j < size; j++) {
+            if (hostid[j] == hostid[i]) {
+                hostof[j] = *nhost;
+                procs[n++] = j;
+            }
+        }
+        (*nhost)++;
+    }
+    first[*nhost] = n;
+
+    ulm_free(hostid);
+
+    return MPI_SUCCESS;
+}
+
+
+/*
+ * Number of edges between vertices mapped to different hosts
+ */
+static int cut(int n, int *xadj, int *adj, int *map, int *hostof)
+{
+    int i, v, ncut;
+
+    ncut = 0;
+    for (v = 0; v < n; v++) {
+        for (i = xadj[v]; i < xadj[v + 1]; i++) {
+            if (hostof[map[v]] != hostof[map[adj[i]]]) {
+                ncut++;
+            }
+        }
+    }
+
+    return ncut;
+}
+
+
+/*
+ * Grow one region per host over the graph with adjacency lists
+ * adj[xadj[v]] to adj[xadj[v + 1] - 1], seeding each at the lowest
+ * unassigned vertex.  Ties are broken in favour of vertices nearest
+ * the seed, which keeps regions compact.
+ */
+static int grow_regions(int n, int *xadj, int *adj, int *procs,
+                        int *first, int nhost, int *map)
+{
+    int *owner, *gain, *dist, *queue, *frontier;
+    int h, i, k, v, u, best, nfrontier, head, tail, seed, assigned;
+
+    owner = (int *) ulm_malloc(5 * n * sizeof(int));
+    if (owner == NULL) {
+        return MPI_ERR_NO_MEM;
+    }
+    gain = owner + n;
+    dist = gain + n;
+    queue = dist + n;
+    frontier = queue + n;
+
+    for (v = 0; v < n; v++) {
+        owner[v] = -1;
+        gain[v] = 0;
+    }
+
+    seed = 0;
+    assigned = 0;
+    for (h = 0; h < nhost && assigned < n; h++) {
+
+        /* distances from the seed through unassigned vertices */
+        while (owner[seed] >= 0) {
+            seed++;
+        }
+        for (v = 0; v < n; v++) {
+            dist[v] = n;
+        }
+        dist[seed] = 0;
+        head = tail = 0;
+        queue[tail++] = seed;
+        while (head < tail) {
+            v = queue[head++];
+            for (i = xadj[v]; i < xadj[v + 1]; i++) {
+                u = adj[i];
+                if (owner[u] < 0 && dist[u] == n) {
+                    dist[u] = dist[v] + 1;
+                    queue[tail++] = u;
+                }
+            }
+        }
+
+        /* grow the region */
+        nfrontier = 0;
+        for (k = first[h]; k < first[h + 1] && assigned < n; k++) {
+            best = -1;
+            for (i = 0; i < nfrontier; i++) {
+                v = frontier[i];
+                if (best < 0 || gain[v] > gain[frontier[best]] ||
+                    (gain[v] == gain[frontier[best]] &&
+                     (dist[v] < dist[frontier[best]] ||
+                      (dist[v] == dist[frontier[best]] &&
+                       v < frontier[best])))) {
+                    best = i;
+                }
+            }
+            if (best < 0) {
+                /* disconnected: start again at the next free vertex */
+                while (owner[seed] >= 0) {
+                    seed++;
+                }
+                v = seed;
+            } else {
+                v = frontier[best];
+                frontier[best] = frontier[--nfrontier];
+            }
+            owner[v] = h;
+            assigned++;
+            for (i = xadj[v]; i < xadj[v + 1]; i++) {
+                u = adj[i];
+                if (owner[u] < 0) {
+                    if (gain[u]++ == 0) {
+                        frontier[nfrontier++] = u;
+                    }
+                }
+            }
+        }
+        for (i = 0; i < nfrontier; i++) {
+            gain[frontier[i]] = 0;
+        }
+    }
+
+    /* give each host's processes to its region in vertex order */
+    for (h = 0; h < nhost; h++) {
+        k = first[h];
+        for (v = 0; v < n; v++) {
+            if (owner[v] == h) {
+                map[v] = procs[k++];
+            }
+        }
+    }
+
+    ulm_free(owner);
+
+    return MPI_SUCCESS;
+}
+
+
+/*
+ * Choose block dimensions b[] dividing dims[] with product ppn that
+ * minimize the number of neighbor pairs cut by block boundaries
+ */
+static void block_search(int d, int ndims, int *dims, int rest, int ppn,
+                         int *b, int *best, int *best_cost)
+{
+    int cost, i;
+
+    if (d == ndims) {
+        if (rest != 1) {
+            return;
+        }
+        cost = 0;
+        for (i = 0; i < ndims; i++) {
+            if (b[i] < dims[i]) {
+                cost += 2 * (ppn / b[i]);
+            }
+        }
+        if (*best_cost < 0 || cost < *best_cost) {
+            *best_cost = cost;
+            memcpy(best, b, ndims * sizeof(int));
+        }
+        return;
+    }
+
+    for (b[d] = 1; b[d] <= rest && b[d] <= dims[d]; b[d]++) {
+        if (rest % b[d] == 0 && dims[d] % b[d] == 0) {
+            block_search(d + 1, ndims, dims, rest / b[d], ppn,
+                         b, best, best_cost);
+        }
+    }
+}
+
+
+/*
+ * Keep map if it cuts fewer edges than the identity map
+ */
+static void choose(int n, int *xadj, int *adj, int *map, int *ident,
+                   int *hostof)
+{
+    int r;
+
+    for (r = 0; r < n; r++) {
+        ident[r] = r;
+    }
+    if (cut(n, xadj, adj, map, hostof) >=
+        cut(n, xadj, adj, ident, hostof)) {
+        memcpy(map, ident, n * sizeof(int));
+    }
+}
+
+
+/*
+ * _mpi_cart_map - map a Cartesian topology onto the processes of comm
+ */
+int _mpi_cart_map(MPI_Comm comm, int ndims, int *dims, int *periods,
+                  int nnodes, int *map)
+{
+    int *procs, *first, *hostof, *b, *block, *x, *xadj, *adj;
+    int i, h, r, v, rc, size, nhost, ppn, cost, stride, blk, off, n;
+
+    rc = PMPI_Comm_size(comm, &size);
+    if (rc != MPI_SUCCESS) {
+        return rc;
+    }
+    procs = (int *) ulm_malloc((3 * size + 1 + 3 * ndims) * sizeof(int));
+    if (procs == NULL) {
+        return MPI_ERR_NO_MEM;
+    }
+    first = procs + size;
+    hostof = first + size + 1;
+    b = hostof + size;
+    block = b + ndims;
+    x = block + ndims;
+    xadj = NULL;
+
+    rc = host_order(comm, size, procs, first, hostof, &nhost);
+    if (rc != MPI_SUCCESS) {
+        goto CLEANUP;
+    }
+
+    /* nothing to gain with all processes on one host or one per host */
+    for (i = 0; i < ndims; i++) {
+        if (dims[i] < 1) {
+            nhost = 1;
+        }
+    }
+    if (nhost == 1 || nhost == size) {
+        for (r = 0; r < nnodes; r++) {
+            map[r] = r;
+        }
+        goto CLEANUP;
+    }
+
+    /* the grid graph, and space for the identity map */
+    xadj = (int *) ulm_malloc((2 * nnodes + 1 + 2 * ndims * nnodes) *
+                              sizeof(int));
+    if (xadj == NULL) {
+        rc = MPI_ERR_NO_MEM;
+        goto CLEANUP;
+    }
+    adj = xadj + nnodes + 1;
+    n = 0;
+    for (r = 0; r < nnodes; r++) {
+        xadj[r] = n;
+        stride = nnodes;
+        for (i = 0; i < ndims; i++) {
+            stride /= dims[i];
+            x[i] = (r / stride) % dims[i];
+            if (x[i] > 0) {
+                adj[n++] = r - stride;
+            } else if (periods[i] && dims[i] > 2) {
+                adj[n++] = r + (dims[i] - 1) * stride;
+            }
+            if (x[i] < dims[i] - 1) {
+                adj[n++] = r + stride;
+            } else if (periods[i] && dims[i] > 2) {
+                adj[n++] = r - (dims[i] - 1) * stride;
+            }
+        }
+    }
+    xadj[nnodes] = n;
+
+    /* uniformly populated hosts: tile the grid with blocks */
+    ppn = first[1];
+    for (h = 0; h < nhost && first[h] < nnodes; h++) {
+        if (first[h + 1] - first[h] != ppn) {
+            break;
+        }
+    }
+    cost = -1;
+    if (nnodes % ppn == 0 && first[h] >= nnodes) {
+        block_search(0, ndims, dims, ppn, ppn, b, block, &cost);
+    }
+    if (cost >= 0) {
+        for (r = 0; r < nnodes; r++) {
+            v = r;
+            for (i = ndims - 1; i >= 0; i--) {
+                x[i] = v % dims[i];
+                v /= dims[i];
+            }
+            blk = off = 0;
+            for (i = 0; i < ndims; i++) {
+                blk = blk * (dims[i] / block[i]) + x[i] / block[i];
+                off = off * block[i] + x[i] % block[i];
+            }
+            map[r] = procs[blk * ppn + off];
+        }
+    } else {
+        rc = grow_regions(nnodes, xadj, adj, procs, first, nhost, map);
+        if (rc != MPI_SUCCESS) {
+            goto CLEANUP;
+        }
+    }
+
+    choose(nnodes, xadj, adj, map, adj + n, hostof);
+
+CLEANUP:
+    if (xadj != NULL) {
+        ulm_free(xadj);
+    }
+    ulm_free(procs);
+
+    return rc;
+}
+
+
+/*
+ * _mpi_graph_map - map a graph topology onto the processes of comm
+ */
+int _mpi_graph_map(MPI_Comm comm, int nnodes, int *index, int *edges,
+                   int *map)
+{
+    int *procs, *first, *hostof, *xadj, *adj, *fill;
+    int i, r, u, rc, size, nhost, nedges;
+
+    rc = PMPI_Comm_size(comm, &size);
+    if (rc != MPI_SUCCESS) {
+        return rc;
+    }
+    procs = (int *) ulm_malloc((3 * size + 1) * sizeof(int));
+    if (procs == NULL) {
+        return MPI_ERR_NO_MEM;
+    }
+    first = procs + size;
+    hostof = first + size + 1;
+    xadj = NULL;
+
+    rc = host_order(comm, size, procs, first, hostof, &nhost);
+    if (rc != MPI_SUCCESS) {
+        goto CLEANUP;
+    }
+
+    if (nhost == 1 || nhost == size) {
+        for (r = 0; r < nnodes; r++) {
+            map[r] = r;
+        }
+        goto CLEANUP;
+    }
+
+    /*
+     * symmetric adjacency lists, since edges may be given one way;
+     * fill[] is reused for the identity map
+     */
+    nedges = index[nnodes - 1];
+    xadj = (int *) ulm_malloc((2 * (nnodes + 1) + 2 * nedges) *
+                              sizeof(int));
+    if (xadj == NULL) {
+        rc = MPI_ERR_NO_MEM;
+        goto CLEANUP;
+    }
+    fill = xadj + nnodes + 1;
+    adj = fill + nnodes + 1;
+    memset(xadj, 0, (nnodes + 1) * sizeof(int));
+    for (r = 0; r < nnodes; r++) {
+        for (i = (r ? index[r - 1] : 0); i < index[r]; i++) {
+            xadj[r + 1]++;
+            xadj[edges[i] + 1]++;
+        }
+    }
+    for (r = 0; r < nnodes; r++) {
+        xadj[r + 1] += xadj[r];
+    }
+    memcpy(fill, xadj, (nnodes + 1) * sizeof(int));
+    for (r = 0; r < nnodes; r++) {
+        for (i = (r ? index[r - 1] : 0); i < index[r]; i++) {
+            u = edges[i];
+            adj[fill[r]++] = u;
+            adj[fill[u]++] = r;
+        }
+    }
+
+    rc = grow_regions(nnodes, xadj, adj, procs, first, nhost, map);
+    if (rc == MPI_SUCCESS) {
+        choose(nnodes, xadj, adj, map, fill, hostof);
+    }
+
+CLEANUP:
+    if (xadj != NULL) {
+        ulm_free(xadj);
+    }
+    ulm_free(procs);
+
+    return rc;
+}
@@ -0,0 +1,416 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/*
+ * Per-process MPI event tracing.
+ *
+ * Enabled at run time by setting LAMPI_TRACE=1.  Each traced MPI
+ * call records one fixed size event (function, peer, tag,
+ * communicator, bytes, entry and exit times) into a ring buffer.
+ * Times are raw time stamp counter cycles when ulm_dclock() uses the
+ * TSC, and nanoseconds otherwise; they are scaled only when the trace
+ * is read.  When threads are in use, slots are claimed with an atomic
+ * fetch-and-add, so no lock is taken on the recording path.  The ring
+ * is split into two halves; when a half fills it is written to the trace file with
+ * an asynchronous write while recording continues into the other
+ * half.
+ *
+ * Environment:
+ *
+ *   LAMPI_TRACE          non-zero to enable tracing
+ *   LAMPI_TRACE_FILE     trace file prefix (default "lampi-trace");
+ *                        each process writes <prefix>.<rank>.trc
+ *   LAMPI_TRACE_EVENTS   ring buffer size in events (default 65536)
+ *
+ * The file is a _mpi_trace_header_t, _MPI_TRACE_NFUNCS function
+ * names of TRACE_NAME_LEN bytes each, then the records.
+ * scripts/parse_trace.pl merges the files from all processes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(HAVE_LIBRT) || defined(HAVE_LIBAIO)
+#define USE_AIO 1
+#include <aio.h>
+#else
+#define USE_AIO 0
+#endif
+
+#include "init/environ.h"
+#include "internal/constants.h"
+#include "internal/mpi.h"
+#include "internal/state.h"
+#include "os/atomic.h"
+
+enum {
+    TRACE_VERSION = 2,
+    TRACE_NAME_LEN = 16,
+    TRACE_MIN_EVENTS = 64
+};
+
+typedef struct _mpi_trace_header_t _mpi_trace_header_t;
+struct _mpi_trace_header_t {
+    char magic[8];              /* "LAMPITRC" */
+    int version;
+    int rank;
+    int nprocs;
+    int record_size;
+    int nfuncs;
+    int pad;
+    double time_offset;         /* gettimeofday() at time stamp 0 */
+    double secs_per_tick;       /* seconds per time stamp tick */
+};
+
+static const char *trace_names[_MPI_TRACE_NFUNCS] = {
+    "MPI_Send",
+    "MPI_Ssend",
+    "MPI_Rsend",
+    "MPI_Bsend",
+    "MPI_Isend",
+    "MPI_Irecv",
+    "MPI_Recv",
+    "MPI_Sendrecv",
+    "MPI_Wait",
+    "MPI_Waitall",
+    "MPI_Barrier",
+    "MPI_Bcast",
+    "MPI_Reduce",
+    "MPI_Allreduce",
+    "MPI_Gather",
+    "MPI_Scatter",
+    "MPI_Allgather",
+    "MPI_Alltoall",
+    "MPI_Reduce_scatter"
+};
+
+int _mpi_trace_enabled = 0;
+int _mpi_trace_tsc = 0;
+
+static struct {
+    _mpi_trace_record_t *records;
+    unsigned int nrecords;      /* ring size, a power of two */
+    unsigned int half;          /* records per half */
+    unsigned int half_shift;    /* log2(half) */
+    unsigned int lap_mask;      /* mask for comparing laps */
+    volatile int next;          /* next slot to claim */
+    volatile int filled[2];     /* records completed in each half */
+    volatile unsigned int lap[2];       /* lap each half may accept */
+    unsigned int flushed;       /* records handed to the file */
+    off_t offset;               /* file offset of next write */
+    int fd;
+#if USE_AIO
+    struct aiocb cb[2];
+    volatile int pending[2];
+#endif
+    lockStructure_t lock[1];
+} trace;
+
+/*
+ * A half has reached the file: make it available for the next lap
+ */
+static void trace_complete(int h)
+{
+    trace.filled[h] = 0;
+    wmb();
+    trace.lap[h]++;
+}
+
+static int trace_write(const void *buf, size_t len)
+{
+    const char *p = (const char *) buf;
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(trace.fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+/*
+ * Check for completed asynchronous writes (lock held)
+ */
+static void trace_reap(void)
+{
+#if USE_AIO
+    int h;
+
+    for (h = 0; h < 2; h++) {
+        if (trace.pending[h] && aio_error(&trace.cb[h]) != EINPROGRESS) {
+            if (aio_return(&trace.cb[h]) != (ssize_t) trace.cb[h].aio_nbytes) {
+                ulm_warn(("Warning: MPI trace: write failed\n"));
+            }
+            trace.pending[h] = 0;
+            trace_complete(h);
+        }
+    }
+#endif
+}
+
+/*
+ * Write out a full half of the ring (lock held)
+ */
+static void trace_flush(int h)
+{
+    size_t len = trace.half * sizeof(_mpi_trace_record_t);
+    void *buf = trace.records + h * trace.half;
+
+#if USE_AIO
+    memset(&trace.cb[h], 0, sizeof(trace.cb[h]));
+    trace.cb[h].aio_fildes = trace.fd;
+    trace.cb[h].aio_buf = buf;
+    trace.cb[h].aio_nbytes = len;
+    trace.cb[h].aio_offset = trace.offset;
+    trace.offset += len;
+    trace.flushed += trace.half;
+    if (aio_write(&trace.cb[h]) == 0) {
+        trace.pending[h] = 1;
+        return;
+    }
+    lseek(trace.fd, trace.cb[h].aio_offset, SEEK_SET);
+#else
+    trace.offset += len;
+    trace.flushed += trace.half;
+#endif
+
+    if (trace_write(buf, len) != 0) {
+        ulm_warn(("Warning: MPI trace: write failed\n"));
+    }
+    trace_complete(h);
+}
+
+/*
+ * Record a traced call: called at exit from the MPI function
+ */
+void _mpi_trace_event(int func, int peer, int tag, int comm,
+                      long long bytes, long long t_enter)
+{
+    _mpi_trace_record_t *r;
+    long long t_exit;
+    unsigned int i;
+    unsigned int h;
+    int n;
+
+    t_exit = _mpi_trace_clock();
+
+    if (lampiState.usethreads) {
+        i = (unsigned int) fetchNadd(&trace.next, 1);
+    } else {
+        i = (unsigned int) trace.next++;
+    }
+    h = (i >> trace.half_shift) & 1;
+
+    /* wait for the previous lap through this half to be written */
+    while ((trace.lap[h] & trace.lap_mask) != (i >> (trace.half_shift + 1))) {
+        if (ATOMIC_TRYLOCK(trace.lock)) {
+            trace_reap();
+            ATOMIC_UNLOCK(trace.lock);
+        }
+    }
+
+    r = trace.records + (i & (trace.nrecords - 1));
+    r->t_enter = t_enter;
+    r->t_exit = t_exit;
+    r->bytes = bytes;
+    r->func = func;
+    r->peer = peer;
+    r->tag = tag;
+    r->comm = comm;
+    wmb();
+
+    if (lampiState.usethreads) {
+        n = fetchNadd(&trace.filled[h], 1);
+    } else {
+        n = trace.filled[h]++;
+    }
+    if (n == (int) trace.half - 1) {
+        ATOMIC_LOCK(trace.lock);
+        trace_reap();
+        trace_flush(h);
+        ATOMIC_UNLOCK(trace.lock);
+    }
+}
+
+int _mpi_trace_init(void)
+{
+    _mpi_trace_header_t header;
+    char names[_MPI_TRACE_NFUNCS][TRACE_NAME_LEN];
+    char filename[ULM_MAX_PATH_LEN];
+    char *prefix;
+    struct timeval tv;
+    long long t0;
+    long long t1;
+    int enable;
+    int nevents;
+    int rank;
+    int nprocs;
+    int i;
+
+    enable = 0;
+    lampi_environ_find_integer("LAMPI_TRACE", &enable);
+    if (enable == 0) {
+        return 0;
+    }
+
+    lampi_environ_find_integer("LAMPI_TRACE_EVENTS", &nevents);
+    lampi_environ_find_string("LAMPI_TRACE_FILE", &prefix);
+    if (prefix == NULL || *prefix == '\0') {
+        prefix = "lampi-trace";
+    }
+
+    memset(&trace, 0, sizeof(trace));
+    ATOMIC_LOCK_INIT(trace.lock);
+
+    for (trace.half = TRACE_MIN_EVENTS / 2, trace.half_shift = 5;
+         2 * trace.half < (unsigned int) nevents;
+         trace.half *= 2, trace.half_shift++) {
+        ;
+    }
+    trace.nrecords = 2 * trace.half;
+    trace.lap_mask = ~0U >> (trace.half_shift + 1);
+
+    trace.records = (_mpi_trace_record_t *)
+        ulm_malloc(trace.nrecords * sizeof(_mpi_trace_record_t));
+    if (trace.records == NULL) {
+        ulm_warn(("Warning: MPI trace: out of memory\n"));
+        return 0;
+    }
+    /* touch the ring now rather than fault it in while recording */
+    memset(trace.records, 0, trace.nrecords * sizeof(_mpi_trace_record_t));
+
+    ulm_comm_rank(ULM_COMM_WORLD, &rank);
+    ulm_comm_size(ULM_COMM_WORLD, &nprocs);
+
+    snprintf(filename, sizeof(filename), "%s.%d.trc", prefix, rank);
+    trace.fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (trace.fd < 0) {
+        ulm_warn(("Warning: MPI trace: can not open %s\n", filename));
+        ulm_free(trace.records);
+        return 0;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "LAMPITRC", sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.rank = rank;
+    header.nprocs = nprocs;
+    header.record_size = sizeof(_mpi_trace_record_t);
+    header.nfuncs = _MPI_TRACE_NFUNCS;
+    _mpi_trace_tsc = ulm_dclock_tsc(&header.secs_per_tick);
+    if (!_mpi_trace_tsc) {
+        header.secs_per_tick = 1.0e-9;
+    }
+    t0 = _mpi_trace_clock();
+    gettimeofday(&tv, NULL);
+    t1 = _mpi_trace_clock();
+    header.time_offset = (double) tv.tv_sec + (double) tv.tv_usec * 1.0e-6
+        - (double) (t0 + (t1 - t0) / 2) * header.secs_per_tick;
+
+    memset(names, 0, sizeof(names));
+    for (i = 0; i < _MPI_TRACE_NFUNCS; i++) {
+        strncpy(names[i], trace_names[i], TRACE_NAME_LEN - 1);
+    }
+
+    if (trace_write(&header, sizeof(header)) != 0 ||
+        trace_write(names, sizeof(names)) != 0) {
+        ulm_warn(("Warning: MPI trace: can not write %s\n", filename));
+        close(trace.fd);
+        ulm_free(trace.records);
+        return 0;
+    }
+    trace.offset = sizeof(header) + sizeof(names);
+
+    _mpi_trace_enabled = 1;
+
+    return 0;
+}
+
+/*
+ * Drain the ring buffer and close the trace file.  Called once all
+ * traced calls have returned.
+ */
+int _mpi_trace_finalize(void)
+{
+    unsigned int first;
+    unsigned int n;
+
+    if (_mpi_trace_enabled == 0) {
+        return 0;
+    }
+    _mpi_trace_enabled = 0;
+
+    ATOMIC_LOCK(trace.lock);
+
+#if USE_AIO
+    while (trace.pending[0] || trace.pending[1]) {
+        trace_reap();
+    }
+#endif
+
+    lseek(trace.fd, trace.offset, SEEK_SET);
+    n = (unsigned int) trace.next - trace.flushed;
+    first = trace.flushed & (trace.nrecords - 1);
+    if (first + n > trace.nrecords) {
+        trace_write(trace.records + first,
+                    (trace.nrecords - first) * sizeof(_mpi_trace_record_t));
+        n -= trace.nrecords - first;
+        first = 0;
+    }
+    if (trace_write(trace.records + first,
+                    n * sizeof(_mpi_trace_record_t)) != 0) {
+        ulm_warn(("Warning: MPI trace: write failed\n"));
+    }
+
+    close(trace.fd);
+    ulm_free(trace.records);
+    trace.records = NULL;
+
+    ATOMIC_UNLOCK(trace.lock);
+
+    return 0;
+}
@@ -113,37 +113,30 @@ int _mpif_finalize(void)
         /* empty the fortran-layer tables */
         
         for (i = 0; i < _mpif.op_table->size; i++) {
-            if (_mpif.op_table->addr[i]) {
-                MPI_Op_free((MPI_Op *) &(_mpif.op_table->addr[i]));
+            if (PTR_TABLE_SLOT(_mpif.op_table, i)) {
+                MPI_Op_free((MPI_Op *) &PTR_TABLE_SLOT(_mpif.op_table, i));
             }
         }
 
         for (i = 0; i < _mpif.request_table->size; i++) {
-            if (_mpif.request_table->addr[i]) {
-                MPI_Request_free((MPI_Request *) &(_mpif.request_table->addr[i]));
+            if (PTR_TABLE_SLOT(_mpif.request_table, i)) {
+                MPI_Request_free((MPI_Request *)
+                                 &PTR_TABLE_SLOT(_mpif.request_table, i));
             }
         }
 
         for (i = 0; i < _mpif.type_table->size; i++) {
-            if (_mpif.type_table->addr[i]) {
-                MPI_Type_free((MPI_Datatype *) &(_mpif.type_table->addr[i]));
+            if (PTR_TABLE_SLOT(_mpif.type_table, i)) {
+                MPI_Type_free((MPI_Datatype *)
+                              &PTR_TABLE_SLOT(_mpif.type_table, i));
             }
         }
 
         /* free the fortran-layer tables */
 
-        if (_mpif.op_table->addr) {
-            ulm_free(_mpif.op_table->addr);
-        }
-        ulm_free(_mpif.op_table);
-        if (_mpif.request_table->addr) {
-            ulm_free(_mpif.request_table->addr);
-        }
-        ulm_free(_mpif.request_table);
-        if (_mpif.type_table->addr) {
-            ulm_free(_mpif.type_table->addr);
-        }
-        ulm_free(_mpif.type_table);
+        _mpi_ptr_table_destroy(_mpif.op_table);
+        _mpi_ptr_table_destroy(_mpif.request_table);
+        _mpi_ptr_table_destroy(_mpif.type_table);
     }
     ATOMIC_UNLOCK(_mpif.lock);
 
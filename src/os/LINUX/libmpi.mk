@@ -1,2 +1,3 @@
 SRC_LIBMPI += \
-	src/os/LINUX/PlatformBarrierSetup.cc
+	src/os/LINUX/PlatformBarrierSetup.cc \
+	src/os/LINUX/numa.cc
@@ -0,0 +1,447 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dirent.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "internal/constants.h"
+#include "internal/log.h"
+#include "internal/malloc.h"
+#include "internal/state.h"
+#include "init/environ.h"
+#include "os/numa.h"
+
+/*
+ * Processor binding and memory placement for Linux
+ *
+ * getCPUSet() runs before the fork.  It reads the topology from
+ * sysfs and chooses a cpu, and so a NUMA node, for each process on
+ * the host, according to LAMPI_PROCESSOR_AFFINITY:
+ *
+ *   0  no binding (the default)
+ *   1  compact: fill the cores of one socket before the next
+ *   2  scatter: deal processes round-robin across sockets
+ *
+ * or to an explicit list of cpus from mpirun -cpulist or
+ * LAMPI_CPULIST (colon separated), which takes precedence.  Only
+ * cpus in the affinity mask inherited from the launcher are used.
+ *
+ * setCPUAffinity() binds a process to its cpu after the fork, and
+ * setAffinity() asks for the pages of a memory pool belonging to a
+ * process to be placed on its node.
+ */
+
+#define SYSFS_CPU	"/sys/devices/system/cpu"
+#define SYSFS_NODE	"/sys/devices/system/node"
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED	1
+#endif
+
+enum {
+    BIND_NONE,
+    BIND_COMPACT,
+    BIND_SCATTER,
+    BIND_LIST
+};
+
+typedef struct {
+    int cpu;
+    int node;
+    int socket;
+    int core;
+    int thread;                 // index among the core's hardware threads
+} cpuInfo_t;
+
+static int *cpuList = NULL;     // explicit list of cpus
+static int cpuListLen = 0;
+static int *procCPU = NULL;     // cpu of each local process
+static int *procNode = NULL;    // NUMA node of each local process
+static int nProcs = 0;
+static int maxNode = 0;
+
+
+/*
+ * read a single integer from a sysfs file, or return -1
+ */
+static int readInt(const char *path)
+{
+    FILE *fp;
+    int value = -1;
+
+    fp = fopen(path, "r");
+    if (fp) {
+        if (fscanf(fp, "%d", &value) != 1) {
+            value = -1;
+        }
+        fclose(fp);
+    }
+
+    return value;
+}
+
+
+/*
+ * parse a sysfs cpu list such as "0-3,8-11" into a cpu set
+ */
+static void readCPUList(const char *path, cpu_set_t *set)
+{
+    FILE *fp;
+    int lo;
+    int hi;
+    char sep;
+
+    CPU_ZERO(set);
+    fp = fopen(path, "r");
+    if (!fp) {
+        return;
+    }
+    while (fscanf(fp, "%d", &lo) == 1) {
+        hi = lo;
+        sep = fgetc(fp);
+        if (sep == '-') {
+            if (fscanf(fp, "%d", &hi) != 1) {
+                break;
+            }
+            sep = fgetc(fp);
+        }
+        for (int c = lo; c <= hi && c < CPU_SETSIZE; c++) {
+            CPU_SET(c, set);
+        }
+        if (sep != ',') {
+            break;
+        }
+    }
+    fclose(fp);
+}
+
+
+static int compareCompact(const void *a, const void *b)
+{
+    const cpuInfo_t *x = (const cpuInfo_t *) a;
+    const cpuInfo_t *y = (const cpuInfo_t *) b;
+
+    if (x->node != y->node) {
+        return x->node - y->node;
+    }
+    if (x->socket != y->socket) {
+        return x->socket - y->socket;
+    }
+    if (x->thread != y->thread) {
+        return x->thread - y->thread;
+    }
+    if (x->core != y->core) {
+        return x->core - y->core;
+    }
+    return x->cpu - y->cpu;
+}
+
+
+/*
+ * fill info with the topology of the cpus this process may use, in
+ * compact order, and return how many there are
+ */
+static int readTopology(cpuInfo_t *info)
+{
+    cpu_set_t allowed;
+    cpu_set_t set;
+    char path[256];
+    DIR *dir;
+    struct dirent *d;
+    int n = 0;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0) {
+        return 0;
+    }
+
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (!CPU_ISSET(c, &allowed)) {
+            continue;
+        }
+        info[n].cpu = c;
+        info[n].node = 0;
+        sprintf(path, SYSFS_CPU "/cpu%d/topology/physical_package_id", c);
+        info[n].socket = readInt(path);
+        sprintf(path, SYSFS_CPU "/cpu%d/topology/core_id", c);
+        info[n].core = readInt(path);
+        sprintf(path, SYSFS_CPU "/cpu%d/topology/thread_siblings_list", c);
+        readCPUList(path, &set);
+        info[n].thread = 0;
+        for (int s = 0; s < c; s++) {
+            if (CPU_ISSET(s, &set)) {
+                info[n].thread++;
+            }
+        }
+        n++;
+    }
+
+    // NUMA nodes (absent on kernels without NUMA support)
+    dir = opendir(SYSFS_NODE);
+    if (dir) {
+        while ((d = readdir(dir)) != NULL) {
+            int node;
+
+            if (sscanf(d->d_name, "node%d", &node) != 1) {
+                continue;
+            }
+            sprintf(path, SYSFS_NODE "/node%d/cpulist", node);
+            readCPUList(path, &set);
+            for (int i = 0; i < n; i++) {
+                if (CPU_ISSET(info[i].cpu, &set)) {
+                    info[i].node = node;
+                }
+            }
+            if (node > maxNode) {
+                maxNode = node;
+            }
+        }
+        closedir(dir);
+    }
+
+    qsort(info, n, sizeof(cpuInfo_t), compareCompact);
+
+    return n;
+}
+
+
+/*
+ * reorder the cpus, given in compact order, to deal them
+ * round-robin across sockets
+ */
+static void scatter(cpuInfo_t *info, int n)
+{
+    cpuInfo_t *tmp = (cpuInfo_t *) ulm_malloc(n * sizeof(cpuInfo_t));
+    int *start = (int *) ulm_malloc((n + 1) * sizeof(int));
+    int nsocket = 0;
+    int m = 0;
+
+    if (!tmp || !start) {
+        ulm_exit(("Error: Out of memory\n"));
+    }
+
+    // compact order keeps the cpus of a socket together
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || info[i].node != info[i - 1].node ||
+            info[i].socket != info[i - 1].socket) {
+            start[nsocket++] = i;
+        }
+    }
+    start[nsocket] = n;
+
+    for (int r = 0; m < n; r++) {
+        for (int k = 0; k < nsocket; k++) {
+            if (start[k] + r < start[k + 1]) {
+                tmp[m++] = info[start[k] + r];
+            }
+        }
+    }
+    memcpy(info, tmp, n * sizeof(cpuInfo_t));
+
+    ulm_free(tmp);
+    ulm_free(start);
+}
+
+
+/*
+ * record the explicit cpu list sent by mpirun
+ */
+void setCPUList(int len, int *list)
+{
+    if (cpuList) {
+        ulm_free(cpuList);
+    }
+    cpuList = (int *) ulm_malloc(len * sizeof(int));
+    if (!cpuList) {
+        ulm_exit(("Error: Out of memory\n"));
+    }
+    memcpy(cpuList, list, len * sizeof(int));
+    cpuListLen = len;
+}
+
+
+/*
+ * choose the cpu and node of each process on this host
+ */
+int getCPUSet(void)
+{
+    cpuInfo_t *info;
+    int policy = BIND_NONE;
+    int ncpu;
+
+    lampi_environ_find_integer("LAMPI_PROCESSOR_AFFINITY", &policy);
+
+    if (cpuListLen == 0) {
+        char **list = NULL;
+
+        lampi_environ_find_string_array("LAMPI_CPULIST", &list);
+        for (int i = 0; list && list[i]; i++) {
+            if (*list[i]) {
+                int cpu = atoi(list[i]);
+
+                if (cpuListLen == 0) {
+                    cpuList = (int *) ulm_malloc(CPU_SETSIZE * sizeof(int));
+                    if (!cpuList) {
+                        ulm_exit(("Error: Out of memory\n"));
+                    }
+                }
+                if (cpuListLen < CPU_SETSIZE) {
+                    cpuList[cpuListLen++] = cpu;
+                }
+            }
+        }
+    }
+    if (cpuListLen > 0) {
+        policy = BIND_LIST;
+    }
+    if (policy == BIND_NONE) {
+        return ULM_SUCCESS;
+    }
+    if (policy != BIND_COMPACT && policy != BIND_SCATTER &&
+        policy != BIND_LIST) {
+        ulm_warn(("Warning: LAMPI_PROCESSOR_AFFINITY=%d not recognized\n",
+                  policy));
+        return ULM_SUCCESS;
+    }
+
+    info = (cpuInfo_t *) ulm_malloc(CPU_SETSIZE * sizeof(cpuInfo_t));
+    if (!info) {
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    ncpu = readTopology(info);
+    if (ncpu == 0) {
+        ulm_warn(("Warning: processor topology not available, "
+                  "processes will not be bound\n"));
+        ulm_free(info);
+        return ULM_SUCCESS;
+    }
+    if (policy == BIND_SCATTER) {
+        scatter(info, ncpu);
+    }
+
+    nProcs = lampiState.map_host_to_local_size[lampiState.hostid];
+    procCPU = (int *) ulm_malloc(nProcs * sizeof(int));
+    procNode = (int *) ulm_malloc(nProcs * sizeof(int));
+    if (!procCPU || !procNode) {
+        ulm_free(info);
+        return ULM_ERR_OUT_OF_RESOURCE;
+    }
+    if (nProcs > ncpu && policy != BIND_LIST) {
+        ulm_warn(("Warning: %d processes share %d cpus\n", nProcs, ncpu));
+    }
+
+    for (int p = 0; p < nProcs; p++) {
+        if (policy == BIND_LIST) {
+            procCPU[p] = cpuList[p % cpuListLen];
+            procNode[p] = -1;
+            for (int i = 0; i < ncpu; i++) {
+                if (info[i].cpu == procCPU[p]) {
+                    procNode[p] = info[i].node;
+                }
+            }
+        } else {
+            procCPU[p] = info[p % ncpu].cpu;
+            procNode[p] = info[p % ncpu].node;
+        }
+    }
+    ulm_free(info);
+
+    // memory pools are placed on the node of the process they belong to
+    lampiState.enforceAffinity = 1;
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * bind this process to the cpu chosen for it
+ */
+int setCPUAffinity(affinity_t affinity)
+{
+    cpu_set_t set;
+
+    if (!procCPU || affinity < 0 || affinity >= nProcs) {
+        return ULM_SUCCESS;
+    }
+
+    CPU_ZERO(&set);
+    CPU_SET(procCPU[affinity], &set);
+    if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+        ulm_warn(("Warning: can't bind to cpu %d (%s)\n",
+                  procCPU[affinity], strerror(errno)));
+    }
+
+    return ULM_SUCCESS;
+}
+
+
+/*
+ * prefer the node of process affinity for the pages of [addr, addr +
+ * size), which must not have been touched yet
+ */
+bool setAffinity(void *addr, size_t size, affinity_t affinity)
+{
+#ifdef SYS_mbind
+    unsigned long mask[1 + CPU_SETSIZE / (8 * sizeof(unsigned long))];
+    unsigned long nbits = 8 * sizeof(mask);
+    unsigned long page = getpagesize();
+    unsigned long start = (unsigned long) addr & ~(page - 1);
+    int node;
+
+    if (!procNode || maxNode == 0 || affinity < 0 || affinity >= nProcs) {
+        return true;
+    }
+    node = procNode[affinity];
+    if (node < 0 || node >= (int) nbits) {
+        return true;
+    }
+
+    memset(mask, 0, sizeof(mask));
+    mask[node / (8 * sizeof(unsigned long))] |=
+        1UL << (node % (8 * sizeof(unsigned long)));
+    if (syscall(SYS_mbind, start, (unsigned long) addr + size - start,
+                MPOL_PREFERRED, mask, nbits + 1, 0) < 0) {
+        ulm_warn(("Warning: mbind failed (%s), memory placement "
+                  "disabled\n", strerror(errno)));
+        maxNode = 0;
+    }
+#endif
+
+    return true;
+}
@@ -151,11 +151,7 @@ inline static int fetchNset(volatile int *addr, int setValue)
     __asm__ __volatile__(
 	"       mov %2, %1\n" \
 	"lock ; xchg %1, %0\n"
-#ifdef __INTEL_COMPILER
-	: "=m" (*addr), "=&r" (inputValue) : "r" (setValue) : "memory");
-#else
-    : "=m" (*addr), "=r" (inputValue) : "r" (setValue) : "memory");
-#endif
+	: "+m" (*addr), "=&r" (inputValue) : "r" (setValue) : "memory");
 
     return (inputValue);
 }
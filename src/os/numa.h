@@ -31,9 +31,24 @@
  */
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
+#ifndef OS_NUMA_H_INCLUDED
+#define OS_NUMA_H_INCLUDED
+
 #include "internal/types.h"
 
-#if ENABLE_NUMA == 0
+#if defined(__linux__)
+
+// sysfs topology, sched_setaffinity() and mbind(): os/LINUX/numa.cc
+
+bool setAffinity(void *addr, size_t size, affinity_t affinity);
+
+int getCPUSet(void);
+
+void setCPUList(int len, int *list);
+
+int setCPUAffinity(affinity_t affinity);
+
+#elif ENABLE_NUMA == 0
 
 inline bool setAffinity(void *addr, size_t size, affinity_t affinity)
 {
@@ -45,12 +60,34 @@ inline int getCPUSet(void)
     return ULM_SUCCESS;
 }
 
+inline void setCPUList(int len, int *list)
+{
+}
+
+inline int setCPUAffinity(affinity_t affinity)
+{
+    return ULM_SUCCESS;
+}
+
 #else
 
-# OS / architecture specific implementation elsewhere
+// OS / architecture specific implementation elsewhere
 
 bool setAffinity(void *addr, size_t size, affinity_t affinity);
 
-int getCPUSet(void)
+int getCPUSet(void);
+
+// processes are placed by the resource request (acquire)
+
+inline void setCPUList(int len, int *list)
+{
+}
+
+inline int setCPUAffinity(affinity_t affinity)
+{
+    return ULM_SUCCESS;
+}
 
 #endif
+
+#endif /* OS_NUMA_H_INCLUDED */
@@ -186,6 +186,8 @@ int BaseRecvFragDesc_t::processRecvDataSeqs(BaseAck_t *ackPtr,
 
 #if ENABLE_RELIABILITY
 
+	ReliabilityInfo::peer_t *peer = reliabilityData->peer(glSourceProcess);
+
 	if( !isDuplicate_m ) {
 		/* 
 		 * this is called after a fragment's data has been processed 
@@ -198,30 +200,24 @@ int BaseRecvFragDesc_t::processRecvDataSeqs(BaseAck_t *ackPtr,
 
 			/* grab lock for sequence tracking lists */
 			if (usethreads())
-				reliabilityData->dataSeqsLock[glSourceProcess].
-					lock();
+				peer->dataSeqsLock.lock();
 
 			/* update sequence tracking lists */
 			bool recorded;
 			if( ackPtr->ackStatus == ACKSTATUS_DATAGOOD ) {
 				/* data is ok - update deliveredDataSeqs list */
-				reliabilityData->
-					deliveredDataSeqs[glSourceProcess].
+				peer->deliveredDataSeqs.
 					recordIfNotRecorded (seq_m, &recorded);
 				if (!recorded) {
-					reliabilityData->dataSeqsLock
-						[glSourceProcess].unlock();
+					peer->dataSeqsLock.unlock();
 					ulm_exit(("BaseRecvFragDesc_t::processRecvDataSeqs(pt2pt) unable "
 								"to record deliv'd sequence number\n"));
 				}
 			} else {
 				/* data is corrupt - erase sequence data from 
 				 * receivedDataSeqs */
-				if (!(reliabilityData->receivedDataSeqs
-							[glSourceProcess].erase
-							(seq_m))) {
-					reliabilityData->dataSeqsLock
-						[glSourceProcess].unlock();
+				if (!(peer->receivedDataSeqs.erase(seq_m))) {
+					peer->dataSeqsLock.unlock();
 					ulm_exit(("seRecvFragDesc_t::processRecvDataSeqs(pt2pt) unable "
 								"to erase rcv'd sequence number\n"));
 				}
@@ -229,7 +225,7 @@ int BaseRecvFragDesc_t::processRecvDataSeqs(BaseAck_t *ackPtr,
 
 			// unlock sequence tracking lists
 			if (usethreads())
-				reliabilityData->dataSeqsLock[glSourceProcess].unlock();
+				peer->dataSeqsLock.unlock();
 		} else {
 			// unknown communication type
 			ulm_exit(("BaseRecvFragDesc_t::processRecvDataSeqs unknown communication "
@@ -252,10 +248,8 @@ int BaseRecvFragDesc_t::processRecvDataSeqs(BaseAck_t *ackPtr,
 	}
 
 	/* set non-specific ack information */
-	ackPtr->receivedFragSeq = reliabilityData->
-		receivedDataSeqs[glSourceProcess].largestInOrder();
-	ackPtr->deliveredFragSeq = reliabilityData->
-		deliveredDataSeqs[glSourceProcess].largestInOrder();
+	ackPtr->receivedFragSeq = peer->receivedDataSeqs.largestInOrder();
+	ackPtr->deliveredFragSeq = peer->deliveredDataSeqs.largestInOrder();
 
 #else
 	ackPtr->receivedFragSeq = 0;
@@ -274,12 +268,14 @@ void SendDesc_t::shallowCopyTo(RequestDesc_t *request)
     SendDesc_t	*sendDesc = (SendDesc_t *)request;
 
     RequestDesc_t::shallowCopyTo(request);
-    sendDesc->bsendBufferSize = bsendBufferSize;
+    if (bsend_m) {
+        sendDesc->bsendInfo()->bufferSize = bsend_m->bufferSize;
+    }
     sendDesc->sendType = sendType;
     sendDesc->addr_m = addr_m;
     sendDesc->posted_m = posted_m;
 
-    ulm_type_retain(sendDesc->bsendDatatype);
+    ulm_type_retain(sendDesc->bsendDatatype());
 }
 
 
@@ -362,8 +358,7 @@ void RecvDesc_t::DeliveredToApp(unsigned long bytesCopied, unsigned long bytesDi
         // remove recv desc from list
         Communicator *Comm = communicators[ctx_m];
         if (WhichQueue == MATCHEDIRECV) {
-            Comm->privateQueues.MatchedRecv[reslts_m.peer_m]
-                ->RemoveLink(this);
+            Comm->peerState(reslts_m.peer_m)->MatchedRecv.RemoveLink(this);
         }
 
         // if ulm_request_free has already been called, then 
@@ -461,7 +456,7 @@ void RecvDesc_t::DeliveredToAppLock(unsigned long bytesCopied, unsigned long byt
         // remove receive descriptor from list
         Communicator *Comm = communicators[ctx_m];
         if (WhichQueue == MATCHEDIRECV) {
-            Comm->privateQueues.MatchedRecv[reslts_m.peer_m]->RemoveLink(this);
+            Comm->peerState(reslts_m.peer_m)->MatchedRecv.RemoveLink(this);
         }
 
         // if ulm_request_free() has already been called, then we
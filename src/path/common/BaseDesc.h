@@ -41,6 +41,8 @@
 #include "util/DblLinkList.h"
 #include "util/MemFunctions.h"
 #include "internal/constants.h"
+#include "internal/log.h"
+#include "internal/malloc.h"
 #include "internal/state.h"
 #include "os/atomic.h"
 #include "ulm/ulm.h"
@@ -57,7 +59,8 @@ enum RequestType_t {
     REQUEST_TYPE_SEND = 1,
     REQUEST_TYPE_RECV = 2,
     REQUEST_TYPE_BCAST = 3,
-    REQUEST_TYPE_SHARE = 4 
+    REQUEST_TYPE_SHARE = 4,
+    REQUEST_TYPE_COLL = 5
 };
 
 enum RequestState_t {
@@ -136,14 +139,39 @@ struct RequestDesc_t : public Links_t {
 //
 // It stores a pointer to the data structures actually used to send
 // data, and to monitor the progress of this specific message.
+//
+// Descriptors come from cache line aligned pool elements.  The first
+// line after RequestDesc_t holds what every send touches (envelope,
+// progress counters, path), the next the path info and lock; the
+// frag lists only the network paths use come last, and persistent
+// buffered send state lives in a side structure.
 
 class SendDesc_t : public RequestDesc_t
 {
 public:
 
+    // state for persistent buffered sends, allocated the first time
+    // a descriptor is used for one, and kept with it after that
+    struct bsendInfo_t {
+        void *appBufferPointer; // set to point to the original buffer (which
+                                // can be different from addr_m -- MPI_Bsend)
+        ULMType_t *datatype;    // original datatype (NULL => contiguous)
+        size_t bufferSize;      // the size of the buffer needed to pack the bsend data
+        int dtypeCount;         // datatype element count of original bsend data
+    };
+
     // Data members
 
     BasePath_t * path_m;        // pointer to path object
+    Status_t posted_m;
+    void *addr_m;               // pointer to the base of the data
+    unsigned long isendSeq_m;   // library specified tag
+    unsigned numfrags;          // number of frags that will be sent
+    volatile int NumSent;       // the number that have had the 'action' applied
+    volatile unsigned NumAcked; //  number of acks received
+    volatile unsigned NumFragDescAllocated;     // number of frag descriptors allocated
+    int sendType;               // send type - normal, buffered, synchronous, or ready
+    bool clearToSend_m;         // flag for flow control, frags are only sent when true
 
     // path specific info/data
     union {
@@ -154,29 +182,14 @@ public:
     } pathInfo;
 
     Locks Lock;                 // lock
-    DoubleLinkList FragsToAck;  // double link list of frags that need to be acked
-    DoubleLinkList FragsToSend; // double link list of frags that need to be sent
-    bool clearToSend_m;         // flag for flow control, frags are only sent when true
-    unsigned long isendSeq_m;   // library specified tag
-    void *addr_m;              // pointer to the base of the data
-    unsigned numfrags;          // number of frags that will be sent
-    volatile unsigned NumAcked; //  number of acks received
-    volatile unsigned NumFragDescAllocated;     // number of frag descriptors allocated
-    volatile int NumSent;       // the number that have had the 'action' applied
-    Status_t posted_m;
-
+    ssize_t bsendOffset;        // bsend buffer allocation offset
 #if ENABLE_RELIABILITY
     double earliestTimeToResend;
 #endif
+    bsendInfo_t *bsend_m;       // persistent bsend state, NULL until used
 
-    int sendType;               // send type - normal, buffered, synchronous, or ready
-    ssize_t bsendOffset;        // bsend buffer allocation offset
-    void *appBufferPointer;     // set to point to the original buffer (which
-    // can be different from addr_m -- MPI_Bsend)
-    ULMType_t *bsendDatatype;   // original datatype (NULL => contiguous)
-    size_t bsendBufferSize;     // the size of the buffer needed to pack the bsend data
-
-    int bsendDtypeCount;        // datatype element count of original bsend data
+    DoubleLinkList FragsToAck;  // double link list of frags that need to be acked
+    DoubleLinkList FragsToSend; // double link list of frags that need to be sent
 
     // Methods
 
@@ -187,7 +200,7 @@ public:
             // free list
             WhichQueue = SENDDESCFREELIST;
             datatype = NULL;
-            bsendDatatype = NULL;
+            bsend_m = NULL;
             path_m = 0;
             addr_m = 0;
             NumAcked = 0;
@@ -204,7 +217,7 @@ public:
         {
             WhichQueue = SENDDESCFREELIST;
             datatype = NULL;
-            bsendDatatype = NULL;
+            bsend_m = NULL;
             Lock.init();
             FragsToSend.Lock.init();
             FragsToAck.Lock.init();
@@ -225,12 +238,32 @@ public:
             return clearToSend_m;
         }
 
+    // persistent bsend state, allocated on first use
+    bsendInfo_t *bsendInfo()
+        {
+            if (!bsend_m) {
+                bsend_m = (bsendInfo_t *) ulm_malloc(sizeof(bsendInfo_t));
+                if (!bsend_m) {
+                    ulm_exit(("Error: Out of memory\n"));
+                }
+                memset(bsend_m, 0, sizeof(bsendInfo_t));
+            }
+            return bsend_m;
+        }
+
+    // original bsend datatype, or NULL if none was ever set
+    ULMType_t *bsendDatatype()
+        {
+            return bsend_m ? bsend_m->datatype : NULL;
+        }
+
     virtual void shallowCopyTo(RequestDesc_t *request);
 };
 
 // RecvDesc_t:
 //
-// Descriptor used to track posted receives.
+// Descriptor used to track posted receives.  Everything matching and
+// completion touch fits in the cache line after RequestDesc_t.
 
 class RecvDesc_t : public RequestDesc_t
 {
@@ -238,16 +271,16 @@ public:
     
     // Data members
 
-    unsigned long long isendSeq_m;          // library specified isend tag
-    unsigned long long irecvSeq_m;          // library specified irecv tag
     void *addr_m;                          // pointer to the base of the data
     Status_t posted_m;
     Status_t reslts_m;
     volatile unsigned long DataReceived;    // Amount of data received
     volatile unsigned long DataInBitBucket; // Amount of data ignored if PostedLength < ReceivedMessageLength
-
     Locks Lock;                             // lock
 
+    unsigned long long irecvSeq_m;          // library specified irecv tag
+    unsigned long long isendSeq_m;          // library specified isend tag
+
     // Methods
 
     // Copy to App buffers
@@ -66,7 +66,8 @@ void InitSendDescriptors(int NumLocalProcs)
     long nPagesPerList = 100;
     long maxPagesPerList = _ulm_maxPgsIn1SendDescList;
     ssize_t pageSize = SMPPAGESIZE;
-    ssize_t eleSize = sizeof(SendDesc_t);
+    ssize_t eleSize = (((sizeof(SendDesc_t) - 1)
+                        / CACHE_ALIGNMENT) + 1) * CACHE_ALIGNMENT;
     ssize_t poolChunkSize = SMPPAGESIZE;
     int nFreeLists = 1;
     int retryForMoreResources = 1;
@@ -192,6 +192,15 @@ public:
         return true;
     }
 
+    // send a small contiguous message without a send descriptor; the
+    // data is copied out before returning, and delivery is then up to
+    // the path.  Returns false if the path can not send it this way,
+    // in which case the caller falls back to a send descriptor.
+    virtual bool sendInline(void *buf, size_t len, int dest, int tag,
+                            int ctx) {
+        return false;
+    }
+
     // is the send done?
     virtual bool sendDone(SendDesc_t *message, double timeNow, int *errorCode) {
 	    unsigned int nAcked;
@@ -257,6 +266,7 @@ public:
         * if ENABLE_RELIABILITY is defined -- since it is recorded and ACK'ed...
         */
         int     globalDestProc;
+        ReliabilityInfo::peer_t *peer;
         
         if ( !doAck() ) {
             if ((frag->parentSendDesc_m->sendType != ULM_SEND_SYNCHRONOUS) ||
@@ -268,11 +278,12 @@ public:
         
         // thread-safe allocation of frag sequence number in header
         globalDestProc = frag->globalDestProc();
+        peer = reliabilityInfo->peer(globalDestProc);
         if (usethreads())
-            reliabilityInfo->next_frag_seqsLock[globalDestProc].lock();
-        frag->setFragSequence(reliabilityInfo->next_frag_seqs[globalDestProc]++);
+            peer->next_frag_seqLock.lock();
+        frag->setFragSequence(peer->next_frag_seq++);
         if (usethreads())
-            reliabilityInfo->next_frag_seqsLock[globalDestProc].unlock();
+            peer->next_frag_seqLock.unlock();
     }
     
     
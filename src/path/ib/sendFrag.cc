@@ -256,11 +256,12 @@ inline bool ibSendFragDesc::ud_init(void)
     frag_seq_m = 0;
 
     if (need_frag_seq) { 
+        ReliabilityInfo::peer_t *peer = reliabilityInfo->peer(globalDestID_m);
         if (usethreads())
-            reliabilityInfo->next_frag_seqsLock[globalDestID_m].lock();
-        frag_seq_m = (reliabilityInfo->next_frag_seqs[globalDestID_m])++;
+            peer->next_frag_seqLock.lock();
+        frag_seq_m = peer->next_frag_seq++;
         if (usethreads())
-            reliabilityInfo->next_frag_seqsLock[globalDestID_m].unlock();
+            peer->next_frag_seqLock.unlock();
     }
 #else
     frag_seq_m = 0;
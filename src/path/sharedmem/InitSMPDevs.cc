@@ -36,10 +36,12 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 #include <new>
 
 #include "queue/globals.h"
 #include "client/daemon.h"
+#include "init/environ.h"
 #include "util/Utility.h"
 #include "util/cbQueue.h"
 #include "internal/constants.h"
@@ -84,12 +86,19 @@ FreeListShared_t<SMPSecondFragDesc_t> SMPFragPool;
 // first frags for which the payload buffers are not yet ready
 ProcessPrivateMemDblLinkList firstFrags;
 
+// inline sends - largest message, headers awaiting ack, and free headers
+int SMPInlineSendMax = -1;
+ProcessPrivateMemDblLinkList SMPInlineSends;
+ProcessPrivateMemDblLinkList SMPInlineSendCache;
+
 // frag list for on-host messages
 // fifo matching queue
 cbQueue < SMPFragDesc_t *, MMAP_SHARED_FLAGS, MMAP_SHARED_FLAGS >
     ***SharedMemIncomingFrags;
 SharedMemDblLinkList **SMPSendsToPost;
 SharedMemDblLinkList **SMPMatchedFrags;
+SMPDoorbell_t **SMPDoorbells;
+volatile int **SMPEagerBytes;
 //  list of on host posted sends that have not yet completed sending
 //  all frags
 //    sorted based on source process
@@ -263,6 +272,46 @@ void SetUpSharedMemoryQueues(int nLocalProcs)
 
         }                       // end of destProc loop
     }                           // end of srcProc loop
+
+    //
+    // doorbells for the incoming frag queues, one per receiver
+    //
+    SMPDoorbells = (SMPDoorbell_t **)
+        ulm_malloc(nLocalProcs * sizeof(SMPDoorbell_t *));
+    if (!SMPDoorbells) {
+        ulm_exit(("Error: Out of memory\n"));
+    }
+    for (int destProc = 0; destProc < nLocalProcs; destProc++) {
+        size_t size = sizeof(SMPDoorbell_t) + (nLocalProcs - 1) * sizeof(int);
+
+        SMPDoorbells[destProc] = (SMPDoorbell_t *)
+            PerProcSharedMemoryPools.getMemorySegment(size, CACHE_ALIGNMENT,
+                                                      destProc);
+        if (!SMPDoorbells[destProc]) {
+            ulm_exit(("Error: Out of memory\n"));
+        }
+        memset((void *) SMPDoorbells[destProc], 0, size);
+    }
+
+    //
+    // eager byte counters, one block per receiver
+    //
+    SMPEagerBytes = (volatile int **)
+        ulm_malloc(nLocalProcs * sizeof(int *));
+    if (!SMPEagerBytes) {
+        ulm_exit(("Error: Out of memory\n"));
+    }
+    for (int destProc = 0; destProc < nLocalProcs; destProc++) {
+        size_t size = (nLocalProcs + 1) * sizeof(int);
+
+        SMPEagerBytes[destProc] = (volatile int *)
+            PerProcSharedMemoryPools.getMemorySegment(size, CACHE_ALIGNMENT,
+                                                      destProc);
+        if (!SMPEagerBytes[destProc]) {
+            ulm_exit(("Error: Out of memory\n"));
+        }
+        memset((void *) SMPEagerBytes[destProc], 0, size);
+    }
     //
     // Sorted list of unprocessed frags for pt2pt - resides in shared memory
     //
@@ -288,4 +337,12 @@ void SetUpSharedMemoryQueues(int nLocalProcs)
     //   has not yet been read
     //   !!!! threaded lock
     firstFrags.Lock.init();
+
+    // small sends are copied straight into a first frag, unless
+    // LAMPI_INLINE_SEND is -1
+    lampi_environ_find_integer("LAMPI_INLINE_SEND", &SMPInlineSendMax);
+    if (SMPInlineSendMax > SMPFirstFragPayload) {
+        SMPInlineSendMax = SMPFirstFragPayload;
+    }
+    SMPInlineSends.Lock.init();
 }
@@ -70,7 +70,7 @@ RecvDesc_t *Communicator::checkSMPRecvListForMatch
         privateQueues.PostedWildRecv.Lock.lock();
     }
 
-    if (privateQueues.PostedSpecificRecv[SourceProcess]->size() == 0) {
+    if (peerState(SourceProcess)->PostedSpecificRecv.size() == 0) {
         //
         // There are only wild irecvs, so specialize the algorithm.
         //
@@ -151,11 +151,9 @@ RecvDesc_t *Communicator::checkSMPSpecificRecvListForMatch
     int SourceProcess = incomingFrag->srcProcID_m;
     for (RecvDesc_t *
          SpecificDesc =
-         (RecvDesc_t *) privateQueues.
-         PostedSpecificRecv[SourceProcess]->begin();
+         (RecvDesc_t *) peerState(SourceProcess)->PostedSpecificRecv.begin();
          SpecificDesc !=
-         (RecvDesc_t *) privateQueues.
-         PostedSpecificRecv[SourceProcess]->end();
+         (RecvDesc_t *) peerState(SourceProcess)->PostedSpecificRecv.end();
          SpecificDesc = (RecvDesc_t *) SpecificDesc->next) {
         //
         // If we have a match...
@@ -167,8 +165,8 @@ RecvDesc_t *Communicator::checkSMPSpecificRecvListForMatch
                 continue;
             }
             // remove link - assumed upper layer handles locking
-            privateQueues.PostedSpecificRecv[SourceProcess]->
-                RemoveLinkNoLock(SpecificDesc);
+            peerState(SourceProcess)->
+                PostedSpecificRecv.RemoveLinkNoLock(SpecificDesc);
 	    SpecificDesc->WhichQueue=ONNOLIST;
             return SpecificDesc;
         }
@@ -194,8 +192,7 @@ RecvDesc_t *Communicator::checkSMPSpecificAndWildRecvListForMatch
 
     int SrcProc = incomingFrag->srcProcID_m;
     RecvDesc_t *SpecificDesc =
-        (RecvDesc_t *) privateQueues.PostedSpecificRecv[SrcProc]->
-        begin();
+        (RecvDesc_t *) peerState(SrcProc)->PostedSpecificRecv.begin();
     RecvDesc_t *WildRecvDesc =
         (RecvDesc_t *) privateQueues.PostedWildRecv.begin();
     unsigned long SpecificSeq = SpecificDesc->irecvSeq_m;
@@ -262,8 +259,8 @@ RecvDesc_t *Communicator::checkSMPSpecificAndWildRecvListForMatch
                 if (!(SpecificRecvTag == ULM_ANY_TAG && SendUserTag < 0)) {
                     // remove descriptor from list - upper layer handle locking
                     SpecificDesc->WhichQueue = ONNOLIST;
-                    privateQueues.PostedSpecificRecv[SrcProc]->
-                        RemoveLinkNoLock(SpecificDesc);
+                    peerState(SrcProc)->
+                        PostedSpecificRecv.RemoveLinkNoLock(SpecificDesc);
                     *queueMatched = Communicator::SPECIFIC_RECV_QUEUE;
 
                     return SpecificDesc;
@@ -279,7 +276,7 @@ RecvDesc_t *Communicator::checkSMPSpecificAndWildRecvListForMatch
             // rest of the wild ones.
             //
             if (SpecificDesc ==
-                privateQueues.PostedSpecificRecv[SrcProc]->end()) {
+                peerState(SrcProc)->PostedSpecificRecv.end()) {
 
                 ReturnValue = checkSMPWildRecvListForMatch(incomingFrag);
                 *queueMatched = Communicator::WILD_RECV_QUEUE;
@@ -48,6 +48,9 @@
 void * allocPayloadBuffer(SMPSharedMem_logical_dev_t *dev,
                           unsigned long length, int *errorCode, int memPoolIndex);
 
+// get a send header, with its first frag, from SMPSendDescs
+sharedMemData_t *allocSMPSendHeader(int *errorCode);
+
 // upper limit on number of pages per forked proc used for on-SMP
 //   messaging
 extern int NSMPSharedMemPagesPerProc;
@@ -79,9 +82,36 @@ extern FreeListShared_t <SMPSecondFragDesc_t> SMPFragPool;
 //! first frags for which the payload buffers are not yet ready
 extern ProcessPrivateMemDblLinkList firstFrags;
 
+//! largest message sent inline, without a send descriptor
+extern int SMPInlineSendMax;
+
+//! send headers of inline sends, awaiting the receiver's ack and free
+extern ProcessPrivateMemDblLinkList SMPInlineSends;
+extern ProcessPrivateMemDblLinkList SMPInlineSendCache;
+
 extern cbQueue<SMPFragDesc_t *, MMAP_SHARED_FLAGS, MMAP_SHARED_FLAGS>
  ***SharedMemIncomingFrags;
 extern SharedMemDblLinkList **SMPSendsToPost;
+
+// Doorbells, one per receiving process and resident in its shared
+// memory.  After writing to SharedMemIncomingFrags[src][dst] the
+// sender sets SMPDoorbells[dst]->pending[src] and then ->any, so that
+// an idle receiver reads one word rather than every incoming queue.
+typedef struct {
+    volatile int any;
+    char pad[CACHE_ALIGNMENT - sizeof(int)];
+    volatile int pending[1];    // local_nprocs() entries
+} SMPDoorbell_t;
+
+extern SMPDoorbell_t **SMPDoorbells;
+
+// Eager bytes sent to each receiving process that it has not matched
+// yet, resident in its shared memory: [0] is the total and [1 + src]
+// is from local process src.  Senders reserve bytes here with
+// flowControl.takeEager() or send by rendezvous, and the receiver
+// releases them when it matches the first frag.
+extern volatile int **SMPEagerBytes;
+
 extern SharedMemDblLinkList **SMPMatchedFrags;
 extern ProcessPrivateMemDblLinkList IncompletePostedSMPSends;
 extern ProcessPrivateMemDblLinkList UnackedPostedSMPSends;
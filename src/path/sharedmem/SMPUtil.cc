@@ -32,8 +32,12 @@
 #include "config.h"
 #endif
 
+#include <new>
+
 #include "ulm/ulm.h"
+#include "internal/state.h"
 #include "path/sharedmem/SMPSharedMemGlobals.h"
+#include "path/sharedmem/SMPFragDesc.h"
 #include "os/numa.h"
 
 // allocate payload buffer
@@ -82,3 +86,32 @@ void *allocPayloadBuffer(SMPSharedMem_logical_dev_t *dev,
 
     return payloadBuffer;
 }
+
+// allocate a send header from shared memory, with its first frag and
+// first frag payload laid out behind it
+sharedMemData_t *allocSMPSendHeader(int *errorCode)
+{
+    sharedMemData_t *header;
+    SMPFragDesc_t *firstFrag;
+
+    header = (sharedMemData_t *)
+        SMPSendDescs.getElement(getMemPoolIndex(), *errorCode);
+    if (!header) {
+        return header;
+    }
+
+    /* first frag follows the header - placement new */
+    firstFrag = (SMPFragDesc_t *) ((char *) header + sizeof(sharedMemData_t));
+    new(firstFrag) SMPFragDesc_t(getMemPoolIndex());
+
+    /* payload address will never change */
+    size_t offsetToPayload =
+        (((sizeof(sharedMemData_t) + sizeof(SMPFragDesc_t) -
+           1) / CACHE_ALIGNMENT) + 1) * CACHE_ALIGNMENT;
+    firstFrag->addr_m = (void *) ((char *) header + offsetToPayload);
+
+    // pointer back to the header, so the receiver can ack
+    firstFrag->SendingHeader_m.SMP = header;
+
+    return header;
+}
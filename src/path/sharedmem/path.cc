@@ -37,23 +37,96 @@
 #include "queue/globals.h"
 #include "path/sharedmem/path.h"
 #include "internal/state.h"
+#include "os/atomic.h"
 #include "SMPSharedMemGlobals.h"
 #include "path/common/InitSendDescriptors.h"
 
 static int maxOutstandingSMPFrags = 30;
 
-// initialization function - first frag is posted on the receive side
-bool sharedmemPath::init(SendDesc_t *message)
+// inline sends in flight before falling back to send descriptors
+static int maxInlineSends = 256;
+
+// tell receiver that sender has written to its incoming frag queue;
+// the stores are unconditional and ordered after the queue write, so
+// the receiver's fetch-and-clear cannot lose a ring
+static inline void ringSMPDoorbell(int sender, int receiver)
 {
-    // For all the pages in the send request  - need a minimum of 1 page
-    unsigned int FragCount;
-    if (message->posted_m.length_m <= SMPFirstFragPayload) {
-        FragCount = 1;
+    SMPDoorbell_t *doorbell = SMPDoorbells[receiver];
+
+    mb();
+    doorbell->pending[sender] = 1;
+    mb();
+    doorbell->any = 1;
+}
+
+// post a first frag on the receiver's incoming queue, or behind any
+// frags still waiting for room there, so frags stay in send order
+static void postFirstFrag(SMPFragDesc_t *frag, int receiverID)
+{
+    int senderID = local_myproc();
+
+    if (SMPSendsToPost[senderID]->size() == 0) {
+        int slot;
+        if (usethreads()) {
+            slot = SharedMemIncomingFrags[senderID][receiverID]->
+                writeToHead(&frag);
+            if (slot == CB_ERROR) {
+                SMPSendsToPost[senderID]->Append(frag);
+            } else {
+                ringSMPDoorbell(senderID, receiverID);
+            }
+        } else {
+            mb();
+            slot = SharedMemIncomingFrags[senderID][receiverID]->
+                writeToHeadNoLock(&frag);
+            if (slot == CB_ERROR) {
+                SMPSendsToPost[senderID]->AppendNoLock(frag);
+            } else {
+                ringSMPDoorbell(senderID, receiverID);
+            }
+            mb();
+        }
     } else {
-        FragCount =
-            ((message->posted_m.length_m - SMPFirstFragPayload) + SMPSecondFragPayload - 1) /
-            SMPSecondFragPayload + 1;
+        if (usethreads())
+            SMPSendsToPost[senderID]->Append(frag);
+        else {
+            mb();
+            SMPSendsToPost[senderID]->AppendNoLock(frag);
+            mb();
+        }
     }
+}
+
+// initialization function - first frag is posted on the receive side.
+// If the receiver has as much unmatched eager data as its limits
+// allow, the first frag goes without data (rendezvous) and the rest
+// follows only once the receiver has matched and acked it.
+bool sharedmemPath::init(SendDesc_t *message)
+{
+    // get communicator pointer
+    Communicator *commPtr = (Communicator *) communicators[message->ctx_m];
+
+    // recv process's queue
+    int SortedRecvFragsIndex =
+        commPtr->remoteGroup->mapGroupProcIDToGlobalProcID
+	[message->posted_m.peer_m];
+    SortedRecvFragsIndex = global_to_local_proc(SortedRecvFragsIndex);
+
+    // data carried by the first frag
+    size_t FirstFragLength = message->posted_m.length_m;
+    if (FirstFragLength > SMPFirstFragPayload) {
+        FirstFragLength = SMPFirstFragPayload;
+    }
+    if (FirstFragLength > 0 &&
+        !flowControl.takeEager(SMPEagerBytes[SortedRecvFragsIndex],
+                               local_myproc(), FirstFragLength)) {
+        FirstFragLength = 0;
+    }
+
+    // For all the pages in the send request  - need a minimum of 1 page
+    unsigned int FragCount = 1 +
+        ((message->posted_m.length_m - FirstFragLength) + SMPSecondFragPayload - 1) /
+        SMPSecondFragPayload;
 
     // Allocate irecv descriptors - these will be put directly into the
     //   queues, for processing by the receive side.
@@ -65,18 +138,11 @@ bool sharedmemPath::init(SendDesc_t *message)
     message->NumSent = 0;
     message->pathInfo.sharedmem.sharedData->matchedRecv = 0;
     message->pathInfo.sharedmem.sharedData->NumAcked = 0;
+    message->pathInfo.sharedmem.sharedData->clearToSend_m =
+        (message->sendType != ULM_SEND_SYNCHRONOUS && FirstFragLength > 0);
     message->messageDone = (message->sendType == ULM_SEND_BUFFERED) ? 
 	    REQUEST_COMPLETE : REQUEST_INCOMPLETE;
 
-    // get communicator pointer
-    Communicator *commPtr = (Communicator *) communicators[message->ctx_m];
-
-    // recv process's queue
-    int SortedRecvFragsIndex =
-        commPtr->remoteGroup->mapGroupProcIDToGlobalProcID
-	[message->posted_m.peer_m];
-    SortedRecvFragsIndex = global_to_local_proc(SortedRecvFragsIndex);
-
     // process as much as possible of the first frag
 
     // get first fragement descriptor - when a send is initialized,
@@ -121,38 +187,8 @@ bool sharedmemPath::init(SendDesc_t *message)
         // ZERO LENGTH
         // append to destination list
 
-        int sizeOfSendsToPost = SMPSendsToPost[(local_myproc())]->size();
-        int senderID = local_myproc();
-        int receiverID = SortedRecvFragsIndex;
-        if (sizeOfSendsToPost == 0) {
-            int slot;
-            if (usethreads()) {
-                slot =
-                    SharedMemIncomingFrags[(senderID)][(receiverID)]->
-                    writeToHead(&(message->pathInfo.sharedmem.firstFrag));
-                if (slot == CB_ERROR) {
-                    SMPSendsToPost[(senderID)]->Append((message->pathInfo.sharedmem.firstFrag));
-                }
-            } else {
-                mb();
-                slot =
-                    SharedMemIncomingFrags[(senderID)][(receiverID)]->
-                    writeToHeadNoLock(&(message->pathInfo.sharedmem.firstFrag));
-                if (slot == CB_ERROR) {
-                    SMPSendsToPost[(senderID)]->AppendNoLock((message->pathInfo.sharedmem.firstFrag));
-                }
-                mb();
-            }
-        } else {
-            if (usethreads())
-                SMPSendsToPost[(senderID)]->Append((message->pathInfo.sharedmem.firstFrag));
-            else {
-                mb();
-                SMPSendsToPost[(senderID)]->AppendNoLock((message->pathInfo.sharedmem.firstFrag));
-                mb();
-            }
-        }
-
+        postFirstFrag(message->pathInfo.sharedmem.firstFrag,
+                      SortedRecvFragsIndex);
 
         // check to see if send is done (buffered already "done";
         // synchronous sends are not done until the first frag is acked)
@@ -165,12 +201,7 @@ bool sharedmemPath::init(SendDesc_t *message)
 
     }
     // fill in frag size
-    size_t LeftToSend = message->posted_m.length_m;
-    if (LeftToSend > SMPFirstFragPayload) {
-        message->pathInfo.sharedmem.firstFrag->length_m = SMPFirstFragPayload;
-    } else {
-        message->pathInfo.sharedmem.firstFrag->length_m = LeftToSend;
-    }
+    message->pathInfo.sharedmem.firstFrag->length_m = FirstFragLength;
 
     // set sequential offset
     message->pathInfo.sharedmem.firstFrag->seqOffset_m = 0;
@@ -190,36 +221,8 @@ bool sharedmemPath::init(SendDesc_t *message)
     mb();
 
     // append to destination list
-    int sizeOfSendsToPost = SMPSendsToPost[(local_myproc())]->size();
-    int senderID = local_myproc();
-    int receiverID = SortedRecvFragsIndex;
-    if (sizeOfSendsToPost == 0) {
-        int slot;
-        if (usethreads()) {
-            slot = SharedMemIncomingFrags[(senderID)][(receiverID)]->
-                writeToHead(&(message->pathInfo.sharedmem.firstFrag));
-            if (slot == CB_ERROR) {
-                SMPSendsToPost[(senderID)]->Append((message->pathInfo.sharedmem.firstFrag));
-            }
-        } else {
-            mb();
-            slot = SharedMemIncomingFrags[(senderID)][(receiverID)]->
-                writeToHeadNoLock(&(message->pathInfo.sharedmem.firstFrag));
-            if (slot == CB_ERROR) {
-                SMPSendsToPost[(senderID)]->AppendNoLock((message->pathInfo.sharedmem.firstFrag));
-            }
-            mb();
-        }
-
-    } else {
-        if (usethreads())
-            SMPSendsToPost[(senderID)]->Append((message->pathInfo.sharedmem.firstFrag));
-        else {
-            mb();
-            SMPSendsToPost[(senderID)]->AppendNoLock((message->pathInfo.sharedmem.firstFrag));
-            mb();
-        }
-    }
+    postFirstFrag(message->pathInfo.sharedmem.firstFrag,
+                  SortedRecvFragsIndex);
 
     // update number of descriptors allocated
     message->NumFragDescAllocated = 1;
@@ -252,6 +255,103 @@ bool sharedmemPath::init(SendDesc_t *message)
     return true;
 }
 
+// copy a small message straight into a first frag whose header is not
+// attached to a send descriptor.  Headers are kept on SMPInlineSends
+// until the receiver acks the frag, and are collected for reuse only
+// when the cache runs dry.
+bool sharedmemPath::sendInline(void *buf, size_t len, int dest, int tag,
+                               int ctx)
+{
+    sharedMemData_t *header;
+    SMPFragDesc_t *frag;
+    int errorCode;
+
+    if ((ssize_t) len > SMPInlineSendMax) {
+        return false;
+    }
+
+    // leave the message to a rendezvous send if the receiver has as
+    // much unmatched eager data as its limits allow
+    Communicator *commPtr = (Communicator *) communicators[ctx];
+    int receiverID = global_to_local_proc(commPtr->remoteGroup->
+                                          mapGroupProcIDToGlobalProcID[dest]);
+    if (len > 0 &&
+        !flowControl.takeEager(SMPEagerBytes[receiverID], local_myproc(),
+                               len)) {
+        return false;
+    }
+
+    if (usethreads())
+        SMPInlineSends.Lock.lock();
+
+    header = (sharedMemData_t *) SMPInlineSendCache.GetLastElementNoLock();
+    if (!header) {
+        for (sharedMemData_t *h = (sharedMemData_t *) SMPInlineSends.begin();
+             h != (sharedMemData_t *) SMPInlineSends.end();
+             h = (sharedMemData_t *) h->next) {
+            if (h->NumAcked) {
+                sharedMemData_t *tmp = (sharedMemData_t *)
+                    SMPInlineSends.RemoveLinkNoLock(h);
+                SMPInlineSendCache.AppendNoLock(h);
+                h = tmp;
+            }
+        }
+        header = (sharedMemData_t *)
+            SMPInlineSendCache.GetLastElementNoLock();
+    }
+    if (!header && SMPInlineSends.size() < maxInlineSends) {
+        header = allocSMPSendHeader(&errorCode);
+    }
+
+    if (usethreads())
+        SMPInlineSends.Lock.unlock();
+
+    // out of headers - the send descriptor path will wait or fail, and
+    // takes its own reservation
+    if (!header) {
+        if (len > 0) {
+            flowControl.releaseEager(SMPEagerBytes[receiverID],
+                                     local_myproc(), len);
+        }
+        return false;
+    }
+
+    header->matchedRecv = 0;
+    header->NumAcked = 0;
+
+    frag = (SMPFragDesc_t *) ((char *) header + sizeof(sharedMemData_t));
+    frag->fragIndex_m = 0;
+    frag->tmapIndex_m = 0;
+    frag->srcProcID_m = commPtr->localGroup->ProcID;
+    frag->dstProcID_m = dest;
+    frag->tag_m = tag;
+    frag->ctx_m = ctx;
+    frag->msgLength_m = len;
+    frag->length_m = len;
+    frag->seqOffset_m = 0;
+    frag->flags_m = 0;
+#ifdef _DEBUGQUEUES
+    frag->WhichQueue = SMPFRAGSTOSEND;
+#endif                          // _DEBUGQUEUES
+
+    // the payload is in place before the frag is visible, so the
+    // receiver never has to defer it to firstFrags
+    if (len) {
+        MEMCOPY_FUNC(buf, frag->addr_m, len);
+    }
+    frag->okToReadPayload_m = true;
+
+    if (usethreads())
+        SMPInlineSends.Append(header);
+    else
+        SMPInlineSends.AppendNoLock(header);
+
+    mb();
+    postFirstFrag(frag, receiverID);
+
+    return true;
+}
+
 // continue sending, may be called multiple times per send descriptor
 bool sharedmemPath::send(SendDesc_t *message, bool *incomplete,
 		int *errorCode)
@@ -292,8 +392,13 @@ bool sharedmemPath::send(SendDesc_t *message, bool *incomplete,
         int NumDescToAllocate = message->numfrags - message->NumFragDescAllocated;
         for (int ndesc = 0; ndesc < NumDescToAllocate; ndesc++) {
 
+            // synchronous and rendezvous sends wait for the first
+            // frag to be matched
+            size_t FirstFragLength =
+                message->pathInfo.sharedmem.firstFrag->length_m;
             int waitOnAck =
-                (message->sendType == ULM_SEND_SYNCHRONOUS);
+                (message->sendType == ULM_SEND_SYNCHRONOUS ||
+                 FirstFragLength == 0);
 
             // slow down the send
             if ((maxOutstandingSMPFrags != -1) &&
@@ -348,7 +453,7 @@ bool sharedmemPath::send(SendDesc_t *message, bool *incomplete,
             FragDesc->msgLength_m = message->posted_m.length_m;
 
             // fill in frag size
-            size_t LeftToSend = (message->posted_m.length_m - SMPFirstFragPayload) -
+            size_t LeftToSend = (message->posted_m.length_m - FirstFragLength) -
                 SMPSecondFragPayload * (message->NumFragDescAllocated - 1);
             if (LeftToSend > (size_t) SMPSecondFragPayload) {
                 FragDesc->length_m = SMPSecondFragPayload;
@@ -358,7 +463,7 @@ bool sharedmemPath::send(SendDesc_t *message, bool *incomplete,
 
             // set sequential offset - message->NumFragDescAllocated has not yet been
             //  incremented
-            FragDesc->seqOffset_m = SMPFirstFragPayload +
+            FragDesc->seqOffset_m = FirstFragLength +
                 (message->NumFragDescAllocated - 1) * SMPSecondFragPayload;
 
             // set typemap index if data is non-contiguous
@@ -451,8 +556,20 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
     	Communicator *Comm;
     	SMPFragDesc_t *incomingFrag;
 	sharedmemPath sharedMemoryPathObject;
+    SMPDoorbell_t *doorbell = SMPDoorbells[local_myproc()];
+    int nSenders = 0;
 
-    for (remoteProc = 0; remoteProc < local_nprocs(); remoteProc++) {
+    // only read the queues of senders that have rung the doorbell
+    if (doorbell->any && fetchNset(&doorbell->any, 0)) {
+        nSenders = local_nprocs();
+    }
+
+    for (remoteProc = 0; remoteProc < nSenders; remoteProc++) {
+
+        if (!doorbell->pending[remoteProc] ||
+            !fetchNset(&doorbell->pending[remoteProc], 0)) {
+            continue;
+        }
 
         int foundData = 1;
         while (foundData) {
@@ -487,7 +604,7 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
                 //   communicator triplet (whether frags of posted receives)
                 Comm = communicators[comm];
                 if (usethreads())
-                    Comm->recvLock[sourceRank].lock();
+                    Comm->peerState(sourceRank)->recvLock.lock();
 
                 /* try and make match - if match made, frag removed from the
                  *  list.  The assumption is that the recvLock is protecting the
@@ -513,7 +630,9 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
 			matchedRecv->Lock.unlock();
 			if( *errorCode != ULM_SUCCESS ){
 				if (usethreads())
-					Comm->recvLock[sourceRank].unlock();
+					Comm->peerState(sourceRank)->recvLock.unlock();
+				// queue may not be empty, so ring again
+				ringSMPDoorbell(remoteProc, local_myproc());
 				return false;
 			}
 
@@ -526,12 +645,14 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
                     //   against - need to be safe, so that other threads can
                     //   read the list in probe
 
-                    Comm->privateQueues.OkToMatchSMPFrags[sourceRank]->
-                        AppendNoLock(incomingFrag);
+                    Comm->peerState(sourceRank)->
+                        OkToMatchSMPFrags.AppendNoLock(incomingFrag);
+                    Comm->unexpectedQueued(sourceRank,
+                                           incomingFrag->length_m);
                     // unlock triplet
                 }
                 if (usethreads())
-                    Comm->recvLock[sourceRank].unlock();
+                    Comm->peerState(sourceRank)->recvLock.unlock();
             }                   /* end processing frag */
         }                       /* end foundData */
     }                           /* end remoteProc loop */
@@ -571,8 +692,8 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
             receiver->reslts_m.length_m) {
             Comm = communicators[receiver->ctx_m];
             if (receiver->WhichQueue == MATCHEDIRECV) {
-                Comm->privateQueues.MatchedRecv[receiver->reslts_m.peer_m]->
-                RemoveLink(receiver);
+                Comm->peerState(receiver->reslts_m.peer_m)->
+                    MatchedRecv.RemoveLink(receiver);
             }
             //mark recv request as complete
             assert(receiver->messageDone != REQUEST_COMPLETE);
@@ -637,8 +758,8 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
                         matchedRecv->reslts_m.length_m) {
                         Comm = communicators[matchedRecv->ctx_m];
                         if (matchedRecv->WhichQueue == MATCHEDIRECV) {
-                            Comm->privateQueues.MatchedRecv[matchedRecv->
-				                reslts_m.peer_m]->RemoveLink(matchedRecv);
+                            Comm->peerState(matchedRecv->reslts_m.peer_m)->
+                                MatchedRecv.RemoveLink(matchedRecv);
                         }
                         //mark recv request as complete
                         assert(matchedRecv->messageDone != REQUEST_COMPLETE);
@@ -695,8 +816,8 @@ bool sharedmemPath::receive(double timeNow, int *errorCode,
                         matchedRecv->reslts_m.length_m) {
                         Comm = communicators[matchedRecv->ctx_m];
                         if (matchedRecv->WhichQueue == MATCHEDIRECV) {
-                            Comm->privateQueues.MatchedRecv[matchedRecv->
-				                reslts_m.peer_m]->RemoveLink(matchedRecv);
+                            Comm->peerState(matchedRecv->reslts_m.peer_m)->
+                                MatchedRecv.RemoveLink(matchedRecv);
                         }
                         //mark recv request as complete
                         assert(matchedRecv->messageDone != REQUEST_COMPLETE);
@@ -916,6 +1037,15 @@ int sharedmemPath::processMatch(SMPFragDesc_t * incomingFrag,
 
 	sharedMemData_t *matchedSender = incomingFrag->SendingHeader_m.SMP;
 
+	// the eager data is matched, so release its reservation
+	if (incomingFrag->length_m > 0) {
+		Comm = communicators[incomingFrag->ctx_m];
+		int sender = global_to_local_proc(Comm->remoteGroup->
+				mapGroupProcIDToGlobalProcID[sourceRank]);
+		flowControl.releaseEager(SMPEagerBytes[local_myproc()],
+				sender, incomingFrag->length_m);
+	}
+
 	//  1st fragment
 
 	if (incomingFrag->length_m > 0) {
@@ -943,6 +1073,10 @@ int sharedmemPath::processMatch(SMPFragDesc_t * incomingFrag,
 			else
 		    		firstFrags.AppendNoLock(incomingFrag);
 		}
+	} else if (incomingFrag->msgLength_m > 0) {
+		/* rendezvous - the first frag carries no data, and its
+		 * ack lets the sender go on with the rest */
+		nFragsProcessed = 1;
 	} else {
 		/* zero byte message */
             assert(matchedRecv->messageDone != REQUEST_COMPLETE);
@@ -1010,8 +1144,7 @@ int sharedmemPath::processMatch(SMPFragDesc_t * incomingFrag,
                 Comm = communicators[incomingFrag->ctx_m];
 		matchedRecv->WhichQueue = MATCHEDIRECV;
                 wmb();
-		Comm->privateQueues.MatchedRecv[sourceRank]->
-	    		Append(matchedRecv);
+		Comm->peerState(sourceRank)->MatchedRecv.Append(matchedRecv);
 	}
 
 	// ack fragement
@@ -1068,6 +1201,7 @@ bool sharedmemPath::push(double timeNow, int *errorCode)
             retVal =
                 SharedMemIncomingFrags[local_myproc()]
                 [SortedRecvFragsIndex]->writeToSlot(getSlot, &fragDesc);
+            ringSMPDoorbell(local_myproc(), SortedRecvFragsIndex);
 
             fragDesc = TmpDesc;
         }
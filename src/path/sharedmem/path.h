@@ -64,6 +64,7 @@ class sharedmemPath : public BasePath_t {
     }
 
     bool send(SendDesc_t *message, bool *incomplete, int *errorCode);
+    bool sendInline(void *buf, size_t len, int dest, int tag, int ctx);
     bool receive(double timeNow, int *errorCode, recvType recvTypeArg);
     void ReturnDesc(SendDesc_t *message, int poolIndex=-1);
     bool push(double timeNow, int *errorCode);
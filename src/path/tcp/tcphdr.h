@@ -42,6 +42,7 @@
 
 #define TCP_MSGTYPE_MSG 0
 #define TCP_MSGTYPE_ACK 1
+#define TCP_MSGTYPE_CREDIT 2
 
 
 struct tcp_msg_header
@@ -57,6 +58,18 @@ struct tcp_msg_header
     ulm_int32_t  tag_m;		 //!< tag user gave in send
     ulm_uint32_t fragIndex_m;    //!< frag index
     ulm_uint64_t isendSeq_m;	 //!< sequence number of isend (source proc)
+    ulm_uint64_t credits;	 //!< eager bytes returned to the receiver
+};
+
+
+//----------------------------------------------------------------------------
+// TCP connection handshake, sent by each side of a new connection
+//----------------------------------------------------------------------------
+
+struct tcp_connect_ack
+{
+    ulm_int64_t  proc;		 //!< global ProcID of sending process
+    ulm_uint64_t eager_window;	 //!< eager bytes the sender accepts from the receiver
 };
 
 #endif 
@@ -44,6 +44,7 @@
 #include "path/common/BaseDesc.h"
 #include "path/common/pathContainer.h"
 #include "path/tcp/tcppath.h"
+#include "queue/FlowControl.h"
 #include "util/InetHash.h"
 #include "util/ScopedLock.h"
 
@@ -54,10 +55,15 @@ Locks    TCPPath::_lock;
 const size_t TCPPath::DefaultFragmentSize = 128 * 1024;
 const size_t TCPPath::DefaultEagerSendSize = 64 * 1024;
 const int    TCPPath::DefaultConnectRetries = 2;
+const int    TCPPath::DefaultConnectionsPerInterface = 1;
+const int    TCPPath::MaxDatatypeVecs = 64;
 
 size_t  TCPPath::MaxFragmentSize = 0;
 size_t  TCPPath::MaxEagerSendSize = 0;
+size_t  TCPPath::EagerSendSize = 0;
 int     TCPPath::MaxConnectRetries = 0;
+int     TCPPath::ConnectionsPerInterface = 0;
+size_t  TCPPath::SocketBufferSize = 0;
 
 TCPPath::TCPPath(int handle) :
     thisHost(myhost()),
@@ -117,6 +123,18 @@ int TCPPath::initSetupParams(adminMessage *admin)
         ulm_err(("Failed unpacking TCPPath::MaxConnectRetries\n"));
         return ULM_ERROR;
     }
+
+    if (admin->unpack(&ConnectionsPerInterface,
+                      (adminMessage::packType) sizeof(int), 1) != true) {
+        ulm_err(("Failed unpacking TCPPath::ConnectionsPerInterface\n"));
+        return ULM_ERROR;
+    }
+
+    if (admin->unpack(&SocketBufferSize,
+                      (adminMessage::packType) sizeof(size_t), 1) != true) {
+        ulm_err(("Failed unpacking TCPPath::SocketBufferSize\n"));
+        return ULM_ERROR;
+    }
     return ULM_SUCCESS;
 }
 
@@ -158,19 +176,42 @@ int TCPPath::initPostFork()
 int TCPPath::initClient(int ifCount, struct sockaddr_in *peerAddrs)
 {
     // setup configurable parameters
+    if (ConnectionsPerInterface == 0)
+        ConnectionsPerInterface = DefaultConnectionsPerInterface;
+    int numSockets = ifCount * ConnectionsPerInterface;
     if (MaxFragmentSize == 0)
-        MaxFragmentSize = (ifCount > 1) ? DefaultFragmentSize : (1024*1024);
+        MaxFragmentSize = (numSockets > 1) ? DefaultFragmentSize : (1024*1024);
     if (MaxEagerSendSize == 0)
         MaxEagerSendSize = DefaultEagerSendSize;
     if (MaxConnectRetries == 0)
         MaxConnectRetries = DefaultConnectRetries;
 
-    // initialize peer addresses
+    // each off-host peer is granted a window of eager credits, its
+    // share of the off-host part of the unexpected data limit but no
+    // more than the per-sender limit, so that unexpected eager data
+    // from all of them stays within flowControl.remoteLimit; the
+    // window is sent to the peer when connecting, and messages that
+    // do not fit the peer's window use rendezvous
+    size_t window = flowControl.peerLimit;
+    int numPeers = nprocs() - local_nprocs();
+    if (numPeers > 0 && window > flowControl.remoteLimit / numPeers)
+        window = flowControl.remoteLimit / numPeers;
+    EagerSendSize = MaxEagerSendSize;
+    if (EagerSendSize > window)
+        EagerSendSize = window;
+    for(size_t i=0; i<tcpPeers.size(); i++)
+        tcpPeers[i].setEagerWindow(window);
+
+    // initialize peer addresses - ConnectionsPerInterface sockets to
+    // each address, interleaved so that consecutive fragments of a
+    // message go out over different interfaces
     size_t index=0;
     for(size_t i=0; i<tcpPeers.size(); i++) {
-        tcpPeers[i].setNumAddresses(ifCount);
+        tcpPeers[i].setNumAddresses(numSockets);
         for(int n=0; n<ifCount; n++) {
-            tcpPeers[i].setAddress(n, peerAddrs[index++]);
+            for(int c=0; c<ConnectionsPerInterface; c++)
+                tcpPeers[i].setAddress(c * ifCount + n, peerAddrs[index]);
+            index++;
         }
     }
 
@@ -181,6 +222,9 @@ int TCPPath::initClient(int ifCount, struct sockaddr_in *peerAddrs)
         return ULM_ERROR;
     }
 
+    // accepted sockets inherit the buffer sizes of the listen socket
+    setSocketBuffers(tcpListenSocket);
+
     // bind to all addresses and dynamically assigned port
     struct sockaddr_in inaddr;
     inaddr.sin_family = AF_INET;
@@ -259,13 +303,26 @@ bool TCPPath::canReach(int globalDestProcessID)
 }
 
 
+//
+//  Messages up to EagerSendSize go in a single fragment, if the peer
+//  has eager credits left for them. Other messages send an envelope
+//  without data, and the data fragments follow once the receiver has
+//  matched the envelope to a posted receive and acked it, so they
+//  land directly in the user buffer.
+//
+
 bool TCPPath::init(SendDesc_t *message) 
 {
+    size_t length = message->posted_m.length_m;
+
     message->numfrags = 1;
     message->clearToSend_m = true;
-    if (message->posted_m.length_m > MaxEagerSendSize) {
-        size_t remaining = message->posted_m.length_m - MaxEagerSendSize;
-        message->numfrags += (remaining + MaxFragmentSize - 1) / MaxFragmentSize;
+    if (length > 0) {
+        int globalDestProc = communicators[message->ctx_m]->remoteGroup->
+            mapGroupProcIDToGlobalProcID[message->posted_m.peer_m];
+        TCPPeer& tcpPeer = tcpPeers[globalDestProc];
+        if (length > EagerSendSize || tcpPeer.takeEagerCredits(length) == false)
+            message->numfrags += (length + MaxFragmentSize - 1) / MaxFragmentSize;
     }
     return true;
 }
@@ -283,6 +340,34 @@ bool TCPPath::send(SendDesc_t *message, bool *incomplete, int *errorCode)
 }
 
 
+//
+//  Queue a peer to have its eager credits returned in a header of
+//  their own (see TCPPeer::returnEagerCredits). The queue is serviced
+//  from receive(), outside of any locks held by the caller here.
+//
+
+void TCPPath::scheduleCredits(TCPPeer* tcpPeer)
+{
+    ScopedLock guard(creditLock);
+    creditPeers.push_back(tcpPeer);
+}
+
+
+void TCPPath::sendCredits()
+{
+    Vector<TCPPeer*> peers;
+    {
+        ScopedLock guard(creditLock);
+        peers = creditPeers;
+        creditPeers.size(0);
+    }
+    for(size_t i=0; i<peers.size(); i++) {
+        if(peers[i]->sendCredits() == false)
+            scheduleCredits(peers[i]);
+    }
+}
+
+
 //
 //  Defined in BasePath_t - called from ulm_finalize to see if data
 //  is still pending. Note that this is also currently called from 
@@ -316,6 +401,82 @@ void TCPPath::finalize()
     }
 }
 
+//
+//  Size the kernel send/receive buffers, which bound the data in
+//  flight on each connection. Must be called before connect() or
+//  listen() for the receive window to be negotiated accordingly.
+//  A size of zero leaves the kernel defaults (and autotuning) alone.
+//
+
+void TCPPath::setSocketBuffers(int sd)
+{
+    if (SocketBufferSize == 0)
+        return;
+
+    int optval = (int)SocketBufferSize;
+    socklen_t optlen = sizeof(optval);
+    if(setsockopt(sd, SOL_SOCKET, SO_SNDBUF, &optval, optlen) < 0) {
+        ulm_err(("TCPPath::setSocketBuffers(%d): setsockopt(SO_SNDBUF) failed with errno=%d\n", sd, errno));
+    }
+    if(setsockopt(sd, SOL_SOCKET, SO_RCVBUF, &optval, optlen) < 0) {
+        ulm_err(("TCPPath::setSocketBuffers(%d): setsockopt(SO_RCVBUF) failed with errno=%d\n", sd, errno));
+    }
+}
+
+
+//
+//  Describe bytes [offset, offset+length) of the packed form of a
+//  non-contiguous datatype at base as iovecs starting at vecs[first],
+//  so fragments can be gathered by writev() and scattered by readv()
+//  without an intermediate buffer. Returns the total number of iovecs
+//  used, or -1 if more than MaxDatatypeVecs are needed, in which case
+//  packing into a buffer is cheaper.
+//
+
+int TCPPath::datatypeVecs(ULMType_t *datatype, void *base, size_t offset,
+                          size_t length, Vector<ulm_iovec_t>& vecs, int first)
+{
+    ULMTypeMapElt_t *tmap = datatype->type_map;
+    size_t dtype_cnt = offset / datatype->packed_size;
+    ssize_t seq_offset = offset - dtype_cnt * datatype->packed_size;
+    unsigned char *start_addr = (unsigned char*)base + dtype_cnt * datatype->extent;
+
+    int ti = 0;
+    while (ti < datatype->num_pairs - 1 &&
+           tmap[ti].seq_offset + (ssize_t)tmap[ti].size <= seq_offset)
+        ti++;
+
+    int n = first;
+    while (length > 0) {
+        size_t skip = seq_offset - tmap[ti].seq_offset;
+        size_t len = tmap[ti].size - skip;
+        if (len > length)
+            len = length;
+        unsigned char *addr = start_addr + tmap[ti].offset + skip;
+
+        if (n > first && (unsigned char*)vecs[n-1].iov_base + vecs[n-1].iov_len == addr) {
+            vecs[n-1].iov_len += len;
+        } else if (len > 0) {
+            if (n - first >= MaxDatatypeVecs)
+                return -1;
+            if ((int)vecs.size() <= n && vecs.size(n+1) == false)
+                return -1;
+            vecs[n].iov_base = addr;
+            vecs[n].iov_len = len;
+            n++;
+        }
+        length -= len;
+
+        if (++ti == datatype->num_pairs) {
+            ti = 0;
+            start_addr += datatype->extent;
+        }
+        seq_offset = tmap[ti].seq_offset;
+    }
+    return n;
+}
+
+
 //
 //  Accessor Methods
 //
@@ -349,9 +510,9 @@ void TCPPath::recvEventHandler(int sd)
     }
     tcpReactor.removeListener(sd, this, Reactor::NotifyAll);
 
-    // receive the peers global process ID
-    long peerProc = 0;
-    int retval = ::recv(sd, &peerProc, sizeof(peerProc), 0);
+    // receive the peers global process ID and eager window
+    tcp_connect_ack ack;
+    int retval = ::recv(sd, &ack, sizeof(ack), MSG_WAITALL);
 
     // peer could close this connection
     if(retval == 0) {
@@ -359,7 +520,7 @@ void TCPPath::recvEventHandler(int sd)
         return;
     }
 
-    if(retval != sizeof(peerProc)) {
+    if(retval != sizeof(ack)) {
         ulm_err(("TCPPath[%d]::recvEventHandler(%d): recv() failed, retval=%d  errno=%d\n", 
             thisProc, sd, retval, errno));
         close(sd);
@@ -367,6 +528,7 @@ void TCPPath::recvEventHandler(int sd)
     }
 
     // validate the ID
+    long peerProc = ack.proc;
     long numPeers = tcpPeers.size();
     if(peerProc < 0 || peerProc >= numPeers) {
         ulm_err(("TCPPath[%d]::recvEventHandler(sd): invalid peer process ID: %d\n", 
@@ -392,7 +554,7 @@ void TCPPath::recvEventHandler(int sd)
 
     // verify the peer will accept the connection - may already be connected
     TCPPeer& tcpPeer = tcpPeers[peerProc];
-    if(tcpPeer.acceptConnection(sd) == false) {
+    if(tcpPeer.acceptConnection(sd, ack.eager_window) == false) {
         close(sd);
     }
 }
@@ -57,10 +57,15 @@ public:
     static const size_t DefaultFragmentSize;
     static const size_t DefaultEagerSendSize;
     static const int     DefaultConnectRetries;
+    static const int     DefaultConnectionsPerInterface;
+    static const int     MaxDatatypeVecs;
 
     static size_t MaxFragmentSize;
     static size_t MaxEagerSendSize;
+    static size_t EagerSendSize;
     static int    MaxConnectRetries;
+    static int    ConnectionsPerInterface;
+    static size_t SocketBufferSize;
 
     // init methods called once at startup
     static int initSetupParams(adminMessage*);
@@ -71,7 +76,7 @@ public:
 
     // BasePath_t methods
     virtual bool receive(double timeNow, int *errorCode, recvType recvTypeArg = ALL) 
-        { tcpReactor.poll(); return true; }
+        { tcpReactor.poll(); if (creditPeers.size()) sendCredits(); return true; }
     virtual bool canReach(int globalDestProcessID);
     virtual bool init(SendDesc_t *message);
     virtual bool send(SendDesc_t *message, bool *incomplete, int *errorCode);
@@ -104,7 +109,12 @@ public:
     inline void insertListener(int sd, Reactor::Listener* l, int flags) { tcpReactor.insertListener(sd,l,flags); }
     inline void removeListener(int sd, Reactor::Listener* l, int flags) { tcpReactor.removeListener(sd,l,flags); }
 
+    void scheduleCredits(TCPPeer*);
+
     static TCPPath* singleton();
+    static void setSocketBuffers(int sd);
+    static int datatypeVecs(ULMType_t *datatype, void *base, size_t offset,
+                            size_t length, Vector<ulm_iovec_t>& vecs, int first);
 
 private:
     static TCPPath* _singleton;
@@ -117,10 +127,13 @@ private:
     unsigned short tcpListenPort;
     Reactor tcpReactor;
     Vector<TCPPeer> tcpPeers;
+    Vector<TCPPeer*> creditPeers;
+    Locks creditLock;
 
     virtual void recvEventHandler(int);
     virtual void exceptEventHandler(int);
     void acceptConnections();
+    void sendCredits();
 };
 
 #endif
@@ -55,7 +55,12 @@ TCPPeer::TCPPeer() :
     peerHost(0),
     peerProc(0),
     peerPort(0),
-    tcpSocketsConnected(0)
+    tcpSocketsConnected(0),
+    eagerCredits(0),
+    eagerWindow(0),
+    peerWindowKnown(false),
+    creditsToReturn(0),
+    creditsScheduled(false)
 {
     tcpPath = TCPPath::singleton();
     thisHost = tcpPath->getHost();
@@ -119,6 +124,59 @@ void TCPPeer::setPort(unsigned short port)
 }
                                                                                        
 
+//
+//  Eager data from the peer has been consumed. The credits normally
+//  go back in the next message or ack header, but a peer that only
+//  sends would run out of them and fall back to rendezvous, so once
+//  half of the window granted to it is held here the path is asked
+//  to return them in a header of their own.
+//
+
+void TCPPeer::returnEagerCredits(size_t bytes)
+{
+    bool schedule;
+    {
+        ScopedLock guard(lock);
+        creditsToReturn += bytes;
+        schedule = (creditsScheduled == false && creditsToReturn >= eagerWindow / 2);
+        if (schedule)
+            creditsScheduled = true;
+    }
+    if (schedule)
+        tcpPath->scheduleCredits(this);
+}
+
+
+//
+//  Called by TCPPath::receive to send the credits scheduled above, if
+//  they have not gone back in another header since. Returns false if
+//  no descriptor or socket was available, leaving them scheduled.
+//
+
+bool TCPPeer::sendCredits()
+{
+    int retval;
+    TCPRecvFrag *recvFrag = TCPRecvFrag::getElement(retval);
+    if(retval != ULM_SUCCESS || recvFrag == 0)
+        return false;
+    recvFrag->init(this);
+
+    size_t credits = collectEagerCredits();
+    if(credits == 0) {
+        recvFrag->ReturnDescToPool(getMemPoolIndex());
+        return true;
+    }
+    if(recvFrag->sendCredits(credits) == false) {
+        recvFrag->ReturnDescToPool(getMemPoolIndex());
+        ScopedLock guard(lock);
+        creditsToReturn += credits;
+        creditsScheduled = true;
+        return false;
+    }
+    return true;
+}
+
+
 //
 //  Called by ulm_finalize to check for data that needs to
 //  be delivered.
@@ -155,13 +213,14 @@ void TCPPeer::finalize()
 
 //
 //  A peer has connected and sent us a procID, which corresponds
-//  to this peer instance. So, if we are not connected, accept the
-//  connection request. If a connection is already in progress, 
-//  accept the connection if the peers procID is lower than our own,
-//  otherwise reject the connection request.
+//  to this peer instance, and the eager window it grants us. So, if
+//  we are not connected, accept the connection request. If a
+//  connection is already in progress, accept the connection if the
+//  peers procID is lower than our own, otherwise reject the
+//  connection request.
 //
 
-bool TCPPeer::acceptConnection(int sd)
+bool TCPPeer::acceptConnection(int sd, size_t peerWindow)
 {
     struct sockaddr_in addr;
     socklen_t addrlen = sizeof(struct sockaddr_in);
@@ -174,6 +233,7 @@ bool TCPPeer::acceptConnection(int sd)
             if (tcpSocket.sd < 0) {
                 tcpSocket.sd = sd;
                 if(sendConnectAck(tcpSocket)) { 
+                    setPeerWindow(peerWindow);
                     tcpSocket.retries = 0;
                     tcpSocket.state = S_CONNECTED;
                     setSocketOptions(tcpSocket.sd);
@@ -188,6 +248,7 @@ bool TCPPeer::acceptConnection(int sd)
                 tcpSocket.close();
                 tcpSocket.sd = sd;
                 if(sendConnectAck(tcpSocket)) {
+                    setPeerWindow(peerWindow);
                     tcpSocket.retries = 0;
                     tcpSocket.state = S_CONNECTED;
                     setSocketOptions(tcpSocket.sd);
@@ -348,6 +409,7 @@ bool TCPPeer::startConnect(int *errorCode)
             *errorCode = ULM_ERR_TEMP_OUT_OF_RESOURCE;
             return false;
         }
+        TCPPath::setSocketBuffers(tcpSocket.sd);
 
         // set the socket to non-blocking
         int flags;
@@ -429,10 +491,13 @@ void TCPPeer::completeConnect(TCPSocket& tcpSocket)
 
 bool TCPPeer::sendConnectAck(TCPSocket& tcpSocket)
 {
-    // send process rank to remote peer
-    unsigned char* ptr = (unsigned char*)&thisProc;
+    // send process rank and eager window to remote peer
+    tcp_connect_ack ack;
+    ack.proc = thisProc;
+    ack.eager_window = eagerWindow;
+    unsigned char* ptr = (unsigned char*)&ack;
     int cnt = 0;
-    int len = sizeof(thisProc);
+    int len = sizeof(ack);
     while(cnt < len) {
         int retval = ::send(tcpSocket.sd, ptr+cnt, len-cnt, 0);
         if(retval < 0) {
@@ -478,8 +543,10 @@ void TCPPeer::recvEventHandler(int sd)
                 if(recvFrag == 0) {
                     int retval;
                     recvFrag = TCPRecvFrag::getElement(retval);
-                    if(retval != ULM_SUCCESS || recvFrag == 0)
+                    if(retval != ULM_SUCCESS || recvFrag == 0) {
+                        tcpSocket.lock.unlock();
                         return;
+                    }
                     recvFrag->init(this);
                 }
                 tcpSocket.recvFrag = recvFrag;
@@ -501,17 +568,17 @@ void TCPPeer::recvEventHandler(int sd)
 }
 
 //
-//  Receive the peers procID/rank and dispatch the connection
-//  request to the appropriate TCPPeer instance.
+//  Receive the peers procID/rank and eager window and complete the
+//  connection.
 //
 
 void TCPPeer::recvConnectAck(TCPSocket& tcpSocket)
 {
-    // recv process rank from remote peer
-    long peer = 0;
-    unsigned char* ptr = (unsigned char*)&peer;
+    // recv process rank and eager window from remote peer
+    tcp_connect_ack ack;
+    unsigned char* ptr = (unsigned char*)&ack;
     int cnt = 0;
-    int len = sizeof(peer);
+    int len = sizeof(ack);
     while(cnt < len) {
         int retval = ::recv(tcpSocket.sd, ptr+cnt, len-cnt, 0);
 
@@ -538,13 +605,14 @@ void TCPPeer::recvConnectAck(TCPSocket& tcpSocket)
     }
 
     // validate ack received from excpected peer
-    if(peer != peerProc) {
+    if(ack.proc != peerProc) {
         ulm_err(("TCPPeer[%d,%d]::recvConnectAck(sd): invalid peer: %d\n", 
-            thisProc, peerProc, tcpSocket.sd, peer));
+            thisProc, peerProc, tcpSocket.sd, (long)ack.proc));
         tcpPath->removeListener(tcpSocket.sd, this, Reactor::NotifyAll);
         tcpSocket.close();
         return;
     }
+    setPeerWindow(ack.eager_window);
     tcpSocket.retries = 0;
     tcpSocket.state = S_CONNECTED;
     setSocketOptions(tcpSocket.sd);
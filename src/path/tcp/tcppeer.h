@@ -66,6 +66,9 @@ class TCPRecvFrag;
 //   Otherwise, Proc1 will close the incoming connection and wait for
 //   the connection it started to complete.
 //
+//   Each procID goes with the eager window granted to the other side
+//   (see tcp_connect_ack).
+//
 //   Once connected, dispatches sends/recvs to appropriate
 //   sockets/descriptors.
 //
@@ -86,7 +89,7 @@ public:
     void setAddress(int index, const struct sockaddr_in&);
     void setPort(unsigned short);
 
-    bool acceptConnection(int sd);
+    bool acceptConnection(int sd, size_t peerWindow);
     bool canReach();
     bool send(SendDesc_t* message, bool* incomplete, int *errorCode);
     void sendStart(SendDesc_t* message);
@@ -101,6 +104,55 @@ public:
     bool needsPush();
     void finalize();
 
+    //
+    //  Eager credits: bytes this process may send eagerly to the
+    //  peer, and bytes of eager data received from the peer that
+    //  have been consumed and are to be returned to it in the next
+    //  message or ack header. If half the window granted to the peer
+    //  accumulates before then, they are returned in a header of
+    //  their own.
+    //
+    //  Each side grants the other its window in the connect
+    //  handshake, so no credits are available until the first
+    //  connection to the peer is up.
+    //
+
+    inline void setEagerWindow(size_t window) {
+        eagerWindow = window;
+    }
+
+    inline void setPeerWindow(size_t window) {
+        ScopedLock guard(lock);
+        if (peerWindowKnown)
+            return;
+        peerWindowKnown = true;
+        eagerCredits += window;
+    }
+
+    inline bool takeEagerCredits(size_t bytes) {
+        ScopedLock guard(lock);
+        if (eagerCredits < bytes)
+            return false;
+        eagerCredits -= bytes;
+        return true;
+    }
+
+    inline void addEagerCredits(size_t bytes) {
+        ScopedLock guard(lock);
+        eagerCredits += bytes;
+    }
+
+    void returnEagerCredits(size_t bytes);
+    bool sendCredits();
+
+    inline size_t collectEagerCredits() {
+        ScopedLock guard(lock);
+        size_t credits = creditsToReturn;
+        creditsToReturn = 0;
+        creditsScheduled = false;
+        return credits;
+    }
+
 private:
     TCPPath *tcpPath;
     ProcessPrivateMemDblLinkList pendingSends;
@@ -110,6 +162,11 @@ private:
     long peerProc;
     unsigned short peerPort;
     size_t tcpSocketsConnected;
+    size_t eagerCredits;
+    size_t eagerWindow;
+    bool peerWindowKnown;
+    size_t creditsToReturn;
+    bool creditsScheduled;
     Locks lock;
 
     enum { S_CLOSED, S_CONNECTING, S_CONNECT_ACK, S_CONNECTED, S_FAILED };
@@ -169,10 +226,10 @@ private:
     inline void decrementSocketCount() {
         if(usethreads()) {
             lock.lock();
-            tcpSocketsConnected++;
+            tcpSocketsConnected--;
             lock.unlock();
         } else
-            tcpSocketsConnected++;
+            tcpSocketsConnected--;
     }
 
     inline int getSocketCount() {
@@ -89,6 +89,8 @@ void TCPRecvFrag::init(TCPPeer* tcpPeer)
     this->fragData = 0;
     this->fragCnt = 0;
     this->fragLen = 0;
+    this->fragVecPtr = 0;
+    this->fragVecCnt = 0;
     this->addr_m = 0;
     this->length_m = 0;
     this->fragAcked = false;
@@ -96,7 +98,8 @@ void TCPRecvFrag::init(TCPPeer* tcpPeer)
 
 
 //
-//  Offset of this fragment w/in entire message.
+//  Offset of this fragment w/in entire message. The first fragment
+//  holds either the whole message or, for rendezvous, no data.
 //
 
 unsigned long TCPRecvFrag::dataOffset() 
@@ -104,16 +107,24 @@ unsigned long TCPRecvFrag::dataOffset()
     if (fragIndex_m == 0) 
         return 0;
     else
-        return TCPPath::MaxEagerSendSize + ((fragIndex_m-1) * TCPPath::MaxFragmentSize);
+        return (fragIndex_m-1) * TCPPath::MaxFragmentSize;
 }
 
 
 //
 //  Return a descriptor to pool, release any resources (e.g. temporary buffers).
+//  The eager data of a single fragment message has been consumed, so its
+//  credits go back to the sender.
 //
 
 void TCPRecvFrag::ReturnDescToPool(int localRank)
 {
+    if (fragHdrCnt >= sizeof(fragHdr) &&
+        fragHdr.type == TCP_MSGTYPE_MSG &&
+        fragHdr.fragIndex_m == 0 &&
+        fragHdr.length > 0 &&
+        fragHdr.length == fragHdr.msg_length)
+        tcpPeer->returnEagerCredits(fragHdr.length);
     tcpPeer = 0;
     if (fragData != 0) {
         ulm_free(fragData);
@@ -218,6 +229,15 @@ bool TCPRecvFrag::recvHeader(int sd)
     if(fragHdrCnt < sizeof(fragHdr))
         return false;
 
+    // eager credits returned by the peer, possibly all the header holds
+    if (fragHdr.credits > 0)
+        tcpPeer->addEagerCredits(fragHdr.credits);
+    if (fragHdr.type == TCP_MSGTYPE_CREDIT) {
+        tcpPeer->recvComplete(this);
+        ReturnDescToPool(getMemPoolIndex());
+        return false;
+    }
+
     // setup this descriptor
     fragLen = fragHdr.length;
     length_m = fragHdr.length;
@@ -244,12 +264,25 @@ bool TCPRecvFrag::recvHeader(int sd)
             fragRequest = (RecvDesc_t*)comm->matchReceivedFrag(this);
         if(fragRequest != 0) {
             ULMType_t *datatype = fragRequest->datatype;
+            size_t offset = dataOffset();
+            size_t appLength = 0;
+            if (offset < fragRequest->posted_m.length_m)
+                appLength = fragRequest->posted_m.length_m - offset;
             if(datatype == 0 || datatype->layout == CONTIGUOUS) {
-                size_t offset = dataOffset();
-                size_t appLength = fragRequest->posted_m.length_m - offset;
                 if (appLength < fragLen)
                      fragLen = appLength;
                 addr_m = ((unsigned char*)fragRequest->addr_m + offset);
+            } else if (fragLen > 0 && appLength > 0) {
+                // scatter directly into the application buffer
+                size_t len = (appLength < fragLen) ? appLength : fragLen;
+                int numVecs = TCPPath::datatypeVecs(datatype, fragRequest->addr_m,
+                    offset, len, fragVecs, 0);
+                if (numVecs > 0) {
+                    fragLen = len;
+                    fragVecPtr = fragVecs.base();
+                    fragVecCnt = numVecs;
+                    addr_m = fragRequest->addr_m;
+                }
             }
             sendAck(); // start an ack now as a match has already been made
         }
@@ -303,7 +336,10 @@ bool TCPRecvFrag::recvData(int sd)
 {
     int cnt = -1;
     while(cnt < 0) {
-        cnt = recv(sd, (unsigned char*)addr_m+fragCnt, fragLen-fragCnt, 0);
+        if (fragVecCnt > 0)
+            cnt = ulm_readv(sd, fragVecPtr, fragVecCnt);
+        else
+            cnt = recv(sd, (unsigned char*)addr_m+fragCnt, fragLen-fragCnt, 0);
         if(cnt == 0) {
             tcpPeer->recvFailed(this);
             ReturnDescToPool(getMemPoolIndex());
@@ -325,6 +361,19 @@ bool TCPRecvFrag::recvData(int sd)
         }
     }
     fragCnt += cnt;
+
+    // advance past the iovecs that have been filled
+    while (fragVecCnt > 0 && cnt > 0) {
+        if (cnt >= (int)fragVecPtr->iov_len) {
+            cnt -= fragVecPtr->iov_len;
+            fragVecPtr++;
+            fragVecCnt--;
+        } else {
+            fragVecPtr->iov_base = ((unsigned char*)fragVecPtr->iov_base) + cnt;
+            fragVecPtr->iov_len -= cnt;
+            cnt = 0;
+        }
+    }
     return (fragCnt >= fragLen);
 }
 
@@ -374,6 +423,10 @@ bool TCPRecvFrag::recvDiscard(int sd)
 
 bool TCPRecvFrag::sendAck()
 {
+    // a credit header has been started by sendCredits
+    if (fragHdr.type == TCP_MSGTYPE_CREDIT)
+        return (fragAckCnt >= sizeof(fragAck));
+
     // send an ack for the first fragment of a multi-fragment message,
     // or if the message type is synchronous
     if ((msgType_m == MSGTYPE_PT2PT) &&
@@ -388,14 +441,48 @@ bool TCPRecvFrag::sendAck()
         fragAck.dst_proc = fragHdr.src_proc;
         fragAck.length = 0;
         fragAck.recv_desc.ptr = fragRequest;
+        fragAck.credits = tcpPeer->collectEagerCredits();
 
-        // attempt to send the ack
+        // attempt to send the ack, keeping the credits for the next
+        // attempt if no socket is free
         fragAcked = tcpPeer->send(this);
+        if (fragAcked == false && fragAck.credits > 0)
+            tcpPeer->returnEagerCredits(fragAck.credits);
     }
     return (fragAckCnt >= sizeof(fragAck));
 }
 
 
+//
+//  Return eager credits to the peer in a header without a message,
+//  using this descriptor as for an ack. Returns false if no socket
+//  is free; otherwise the descriptor is returned to the pool once
+//  the header has been sent.
+//
+
+bool TCPRecvFrag::sendCredits(size_t credits)
+{
+    memset(&fragAck, 0, sizeof(fragAck));
+    fragAck.type = TCP_MSGTYPE_CREDIT;
+    fragAck.src_proc = thisProc;
+    fragAck.dst_proc = peerProc;
+    fragAck.credits = credits;
+    fragHdr = fragAck;
+    fragHdrCnt = sizeof(fragHdr);
+
+    fragAcked = tcpPeer->send(this);
+    if (fragAcked == false)
+        return false;
+    if (sendAck()) {
+        ReturnDescToPool(getMemPoolIndex());
+    } else {
+        WhichQueue = FRAGSTOACK;
+        UnprocessedAcks.Append(this);
+    }
+    return true;
+}
+
+
 //
 //  Continue with non-blocking send() calls until the
 //  entire ack header is delivered.
@@ -34,6 +34,7 @@
 #include "queue/globals.h"
 #include "path/common/BaseDesc.h"
 #include "path/tcp/tcphdr.h"
+#include "util/Vector.h"
 
 
 class TCPRecvFrag : public BaseRecvFragDesc_t, public Reactor::Listener {
@@ -46,6 +47,7 @@ public:
         return TCPRecvFrags.getElement(getMemPoolIndex(), retval); 
     }
     virtual void init(TCPPeer* tcpPeer);
+    bool sendCredits(size_t credits);
 
     // BaseRecvFragDesc_t
     virtual void ReturnDescToPool(int localRank);
@@ -78,6 +80,9 @@ private:
     unsigned char*  fragData;
     size_t          fragCnt;
     size_t          fragLen;
+    Vector<ulm_iovec_t> fragVecs;
+    ulm_iovec_t*    fragVecPtr;
+    int             fragVecCnt;
 
     bool recvHeader(int sd);
     bool recvData(int sd);
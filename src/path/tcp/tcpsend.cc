@@ -98,15 +98,16 @@ int TCPSendFrag::init(TCPPeer *tcpPeer, SendDesc_t *message)
     else
         this->fragMsgType = MSGTYPE_PT2PT;
 
-    // determine offset and fragment length
+    // determine offset and fragment length - the first fragment of a
+    // rendezvous message is an envelope without data
     if(message->NumFragDescAllocated == 0) {
         this->fragMsgOffset = 0;
-        if (message->posted_m.length_m > TCPPath::MaxEagerSendSize)
-            this->fragLength = TCPPath::MaxEagerSendSize;
+        if (message->numfrags > 1)
+            this->fragLength = 0;
         else
             this->fragLength = message->posted_m.length_m;
     } else {
-        this->fragMsgOffset = TCPPath::MaxEagerSendSize + 
+        this->fragMsgOffset = 
             ((message->NumFragDescAllocated-1) * TCPPath::MaxFragmentSize);
         size_t leftToSend = message->posted_m.length_m - this->fragMsgOffset;
         if(leftToSend > TCPPath::MaxFragmentSize)
@@ -150,6 +151,7 @@ int TCPSendFrag::init(TCPPeer *tcpPeer, SendDesc_t *message)
     header.ctxAndMsgType    = GENERATE_CTX_AND_MSGTYPE(message->ctx_m, this->fragMsgType);
     header.fragIndex_m      = this->fragMsgIndex;
     header.isendSeq_m       = message->isendSeq_m;
+    header.credits          = tcpPeer->collectEagerCredits();
 
     this->fragVecs.size(2);
     this->fragVecPtr = this->fragVecs.base();
@@ -157,19 +159,32 @@ int TCPSendFrag::init(TCPPeer *tcpPeer, SendDesc_t *message)
     this->fragVecs[0].iov_len  = sizeof(header);
 
     // setup the data
+    this->fragData = 0;
     if(this->fragLength == 0) {
         this->fragVecCnt = 1;
         header.length = 0;
     } else {
         this->fragVecCnt = 2;
         if(nonContig) {
+            // gather directly from the application buffer if the
+            // fragment maps to a reasonable number of iovecs
+            int numVecs = TCPPath::datatypeVecs(message->datatype, message->addr_m,
+                this->fragMsgOffset, this->fragLength, this->fragVecs, 1);
+            if(numVecs > 0) {
+                this->fragVecPtr = this->fragVecs.base();
+                this->fragVecs[0].iov_base = &header;
+                this->fragVecCnt = numVecs;
+                header.length = this->fragLength;
+                return ULM_SUCCESS;
+            }
+            // datatypeVecs may have grown (and so moved) fragVecs
+            this->fragVecPtr = this->fragVecs.base();
             this->fragData = (unsigned char*)ulm_malloc(this->fragLength);
             if(this->fragData == 0)
                 return ULM_ERR_OUT_OF_RESOURCE;
             packData(message);
         } else {
             // read data directly from application buffers
-            this->fragData = 0;
             this->fragVecs[1].iov_base = ((caddr_t)message->addr_m + this->fragMsgOffset);
             this->fragVecs[1].iov_len = this->fragLength;
         }
@@ -194,8 +209,8 @@ void TCPSendFrag::ReturnDescToPool(int localIndex)
 //
 //  Copied blatantly from UDP code. 
 //
-//  TODO: Investigate using an array of iovecs for non-contiguous
-//  data rather than packing it.
+//  Used for non-contiguous data only when the fragment maps to
+//  too many iovecs to gather it directly (see TCPPath::datatypeVecs).
 //
 
 void TCPSendFrag::packData(SendDesc_t* message)
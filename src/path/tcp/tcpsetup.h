@@ -44,13 +44,17 @@ struct TCPNetworkSetupInfo {
     TCPNetworkSetupInfo() :
         MaxFragmentSize(0),
         MaxEagerSendSize(0),
-        MaxConnectRetries(0)
+        MaxConnectRetries(0),
+        ConnectionsPerInterface(0),
+        SocketBufferSize(0)
         {
         }
 
     size_t  MaxFragmentSize;
     size_t  MaxEagerSendSize;
     int     MaxConnectRetries;
+    int     ConnectionsPerInterface;
+    size_t  SocketBufferSize;
 };
 
 #endif 
@@ -55,13 +55,14 @@ bool Communicator::areQueuesEmpty()
 
     // check this communicator's request reference count and its queues...
     empty = ((requestRefCount + privateQueues.PostedWildRecv.size()) == 0);
-    for (i = 0; i < remoteGroup->groupSize; i++) {
-        empty = empty && (privateQueues.PostedSpecificRecv[i]->size() == 0);
-        empty = empty && (privateQueues.MatchedRecv[i]->size() == 0);
-        empty = empty && (privateQueues.AheadOfSeqRecvFrags[i]->size() == 0);
-        empty = empty && (privateQueues.OkToMatchRecvFrags[i]->size() == 0);
+    for (i = peers.next(0); i < remoteGroup->groupSize;
+         i = peers.next(i + 1)) {
+        empty = empty && (peerState(i)->PostedSpecificRecv.size() == 0);
+        empty = empty && (peerState(i)->MatchedRecv.size() == 0);
+        empty = empty && (peerState(i)->AheadOfSeqRecvFrags.size() == 0);
+        empty = empty && (peerState(i)->OkToMatchRecvFrags.size() == 0);
 #if ENABLE_SHARED_MEMORY
-        empty = empty && (privateQueues.OkToMatchSMPFrags[i]->size() == 0);
+        empty = empty && (peerState(i)->OkToMatchSMPFrags.size() == 0);
 #endif				// SHARED_MEMORY
         if (!empty)
             break;
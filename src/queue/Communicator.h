@@ -41,13 +41,17 @@
 #define SMPSWBARRIER             2
 
 #include "internal/ftoc.h"
+#include "collective/coll_neighbor.h"
+#include "collective/coll_tune.h"
 #include "path/common/BaseDesc.h"
+#include "queue/FlowControl.h"
 #include "queue/Group.h"
 #include "sender_ackinfo.h"
 #include "ulm/ulm.h"
 #include "internal/new.h"
 #include "util/DblLinkList.h"
 #include "util/Lock.h"
+#include "util/PeerTable.h"
 
 #if ENABLE_SHARED_MEMORY
 #include "path/sharedmem/SMPFragDesc.h"
@@ -126,28 +130,40 @@ struct procPrivateQs_t {
     // receive side
     // posted receive messages, wild source process
     ProcessPrivateMemDblLinkList PostedWildRecv;
+};
+
+// per-peer point-to-point state, process private, created the first
+// time a message is sent to, received from or posted for the peer
+struct peerState_t {
+    // next pt-2-pt message sequence number expected on the receive side
+    ULM_64BIT_INT next_expected_isendSeq;
+    Locks next_expected_isendSeqLock;
+
+    // next pt-2-pt message sequence number generated on the send side
+    ULM_64BIT_INT next_isendSeq;
+    Locks next_isendSeqLock;
+
+    // point-to-point receive lock, see Communicator::peerState()
+    Locks recvLock;
 
     // posted receive messages, specified source process
-    // sorted based on source process
-    ProcessPrivateMemDblLinkList **PostedSpecificRecv;
+    ProcessPrivateMemDblLinkList PostedSpecificRecv;
 
     // matched posted receives, source process specified
-    // sorted based on source process
-    ProcessPrivateMemDblLinkList **MatchedRecv;
+    ProcessPrivateMemDblLinkList MatchedRecv;
 
     // received message frags that can't be matched yet
-    // sorted based on source process
-    ProcessPrivateMemDblLinkList **AheadOfSeqRecvFrags;
+    ProcessPrivateMemDblLinkList AheadOfSeqRecvFrags;
 
     // received message frags that may be used to match
     //   posted receives
-    // sorted based on source process
-    ProcessPrivateMemDblLinkList **OkToMatchRecvFrags;
+    ProcessPrivateMemDblLinkList OkToMatchRecvFrags;
 
 #if ENABLE_SHARED_MEMORY
-    ProcessPrivateMemDblLinkList **OkToMatchSMPFrags;
+    ProcessPrivateMemDblLinkList OkToMatchSMPFrags;
 #endif                          // SHARED_MEMORY
 
+    peerState_t() : next_expected_isendSeq(0), next_isendSeq(0) { }
 };
 
 
@@ -209,6 +225,9 @@ struct CollectiveOpt_t {
     size_t reduceOffset;
     size_t minReduceOffset;
     size_t maxReduceExtent;
+
+    // collective algorithm decision table
+    CollTuneTable_t tune;
 };
 
 
@@ -252,10 +271,12 @@ public:
         ulm_alltoallw_t *alltoallw;
         ulm_barrier_t *barrier;
         ulm_bcast_t *bcast;
+        ulm_scan_t *exscan;
         ulm_gather_t *gather;
         ulm_gatherv_t *gatherv;
         ulm_reduce_t *reduce;
         ulm_reduce_scatter_t *reduce_scatter;
+        ulm_reduce_scatter_block_t *reduce_scatter_block;
         ulm_scan_t *scan;
         ulm_scatter_t *scatter;
         ulm_scatterv_t *scatterv;
@@ -264,6 +285,9 @@ public:
     // topology
     ULMTopology_t *topology;
 
+    // neighborhood collective plan, built on first use
+    NbrPlan_t *neighborPlan;
+
     // hardware quadrics context for multicast
     int hw_ctx_stripe;
 
@@ -336,29 +360,35 @@ public:
     // is threaded access expected for this group
     bool useThreads;
 
-    // next pt-2-pt message sequence number expected on the receive
-    // side process private
-    ULM_64BIT_INT *next_expected_isendSeqs;
-    Locks *next_expected_isendSeqsLock;
-
     // posted recv counter - used to keep track internally of
     //  the posted receives
     bigAtomicUnsignedInt next_irecv_id_counter;
     Locks next_irecv_id_counterLock;
 
-    // point-to-point receive lock. To avoid a race conditions between
-    // a receive being posted and an incoming frament being placed on
-    // the privateQueues.OkToMatchRecvFrags list, this lock must be
-    // aquired before posting a receive of processing an incoming
-    // fratment.  Alternatively one could keep checking the posted
-    // receive queues and the privateQueues.OkToMatchRecvFrags queues,
+    // per-peer state, indexed by rank in the remote group.  Each
+    // peer's recvLock avoids a race between a receive being posted
+    // and an incoming frament being placed on its OkToMatchRecvFrags
+    // list: it must be aquired before posting a receive or processing
+    // an incoming fragment.  Alternatively one could keep checking
+    // the posted receive queues and the OkToMatchRecvFrags queues,
     // but this seems more expensive.
-    Locks *recvLock;
+    PeerTable<peerState_t> peers;
 
-    // next pt-2-pt message sequence number generated on the send side
-    //    process private
-    ULM_64BIT_INT *next_isendSeqs;
-    Locks *next_isendSeqsLock;
+    // state for peer proc, created on first use
+    peerState_t *peerState(int proc) { return peers.get(proc); }
+
+    // account for bytes from peer proc added to or removed from the
+    // unexpected frag lists (OkToMatch* and AheadOfSeqRecvFrags)
+    void unexpectedQueued(int proc, size_t bytes)
+        {
+            flowControl.queued(remoteGroup->
+                               mapGroupProcIDToGlobalProcID[proc], bytes);
+        }
+    void unexpectedDequeued(int proc, size_t bytes)
+        {
+            flowControl.dequeued(remoteGroup->
+                                 mapGroupProcIDToGlobalProcID[proc], bytes);
+        }
 
     // see if shared memory queues are actually allocated from shared
     // memory (for COMM_SELF this is not the case)
@@ -451,6 +481,9 @@ public:
             if( localGroup->onHostProcID == 0 ) {
 		for( int ele=0 ; ele <  N_COLLCTL_PER_COMM ; ele++ ) {
                     sharedCollectiveData[ele].flag=0;
+                    for (int p = 0; p < localGroup->onHostGroupSize; p++) {
+                        sharedCollectiveData[ele].controlFlags[p].flag = 0;
+                    }
 		}
             }
             /* don't let anyone move ahead until initialization is done */
@@ -470,8 +503,7 @@ public:
 
     // initialization function - can be used to recycle
     //   an instance of the class
-    //  - initialize next_expected_isendSeqs
-    //  - initialize next_isendSeqs
+    //  - initialize the per-peer state table
     //  - initialize send/recv queues
     //  - set thread usage
     //  - get map of Group to Global ProcID
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "init/environ.h"
+#include "internal/state.h"
+#include "os/atomic.h"
+#include "queue/FlowControl.h"
+
+FlowControl flowControl;
+
+const size_t FlowControl::DefaultPeerLimit = 4 * 1024 * 1024;
+const size_t FlowControl::DefaultLimit = 64 * 1024 * 1024;
+
+
+FlowControl::FlowControl() :
+    peerLimit(DefaultPeerLimit),
+    limit(DefaultLimit),
+    localLimit(DefaultLimit),
+    remoteLimit(0),
+    bytes_m(0),
+    highWater_m(0)
+{
+}
+
+
+void FlowControl::init()
+{
+    int value;
+
+    lock_m.init();
+    peers_m.init(nprocs());
+
+    value = (int) DefaultPeerLimit;
+    lampi_environ_find_integer("LAMPI_UNEXPECTED_PEER_LIMIT", &value);
+    if (value > 0) {
+        peerLimit = (size_t) value;
+    }
+    value = (int) DefaultLimit;
+    lampi_environ_find_integer("LAMPI_UNEXPECTED_LIMIT", &value);
+    if (value > 0) {
+        limit = (size_t) value;
+    }
+    if (peerLimit > limit) {
+        peerLimit = limit;
+    }
+
+    // split the limit between the paths so that together they stay
+    // within it: on-host senders use shared memory, off-host ones TCP
+    size_t localPeers = local_nprocs() - 1;
+    size_t remotePeers = nprocs() - local_nprocs();
+    if (remotePeers == 0) {
+        localLimit = limit;
+        remoteLimit = 0;
+    } else {
+        localLimit = (limit / (localPeers + remotePeers)) * localPeers;
+        remoteLimit = limit - localLimit;
+    }
+}
+
+
+void FlowControl::queued(int proc, size_t bytes)
+{
+    if (bytes == 0) {
+        return;
+    }
+    if (usethreads()) {
+        lock_m.lock();
+    }
+
+    peer_t *peer = peers_m.get(proc);
+    peer->bytes += bytes;
+    if (peer->bytes > peer->highWater) {
+        peer->highWater = peer->bytes;
+    }
+    bytes_m += bytes;
+    if (bytes_m > highWater_m) {
+        highWater_m = bytes_m;
+    }
+
+    if (usethreads()) {
+        lock_m.unlock();
+    }
+}
+
+
+void FlowControl::dequeued(int proc, size_t bytes)
+{
+    if (bytes == 0) {
+        return;
+    }
+    if (usethreads()) {
+        lock_m.lock();
+    }
+
+    peer_t *peer = peers_m.get(proc);
+    peer->bytes -= bytes;
+    bytes_m -= bytes;
+
+    if (usethreads()) {
+        lock_m.unlock();
+    }
+}
+
+
+void FlowControl::counters(int proc, size_t *bytes, size_t *highWater)
+{
+    if (usethreads()) {
+        lock_m.lock();
+    }
+
+    if (proc < 0) {
+        *bytes = bytes_m;
+        *highWater = highWater_m;
+    } else {
+        peer_t *peer = peers_m.find(proc);
+        *bytes = peer ? peer->bytes : 0;
+        *highWater = peer ? peer->highWater : 0;
+    }
+
+    if (usethreads()) {
+        lock_m.unlock();
+    }
+}
+
+
+bool FlowControl::takeEager(volatile int *count, int sender, size_t bytes)
+{
+    // senders may race past the limits by a message each, which is
+    // cheaper than locking the counters
+    if ((size_t) count[0] + bytes > localLimit ||
+        (size_t) count[1 + sender] + bytes > peerLimit) {
+        return false;
+    }
+    fetchNadd(&count[0], (int) bytes);
+    fetchNadd(&count[1 + sender], (int) bytes);
+
+    return true;
+}
+
+
+void FlowControl::releaseEager(volatile int *count, int sender, size_t bytes)
+{
+    fetchNadd(&count[0], -(int) bytes);
+    fetchNadd(&count[1 + sender], -(int) bytes);
+}
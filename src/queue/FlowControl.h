@@ -0,0 +1,110 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef _FLOWCONTROL
+#define _FLOWCONTROL
+
+#include <sys/types.h>
+
+#include "util/Lock.h"
+#include "util/PeerTable.h"
+
+//
+// FlowControl
+//
+// Accounting and limits for unexpected data: fragments held on a
+// communicator's OkToMatchRecvFrags, AheadOfSeqRecvFrags and
+// OkToMatchSMPFrags lists until a matching receive is posted.  Bytes
+// are counted per sending process (global ProcID) and in total, with
+// high-water marks for each.
+//
+// Senders keep their eager data within the limits and use rendezvous
+// when it would not fit.  The total limit is split between on-host
+// and off-host senders in proportion to their numbers: the shared
+// memory path reserves eager bytes against localLimit in counters
+// shared with the receiver, which releases them when it matches the
+// data, and the TCP path grants each off-host peer a window of eager
+// credits, its share of remoteLimit, that the receiver returns as it
+// consumes eager fragments.
+//
+
+class FlowControl {
+public:
+
+    static const size_t DefaultPeerLimit;
+    static const size_t DefaultLimit;
+
+    //! unexpected bytes allowed from one sender, and from all senders
+    size_t peerLimit;
+    size_t limit;
+
+    //! shares of limit for on-host and off-host senders
+    size_t localLimit;
+    size_t remoteLimit;
+
+    FlowControl();
+
+    //! read the limits from the environment and size the peer table
+    void init();
+
+    //! bytes from global process proc added to or removed from the
+    //! unexpected lists
+    void queued(int proc, size_t bytes);
+    void dequeued(int proc, size_t bytes);
+
+    //! unexpected bytes and high-water mark for global process proc,
+    //! or over all senders if proc is -1
+    void counters(int proc, size_t *bytes, size_t *highWater);
+
+    //! reserve bytes of eager data from local process sender in a
+    //! receiver's shared counters, if they stay within the limits;
+    //! count[0] is the total and count[1 + i] is from local process i
+    bool takeEager(volatile int *count, int sender, size_t bytes);
+
+    //! release the reservation once the receiver has matched the data
+    void releaseEager(volatile int *count, int sender, size_t bytes);
+
+private:
+
+    struct peer_t {
+        size_t bytes;
+        size_t highWater;
+        peer_t() : bytes(0), highWater(0) { }
+    };
+
+    PeerTable<peer_t> peers_m;
+    size_t bytes_m;
+    size_t highWater_m;
+    Locks lock_m;
+};
+
+extern FlowControl flowControl;
+
+#endif /* _FLOWCONTROL */
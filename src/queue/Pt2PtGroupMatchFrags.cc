@@ -57,15 +57,14 @@ RecvDesc_t *Communicator::isThisMissingFrag(BaseRecvFragDesc_t *rec)
     int SourceProcess = rec->srcProcID_m;
 
     // lock list for safe (threads) reading
-    privateQueues.MatchedRecv[SourceProcess]->Lock.lock();
+    peerState(SourceProcess)->MatchedRecv.Lock.lock();
 
     for (RecvDesc_t *
              SpecificDesc =
-             (RecvDesc_t *) privateQueues.MatchedRecv[SourceProcess]->
-             begin();
+             (RecvDesc_t *) peerState(SourceProcess)->MatchedRecv.begin();
          SpecificDesc !=
-             (RecvDesc_t *) privateQueues.MatchedRecv[SourceProcess]->
-             end(); SpecificDesc = (RecvDesc_t *) SpecificDesc->next) {
+             (RecvDesc_t *) peerState(SourceProcess)->MatchedRecv.end();
+         SpecificDesc = (RecvDesc_t *) SpecificDesc->next) {
         //
         // The matching irecv has the sequence number and the source
         // proc recorded.
@@ -78,14 +77,14 @@ RecvDesc_t *Communicator::isThisMissingFrag(BaseRecvFragDesc_t *rec)
             //
 
             // unlock list
-            privateQueues.MatchedRecv[SourceProcess]->Lock.unlock();
+            peerState(SourceProcess)->MatchedRecv.Lock.unlock();
 
             return SpecificDesc;
         }
     }
 
     // unlock list
-    privateQueues.MatchedRecv[SourceProcess]->Lock.unlock();
+    peerState(SourceProcess)->MatchedRecv.Lock.unlock();
 
     return ReturnValue;
 }
@@ -113,11 +112,11 @@ void Communicator::SearchForFragsWithSpecifiedISendSeqNum
     // loop over list of frags
     for (BaseRecvFragDesc_t *
              RecDesc =
-             (BaseRecvFragDesc_t *) privateQueues.
-             OkToMatchRecvFrags[SendingProc]->begin();
+             (BaseRecvFragDesc_t *) peerState(SendingProc)->
+                 OkToMatchRecvFrags.begin();
          RecDesc !=
-             (BaseRecvFragDesc_t *) privateQueues.
-             OkToMatchRecvFrags[SendingProc]->end();
+             (BaseRecvFragDesc_t *) peerState(SendingProc)->
+                 OkToMatchRecvFrags.end();
          RecDesc = (BaseRecvFragDesc_t *) RecDesc->next) {
         // sanity check
         assert(RecDesc->WhichQueue == UNMATCHEDFRAGS);
@@ -127,8 +126,9 @@ void Communicator::SearchForFragsWithSpecifiedISendSeqNum
             // remove frag from privateQueues.OkToMatchRecvFrags list
             BaseRecvFragDesc_t *TmpDesc = RecDesc;
             RecDesc = (BaseRecvFragDesc_t *)
-                privateQueues.OkToMatchRecvFrags[SendingProc]->
-                RemoveLinkNoLock(RecDesc);
+                peerState(SendingProc)->
+                    OkToMatchRecvFrags.RemoveLinkNoLock(RecDesc);
+            unexpectedDequeued(SendingProc, TmpDesc->length_m);
             /* process data */
             ProcessMatchedData(MatchedPostedRecvHeader, TmpDesc, timeNow,
                                recvDone);
@@ -154,15 +154,15 @@ void Communicator::SearchForFragsWithSpecifiedTag
 
     // lock list for thread safety
     if(usethreads()) {
-        privateQueues.OkToMatchRecvFrags[SendingProc]->Lock.lock();
+        peerState(SendingProc)->OkToMatchRecvFrags.Lock.lock();
     }
 
     for (BaseRecvFragDesc_t *RecDesc =
-             (BaseRecvFragDesc_t *) privateQueues.
-             OkToMatchRecvFrags[SendingProc]->begin();
+             (BaseRecvFragDesc_t *) peerState(SendingProc)->
+                 OkToMatchRecvFrags.begin();
          RecDesc !=
-             (BaseRecvFragDesc_t *) privateQueues.
-             OkToMatchRecvFrags[SendingProc]->end();
+             (BaseRecvFragDesc_t *) peerState(SendingProc)->
+                 OkToMatchRecvFrags.end();
          RecDesc = (BaseRecvFragDesc_t *) RecDesc->next) {
 
         // sanity check
@@ -172,8 +172,9 @@ void Communicator::SearchForFragsWithSpecifiedTag
             // remove frag from privateQueues.OkToMatchRecvFrags list
             BaseRecvFragDesc_t *TmpDesc = RecDesc;
             RecDesc = (BaseRecvFragDesc_t *)
-                privateQueues.OkToMatchRecvFrags[SendingProc]->
-                RemoveLinkNoLock(RecDesc);
+                peerState(SendingProc)->
+                    OkToMatchRecvFrags.RemoveLinkNoLock(RecDesc);
+            unexpectedDequeued(SendingProc, TmpDesc->length_m);
             // process data
             ProcessMatchedData(MatchedPostedRecvHeader, TmpDesc, timeNow,
                                recvDone);
@@ -185,7 +186,7 @@ void Communicator::SearchForFragsWithSpecifiedTag
 
     // unlock list
     if(usethreads()) {
-        privateQueues.OkToMatchRecvFrags[SendingProc]->Lock.unlock();
+        peerState(SendingProc)->OkToMatchRecvFrags.Lock.unlock();
     }
 
     return;
@@ -212,20 +213,21 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
     BaseRecvFragDesc_t *TmpDesc;
     bool Found = true, recvDone;
 
-    while ((privateQueues.AheadOfSeqRecvFrags[proc]->size() > 0) && Found) {
+    while ((peerState(proc)->AheadOfSeqRecvFrags.size() > 0) && Found) {
 
         Found = false;
 
         // get sequence number to look for
-        unsigned long nextSeqIDToMatch = next_expected_isendSeqs[proc];
+        unsigned long nextSeqIDToMatch = peerState(proc)->
+            next_expected_isendSeq;
 
         for (BaseRecvFragDesc_t *
                  RecvDesc =
-                 (BaseRecvFragDesc_t *) privateQueues.
-                 AheadOfSeqRecvFrags[proc]->begin();
+                 (BaseRecvFragDesc_t *) peerState(proc)->
+                     AheadOfSeqRecvFrags.begin();
              RecvDesc !=
-                 (BaseRecvFragDesc_t *) privateQueues.
-                 AheadOfSeqRecvFrags[proc]->end();
+                 (BaseRecvFragDesc_t *) peerState(proc)->
+                     AheadOfSeqRecvFrags.end();
              RecvDesc = (BaseRecvFragDesc_t *) (RecvDesc->next)) {
             //
             // If the message has the next expected seq from that proc...
@@ -244,11 +246,12 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
                 // Take it out of the ahead of sequence list.
                 //
                 TmpDesc = (BaseRecvFragDesc_t *)
-                    privateQueues.AheadOfSeqRecvFrags[proc]->
-                    RemoveLinkNoLock(RecvDesc);
+                    peerState(proc)->
+                        AheadOfSeqRecvFrags.RemoveLinkNoLock(RecvDesc);
 
                 // process the frag
                 if (MatchedPostedRecvHeader) {
+			unexpectedDequeued(proc, RecvDesc->length_m);
 			request=(RequestDesc_t *)MatchedPostedRecvHeader;
 			ProcessMatchedData(MatchedPostedRecvHeader, RecvDesc,
 			 		timeNow, &recvDone);
@@ -261,8 +264,7 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
 
                     // if match not found, place on privateQueues.OkToMatchRecvFrags list
                     RecvDesc->WhichQueue = UNMATCHEDFRAGS;
-                    privateQueues.OkToMatchRecvFrags[proc]->
-                        AppendNoLock(RecvDesc);
+                    peerState(proc)->OkToMatchRecvFrags.AppendNoLock(RecvDesc);
 
                 }
 
@@ -270,7 +272,7 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
                 RecvDesc = TmpDesc;
 
                 if (recvDone) {
-                    next_expected_isendSeqs[proc] += 1;
+                    peerState(proc)->next_expected_isendSeq += 1;
                     break;
                 }
                 //
@@ -279,18 +281,19 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
                 for (BaseRecvFragDesc_t *
                          RDesc = (BaseRecvFragDesc_t *) RecvDesc->next;
                      RDesc !=
-                         (BaseRecvFragDesc_t *) privateQueues.
-                         AheadOfSeqRecvFrags[proc]->end();
+                         (BaseRecvFragDesc_t *) peerState(proc)->
+                             AheadOfSeqRecvFrags.end();
                      RDesc = (BaseRecvFragDesc_t *) RDesc->next) {
                     if (RDesc->isendSeq_m == nextSeqIDToMatch) {
 
                         // Take it out of the ahead of sequence list.
                         TmpDesc = (BaseRecvFragDesc_t *)
-                            privateQueues.AheadOfSeqRecvFrags[proc]->
-                            RemoveLinkNoLock(RDesc);
+                            peerState(proc)->
+                                AheadOfSeqRecvFrags.RemoveLinkNoLock(RDesc);
 
                         // process the frag
                         if (MatchedPostedRecvHeader) {
+				unexpectedDequeued(proc, RDesc->length_m);
 				request=(RequestDesc_t *)MatchedPostedRecvHeader;
 				ProcessMatchedData(MatchedPostedRecvHeader,
 				 		RDesc, timeNow, &recvDone);
@@ -302,8 +305,8 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
 
                             // if match not found, place on privateQueues.OkToMatchRecvFrags list
                             RDesc->WhichQueue = UNMATCHEDFRAGS;
-                            privateQueues.OkToMatchRecvFrags[proc]->
-                                AppendNoLock(RDesc);
+                            peerState(proc)->
+                                OkToMatchRecvFrags.AppendNoLock(RDesc);
 
                         }
 
@@ -319,7 +322,7 @@ int Communicator::matchFragsInAheadOfSequenceList(int proc,
                 //
                 // We're now expecting the next sequence number.
                 //
-                next_expected_isendSeqs[proc] += 1;
+                peerState(proc)->next_expected_isendSeq += 1;
                 break;
 
             }                   // end of match code block
@@ -359,7 +362,7 @@ RecvDesc_t *Communicator::checkPostedRecvListForMatch
         privateQueues.PostedWildRecv.Lock.lock();
     }
 
-    if (privateQueues.PostedSpecificRecv[SourceProcess]->size() == 0) {
+    if (peerState(SourceProcess)->PostedSpecificRecv.size() == 0) {
         //
         // There are only wild irecvs, so specialize the algorithm.
         //
@@ -429,8 +432,7 @@ checkWildPostedRecvListForMatch(BaseRecvFragDesc_t *rec)
 
             //  add this descriptor to the matched ireceive list
             WildDesc->WhichQueue = MATCHEDIRECV;
-            privateQueues.MatchedRecv[rec->srcProcID_m]->
-                Append(WildDesc);
+            peerState(rec->srcProcID_m)->MatchedRecv.Append(WildDesc);
 
             // exit the loop
             break;
@@ -452,11 +454,10 @@ RecvDesc_t *Communicator::checkSpecificPostedRecvListForMatch(BaseRecvFragDesc_t
     int SourceProcess = rec->srcProcID_m;
     for (RecvDesc_t *
              SpecificDesc =
-             (RecvDesc_t *) privateQueues.
-             PostedSpecificRecv[SourceProcess]->begin();
+             (RecvDesc_t *) peerState(SourceProcess)->
+                 PostedSpecificRecv.begin();
          SpecificDesc !=
-             (RecvDesc_t *) privateQueues.
-             PostedSpecificRecv[SourceProcess]->end();
+             (RecvDesc_t *) peerState(SourceProcess)->PostedSpecificRecv.end();
          SpecificDesc = (RecvDesc_t *) SpecificDesc->next) {
         //
         // If we have a match...
@@ -480,11 +481,11 @@ RecvDesc_t *Communicator::checkSpecificPostedRecvListForMatch(BaseRecvFragDesc_t
             //
             ReturnValue = SpecificDesc;
             // remove descriptor from posted specific ireceive list
-            privateQueues.PostedSpecificRecv[SourceProcess]->
-                RemoveLinkNoLock(SpecificDesc);
+            peerState(SourceProcess)->
+                PostedSpecificRecv.RemoveLinkNoLock(SpecificDesc);
             // append to match ireceive list
             SpecificDesc->WhichQueue = MATCHEDIRECV;
-            privateQueues.MatchedRecv[SourceProcess]->Append(SpecificDesc);
+            peerState(SourceProcess)->MatchedRecv.Append(SpecificDesc);
             return ReturnValue;
         }
     }
@@ -508,8 +509,7 @@ RecvDesc_t *Communicator::checkSpecificAndWildPostedRecvListForMatch
 
     int SrcProc = rec->srcProcID_m;
     RecvDesc_t *SpecificDesc =
-        (RecvDesc_t *) privateQueues.PostedSpecificRecv[SrcProc]->
-        begin();
+        (RecvDesc_t *) peerState(SrcProc)->PostedSpecificRecv.begin();
     RecvDesc_t *WildDesc =
         (RecvDesc_t *) privateQueues.PostedWildRecv.begin();
     unsigned long SpecificSeq = SpecificDesc->irecvSeq_m;
@@ -548,7 +548,7 @@ RecvDesc_t *Communicator::checkSpecificAndWildPostedRecvListForMatch
                     privateQueues.PostedWildRecv.
                         RemoveLinkNoLock(WildDesc);
                     //  add this descriptor to the matched ireceive list
-                    privateQueues.MatchedRecv[SrcProc]->Append(WildDesc);
+                    peerState(SrcProc)->MatchedRecv.Append(WildDesc);
 
                     return ReturnValue;
                 }
@@ -598,11 +598,10 @@ RecvDesc_t *Communicator::checkSpecificAndWildPostedRecvListForMatch
                     ReturnValue = SpecificDesc;
                     SpecificDesc->WhichQueue = MATCHEDIRECV;
                     // remove descriptor from posted specific ireceive list
-                    privateQueues.PostedSpecificRecv[SrcProc]->
-                        RemoveLinkNoLock(SpecificDesc);
+                    peerState(SrcProc)->
+                        PostedSpecificRecv.RemoveLinkNoLock(SpecificDesc);
                     // append to match ireceive list
-                    privateQueues.MatchedRecv[SrcProc]->
-                        Append(SpecificDesc);
+                    peerState(SrcProc)->MatchedRecv.Append(SpecificDesc);
 
                     return ReturnValue;
                 }
@@ -617,8 +616,7 @@ RecvDesc_t *Communicator::checkSpecificAndWildPostedRecvListForMatch
             // rest of the wild ones.
             //
             if (SpecificDesc ==
-                (RecvDesc_t *) privateQueues.
-                PostedSpecificRecv[SrcProc]->end()) {
+                (RecvDesc_t *) peerState(SrcProc)->PostedSpecificRecv.end()) {
 
                 ReturnValue = checkWildPostedRecvListForMatch(rec);
                 return ReturnValue;
@@ -59,20 +59,21 @@ void Communicator::checkFragListsForWildMatch(RecvDesc_t * IRDesc)
     // Loop over all the outstanding messages to find one that matches.
     // There is an outer loop over lists of messages from each
     // processor, then an inner loop over the messages from the
-    // processor.
+    // processor.  Processors we have no state for have sent nothing.
     //
-    for (int ProcWithData = 0; ProcWithData < remoteGroup->groupSize;
-         ProcWithData++) {
+    for (int ProcWithData = peers.next(0);
+         ProcWithData < remoteGroup->groupSize;
+         ProcWithData = peers.next(ProcWithData + 1)) {
 
         // continue if no frags to match
 #if ENABLE_SHARED_MEMORY
-        if ((privateQueues.OkToMatchRecvFrags[ProcWithData]->size() == 0)
-            && (privateQueues.OkToMatchSMPFrags[ProcWithData]->size() ==
+        if ((peerState(ProcWithData)->OkToMatchRecvFrags.size() == 0)
+            && (peerState(ProcWithData)->OkToMatchSMPFrags.size() ==
                 0)) {
             continue;
         }
 #else
-        if (privateQueues.OkToMatchRecvFrags[ProcWithData]->size() == 0)
+        if (peerState(ProcWithData)->OkToMatchRecvFrags.size() == 0)
             continue;
 #endif                          // SHARED_MEMORY
         //
@@ -122,16 +123,16 @@ void Communicator::checkFragListsForSpecificMatch(RecvDesc_t * IRDesc)
     int SourceProc = IRDesc->posted_m.peer_m;
 
 #if ENABLE_SHARED_MEMORY
-    if ((privateQueues.OkToMatchRecvFrags[SourceProc]->size() == 0) &&
-        (privateQueues.OkToMatchSMPFrags[SourceProc]->size() == 0)) {
+    if ((peerState(SourceProc)->OkToMatchRecvFrags.size() == 0) &&
+        (peerState(SourceProc)->OkToMatchSMPFrags.size() == 0)) {
         IRDesc->WhichQueue = POSTEDIRECV;
-        privateQueues.PostedSpecificRecv[SourceProc]->AppendNoLock(IRDesc);
+        peerState(SourceProc)->PostedSpecificRecv.AppendNoLock(IRDesc);
         return;
     }
 #else
-    if (privateQueues.OkToMatchRecvFrags[SourceProc]->size() == 0) {
+    if (peerState(SourceProc)->OkToMatchRecvFrags.size() == 0) {
         IRDesc->WhichQueue = POSTEDIRECV;
-        privateQueues.PostedSpecificRecv[SourceProc]->AppendNoLock(IRDesc);
+        peerState(SourceProc)->PostedSpecificRecv.AppendNoLock(IRDesc);
         return;
     }
 #endif                          // SHARED_MEMORY
@@ -151,7 +152,7 @@ void Communicator::checkFragListsForSpecificMatch(RecvDesc_t * IRDesc)
 #endif                          // SHARED_MEMORY
     // no match found
     IRDesc->WhichQueue = POSTEDIRECV;
-    privateQueues.PostedSpecificRecv[SourceProc]->AppendNoLock(IRDesc);
+    peerState(SourceProc)->PostedSpecificRecv.AppendNoLock(IRDesc);
 
     return;
 }
@@ -176,11 +177,11 @@ bool Communicator::checkSpecifiedFragListsForMatch(RecvDesc_t * IRDesc,
 
     for (BaseRecvFragDesc_t *
          RecDesc =
-         (BaseRecvFragDesc_t *) privateQueues.
-         OkToMatchRecvFrags[ProcWithData]->begin();
+         (BaseRecvFragDesc_t *) peerState(ProcWithData)->
+             OkToMatchRecvFrags.begin();
          RecDesc !=
-         (BaseRecvFragDesc_t *) privateQueues.
-         OkToMatchRecvFrags[ProcWithData]->end();
+         (BaseRecvFragDesc_t *) peerState(ProcWithData)->
+             OkToMatchRecvFrags.end();
          RecDesc = (BaseRecvFragDesc_t *) RecDesc->next) {
         // pull off first frag - we assume that process matching has been
         //   done already
@@ -211,6 +212,7 @@ bool Communicator::checkSpecifiedFragListsForMatch(RecvDesc_t * IRDesc,
             // CopyToApp will return >= 0 if the data is okay, and -1
             // if the data is corrupted -- we don't care since we
             // call AckData in either case...
+            unexpectedDequeued(ProcWithData, RecDesc->length_m);
             IRDesc->CopyToApp(RecDesc);
 
             // remove descriptor from unmatched list - RecDesc now points to
@@ -222,8 +224,8 @@ bool Communicator::checkSpecifiedFragListsForMatch(RecvDesc_t * IRDesc,
             RecDesc->WhichQueue = FRAGSTOACK;
             BaseRecvFragDesc_t *TmpDesc = RecDesc;
             RecDesc = (BaseRecvFragDesc_t *)
-                privateQueues.OkToMatchRecvFrags[ProcWithData]->
-                RemoveLinkNoLock(TmpDesc);
+                peerState(ProcWithData)->
+                    OkToMatchRecvFrags.RemoveLinkNoLock(TmpDesc);
 
             // send ack
             bool acked = TmpDesc->AckData();
@@ -244,8 +246,7 @@ bool Communicator::checkSpecifiedFragListsForMatch(RecvDesc_t * IRDesc,
                 // Record this irecv in the list of matched irecvs.
                 //
                 IRDesc->WhichQueue = MATCHEDIRECV;
-                privateQueues.MatchedRecv[IRDesc->reslts_m.peer_m]->
-                    Append(IRDesc);
+                peerState(IRDesc->reslts_m.peer_m)->MatchedRecv.Append(IRDesc);
             }
 
         } else if (FragFound
@@ -261,6 +262,7 @@ bool Communicator::checkSpecifiedFragListsForMatch(RecvDesc_t * IRDesc,
             // CopyToAppLock will return >= 0 if data is okay, and -1 if it is corrupt;
             // we don't care either way since we call AckData in either case
             recvDone = false;
+            unexpectedDequeued(ProcWithData, RecDesc->length_m);
             IRDesc->CopyToAppLock(RecDesc, &recvDone);
             if (recvDone) {
                 assert(requestDesc->messageDone != REQUEST_COMPLETE);
@@ -276,8 +278,8 @@ bool Communicator::checkSpecifiedFragListsForMatch(RecvDesc_t * IRDesc,
             //  data associated with the match
             BaseRecvFragDesc_t *TmpDesc = RecDesc;
             RecDesc = (BaseRecvFragDesc_t *)
-                privateQueues.OkToMatchRecvFrags[ProcWithData]->
-                RemoveLinkNoLock(RecDesc);
+                peerState(ProcWithData)->
+                    OkToMatchRecvFrags.RemoveLinkNoLock(RecDesc);
 
             // send ack
             if (TmpDesc->AckData()) {
@@ -316,7 +318,7 @@ bool Communicator::matchAgainstSMPFragList(RecvDesc_t * receiver,
     sharedmemPath sharedMemObject;
 
     // return if nothing to get
-    if (privateQueues.OkToMatchSMPFrags[sourceProcess]->size() == 0) {
+    if (peerState(sourceProcess)->OkToMatchSMPFrags.size() == 0) {
         return FragFound;
     }
 
@@ -328,10 +330,9 @@ bool Communicator::matchAgainstSMPFragList(RecvDesc_t * receiver,
     // loop over list of frags - upper level manages thread safety
 
 
-    for (SMPFragDesc_t *frag = (SMPFragDesc_t *)privateQueues.
-         OkToMatchSMPFrags[sourceProcess]->begin();
-         frag != (SMPFragDesc_t *) privateQueues.
-         OkToMatchSMPFrags[sourceProcess]->end();
+    for (SMPFragDesc_t *frag =
+             (SMPFragDesc_t *) peerState(sourceProcess)->OkToMatchSMPFrags.begin();
+         frag != (SMPFragDesc_t *) peerState(sourceProcess)->OkToMatchSMPFrags.end();
         frag = (SMPFragDesc_t *) frag->next) {
 
         // pull off first frag, only 0th frag will be present if
@@ -342,8 +343,8 @@ bool Communicator::matchAgainstSMPFragList(RecvDesc_t * receiver,
             }
 
             // remove frag from list
-            privateQueues.OkToMatchSMPFrags[sourceProcess]->
-                RemoveLinkNoLock(frag);
+            peerState(sourceProcess)->OkToMatchSMPFrags.RemoveLinkNoLock(frag);
+            unexpectedDequeued(sourceProcess, frag->length_m);
 
             FragFound = true;
 		    errorCode=sharedMemObject.processMatch(frag,receiver);
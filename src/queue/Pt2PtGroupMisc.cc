@@ -263,6 +263,7 @@ int Communicator::init(int ctxID, bool threadUsage, int group1Index,
 
     // initialize topology pointer to NULL
     topology = (ULMTopology_t *) NULL;
+    neighborPlan = (NbrPlan_t *) NULL;
 
     // initialize error handler index
     errorHandlerIndex = MPI_ERRHANDLER_DEFAULT;
@@ -313,55 +314,9 @@ int Communicator::init(int ctxID, bool threadUsage, int group1Index,
     /* !!!!! threaded-lock */
     next_irecv_id_counterLock.init();
 
-    // next sequence number expected to arrive on the receive side
-    next_expected_isendSeqs =
-        ulm_new(ULM_64BIT_INT, remoteGroup->groupSize);
-    if (!next_expected_isendSeqs) {
-        ulm_exit(("Error: Communicator::init: "
-                  "Unable to allocate space for next_expected_isendSeqs\n"));
-    }
-    next_expected_isendSeqsLock = ulm_new(Locks, remoteGroup->groupSize);
-    if (!next_expected_isendSeqsLock) {
-        ulm_exit(("Error: Communicator::init: Unable to allocate "
-                  "space for next_expected_isendSeqsLock\n"));
-    }
-    // !!!!! threaded-lock
-    for (int ele = 0; ele < remoteGroup->groupSize; ele++) {
-        next_expected_isendSeqsLock[ele].init();
-    }
-    for (int i = 0; i < remoteGroup->groupSize; ++i)
-        next_expected_isendSeqs[i] = 0;
-
-    // set up receive lock
-    recvLock = ulm_new(Locks, remoteGroup->groupSize);
-    if (!recvLock) {
-        ulm_exit(("Error: Communicator::init: "
-                  "Unable to allocate space for recvLock\n"));
-    }
-    //!!!!! threaded-lock
-    for (int ele = 0; ele < remoteGroup->groupSize; ele++) {
-        recvLock[ele].init();
-    }
-
-    // next sequence number to be assigned for a send
-    next_isendSeqs = ulm_new(ULM_64BIT_INT, remoteGroup->groupSize);
-    if (!next_isendSeqs) {
-        ulm_exit(("Error: Communicator::init: "
-                  "Unable to allocate space for next_isendSeqs\n"));
-    }
-
-    for (int i = 0; i < remoteGroup->groupSize; ++i)
-        next_isendSeqs[i] = 0;
-
-    next_isendSeqsLock = ulm_new(Locks, remoteGroup->groupSize);
-    if (!next_isendSeqsLock) {
-        ulm_exit(("Error: Communicator::init: "
-                  "Unable to allocate space for next_isendSeqsLock\n"));
-    }
-    //!!!!! threaded-lock
-    for (int ele = 0; ele < remoteGroup->groupSize; ele++) {
-        next_isendSeqsLock[ele].init();
-    }
+    // per-peer sequence numbers, locks and queues are created on
+    // first traffic with each peer
+    peers.init(remoteGroup->groupSize);
 
     // initialize queues
     //
@@ -371,96 +326,6 @@ int Communicator::init(int ctxID, bool threadUsage, int group1Index,
     // !!!!! threaded-lock
     privateQueues.PostedWildRecv.Lock.init();
 
-    //
-    // List of posted Specific ireceives - list resides in process private memory
-    //
-    privateQueues.PostedSpecificRecv =
-        ulm_new(ProcessPrivateMemDblLinkList *, remoteGroup->groupSize);
-    for (int proc = 0; proc < remoteGroup->groupSize; proc++) {
-        privateQueues.PostedSpecificRecv[proc] =
-            ulm_new(ProcessPrivateMemDblLinkList, 1);
-        if (!privateQueues.PostedSpecificRecv) {
-            ulm_exit(("Error: Communicator::init: Unable to allocate "
-                      "space for privateQueues.PostedSpecificRecv[proc]\n"));
-        }
-        // initialize locks
-        // !!!!! threaded-lock
-        privateQueues.PostedSpecificRecv[proc]->Lock.init();
-    }                           // end proc loop
-
-    //
-    //  Allocate list of lists for Matched Ireceives
-    //
-    privateQueues.MatchedRecv =
-        ulm_new(ProcessPrivateMemDblLinkList *, remoteGroup->groupSize);
-    for (int proc = 0; proc < remoteGroup->groupSize; proc++) {
-        privateQueues.MatchedRecv[proc] =
-            ulm_new(ProcessPrivateMemDblLinkList, 1);
-        if (!privateQueues.MatchedRecv[proc]) {
-            ulm_exit(("Error: Communicator::init: Unable to allocate"
-                      "space for privateQueues.MatchedRecv[proc]\n"));
-        }
-        // Initialize locks
-        // !!!!! threaded-lock
-        privateQueues.MatchedRecv[proc]->Lock.init();
-    }
-
-    //
-    //  Allocate list of lists for Ahead of Sequeunce frags
-    //
-    privateQueues.AheadOfSeqRecvFrags =
-        ulm_new(ProcessPrivateMemDblLinkList *, remoteGroup->groupSize);
-    for (int proc = 0; proc < remoteGroup->groupSize; proc++) {
-        privateQueues.AheadOfSeqRecvFrags[proc] =
-            ulm_new(ProcessPrivateMemDblLinkList, 1);
-        if (!privateQueues.AheadOfSeqRecvFrags[proc]) {
-            ulm_exit(("Error: Communicator::init: Unable to allocate "
-                      "space for privateQueues.AheadOfSeqRecvFrags[proc]\n"));
-        }
-        // initialize lock
-        // !!!!! threaded-lock
-        privateQueues.AheadOfSeqRecvFrags[proc]->Lock.init();
-    }
-
-    //
-    // List of message frags recieved in sequence, but with no ireceive posted -
-    //   list resides in process private memory
-    //
-    privateQueues.OkToMatchRecvFrags =
-        ulm_new(ProcessPrivateMemDblLinkList *, nprocs());
-    for (int proc = 0; proc < nprocs(); proc++) {
-        privateQueues.OkToMatchRecvFrags[proc] =
-            ulm_new(ProcessPrivateMemDblLinkList, 1);
-        if (!privateQueues.OkToMatchRecvFrags[proc]) {
-            ulm_exit(("Error: Communicator::init: Unable to allocate "
-                      "space for privateQueues.OkToMatchRecvFrags[proc]\n"));
-        }
-        // initialize locks
-        // !!!!! threaded-lock
-        privateQueues.OkToMatchRecvFrags[proc]->Lock.init();
-    }
-#if ENABLE_SHARED_MEMORY
-    //
-    // List of SMP message frags recieved in sequence, but with no ireceive posted -
-    //   list resides in process private memory - only 0th frag of a message
-    //   is appended on this list.
-    //
-    privateQueues.OkToMatchSMPFrags =
-        ulm_new(ProcessPrivateMemDblLinkList *, nprocs());
-    for (int proc = 0; proc < nprocs(); proc++) {
-        privateQueues.OkToMatchSMPFrags[proc] =
-            ulm_new(ProcessPrivateMemDblLinkList, 1);
-        if (!privateQueues.OkToMatchSMPFrags[proc]) {
-            ulm_exit(("Error: Communicator::init: Unable to allocate "
-                      "space for privateQueues.OkToMatchSMPFrags[proc]\n"));
-        }
-        // initialize locks
-        // !!!!! threaded-lock
-        privateQueues.OkToMatchSMPFrags[proc]->Lock.init();
-    }
-
-#endif                          // SHARED_MEMORY
-
     //
     // barrier initialization - host specific code
     //
@@ -501,10 +366,12 @@ int Communicator::init(int ctxID, bool threadUsage, int group1Index,
 #else
     collective.bcast = ulm_bcast;
 #endif
+    collective.exscan = ulm_exscan;
     collective.gather = ulm_gather;
     collective.gatherv = ulm_gatherv;
     collective.reduce = ulm_reduce;
-    collective.reduce_scatter = NULL; /*ulm_reduce_scatter; */
+    collective.reduce_scatter = ulm_reduce_scatter;
+    collective.reduce_scatter_block = ulm_reduce_scatter_block;
     collective.scan = ulm_scan;
     collective.scatter = ulm_scatter;
     collective.scatterv = ulm_scatterv;
@@ -691,43 +558,12 @@ int Communicator::getMcastVpid(int rail, int *vp)
  */
 int Communicator::freeCommunicator()
 {
-    int i;
-
     // reset counters
     // reset receive counter
     setBigAtomicUnsignedInt(&next_irecv_id_counter, 1);
 
-    ulm_delete(next_expected_isendSeqs);
-    ulm_delete(next_expected_isendSeqsLock);
-    ulm_delete(next_isendSeqs);
-    ulm_delete(next_isendSeqsLock);
-    ulm_delete(recvLock);
-
-    // free queues
-    // NOTE:  these are List**, so need to walk the array, calling delete, 
-    // then free everything else
-    for (i = 0; i < remoteGroup->groupSize; i++) {
-        ulm_delete(privateQueues.PostedSpecificRecv[i]);
-        ulm_delete(privateQueues.MatchedRecv[i]);
-        ulm_delete(privateQueues.AheadOfSeqRecvFrags[i]);
-    }
-    ulm_delete(privateQueues.PostedSpecificRecv);
-    ulm_delete(privateQueues.MatchedRecv);
-    ulm_delete(privateQueues.AheadOfSeqRecvFrags);
-
-    // free list of message frags recieved in sequence, but with 
-    // no ireceive posted list resides in process private memory
-    for (i = 0; i < nprocs(); i++) {
-        ulm_delete(privateQueues.OkToMatchRecvFrags[i]);
-    }
-    ulm_delete(privateQueues.OkToMatchRecvFrags);
-
-#if ENABLE_SHARED_MEMORY
-    for (i = 0; i < nprocs(); i++) {
-        ulm_delete(privateQueues.OkToMatchSMPFrags[i]);
-    }
-    ulm_delete(privateQueues.OkToMatchSMPFrags);
-#endif                          // SHARED_MEMORY
+    // free per-peer state and queues
+    peers.clear();
 
     // free barrier resources
     int retVal = barrierFree();
@@ -746,6 +582,9 @@ int Communicator::freeCommunicator()
     // free resources for collective optimization
     freeCollectivesResources();
 
+    ulm_neighbor_plan_free(neighborPlan);
+    neighborPlan = (NbrPlan_t *) NULL;
+
     if (reduceBuffer != NULL)
         ulm_free(reduceBuffer);
     return ULM_SUCCESS;
@@ -787,7 +626,7 @@ void CheckForAckedMessages(double timeNow)
                     SendDesc->messageDone = REQUEST_COMPLETE;
                     if (!SendDesc->persistent) {
                         ulm_type_release(SendDesc->datatype);
-                        ulm_type_release(SendDesc->bsendDatatype);
+                        ulm_type_release(SendDesc->bsendDatatype());
                     }
                 }
 
@@ -800,7 +639,7 @@ void CheckForAckedMessages(double timeNow)
                     SendDesc->WhichQueue = ONNOLIST;
                     if ( SendDesc->persistFreeCalled ) {
                         ulm_type_release(SendDesc->datatype);
-                        ulm_type_release(SendDesc->bsendDatatype);
+                        ulm_type_release(SendDesc->bsendDatatype());
                     }
                     if (usethreads())
                         SendDesc->Lock.unlock();
@@ -1103,8 +942,7 @@ int Communicator::initializeCollectives(int useSharedMemCollOpts)
                      lp < localGroup->
                      groupHostData[localGroup->hostIndexInGroup].
                      nGroupProcIDOnHost; lp++) {
-                    sharedCollectiveData[dN].controlFlags[lp].flag =
-                        READY_TO_READ;
+                    sharedCollectiveData[dN].controlFlags[lp].flag = 0;
                 }
             }
         } else {
@@ -1158,6 +996,9 @@ int Communicator::initializeCollectives(int useSharedMemCollOpts)
             if (!sharedCollectiveData[i].controlFlags) {
                 return ULM_ERR_OUT_OF_RESOURCE;
             }
+            for (int lp = 0; lp < local_nprocs(); lp++) {
+                sharedCollectiveData[i].controlFlags[lp].flag = 0;
+            }
             sharedCollectiveData[i].lock.init();
 
         }
@@ -1274,7 +1115,9 @@ int Communicator::initializeCollectives(int useSharedMemCollOpts)
      * Shared buffer offset used for reduce on this host, and the
      * minimum such offset across all hosts.  Each process uses a
      * segment of the shared memory buffer starting at
-     * reduceOffset * onOnHostProcID.
+     * reduceOffset * onOnHostProcID.  ulm_reduce_intrahost splits
+     * each segment into a header and two slots, so an object must
+     * fit in half a segment.
      *
      * 8-byte aligned
      */
@@ -1285,7 +1128,12 @@ int Communicator::initializeCollectives(int useSharedMemCollOpts)
         (sharedCollectiveData[0].max_length /
          localGroup->maxOnHostGroupSize) & ~7;
     collectiveOpt.maxReduceExtent =
-        collectiveOpt.minReduceOffset - 2 * sizeof(int);
+        ((collectiveOpt.minReduceOffset - 4 * sizeof(int)) / 2) & ~7;
+
+    /* collective algorithm decision table for this communicator */
+    returnValue = ulm_coll_tune_init(&collectiveOpt.tune,
+                                     localGroup->groupSize, numHosts,
+                                     localGroup->maxOnHostGroupSize);
 
     return returnValue;
 }
@@ -1350,4 +1198,6 @@ void Communicator::freeCollectivesResources()
     ulm_free(collectiveOpt.currentRankBytesRead);
     assert(collectiveOpt.dataToSendNow != NULL);
     ulm_free(collectiveOpt.dataToSendNow);
+
+    ulm_coll_tune_free(&collectiveOpt.tune);
 }
@@ -165,7 +165,7 @@ int push_frags_into_network(double timeNow)
                         SendDesc->messageDone = REQUEST_COMPLETE;
                         if (!SendDesc->persistent) {
                             ulm_type_release(SendDesc->datatype);
-                            ulm_type_release(SendDesc->bsendDatatype);
+                            ulm_type_release(SendDesc->bsendDatatype());
                         }
                     }
 
@@ -176,7 +176,7 @@ int push_frags_into_network(double timeNow)
                         SendDesc->WhichQueue = ONNOLIST;
                         if ( SendDesc->persistFreeCalled ) {
                             ulm_type_release(SendDesc->datatype);
-                            ulm_type_release(SendDesc->bsendDatatype);
+                            ulm_type_release(SendDesc->bsendDatatype());
                         }
                         if (usethreads())
                             SendDesc->Lock.unlock();
@@ -101,7 +101,7 @@ int Communicator::irecv_start(ULMRequest_t *request)
         // ULM_ANY_PROC case ***)
         if (usethreads()) {
             for (int i = 0; i < remoteGroup->groupSize; i++) {
-                recvLock[i].lock();
+                peerState(i)->recvLock.lock();
             }
         }
         assert(RecvDesc->messageDone != REQUEST_COMPLETE);
@@ -111,7 +111,7 @@ int Communicator::irecv_start(ULMRequest_t *request)
         // "free" lists
         if (usethreads()) {
             for (int i = 0; i < remoteGroup->groupSize; i++) {
-                recvLock[i].unlock();
+                peerState(i)->recvLock.unlock();
             }
         }
 
@@ -120,7 +120,7 @@ int Communicator::irecv_start(ULMRequest_t *request)
         // lock for thread safety
         if (usethreads()) {
             srcProc = RecvDesc->posted_m.peer_m;
-            recvLock[srcProc].lock();
+            peerState(srcProc)->recvLock.lock();
         }
 
         assert(RecvDesc->messageDone != REQUEST_COMPLETE);
@@ -130,7 +130,7 @@ int Communicator::irecv_start(ULMRequest_t *request)
 
         // "free" lists
         if (usethreads()) {
-            recvLock[srcProc].unlock();
+            peerState(srcProc)->recvLock.unlock();
         }
 
     }
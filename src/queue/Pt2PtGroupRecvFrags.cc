@@ -68,8 +68,9 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	bool sendthisack;
 	bool recorded;
 	unsigned int glfragSrc = remoteGroup->mapGroupProcIDToGlobalProcID[fragSrc];
-	reliabilityInfo->dataSeqsLock[glfragSrc].lock();
-	if (reliabilityInfo->receivedDataSeqs[glfragSrc].recordIfNotRecorded(DataHeader->seq_m, &recorded)) {
+	ReliabilityInfo::peer_t *peer = reliabilityInfo->peer(glfragSrc);
+	peer->dataSeqsLock.lock();
+	if (peer->receivedDataSeqs.recordIfNotRecorded(DataHeader->seq_m, &recorded)) {
 
             ulm_warn(("Process rank %d (%s): Warning: "
                       "Received duplicate fragment [rank %d --> rank %d]: "
@@ -86,13 +87,13 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 
 	    // this is a duplicate from a retransmission...maybe a previous ACK was lost?
 	    // unlock so we can lock while building the ACK...
-	    if (reliabilityInfo->deliveredDataSeqs[glfragSrc].isRecorded(DataHeader->seq_m)) {
+	    if (peer->deliveredDataSeqs.isRecorded(DataHeader->seq_m)) {
 		// send another ACK for this specific frag...
 		DataHeader->isDuplicate_m = DUPLICATE_DELIVERD;
 		DataHeader->DataOK=ACKSTATUS_DATAGOOD;
 		sendthisack = true;
 	    }
-	    else if (reliabilityInfo->receivedDataSeqs[glfragSrc].
+	    else if (peer->receivedDataSeqs.
 		     largestInOrder() >= DataHeader->seq_m) {
 		// send a non-specific ACK that should prevent this frag from being retransmitted...
 		DataHeader->isDuplicate_m = DUPLICATE_RECEIVED;
@@ -101,7 +102,7 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 		sendthisack = false;
 	    }
 
-	    reliabilityInfo->dataSeqsLock[glfragSrc].unlock();
+	    peer->dataSeqsLock.unlock();
 	    // do we send an ACK for this frag?
 	    if (!sendthisack) {
 		// return descriptor to pool
@@ -122,11 +123,11 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	}		// end duplicate frag processing
 	// record the frag_seq number
 	if (!recorded) {
-	    reliabilityInfo->dataSeqsLock[glfragSrc].unlock();
+	    peer->dataSeqsLock.unlock();
 	    ulm_exit(("Error: Unable to record frag sequence "
                       "number(2)\n"));
 	}
-	reliabilityInfo->dataSeqsLock[glfragSrc].unlock();
+	peer->dataSeqsLock.unlock();
 	// continue on...
     }
 #endif
@@ -137,11 +138,11 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
     //!   This also keeps other threads from processing other frags
     //!   for this particluar send/recv process pair.
     if( usethreads() )
-        next_expected_isendSeqsLock[fragSrc].lock();
+        peerState(fragSrc)->next_expected_isendSeqLock.lock();
 
     //! get sequence number of next message that can be processed
     ULM_64BIT_INT nextSeqIDToProcess =
-	next_expected_isendSeqs[fragSrc];
+	peerState(fragSrc)->next_expected_isendSeq;
 
     if (fragSendSeqID == nextSeqIDToProcess) {
 
@@ -153,7 +154,7 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//!   from being posted before this frag is processed
 	//!
         if( usethreads() )
-	    recvLock[fragSrc].lock();
+	    peerState(fragSrc)->recvLock.lock();
 
 	//! see if receive has already been posted
 
@@ -183,27 +184,27 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	    //! if match not found, place on privateQueues.OkToMatchRecvFrags list
 
 	    DataHeader->WhichQueue = UNMATCHEDFRAGS;
-	    privateQueues.OkToMatchRecvFrags[fragSrc]->
-		AppendNoLock(DataHeader);
+	    peerState(fragSrc)->OkToMatchRecvFrags.AppendNoLock(DataHeader);
+	    unexpectedQueued(fragSrc, DataHeader->length_m);
 
 	}
 
 	//
 	// We're now expecting the next sequence number.
 	//
-	++next_expected_isendSeqs[fragSrc];
+	++peerState(fragSrc)->next_expected_isendSeq;
 
 	//!
 	//! Handle old ahead of sequence messages from this proc
 	//! that may have been freed up.
 	//!
-	if (privateQueues.AheadOfSeqRecvFrags[fragSrc]->size() > 0) {
+	if (peerState(fragSrc)->AheadOfSeqRecvFrags.size() > 0) {
 	    matchFragsInAheadOfSequenceList(fragSrc, timeNow);
 	}
 	//! release locks
         if( usethreads() ){
-            recvLock[fragSrc].unlock();
-            next_expected_isendSeqsLock[fragSrc].unlock();
+            peerState(fragSrc)->recvLock.unlock();
+            peerState(fragSrc)->next_expected_isendSeqLock.unlock();
         }
 
 	/* mark message as done, if it has completed - need to mark
@@ -226,7 +227,7 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//!   again for posted message) and this frag being put
 	//!   on the privateQueues.OkToMatchRecvFrags list, if no match is found.
         if( usethreads() )
-	    recvLock[fragSrc].lock();
+	    peerState(fragSrc)->recvLock.lock();
 
 	//!
 	//! This frag comes before the next expected, so it
@@ -245,7 +246,8 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	    //! if match not found, place on privateQueues.OkToMatchRecvFrags list
 	    //!
 	    DataHeader->WhichQueue = UNMATCHEDFRAGS;
-	    privateQueues.OkToMatchRecvFrags[fragSrc]->AppendNoLock(DataHeader);
+	    peerState(fragSrc)->OkToMatchRecvFrags.AppendNoLock(DataHeader);
+	    unexpectedQueued(fragSrc, DataHeader->length_m);
 
 	}
 	//!
@@ -253,10 +255,10 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//!  these frags to be "lost" on the privateQueues.OkToMatchRecvFrags
 	//!  queue.
         if( usethreads() ){
-            next_expected_isendSeqsLock[fragSrc].unlock();
+            peerState(fragSrc)->next_expected_isendSeqLock.unlock();
 
             //! receives can now be posted safely
-            recvLock[fragSrc].unlock();
+            peerState(fragSrc)->recvLock.unlock();
         }
 
 	if (MatchedPostedRecvHeader) {
@@ -276,16 +278,17 @@ int Communicator::handleReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//
 
     if (usethreads()) {
-        recvLock[fragSrc].lock();
+        peerState(fragSrc)->recvLock.lock();
     }
 
 	DataHeader->WhichQueue = AHEADOFSEQUENCEFRAGS;
-	privateQueues.AheadOfSeqRecvFrags[fragSrc]->AppendNoLock(DataHeader);
+	peerState(fragSrc)->AheadOfSeqRecvFrags.AppendNoLock(DataHeader);
+	unexpectedQueued(fragSrc, DataHeader->length_m);
 
 	//! grant other threads access to frags
         if( usethreads() )
-            recvLock[fragSrc].unlock();
-            next_expected_isendSeqsLock[fragSrc].unlock();
+            peerState(fragSrc)->recvLock.unlock();
+            peerState(fragSrc)->next_expected_isendSeqLock.unlock();
     }
 
     return ULM_SUCCESS;
@@ -314,16 +317,17 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	bool sendthisack;
 	bool recorded;
 	unsigned int glfragSrc = remoteGroup->mapGroupProcIDToGlobalProcID[fragSrc];
-	reliabilityInfo->dataSeqsLock[glfragSrc].lock();
-	if (reliabilityInfo->receivedDataSeqs[glfragSrc].recordIfNotRecorded(DataHeader->seq_m, &recorded)) {
+	ReliabilityInfo::peer_t *peer = reliabilityInfo->peer(glfragSrc);
+	peer->dataSeqsLock.lock();
+	if (peer->receivedDataSeqs.recordIfNotRecorded(DataHeader->seq_m, &recorded)) {
 	    // this is a duplicate from a retransmission...maybe a previous ACK was lost?
 	    // unlock so we can lock while building the ACK...
-	    if (reliabilityInfo->deliveredDataSeqs[glfragSrc].isRecorded(DataHeader->seq_m)) {
+	    if (peer->deliveredDataSeqs.isRecorded(DataHeader->seq_m)) {
 		// send another ACK for this specific frag...
 		DataHeader->isDuplicate_m = true;
 		sendthisack = true;
 	    }
-	    else if (reliabilityInfo->receivedDataSeqs[glfragSrc].
+	    else if (peer->receivedDataSeqs.
 		     largestInOrder() >= DataHeader->seq_m) {
 		// send a non-specific ACK that should prevent this frag from being retransmitted...
 		DataHeader->isDuplicate_m = true;
@@ -332,7 +336,7 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 		sendthisack = false;
 	    }
 
-	    reliabilityInfo->dataSeqsLock[glfragSrc].unlock();
+	    peer->dataSeqsLock.unlock();
 	    // do we send an ACK for this frag?
 	    if (!sendthisack) {
 		// return descriptor to pool
@@ -354,11 +358,11 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	}		// end duplicate frag processing
 	// record the frag_seq number
 	if (!recorded) {
-	    reliabilityInfo->dataSeqsLock[glfragSrc].unlock();
+	    peer->dataSeqsLock.unlock();
 	    ulm_exit(("Error: Unable to record frag sequence "
                       "number(2)\n"));
 	}
-	reliabilityInfo->dataSeqsLock[glfragSrc].unlock();
+	peer->dataSeqsLock.unlock();
 	// continue on...
     }
 #endif
@@ -369,11 +373,11 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
     //!   This also keeps other threads from processing other frags
     //!   for this particluar send/recv process pair.
     if( usethreads() )
-        next_expected_isendSeqsLock[fragSrc].lock();
+        peerState(fragSrc)->next_expected_isendSeqLock.lock();
 
     //! get sequence number of next message that can be processed
     ULM_64BIT_INT nextSeqIDToProcess =
-	next_expected_isendSeqs[fragSrc];
+	peerState(fragSrc)->next_expected_isendSeq;
 
     if (fragSendSeqID == nextSeqIDToProcess) {
 
@@ -385,7 +389,7 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//!   from being posted before this frag is processed
 	//!
         if( usethreads() )
-	    recvLock[fragSrc].lock();
+	    peerState(fragSrc)->recvLock.lock();
 
 	//! see if receive has already been posted
 
@@ -398,21 +402,21 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	    //
 	    // We're now expecting the next sequence number.
 	    //
-	    ++next_expected_isendSeqs[fragSrc];
+	    ++peerState(fragSrc)->next_expected_isendSeq;
     
 	    //!
 	    //! Handle old ahead of sequence messages from this proc
 	    //! that may have been freed up.
 	    //!
-	    if (privateQueues.AheadOfSeqRecvFrags[fragSrc]->size() > 0) {
+	    if (peerState(fragSrc)->AheadOfSeqRecvFrags.size() > 0) {
 	        matchFragsInAheadOfSequenceList(fragSrc, timeNow);
 	    }
         }
 
 	//! release locks
         if( usethreads() ){
-            recvLock[fragSrc].unlock();
-            next_expected_isendSeqsLock[fragSrc].unlock();
+            peerState(fragSrc)->recvLock.unlock();
+            peerState(fragSrc)->next_expected_isendSeqLock.unlock();
         }
 
     } else if (fragSendSeqID < nextSeqIDToProcess) {
@@ -424,7 +428,7 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//!   again for posted message) and this frag being put
 	//!   on the privateQueues.OkToMatchRecvFrags list, if no match is found.
         if( usethreads() )
-	    recvLock[fragSrc].lock();
+	    peerState(fragSrc)->recvLock.lock();
 
 	//!
 	//! This frag comes before the next expected, so it
@@ -440,29 +444,21 @@ RecvDesc_t* Communicator::matchReceivedFrag(BaseRecvFragDesc_t *DataHeader,
 	//!  these frags to be "lost" on the privateQueues.OkToMatchRecvFrags
 	//!  queue.
         if( usethreads() ) {
-            next_expected_isendSeqsLock[fragSrc].unlock();
+            peerState(fragSrc)->next_expected_isendSeqLock.unlock();
     
             //! receives can now be posted safely
-            recvLock[fragSrc].unlock();
+            peerState(fragSrc)->recvLock.unlock();
         }
 
     } else {
 	//
 	// This message comes after the next expected, so it
-	// is ahead of sequence.  Save it for later.
+	// is ahead of sequence.  The caller still has to read
+	// its data, and queues it with handleReceivedFrag()
+	// once it has, so it must not be queued here as well.
 	//
-
-    if (usethreads()) {
-        recvLock[fragSrc].lock();
-    }
-
-	DataHeader->WhichQueue = AHEADOFSEQUENCEFRAGS;
-	privateQueues.AheadOfSeqRecvFrags[fragSrc]->AppendNoLock(DataHeader);
-
-	//! grant other threads access to frags
         if( usethreads() )
-            recvLock[fragSrc].unlock();
-            next_expected_isendSeqsLock[fragSrc].unlock();
+            peerState(fragSrc)->next_expected_isendSeqLock.unlock();
     }
     return MatchedPostedRecvHeader;
 }
@@ -75,19 +75,20 @@ int Communicator::isend_start(SendDesc_t **pSendDesc)
 
     if (!SendDesc->persistent) {
         ulm_type_retain(SendDesc->datatype);
-        ulm_type_retain(SendDesc->bsendDatatype);
+        ulm_type_retain(SendDesc->bsendDatatype());
     }
 
     // for buffered send copy data from user space into the "buffer"
 
     if ((SendDesc->sendType == ULM_SEND_BUFFERED) &&
         (SendDesc->persistent)) {
+        SendDesc_t::bsendInfo_t *bsend = SendDesc->bsendInfo();
         int offset = 0;
-        rc = PMPI_Pack(SendDesc->appBufferPointer,
-                       SendDesc->bsendDtypeCount,
-                       (MPI_Datatype) SendDesc->bsendDatatype,
+        rc = PMPI_Pack(bsend->appBufferPointer,
+                       bsend->dtypeCount,
+                       (MPI_Datatype) bsend->datatype,
                        SendDesc->addr_m,
-                       SendDesc->bsendBufferSize, &offset, contextID);
+                       bsend->bufferSize, &offset, contextID);
         if (rc != MPI_SUCCESS) {
             return rc;
         }
@@ -164,10 +165,10 @@ int Communicator::isend_start(SendDesc_t **pSendDesc)
 
     if (SendDesc->path_m->pathType_m != SHAREDMEM) {
         if (usethreads())
-            next_isendSeqsLock[SendDesc->posted_m.peer_m].lock();
-        seq = next_isendSeqs[SendDesc->posted_m.peer_m]++;
+            peerState(SendDesc->posted_m.peer_m)->next_isendSeqLock.lock();
+        seq = peerState(SendDesc->posted_m.peer_m)->next_isendSeq++;
         if (usethreads())
-            next_isendSeqsLock[SendDesc->posted_m.peer_m].unlock();
+            peerState(SendDesc->posted_m.peer_m)->next_isendSeqLock.unlock();
         // set sequence number
         SendDesc->isendSeq_m = seq;
     }
@@ -60,15 +60,14 @@ int Communicator::iprobe(int sourceProc, int tag,
     // wild source and wild tag
     //
     if (sourceProc == ULM_ANY_PROC && tag == ULM_ANY_TAG) {
-        // loop over all source queues   !!!!!! change this to look only at list with data
-        for (int SrcIndex = 0; SrcIndex < remoteGroup->groupSize;
-             SrcIndex++) {
+        // loop over the source queues of peers with state
+        for (int SrcIndex = peers.next(0); SrcIndex < remoteGroup->groupSize;
+             SrcIndex = peers.next(SrcIndex + 1)) {
 #if ENABLE_SHARED_MEMORY
-            if (lampiState.map_global_rank_to_host
-                [remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]] ==
+            if (global_proc_to_host(remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]) ==
                 myhost()) {
                 // if no frags - continue
-                if (privateQueues.OkToMatchSMPFrags[SrcIndex]->size() == 0)
+                if (peerState(SrcIndex)->OkToMatchSMPFrags.size() == 0)
                     continue;
                 //
                 // Get the list of frags from the given processor.
@@ -76,14 +75,14 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // hold big receive lock for thread safety...
                 if (usethreads()) {
-                    recvLock[SrcIndex].lock();
+                    peerState(SrcIndex)->recvLock.lock();
                 }
 
                 for (SMPFragDesc_t *
-                     rfd = (SMPFragDesc_t *) privateQueues.
-                     OkToMatchSMPFrags[SrcIndex]->begin();
-                     rfd != (SMPFragDesc_t *) privateQueues.
-                     OkToMatchSMPFrags[SrcIndex]->end();
+                     rfd = (SMPFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchSMPFrags.begin();
+                     rfd != (SMPFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchSMPFrags.end();
                      rfd = (SMPFragDesc_t *) rfd->next) {
                     // do not match on a negative tag for a ULM_ANY_TAG probe
                     if (rfd->tag_m < 0) {
@@ -105,7 +104,7 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // unlock big receive list
                 if (usethreads()) {
-                    recvLock[SrcIndex].unlock();
+                    peerState(SrcIndex)->recvLock.unlock();
                 }
 
                 if (*found)
@@ -113,7 +112,7 @@ int Communicator::iprobe(int sourceProc, int tag,
             } else {
 #endif                          // SHARED_MEMORY
                 // if no frags - continue
-                if (privateQueues.OkToMatchRecvFrags[SrcIndex]->size() ==
+                if (peerState(SrcIndex)->OkToMatchRecvFrags.size() ==
                     0)
                     continue;
                 //
@@ -122,16 +121,16 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // hold big receive lock for thread safety
                 if (usethreads()) {
-                    recvLock[SrcIndex].lock();
+                    peerState(SrcIndex)->recvLock.lock();
                 }
 
                 for (BaseRecvFragDesc_t *
                      rfd =
-                     (BaseRecvFragDesc_t *) privateQueues.
-                     OkToMatchRecvFrags[SrcIndex]->begin();
+                     (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchRecvFrags.begin();
                      rfd !=
-                     (BaseRecvFragDesc_t *) privateQueues.
-                     OkToMatchRecvFrags[SrcIndex]->end();
+                     (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchRecvFrags.end();
                      rfd = (BaseRecvFragDesc_t *) rfd->next) {
                     // do not match on a negative tag for a ULM_ANY_TAG probe
                     if (rfd->tag_m < 0) {
@@ -153,7 +152,7 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // unlock big receive lock
                 if (usethreads()) {
-                    recvLock[SrcIndex].unlock();
+                    peerState(SrcIndex)->recvLock.unlock();
                 }
 
                 if (*found)
@@ -169,16 +168,15 @@ int Communicator::iprobe(int sourceProc, int tag,
     //
     else if (sourceProc == ULM_ANY_PROC) {
         long Tag = tag;
-        // loop over all source queues
-        for (int SrcIndex = 0; SrcIndex < remoteGroup->groupSize;
-             SrcIndex++) {
+        // loop over the source queues of peers with state
+        for (int SrcIndex = peers.next(0); SrcIndex < remoteGroup->groupSize;
+             SrcIndex = peers.next(SrcIndex + 1)) {
             // if no frags - continue    !!!! look at better way to do this
 #if ENABLE_SHARED_MEMORY
-            if (lampiState.map_global_rank_to_host
-                [remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]] ==
+            if (global_proc_to_host(remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]) ==
                 myhost()) {
                 // if no frags - continue
-                if (privateQueues.OkToMatchSMPFrags[SrcIndex]->size() == 0)
+                if (peerState(SrcIndex)->OkToMatchSMPFrags.size() == 0)
                     continue;
                 //
                 // Get the list of frags from the given processor.
@@ -186,14 +184,14 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // lock big receive lock for thread safety
                 if (usethreads()) {
-                    recvLock[SrcIndex].lock();
+                    peerState(SrcIndex)->recvLock.lock();
                 }
 
                 for (SMPFragDesc_t *
-                     rfd = (SMPFragDesc_t *) privateQueues.
-                     OkToMatchSMPFrags[SrcIndex]->begin();
-                     rfd != (SMPFragDesc_t *) privateQueues.
-                     OkToMatchSMPFrags[SrcIndex]->end();
+                     rfd = (SMPFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchSMPFrags.begin();
+                     rfd != (SMPFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchSMPFrags.end();
                      rfd = (SMPFragDesc_t *) rfd->next) {
                     // look for matching tag
                     if (Tag == rfd->tag_m) {
@@ -212,7 +210,7 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // unlock big receive lock 
                 if (usethreads()) {
-                    recvLock[SrcIndex].unlock();
+                    peerState(SrcIndex)->recvLock.unlock();
                 }
 
                 if (*found)
@@ -220,7 +218,7 @@ int Communicator::iprobe(int sourceProc, int tag,
             } else {
 #endif                          // SHARED_MEMORY
                 // if no frags - continue
-                if (privateQueues.OkToMatchRecvFrags[SrcIndex]->size() ==
+                if (peerState(SrcIndex)->OkToMatchRecvFrags.size() ==
                     0)
                     continue;
                 //
@@ -229,16 +227,16 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // hold big receive lock for thread safety
                 if (usethreads()) {
-                    recvLock[SrcIndex].lock();
+                    peerState(SrcIndex)->recvLock.lock();
                 }
 
                 for (BaseRecvFragDesc_t *
                      rfd =
-                     (BaseRecvFragDesc_t *) privateQueues.
-                     OkToMatchRecvFrags[SrcIndex]->begin();
+                     (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchRecvFrags.begin();
                      rfd !=
-                     (BaseRecvFragDesc_t *) privateQueues.
-                     OkToMatchRecvFrags[SrcIndex]->end();
+                     (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                         OkToMatchRecvFrags.end();
                      rfd = (BaseRecvFragDesc_t *) rfd->next) {
                     // look for matching tag
                     if (Tag == rfd->tag_m) {
@@ -257,7 +255,7 @@ int Communicator::iprobe(int sourceProc, int tag,
 
                 // unlock big receive lock
                 if (usethreads()) {
-                    recvLock[SrcIndex].unlock();
+                    peerState(SrcIndex)->recvLock.unlock();
                 }
 
                 if (*found)
@@ -284,19 +282,18 @@ int Communicator::iprobe(int sourceProc, int tag,
         int SrcIndex = sourceProc;
 
 #if ENABLE_SHARED_MEMORY
-        if (lampiState.map_global_rank_to_host
-            [remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]] ==
+        if (global_proc_to_host(remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]) ==
             myhost()) {
             // lock big receive lock for thread safety
             if (usethreads()) {
-                recvLock[SrcIndex].lock();
+                peerState(SrcIndex)->recvLock.lock();
             }
 
             for (SMPFragDesc_t *
-                 rfd = (SMPFragDesc_t *) privateQueues.
-                 OkToMatchSMPFrags[SrcIndex]->begin();
-                 rfd != (SMPFragDesc_t *) privateQueues.
-                 OkToMatchSMPFrags[SrcIndex]->end();
+                 rfd = (SMPFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchSMPFrags.begin();
+                 rfd != (SMPFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchSMPFrags.end();
                  rfd = (SMPFragDesc_t *) rfd->next) {
                 // do not match on a negative tag for a ULM_ANY_TAG probe
                 if (rfd->tag_m < 0) {
@@ -318,22 +315,22 @@ int Communicator::iprobe(int sourceProc, int tag,
             }
             // unlock big receive lock
             if (usethreads()) {
-                recvLock[SrcIndex].unlock();
+                peerState(SrcIndex)->recvLock.unlock();
             }
         } else {
 #endif                          // SHARED_MEMORY
             // lock big receive lock for thread safety
             if (usethreads()) {
-                recvLock[SrcIndex].lock();
+                peerState(SrcIndex)->recvLock.lock();
             }
 
             for (BaseRecvFragDesc_t *
                  rfd =
-                 (BaseRecvFragDesc_t *) privateQueues.
-                 OkToMatchRecvFrags[SrcIndex]->begin();
+                 (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchRecvFrags.begin();
                  rfd !=
-                 (BaseRecvFragDesc_t *) privateQueues.
-                 OkToMatchRecvFrags[SrcIndex]->end();
+                 (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchRecvFrags.end();
                  rfd = (BaseRecvFragDesc_t *) rfd->next) {
                 // do not match on a negative tag for a ULM_ANY_TAG probe
                 if (rfd->tag_m < 0) {
@@ -355,7 +352,7 @@ int Communicator::iprobe(int sourceProc, int tag,
             }
             // unlock big receive lock
             if (usethreads()) {
-                recvLock[SrcIndex].unlock();
+                peerState(SrcIndex)->recvLock.unlock();
             }
 
 #if ENABLE_SHARED_MEMORY
@@ -374,19 +371,18 @@ int Communicator::iprobe(int sourceProc, int tag,
 
         int SrcIndex = sourceProc;
 #if ENABLE_SHARED_MEMORY
-        if (lampiState.map_global_rank_to_host
-            [remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]] ==
+        if (global_proc_to_host(remoteGroup->mapGroupProcIDToGlobalProcID[SrcIndex]) ==
             myhost()) {
             // lock big receive lock for thread safety
             if (usethreads()) {
-                recvLock[SrcIndex].lock();
+                peerState(SrcIndex)->recvLock.lock();
             }
 
             for (SMPFragDesc_t *
-                 rfd = (SMPFragDesc_t *) privateQueues.
-                 OkToMatchSMPFrags[SrcIndex]->begin();
-                 rfd != (SMPFragDesc_t *) privateQueues.
-                 OkToMatchSMPFrags[SrcIndex]->end();
+                 rfd = (SMPFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchSMPFrags.begin();
+                 rfd != (SMPFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchSMPFrags.end();
                  rfd = (SMPFragDesc_t *) rfd->next) {
                 //
                 // If the tags match, then we have a match, since we're looking
@@ -411,22 +407,22 @@ int Communicator::iprobe(int sourceProc, int tag,
 
             // unlock big receive lock
             if (usethreads()) {
-                recvLock[SrcIndex].unlock();
+                peerState(SrcIndex)->recvLock.unlock();
             }
         } else {
 #endif                          // SHARED_MEMORY
             // lock big receive lock for thread safety
             if (usethreads()) {
-                recvLock[SrcIndex].lock();
+                peerState(SrcIndex)->recvLock.lock();
             }
 
             for (BaseRecvFragDesc_t *
                  rfd =
-                 (BaseRecvFragDesc_t *) privateQueues.
-                 OkToMatchRecvFrags[SrcIndex]->begin();
+                 (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchRecvFrags.begin();
                  rfd !=
-                 (BaseRecvFragDesc_t *) privateQueues.
-                 OkToMatchRecvFrags[SrcIndex]->end();
+                 (BaseRecvFragDesc_t *) peerState(SrcIndex)->
+                     OkToMatchRecvFrags.end();
                  rfd = (BaseRecvFragDesc_t *) rfd->next) {
                 //
                 // If the tags match, then we have a match, since we're looking
@@ -451,7 +447,7 @@ int Communicator::iprobe(int sourceProc, int tag,
 
             // unlock big receive lock
             if (usethreads()) {
-                recvLock[SrcIndex].unlock();
+                peerState(SrcIndex)->recvLock.unlock();
             }
 
 #if ENABLE_SHARED_MEMORY
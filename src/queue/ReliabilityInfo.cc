@@ -73,46 +73,9 @@ ReliabilityInfo::ReliabilityInfo()
         bzero((void *) sender_ackinfo[i].process_array, LenToAllocate);
     }
 
-    //! next frag sequence number to be assigned for a send
-    next_frag_seqs = ulm_new(ULM_64BIT_INT, nprocs());
-    if (!next_frag_seqs) {
-        ulm_exit(("Error: Unable to allocate space for next_frag_seqs\n"));
-    }
-
-    for (int i = 0; i < nprocs(); ++i) {
-        next_frag_seqs[i] = 1;        // 0 is an null/invalid value
-    }
-
-    next_frag_seqsLock = ulm_new(Locks, nprocs());
-    if (!next_frag_seqsLock) {
-        ulm_exit(("Error: Unable to allocate space for "
-                  "next_frag_seqsLock\n"));
-    }
-    /* !!!!! threaded-lock */
-    for (int ele = 0; ele < nprocs(); ele++) {
-        next_frag_seqsLock[ele].init();
-    }
-
-    // initialize sequence tracking list array for all received message frags
-    receivedDataSeqs = ulm_new(SeqTrackingList, nprocs());
-    if (!receivedDataSeqs) {
-        ulm_exit(("Error: Unable to allocate space for receivedDataSeqs\n"));
-    }
-    // initialize sequence tracking list array for all delivered message frags
-    deliveredDataSeqs = ulm_new(SeqTrackingList, nprocs());
-    if (!deliveredDataSeqs) {
-        ulm_exit(("Error: Unable to allocate space for "
-                 "deliveredDataSeqs\n"));
-    }
-    // initialize sequence tracking list lock array for both rec'vd+delivered DataSeqs
-    dataSeqsLock = ulm_new(Locks, nprocs());
-    if (!dataSeqsLock) {
-        ulm_exit(("Error: Unable to allocate space for dataSeqsLock\n"));
-    }
-    /* !!!!! threaded-lock */
-    for (int ele = 0; ele < nprocs(); ele++) {
-        dataSeqsLock[ele].init();
-    }
+    // per-peer sequencing is created on first traffic with each peer
+    peers = new PeerTable<peer_t>;
+    peers->init(nprocs());
 
     /* Collective Information initialization */
 
@@ -208,25 +171,9 @@ ReliabilityInfo::ReliabilityInfo()
 ReliabilityInfo::~ReliabilityInfo()
 {
 #if ENABLE_RELIABILITY
-    if (next_frag_seqs) {
-        ulm_delete(next_frag_seqs);
-        next_frag_seqs = 0;
-    }
-    if (next_frag_seqsLock) {
-        ulm_delete(next_frag_seqsLock);
-        next_frag_seqsLock = 0;
-    }
-    if (receivedDataSeqs) {
-        ulm_delete(receivedDataSeqs);
-        receivedDataSeqs = 0;
-    }
-    if (deliveredDataSeqs) {
-        ulm_delete(deliveredDataSeqs);
-        deliveredDataSeqs = 0;
-    }
-    if (dataSeqsLock) {
-        ulm_delete(dataSeqsLock);
-        dataSeqsLock = 0;
+    if (peers) {
+        delete peers;
+        peers = 0;
     }
 #endif
 }
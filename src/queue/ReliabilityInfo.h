@@ -36,6 +36,7 @@
 #define ULM_64BIT_INT long long
 
 #include "util/Lock.h"
+#include "util/PeerTable.h"
 #include "SeqTrackingList.h"
 #include "sender_ackinfo.h"
 
@@ -45,19 +46,29 @@ public:
 
     /* Point-to-Point traffic information */
 
-    //! next pt-2-pt frag sequence number generated on the send side
-    //! monotonically increasing from (1 .. (2^64 - 1))
-    //  process private memory
-    ULM_64BIT_INT *next_frag_seqs;
-    Locks *next_frag_seqsLock;
-
-    /*! ACK received and delivered sequence tracking lists for received
-     * data messages, and one array of locks for both lists
-     *  process private memory
-     */
-    SeqTrackingList *receivedDataSeqs;
-    SeqTrackingList *deliveredDataSeqs;
-    Locks *dataSeqsLock;
+    //! per-peer send and receive sequencing, process private memory
+    struct peer_t {
+        //! next pt-2-pt frag sequence number generated on the send side
+        //! monotonically increasing from (1 .. (2^64 - 1))
+        ULM_64BIT_INT next_frag_seq;
+        Locks next_frag_seqLock;
+
+        /*! ACK received and delivered sequence tracking lists for
+         * received data messages, and one lock for both lists
+         */
+        SeqTrackingList receivedDataSeqs;
+        SeqTrackingList deliveredDataSeqs;
+        Locks dataSeqsLock;
+
+        peer_t() : next_frag_seq(1) { }  // 0 is an null/invalid value
+    };
+
+    //! per-peer state, created on first traffic with each peer; the
+    //! table itself is process private, unlike this object
+    PeerTable<peer_t> *peers;
+
+    //! state for global process proc
+    peer_t *peer(int proc) { return peers->get(proc); }
 
     //! shared memory arrays to track per-process peer ACK status
     sender_ackinfo_control_t *sender_ackinfo;
@@ -32,15 +32,17 @@
 #include "config.h"
 #endif
 
-#include <new>
+#include <string.h>
 
 #include "queue/Communicator.h"
 #include "queue/barrier.h"
 #include "queue/globals.h"
 #include "client/daemon.h"
+#include "init/environ.h"
 #include "internal/constants.h"
 #include "internal/log.h"
 #include "internal/malloc.h"
+#include "internal/state.h"
 #include "internal/system.h"
 #include "internal/types.h"
 
@@ -48,41 +50,150 @@
 SWBarrierPool swBarrier;
 
 //
-//  Simple on host barrier
+//  Spin until a barrier flag reaches value, making progress every so
+//    often
 //
-void SMPSWBarrier(volatile void *barrierData)
+inline static void spinUntil(volatile long long *flag, long long value)
 {
     int count = 0;
+
+    while (*flag < value) {
+        if (count++ == 10000) {
+            ulm_make_progress();
+            count = 0;
+        }
+    }
+}
+
+//
+//  On host barrier.  Each process signals and waits on its own cache
+//    line (tree and dissemination) or on a counter without a lock
+//    (sense-reversing), rather than all taking a lock to update one
+//    shared counter.
+//
+void SMPSWBarrier(volatile void *barrierData)
+{
     // cast data to real type
-    volatile swBarrierData *barData = (volatile swBarrierData *) barrierData;
+    swBarrierData *barData = (swBarrierData *) barrierData;
+    swBarrierFlags *flags = barData->flags;
+    int commSize = barData->commSize;
+    int rank = barData->rank;
+    long long episode = ++(barData->episode);
 
-    // increment "release" count
-    barData->releaseCnt += barData->commSize;
+    // make data written before the barrier visible after it
+    mb();
 
-    // increment fetch and op variable
-    barData->lock->lock();
-    *(barData->Counter) += 1;
-    barData->lock->unlock();
+    switch (barData->algorithm) {
 
-    // spin until fetch and op variable == release count
-    while (*(barData->Counter) < barData->releaseCnt) {
-	if (count++ == 10000) {
-            ulm_make_progress();
-            count = 0;
-	}
+    case SWBARRIER_DISSEMINATION:
+    {
+        // in round k signal process rank + 2^k and wait for rank - 2^k
+        int round = 0;
+        for (int dist = 1; dist < commSize; dist <<= 1, round++) {
+            flags[(rank + dist) % commSize].flag[round] = episode;
+            spinUntil(&(flags[rank].flag[round]), episode);
+        }
+        break;
     }
 
+    case SWBARRIER_TREE:
+    {
+        // wait for children to arrive
+        int child = SWBARRIER_TREE_RADIX * rank + 1;
+        for (int i = 0; i < SWBARRIER_TREE_RADIX && child + i < commSize; i++) {
+            spinUntil(&(flags[child + i].flag[0]), episode);
+        }
+        if (rank == 0) {
+            // everyone has arrived - release
+            flags[0].flag[1] = episode;
+        } else {
+            // arrive, and wait for release
+            flags[rank].flag[0] = episode;
+            spinUntil(&(flags[0].flag[1]), episode);
+        }
+        break;
+    }
+
+    default:
+    {
+        swBarrierCentral *central = barData->central;
+        int sense = barData->sense = !barData->sense;
+
+        if (fetchNadd(&(central->count), 1) == commSize - 1) {
+            // last to arrive - reset the counter, then release
+            central->count = 0;
+            wmb();
+            central->sense = sense;
+        } else {
+            int count = 0;
+            while (central->sense != sense) {
+                if (count++ == 10000) {
+                    ulm_make_progress();
+                    count = 0;
+                }
+            }
+        }
+        break;
+    }
+    }
+
+    mb();
+
     return;
 }
 
+//
+//  Attach to barrier data, and select the algorithm.  LAMPI_BARRIER
+//    may be set to "sense", "tree" or "dissemination"; by default a
+//    central counter is used for a few processes and a combining tree
+//    for more.  All processes on the host make the same choice.
+//
+void SMPSWBarrierInit(swBarrierData *barrierData, int commSize, int rank,
+                      int firstInstance)
+{
+    char *name;
+
+    barrierData->commSize = commSize;
+    barrierData->rank = rank;
+    barrierData->sense = 0;
+    barrierData->episode = 0;
+
+    barrierData->algorithm = SWBARRIER_AUTO;
+    lampi_environ_find_string("LAMPI_BARRIER", &name);
+    if (strcmp(name, "sense") == 0) {
+        barrierData->algorithm = SWBARRIER_SENSE_REVERSING;
+    } else if (strcmp(name, "tree") == 0) {
+        barrierData->algorithm = SWBARRIER_TREE;
+    } else if (strcmp(name, "dissemination") == 0 &&
+               commSize <= (1 << (CACHE_ALIGNMENT / sizeof(long long)))) {
+        barrierData->algorithm = SWBARRIER_DISSEMINATION;
+    }
+    if (barrierData->algorithm == SWBARRIER_AUTO) {
+        if (commSize <= SWBARRIER_SMALL) {
+            barrierData->algorithm = SWBARRIER_SENSE_REVERSING;
+        } else {
+            barrierData->algorithm = SWBARRIER_TREE;
+        }
+    }
+
+    if (firstInstance) {
+        memset((void *) barrierData->central, 0, sizeof(swBarrierCentral));
+        memset((void *) barrierData->flags, 0,
+               commSize * sizeof(swBarrierFlags));
+    }
+}
+
 
 //
-//  This routine is used to allocate a pool of O2k atomic fetch-
-//    and-op variables.
+//  This routine is used to allocate the pool of on host barrier
+//    data.  Each element has a counter and a cache line per local
+//    process in shared memory.
 //
 
 int allocSWSMPBarrierPools()
 {
+    enum { N_ELEMENTS = 256 };
+
     //
     // set the number of pools
     //
@@ -94,11 +205,6 @@ int allocSWSMPBarrierPools()
     if (swBarrier.nPools <= 0) {
         return ULM_SUCCESS;
     }
-    //
-    //  determine how many pages to allocate (the granularity of the
-    //    per node allocation is 1 page)
-    //
-    int nPages = 1;
 
     //
     // allocate nElementsInPool
@@ -135,8 +241,10 @@ int allocSWSMPBarrierPools()
         ulm_exit(("swBarrier.pool is invalid\n"));
     }
     // allocate shared memory
-    long long memory = nPages * getpagesize();
-    swBarrierData *memPtr = (swBarrierData *)
+    long long elementLen = sizeof(swBarrierCentral) +
+        local_nprocs() * sizeof(swBarrierFlags);
+    long long memory = swBarrier.nPools * N_ELEMENTS * elementLen;
+    char *memPtr = (char *)
         SharedMemoryPools.getMemorySegment(memory, getpagesize());
     if (!memPtr) {
         swBarrier.nPools = 0;
@@ -150,45 +258,36 @@ int allocSWSMPBarrierPools()
     //
     // setup the memory pools
     //
-    assert(nPages == swBarrier.nPools);
-    long long lockSize = sizeof(Locks);
-    lockSize = ((lockSize / (sizeof(long long) - 1)) + 1) * sizeof(long long);
-    long long barrierDataLen = lockSize + sizeof(long long);
-    long long nElements = nPages * getpagesize() / barrierDataLen;
     for (int pl = 0; pl < swBarrier.nPools; pl++) {
-        swBarrier.nElementsInPool[pl] = nElements;
+        swBarrier.nElementsInPool[pl] = N_ELEMENTS;
         swBarrier.pool[pl] = (swBarrierCtlData *)
-	    SharedMemoryPools.getMemorySegment(nElements * sizeof(swBarrierCtlData),
+	    SharedMemoryPools.getMemorySegment(N_ELEMENTS * sizeof(swBarrierCtlData),
                                                CACHE_ALIGNMENT);
         if (!(swBarrier.pool[pl])) {
             ulm_exit(("swBarrier.pool[%i] is invalid\n", pl));
         }
-        char *counter = (char *) memPtr + pl * nPages * getpagesize();
-        for (int ele = 0; ele < nElements; ele++) {
+        char *shared = memPtr + pl * N_ELEMENTS * elementLen;
+        for (int ele = 0; ele < N_ELEMENTS; ele++) {
 	    swBarrier.pool[pl][ele].inUse = 0;
 	    swBarrier.pool[pl][ele].commRoot = -1;
 	    swBarrier.pool[pl][ele].contextID = -1;
 	    swBarrier.pool[pl][ele].nAllocated = 0;
 	    swBarrier.pool[pl][ele].nFreed = 0;
             // allocate the barrierData element out of process private memory
-            (swBarrier.pool[pl][ele]).barrierData = (swBarrierData *) ulm_malloc(sizeof(swBarrierData));
-            if (!(swBarrier.pool[pl][ele].barrierData)) {
+            swBarrierData *barData = (swBarrierData *) ulm_malloc(sizeof(swBarrierData));
+            if (!barData) {
                 ulm_exit(("swBarrier.pool[%i][%i].barrierData is "
                           "invalid\n", pl, ele));
             }
-            // set the pointer to the fetchop variable
-            swBarrier.pool[pl][ele].barrierData->Counter = (long long *)
-                ((char *) counter + lockSize);
-
-            // allocate lock and Counter data - make sure long long is aligned
-            //  on long long boundry
-            swBarrier.pool[pl][ele].barrierData->lock = (Locks *) counter;
-            // placement new
-            new(swBarrier.pool[pl][ele].barrierData->lock) Locks;
-            // initialize locks
-            swBarrier.pool[pl][ele].barrierData->lock->init();
-
-            counter = (char *) counter + barrierDataLen;
+            memset(barData, 0, sizeof(swBarrierData));
+            swBarrier.pool[pl][ele].barrierData = barData;
+
+            // set the pointers to the shared counter and flags
+            barData->central = (swBarrierCentral *) shared;
+            barData->flags = (swBarrierFlags *)
+                (shared + sizeof(swBarrierCentral));
+
+            shared += elementLen;
 
         }                       // end element loop
     }                           // end pool loop
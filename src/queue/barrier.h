@@ -33,11 +33,38 @@
 #ifndef _BARRIER
 #define _BARRIER
 
+#include "internal/system.h"
+#include "util/Lock.h"
+
+//! on-host barrier algorithms
+enum {
+    SWBARRIER_AUTO = 0,                 //! select by number of processes
+    SWBARRIER_SENSE_REVERSING = 1,      //! central counter, sense reversal
+    SWBARRIER_TREE = 2,                 //! combining tree
+    SWBARRIER_DISSEMINATION = 3,        //! dissemination (log2 rounds)
+    SWBARRIER_TREE_RADIX = 4,           //! fan-in of the combining tree
+    SWBARRIER_SMALL = 4                 //! AUTO: sense-reversing up to here
+};
+
+//! per-process flags for the tree and dissemination barriers, one
+//!   cache line per process - process shared memory.  Flags hold the
+//!   number of the last barrier signalled, so never need resetting.
+typedef struct {
+    volatile long long flag[CACHE_ALIGNMENT / sizeof(long long)];
+} swBarrierFlags;
+
+//! counter and release flag for the sense-reversing barrier, on
+//!   separate cache lines - process shared memory
+typedef struct {
+    volatile int count;
+    char pad0[CACHE_ALIGNMENT - sizeof(int)];
+    volatile int sense;
+    char pad1[CACHE_ALIGNMENT - sizeof(int)];
+} swBarrierCentral;
+
 //! structure defining data needed for fetch and add barrier with
 //!   hardware supporting atomic variable access
 
-#include "util/Lock.h"
-
 typedef struct {
     int commSize;                    //! number of processes participating in the barrier
     //!  process private memory
@@ -47,6 +74,14 @@ typedef struct {
 
     volatile long long *Counter;     //! pointer to atmoic variable - process shared memory
 
+    int algorithm;                   //! SWBARRIER_* algorithm in use
+    int rank;                        //! on-host rank of this process
+    int sense;                       //! sense of current sense-reversing barrier
+    long long episode;               //! number of barriers entered
+
+    swBarrierCentral *central;       //! process shared memory
+    swBarrierFlags *flags;           //! process shared memory, 1 per local process
+
 } swBarrierData;
 
 
@@ -80,6 +115,14 @@ typedef struct {
 //!
 void SMPSWBarrier(volatile void *barrierData);
 
+//!
+//!  Attach a process to barrier data for a communicator with commSize
+//!    processes on this host, of which it is number rank.  The first
+//!    process to attach (firstInstance) resets the shared flags.
+//!
+void SMPSWBarrierInit(swBarrierData *barrierData, int commSize, int rank,
+                      int firstInstance);
+
 //!
 //! This routine is used to allocate a pool of O2k atomic fetch-
 //!    and-op variables.
@@ -1,5 +1,6 @@
 SRC_LIBMPI += \
 	src/queue/Communicator.cc \
+	src/queue/FlowControl.cc \
 	src/queue/Pt2PtGroupMatchFrags.cc \
 	src/queue/Pt2PtGroupMatchRecv.cc \
 	src/queue/Pt2PtGroupMisc.cc \
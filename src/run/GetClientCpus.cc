@@ -56,7 +56,7 @@
  ***/
 
 
-#if ENABLE_NUMA
+#if ENABLE_NUMA || defined(__linux__)
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -67,7 +67,9 @@
 #include "internal/log.h"
 #include "internal/new.h"
 #include "internal/types.h"
+#include "run/Input.h"
 #include "run/Run.h"
+#include "run/RunParams.h"
 #include "util/ParseString.h"
 
 void GetClientCpus(const char *InfoStream)
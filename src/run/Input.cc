@@ -43,6 +43,7 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <limits.h>
 #include <pwd.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -474,6 +475,20 @@ Options_t Options[] =
      parseTCPConnectRetries,
      "TCP connection retries"
     },
+    {{"tcpconns"},
+     "TCPConnections",
+     STRING_ARGS,
+     NoOpFunction,
+     parseTCPConnections,
+     "TCP connections per interface to each peer"
+    },
+    {{"tcpsockbuf"},
+     "TCPSocketBuffer",
+     STRING_ARGS,
+     NoOpFunction,
+     parseTCPSocketBuffer,
+     "TCP socket send/receive buffer size"
+    },
 #endif
     {{"list-options"},
      "ListOptions",
@@ -2145,4 +2160,55 @@ void parseTCPConnectRetries(const char *InfoStream)
     }
 }
 
+void parseTCPConnections(const char *InfoStream)
+{
+    int NSeparators = 1;
+    char SeparatorList[] = { " " };
+
+    int OptionIndex =
+        MatchOption("TCPConnections");
+    if (OptionIndex < 0) {
+        ulm_err(("Error: Option TCPConnections not found\n"));
+        Abort();
+    }
+
+    ParseString params(Options[OptionIndex].InputData,
+                       NSeparators, SeparatorList);
+
+    for (ParseString::iterator i = params.begin(); i != params.end(); i++) {
+        RunParams.Networks.TCPSetup.ConnectionsPerInterface = atol(*i);
+        if(RunParams.Networks.TCPSetup.ConnectionsPerInterface <= 0) {
+            ulm_err(("Error: invalid value for option -tcpconns \"%s\"\n", *i));
+            Abort();
+        }
+    }
+}
+
+void parseTCPSocketBuffer(const char *InfoStream)
+{
+    int NSeparators = 1;
+    char SeparatorList[] = { " " };
+
+    int OptionIndex =
+        MatchOption("TCPSocketBuffer");
+    if (OptionIndex < 0) {
+        ulm_err(("Error: Option TCPSocketBuffer not found\n"));
+        Abort();
+    }
+
+    ParseString params(Options[OptionIndex].InputData,
+                       NSeparators, SeparatorList);
+
+    for (ParseString::iterator i = params.begin(); i != params.end(); i++) {
+        char *ptr;
+        long size = strtol(*i, &ptr, 10);
+        if (ptr == *i || *ptr != '\0' || size <= 0 || size > INT_MAX) {
+            ulm_err(("Error: invalid value for option -tcpsockbuf \"%s\"\n", *i));
+            Usage(stderr);
+            exit(MPIRUN_EXIT_INVALID_ARGUMENTS);
+        }
+        RunParams.Networks.TCPSetup.SocketBufferSize = (size_t) size;
+    }
+}
+
 #endif
@@ -146,6 +146,8 @@ void setUseSSH(const char *msg);
 void parseTCPMaxFragment(const char* msg);
 void parseTCPEagerSend(const char* msg);
 void parseTCPConnectRetries(const char *msg);
+void parseTCPConnections(const char *msg);
+void parseTCPSocketBuffer(const char *msg);
 #endif
 
 /*
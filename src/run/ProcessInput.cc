@@ -179,6 +179,10 @@ int ProcessInput(int argc, char **argv, int *FirstAppArg)
     /* are we in charge of standard I/O redirection? */
     RunParams.handleSTDio = RunParams.UseRMS ? 0 : 1;
 
+    /* no cpu list unless -cpulist is given */
+    RunParams.CpuList = NULL;
+    RunParams.CpuListLen = 0;
+
     /* get input data - not parsed at this stage */
     ScanInput(argc, argv, FirstAppArg);
 
@@ -266,8 +270,6 @@ int ProcessInput(int argc, char **argv, int *FirstAppArg)
     }
 
 #if ENABLE_NUMA
-    RunParams.CpuList = NULL;
-    RunParams.CpuListLen = 0;
     RunParams.nCpusPerNode = 0;
 #endif                          // ENABLE_NUMA
 
@@ -176,9 +176,9 @@ struct RunParams_t {
 #endif
     } Networks;
 
-#if ENABLE_NUMA
     int *CpuList;
     int CpuListLen;
+#if ENABLE_NUMA
     // number of cpus to allocate per node (1 or 2)
     int *nCpusPerNode;
     // cpu affinity policy
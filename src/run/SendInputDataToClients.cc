@@ -487,6 +487,10 @@ static int SendTCPInputToClients(void)
                  (adminMessage::packType) sizeof(size_t), 1);
     server->pack(&RunParams.Networks.TCPSetup.MaxConnectRetries,
                  (adminMessage::packType) sizeof(int), 1);
+    server->pack(&RunParams.Networks.TCPSetup.ConnectionsPerInterface,
+                 (adminMessage::packType) sizeof(int), 1);
+    server->pack(&RunParams.Networks.TCPSetup.SocketBufferSize,
+                 (adminMessage::packType) sizeof(size_t), 1);
     tag = dev_type_params::END_TCP_INPUT;
     server->pack(&tag, adminMessage::INTEGER, 1);
     if (!server->broadcast(dev_type_params::START_TCP_INPUT, &errorCode)) {
@@ -670,7 +674,6 @@ int SendInitialInputDataToClients(void)
              1))
         DataError("HeartbeatPeriod");
 
-#if ENABLE_NUMA
     /* cpu list */
     if (RunParams.CpuListLen != 0) {
         tag = adminMessage::CPULIST;
@@ -681,12 +684,14 @@ int SendInitialInputDataToClients(void)
                           (adminMessage::packType) sizeof(int), 1))
             DataError("CpuListLen");
 
-        if (!server->pack(&RunParams.CpuList,
+        if (!server->pack(RunParams.CpuList,
                           (adminMessage::packType) sizeof(int),
                           RunParams.CpuListLen))
             DataError("CpuList");
     }
 
+#if ENABLE_NUMA
+
     /* number of cpus per node */
     if (RunParams.nCpusPerNode != 0) {
         tag = adminMessage::NCPUSPERNODE;
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2002-2003. The Regents of the University of California. This material 
+ * was produced under U.S. Government contract W-7405-ENG-36 for Los Alamos 
+ * National Laboratory, which is operated by the University of California for 
+ * the U.S. Department of Energy. The Government is granted for itself and 
+ * others acting on its behalf a paid-up, nonexclusive, irrevocable worldwide 
+ * license in this material to reproduce, prepare derivative works, and 
+ * perform publicly and display publicly. Beginning five (5) years after 
+ * October 10,2002 subject to additional five-year worldwide renewals, the 
+ * Government is granted for itself and others acting on its behalf a paid-up, 
+ * nonexclusive, irrevocable worldwide license in this material to reproduce, 
+ * prepare derivative works, distribute copies to the public, perform publicly 
+ * and display publicly, and to permit others to do so. NEITHER THE UNITED 
+ * STATES NOR THE UNITED STATES DEPARTMENT OF ENERGY, NOR THE UNIVERSITY OF 
+ * CALIFORNIA, NOR ANY OF THEIR EMPLOYEES, MAKES ANY WARRANTY, EXPRESS OR 
+ * IMPLIED, OR ASSUMES ANY LEGAL LIABILITY OR RESPONSIBILITY FOR THE ACCURACY, 
+ * COMPLETENESS, OR USEFULNESS OF ANY INFORMATION, APPARATUS, PRODUCT, OR 
+ * PROCESS DISCLOSED, OR REPRESENTS THAT ITS USE WOULD NOT INFRINGE PRIVATELY 
+ * OWNED RIGHTS.
+
+ * Additionally, this program is free software; you can distribute it and/or 
+ * modify it under the terms of the GNU Lesser General Public License as 
+ * published by the Free Software Foundation; either version 2 of the License, 
+ * or any later version.  Accordingly, this program is distributed in the hope 
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied 
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU Lesser General Public License for more details.
+ */
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef _PEERTABLE_
+#define _PEERTABLE_
+
+#include <new>
+
+#include "internal/new.h"
+#include "os/atomic.h"
+#include "util/Lock.h"
+
+//
+// PeerTable
+//
+// Sparse table of per-peer state indexed by process number.  Entries
+// are created on first use, so memory grows with the number of peers
+// actually communicated with rather than with the job size.  The
+// table is two level: a top array with one pointer per chunk of
+// CHUNK peers, and chunks allocated as peers in them are touched.
+// Lookups take no lock; creation is serialized.
+//
+
+template <class T>
+class PeerTable {
+public:
+
+    enum { LOG2_CHUNK = 8, CHUNK = 1 << LOG2_CHUNK };
+
+    PeerTable() : chunks_m(0), nChunks_m(0), nPeers_m(0), nEntries_m(0) { }
+
+    ~PeerTable() { clear(); }
+
+    //! size the table for peers 0 .. npeers - 1
+    void init(int npeers)
+        {
+            clear();
+            lock_m.init();
+            nPeers_m = npeers;
+            nChunks_m = (npeers + CHUNK - 1) >> LOG2_CHUNK;
+            if (nChunks_m > 0) {
+                chunks_m = ulm_new(T **, nChunks_m);
+                for (int c = 0; c < nChunks_m; c++) {
+                    chunks_m[c] = 0;
+                }
+            }
+        }
+
+    //! number of peers the table covers
+    int size() const { return nPeers_m; }
+
+    //! number of peers with state
+    int entries() const { return nEntries_m; }
+
+    //! state for peer, or 0 if none has been created
+    T *find(int peer) const
+        {
+            T **chunk = chunks_m[peer >> LOG2_CHUNK];
+            return chunk ? chunk[peer & (CHUNK - 1)] : 0;
+        }
+
+    //! state for peer, created on first use
+    T *get(int peer)
+        {
+            T *entry = find(peer);
+            return entry ? entry : create(peer);
+        }
+
+    //! first peer at or after peer with state, or size() if none
+    int next(int peer) const
+        {
+            while (peer < nPeers_m) {
+                T **chunk = chunks_m[peer >> LOG2_CHUNK];
+                if (!chunk) {
+                    peer = ((peer >> LOG2_CHUNK) + 1) << LOG2_CHUNK;
+                    continue;
+                }
+                if (chunk[peer & (CHUNK - 1)]) {
+                    return peer;
+                }
+                peer++;
+            }
+            return nPeers_m;
+        }
+
+    //! release all peer state
+    void clear()
+        {
+            for (int c = 0; c < nChunks_m; c++) {
+                if (chunks_m[c]) {
+                    for (int i = 0; i < CHUNK; i++) {
+                        if (chunks_m[c][i]) {
+                            delete chunks_m[c][i];
+                        }
+                    }
+                    ulm_delete(chunks_m[c]);
+                }
+            }
+            if (chunks_m) {
+                ulm_delete(chunks_m);
+            }
+            chunks_m = 0;
+            nChunks_m = 0;
+            nPeers_m = 0;
+            nEntries_m = 0;
+        }
+
+private:
+
+    T *create(int peer)
+        {
+            T *entry;
+
+            lock_m.lock();
+            T **chunk = chunks_m[peer >> LOG2_CHUNK];
+            if (!chunk) {
+                chunk = ulm_new(T *, CHUNK);
+                for (int i = 0; i < CHUNK; i++) {
+                    chunk[i] = 0;
+                }
+                mb();
+                chunks_m[peer >> LOG2_CHUNK] = chunk;
+            }
+            entry = chunk[peer & (CHUNK - 1)];
+            if (!entry) {
+                entry = new T;
+                mb();
+                chunk[peer & (CHUNK - 1)] = entry;
+                nEntries_m++;
+            }
+            lock_m.unlock();
+
+            return entry;
+        }
+
+    T ***chunks_m;
+    int nChunks_m;
+    int nPeers_m;
+    int nEntries_m;
+    Locks lock_m;
+};
+
+#endif /* _PEERTABLE_ */
@@ -43,7 +43,10 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <limits.h>
+#include <string.h>
+#include <time.h>
 
+#include "init/environ.h"
 #include "internal/log.h"
 #include "internal/profiler.h"
 #include "util/dclock.h"
@@ -106,10 +109,186 @@ dclock_hardware_t hw_dclock_overhead()
     return (x1-x0)/10000;
 }
 
+double dclock_resolution()
+{
+    return dclock_secs_per_cycle;
+}
+
 #else
 
 static double time0;
 
+#if defined(__x86_64__) && defined(__linux__)
+
+//----------------------------------------------------------------------
+// Time stamp counter clock for x86_64 Linux.
+//
+// The TSC is only used if the processor reports it as invariant
+// (constant rate, running in all C- and P-states) and the kernel has
+// not rejected it as its own clock source (e.g. because it is not
+// synchronized between sockets).  It is calibrated against
+// CLOCK_MONOTONIC and given the same origin as the gettimeofday()
+// clock.  init_dclock() is called before the local processes are
+// forked, so they all share one calibration and offset per node, and
+// their times are directly comparable.
+//----------------------------------------------------------------------
+
+int dclock_use_tsc = 0;
+double dclock_secs_per_cycle;
+dclock_hardware_t dclock_offset;
+
+static void cpuid(unsigned int op, unsigned int *a, unsigned int *b,
+                  unsigned int *c, unsigned int *d)
+{
+    __asm__ __volatile__("cpuid"
+                         : "=a" (*a), "=b" (*b), "=c" (*c), "=d" (*d)
+                         : "a" (op), "c" (0));
+}
+
+static int tsc_is_invariant()
+{
+    unsigned int a, b, c, d;
+    char buf[32];
+    FILE *fp;
+
+    cpuid(0x80000000, &a, &b, &c, &d);
+    if (a < 0x80000007) {
+        return 0;
+    }
+    cpuid(0x80000007, &a, &b, &c, &d);
+    if ((d & (1 << 8)) == 0) {
+        return 0;
+    }
+
+    fp = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (fp) {
+        int ok = (fgets(buf, sizeof(buf), fp) != NULL &&
+                  strncmp(buf, "tsc", 3) == 0);
+        fclose(fp);
+        if (!ok) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static double monotonic_time()
+{
+#ifdef HAVE_CLOCK_GETTIME
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return double(ts.tv_sec) + double(ts.tv_nsec)/1000000000;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return double(tv.tv_sec) + double(tv.tv_usec)/1000000;
+#endif
+}
+
+// Read the TSC and CLOCK_MONOTONIC together, keeping the pair that
+// was read closest together of a few attempts
+
+static void tsc_sample(dclock_hardware_t *tsc, double *t)
+{
+    dclock_hardware_t best = -1;
+
+    for (int i = 0; i < 8; i++) {
+        dclock_hardware_t c0 = hw_dclock();
+        double t0 = monotonic_time();
+        dclock_hardware_t c1 = hw_dclock();
+
+        if (best < 0 || c1 - c0 < best) {
+            best = c1 - c0;
+            *tsc = c0 + (c1 - c0) / 2;
+            *t = t0;
+        }
+    }
+}
+
+static int tsc_calibrate()
+{
+    enum { CALIBRATION_USECS = 20000 };
+    dclock_hardware_t c0, c1;
+    double t0, t1, hz;
+    struct timeval tv;
+
+    tsc_sample(&c0, &t0);
+    usleep(CALIBRATION_USECS);
+    tsc_sample(&c1, &t1);
+
+    if (c1 <= c0 || t1 <= t0) {
+        return 0;
+    }
+    hz = double(c1 - c0) / (t1 - t0);
+    if (hz < 1.0e8 || hz > 1.0e11) {
+        return 0;
+    }
+    dclock_secs_per_cycle = 1.0 / hz;
+
+    // origin: the same instant as the gettimeofday() clock
+    c0 = hw_dclock();
+    gettimeofday(&tv, NULL);
+    c1 = hw_dclock();
+    time0 = double(tv.tv_sec) + double(tv.tv_usec)/1000000;
+    dclock_offset = c0 + (c1 - c0) / 2;
+
+    return 1;
+}
+
+void init_dclock()
+{
+    struct timeval tv;
+    int use_tsc;
+
+    gettimeofday(&tv, NULL);
+    time0 = double(tv.tv_sec) + double(tv.tv_usec)/1000000;
+
+    dclock_use_tsc = 0;
+    lampi_environ_find_integer("LAMPI_DCLOCK_TSC", &use_tsc);
+    if (use_tsc && tsc_is_invariant()) {
+        dclock_use_tsc = tsc_calibrate();
+    }
+}
+
+dclock_hardware_t hw_dclock_overhead()
+{
+    if (dclock_use_tsc) {
+        dclock_hardware_t x0 = hw_dclock();
+        dclock_hardware_t x1 = x0;
+        for (int i=0; i<10000; ++i)
+            x1 += hw_dclock() - x1;
+        return (x1-x0)/10000;
+    }
+
+    struct timeval tv0, tv1;
+
+    gettimeofday(&tv0, NULL);
+    for (int i=0; i<10000; ++i) {
+	gettimeofday(&tv1, NULL);
+    }
+    double t0 = double(tv0.tv_sec) + double(tv0.tv_usec)/1000000;
+    double t1 = double(tv1.tv_sec) + double(tv1.tv_usec)/1000000;
+
+    return dclock_hardware_t((t1 - t0)/10000);
+}
+
+double dclock_gettimeofday()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double(tv.tv_sec) - time0) + double(tv.tv_usec)/1000000;
+}
+
+double dclock_resolution()
+{
+    return dclock_use_tsc ? dclock_secs_per_cycle : 1.0e-6;
+}
+
+#else
+
 void init_dclock()
 {
     struct timeval tv;
@@ -139,6 +318,13 @@ double dclock()
     return (double(tv.tv_sec) - time0) + double(tv.tv_usec)/1000000;
 }
 
+double dclock_resolution()
+{
+    return 1.0e-6;
+}
+
+#endif // __x86_64__ && __linux__
+
 #endif // __sgi
 
 double dclock_overhead()
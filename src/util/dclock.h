@@ -38,6 +38,7 @@ typedef long long int dclock_hardware_t;
 void init_dclock(void);
 dclock_hardware_t hw_dclock_overhead(void);
 double dclock_overhead(void);
+double dclock_resolution(void);
 
 #ifdef __sgi
 
@@ -55,6 +56,33 @@ inline double dclock()
     return hw_dclock()*dclock_secs_per_cycle;
 }
 
+#elif defined(__x86_64__) && defined(__linux__)
+
+// Time stamp counter, used when init_dclock() finds it to be
+// invariant, otherwise dclock() falls back to gettimeofday()
+
+extern int dclock_use_tsc;
+extern double dclock_secs_per_cycle;
+extern dclock_hardware_t dclock_offset;
+
+double dclock_gettimeofday(void);
+
+inline dclock_hardware_t hw_dclock()
+{
+    unsigned int lo, hi;
+
+    __asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((dclock_hardware_t) hi << 32) | lo;
+}
+
+inline double dclock()
+{
+    if (dclock_use_tsc) {
+        return (hw_dclock() - dclock_offset) * dclock_secs_per_cycle;
+    }
+    return dclock_gettimeofday();
+}
+
 #else // __sgi
 
 #include <sys/time.h>